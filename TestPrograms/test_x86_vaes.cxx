@@ -0,0 +1,8 @@
+#include <immintrin.h>
+int main(int argc, char* argv[])
+{
+	__m256i x = _mm256_setzero_si256();
+	__m256i y = _mm256_aesenc_epi128(x, x);
+	__m256i z = _mm256_clmulepi64_epi128(x, y, 0x00);
+	return 0;
+}
@@ -313,6 +313,212 @@ void AbstractGroup<T>::SimultaneousMultiply(T *results, const T &base, const Int
 	}
 }
 
+// Signed base 2^w digits of the exponents for Pippenger's method. When
+// inversion is fast the digits are in [-2^(w-1), 2^(w-1)] and 2^(w-1)
+// buckets are needed. Otherwise the digits are in [0, 2^w) and only
+// negative exponents produce negative digits.
+struct PippengerRecoder
+{
+	PippengerRecoder(const Integer *exponents, size_t count, bool fastNegate)
+		: count(count), windowSize(0), windowCount(0), bucketCount(0)
+	{
+		unsigned int expLen = 0;
+		for (size_t i=0; i<count; i++)
+			expLen = STDMAX(expLen, exponents[i].BitCount());
+
+		// About log2(count)-2 bits, capped to keep the bucket table small
+		const unsigned int countLen = BitPrecision(count);
+		windowSize = countLen <= 4 ? 2 : STDMIN(countLen-2, 12U);
+		windowCount = expLen / windowSize + 1;
+		bucketCount = fastNegate ? (1U << (windowSize-1)) : (1U << windowSize) - 1;
+		digits.resize(windowCount * count);
+
+		const int radix = 1 << windowSize;
+		for (size_t i=0; i<count; i++)
+		{
+			const bool negative = exponents[i].IsNegative();
+			int carry = 0;
+			for (unsigned int j=0; j<windowCount; j++)
+			{
+				int d = static_cast<int>(exponents[i].GetBits(j*windowSize, windowSize)) + carry;
+				carry = 0;
+				if (fastNegate && d > radix/2)
+				{
+					d -= radix;
+					carry = 1;
+				}
+				digits[j*count+i] = negative ? -d : d;
+			}
+		}
+	}
+
+	int Digit(unsigned int window, size_t i) const {return digits[window*count+i];}
+
+	size_t count;
+	unsigned int windowSize, windowCount, bucketCount;
+	std::vector<int> digits;
+};
+
+template <class T>
+T AbstractGroup<T>::MultiScalarMultiply(const Element *bases, const Integer *exponents, size_t count) const
+{
+	if (count == 0)
+		return this->Identity();
+	if (count == 1 && exponents[0].NotNegative())
+		return this->ScalarMultiply(bases[0], exponents[0]);
+	if (count == 2 && exponents[0].NotNegative() && exponents[1].NotNegative())
+		return this->CascadeScalarMultiply(bases[0], exponents[0], bases[1], exponents[1]);
+
+	const PippengerRecoder recoder(exponents, count, InversionIsFast());
+	const unsigned int windowCount = recoder.windowCount, bucketCount = recoder.bucketCount;
+	size_t i;
+	unsigned int j, k;
+
+	std::vector<Element> inverses(count);
+	for (i=0; i<count; i++)
+	{
+		if (InversionIsFast() || exponents[i].IsNegative())
+			inverses[i] = this->Inverse(bases[i]);
+	}
+
+	// buckets[j*bucketCount+k] is the sum of the bases with digit +/-(k+1) in window j
+	std::vector<Element> buckets(size_t(windowCount)*bucketCount, this->Identity());
+	std::vector<bool> occupied(buckets.size(), false);
+	std::vector<size_t> busy(buckets.size(), 0);
+
+	std::vector<size_t> target, nextTarget;
+	std::vector<const Element*> source, nextSource;
+	std::vector<Element*> a;
+	std::vector<const Element*> b;
+
+	for (j=0; j<windowCount; j++)
+	{
+		for (i=0; i<count; i++)
+		{
+			const int d = recoder.Digit(j, i);
+			if (d != 0)
+			{
+				target.push_back(size_t(j)*bucketCount + (d > 0 ? d : -d) - 1);
+				source.push_back(d > 0 ? &bases[i] : &inverses[i]);
+			}
+		}
+	}
+
+	// Each round adds at most one element to each bucket, so the
+	// additions in a round are independent and can be batched.
+	for (size_t round=1; !target.empty(); round++)
+	{
+		a.clear(); b.clear();
+		nextTarget.clear(); nextSource.clear();
+
+		for (i=0; i<target.size(); i++)
+		{
+			const size_t t = target[i];
+			if (busy[t] == round)
+			{
+				nextTarget.push_back(t);
+				nextSource.push_back(source[i]);
+			}
+			else if (!occupied[t])
+			{
+				buckets[t] = *source[i];
+				occupied[t] = true;
+			}
+			else
+			{
+				a.push_back(&buckets[t]);
+				b.push_back(source[i]);
+				busy[t] = round;
+			}
+		}
+
+		if (!a.empty())
+			AccumulateBatch(&a[0], &b[0], a.size());
+
+		std::swap(target, nextTarget);
+		std::swap(source, nextSource);
+	}
+
+	// Running sums give sum((k+1)*buckets[k]) for each window. The
+	// windows are independent, so each step is one batch.
+	std::vector<Element> sums(windowCount, this->Identity()), totals(windowCount, this->Identity());
+	for (k=bucketCount; k--; )
+	{
+		a.clear(); b.clear();
+		for (j=0; j<windowCount; j++)
+		{
+			if (occupied[size_t(j)*bucketCount+k])
+			{
+				a.push_back(&sums[j]);
+				b.push_back(&buckets[size_t(j)*bucketCount+k]);
+			}
+		}
+		if (!a.empty())
+			AccumulateBatch(&a[0], &b[0], a.size());
+
+		a.clear(); b.clear();
+		for (j=0; j<windowCount; j++)
+		{
+			a.push_back(&totals[j]);
+			b.push_back(&sums[j]);
+		}
+		AccumulateBatch(&a[0], &b[0], a.size());
+	}
+
+	Element result = totals[windowCount-1];
+	for (j=windowCount-1; j--; )
+	{
+		for (k=0; k<recoder.windowSize; k++)
+			result = this->Double(result);
+		Accumulate(result, totals[j]);
+	}
+	return result;
+}
+
+template <class T>
+void AbstractGroup<T>::AccumulateBatch(Element *const *a, const Element *const *b, size_t count) const
+{
+	for (size_t i=0; i<count; i++)
+		Accumulate(*a[i], *b[i]);
+}
+
+template <class T, class Iterator> void ParallelInvert(const AbstractRing<T> &ring, Iterator begin, Iterator end)
+{
+	size_t n = end-begin;
+	if (n == 1)
+		*begin = ring.MultiplicativeInverse(*begin);
+	else if (n > 1)
+	{
+		std::vector<T> vec((n+1)/2);
+		unsigned int i;
+		Iterator it;
+
+		for (i=0, it=begin; i<n/2; i++, it+=2)
+			vec[i] = ring.Multiply(*it, *(it+1));
+		if (n%2 == 1)
+			vec[n/2] = *it;
+
+		ParallelInvert(ring, vec.begin(), vec.end());
+
+		for (i=0, it=begin; i<n/2; i++, it+=2)
+		{
+			if (!vec[i])
+			{
+				*it = ring.MultiplicativeInverse(*it);
+				*(it+1) = ring.MultiplicativeInverse(*(it+1));
+			}
+			else
+			{
+				std::swap(*it, *(it+1));
+				*it = ring.Multiply(*it, vec[i]);
+				*(it+1) = ring.Multiply(*(it+1), vec[i]);
+			}
+		}
+		if (n%2 == 1)
+			*it = vec[n/2];
+	}
+}
+
 template <class T> T AbstractRing<T>::Exponentiate(const Element &base, const Integer &exponent) const
 {
 	Element result;
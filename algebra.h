@@ -104,6 +104,34 @@ public:
 	/// \pre <tt>COUNTOF(results) == exponentsCount</tt>
 	/// \pre <tt>COUNTOF(exponents) == exponentsCount</tt>
 	virtual void SimultaneousMultiply(Element *results, const Element &base, const Integer *exponents, unsigned int exponentsCount) const;
+
+	/// \brief Multiplies many bases by many exponents and sums the products
+	/// \param bases an array of Elements
+	/// \param exponents an array of exponents
+	/// \param count the number of bases and exponents in the arrays
+	/// \returns the sum of <tt>exponents[i]*bases[i]</tt>
+	/// \details MultiScalarMultiply() uses Pippenger's bucket method. The exponents are split
+	///   into windows, the bases are sorted into buckets by their window value, and the buckets
+	///   are combined with running sums. The cost is about <tt>b/w*(count+2^w)</tt> additions
+	///   for <tt>b</tt>-bit exponents and a window of <tt>w</tt> bits, rather than
+	///   <tt>b*count</tt> for separate ScalarMultiply() calls.
+	/// \details The additions are grouped and handed to AccumulateBatch(), so derived classes
+	///   can amortize expensive operations across the group. Exponents may be negative.
+	/// \pre <tt>COUNTOF(bases) == count</tt>
+	/// \pre <tt>COUNTOF(exponents) == count</tt>
+	/// \since Crypto++ 8.3
+	virtual Element MultiScalarMultiply(const Element *bases, const Integer *exponents, size_t count) const;
+
+	/// \brief Adds elements in the group in a batch
+	/// \param a an array of pointers to accumulators
+	/// \param b an array of pointers to elements
+	/// \param count the number of pointers in the arrays
+	/// \details AccumulateBatch() performs <tt>Accumulate(*a[i], *b[i])</tt> for each
+	///   <tt>i</tt>. The accumulators must be distinct. The default implementation calls
+	///   Accumulate() for each pair. ECP and EC2N override it to share one field inversion
+	///   among all the additions using Montgomery's trick.
+	/// \since Crypto++ 8.3
+	virtual void AccumulateBatch(Element *const *a, const Element *const *b, size_t count) const;
 };
 
 /// \brief Abstract ring
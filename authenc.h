@@ -72,6 +72,18 @@ protected:
 	virtual void AuthenticateLastConfidentialBlock() {}
 	virtual void AuthenticateLastFooterBlock(byte *mac, size_t macSize) =0;
 
+	/// \brief Encrypt or decrypt and authenticate in a single pass
+	/// \param outString the output buffer
+	/// \param inString the input buffer
+	/// \param length the size of the buffers, in bytes
+	/// \returns the number of bytes that were not processed
+	/// \details ProcessAndAuthenticateBlocks() is called by ProcessData() when no
+	///   authentication data is buffered. Modes with a fused cipher and authenticator
+	///   override it and process as many bytes as they can. The default implementation
+	///   processes no bytes.
+	virtual size_t ProcessAndAuthenticateBlocks(byte *outString, const byte *inString, size_t length)
+		{CRYPTOPP_UNUSED(outString), CRYPTOPP_UNUSED(inString); return length;}
+
 	// State_AuthUntransformed: authentication is applied to plain text (Authenticate-then-Encrypt)
 	// State_AuthTransformed: authentication is applied to cipher text (Encrypt-then-Authenticate)
 	enum State {State_Start, State_KeySet, State_IVSet, State_AuthUntransformed, State_AuthTransformed, State_AuthFooter};
@@ -490,6 +490,12 @@ void Benchmark1(double t, double hertz)
 		BenchMarkByNameKeyLess<HashTransformation>("SM3");
 		BenchMarkByNameKeyLess<HashTransformation>("BLAKE2s");
 		BenchMarkByNameKeyLess<HashTransformation>("BLAKE2b");
+		BenchMarkByNameKeyLess<HashTransformation>("BLAKE2sp");
+		BenchMarkByNameKeyLess<HashTransformation>("BLAKE2bp");
+		BenchMarkByNameKeyLess<HashTransformation>("BLAKE3");
+		BenchMarkByNameKeyLess<HashTransformation>("KangarooTwelve");
+		BenchMarkByNameKeyLess<HashTransformation>("ParallelHash128");
+		BenchMarkByNameKeyLess<HashTransformation>("ParallelHash256");
 	}
 
 	std::cout << "\n</TABLE>" << std::endl;
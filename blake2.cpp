@@ -191,6 +191,133 @@ extern void BLAKE2_Compress32_ALTIVEC(const byte* input, BLAKE2s_State& state);
 extern void BLAKE2_Compress64_POWER8(const byte* input, BLAKE2b_State& state);
 #endif
 
+#if CRYPTOPP_AVX2_AVAILABLE
+extern void BLAKE2_Compress32x8_AVX2(const byte* input, size_t stripes, BLAKE2s_State* states);
+extern void BLAKE2_Compress64x4_AVX2(const byte* input, size_t stripes, BLAKE2b_State* states);
+#endif
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+inline void BLAKE2_Compress(const byte *input, BLAKE2s_State& state)
+{
+#if CRYPTOPP_SSE41_AVAILABLE
+    if(HasSSE41())
+    {
+        return BLAKE2_Compress32_SSE4(input, state);
+    }
+#endif
+#if CRYPTOPP_ARM_NEON_AVAILABLE
+    if(HasNEON())
+    {
+        return BLAKE2_Compress32_NEON(input, state);
+    }
+#endif
+#if CRYPTOPP_POWER7_AVAILABLE
+    if(HasPower7())
+    {
+        return BLAKE2_Compress32_POWER7(input, state);
+    }
+#elif CRYPTOPP_ALTIVEC_AVAILABLE
+    if(HasAltivec())
+    {
+        return BLAKE2_Compress32_ALTIVEC(input, state);
+    }
+#endif
+    return BLAKE2_Compress32_CXX(input, state);
+}
+
+inline void BLAKE2_Compress(const byte *input, BLAKE2b_State& state)
+{
+#if CRYPTOPP_SSE41_AVAILABLE
+    if(HasSSE41())
+    {
+        return BLAKE2_Compress64_SSE4(input, state);
+    }
+#endif
+#if CRYPTOPP_ARM_NEON_AVAILABLE
+    if(HasNEON())
+    {
+        return BLAKE2_Compress64_NEON(input, state);
+    }
+#endif
+#if CRYPTOPP_POWER8_AVAILABLE
+    if(HasPower8())
+    {
+        return BLAKE2_Compress64_POWER8(input, state);
+    }
+#endif
+    return BLAKE2_Compress64_CXX(input, state);
+}
+
+// The tree modes drive the leaf and root states directly, without
+// a BLAKE2s or BLAKE2b object. These mirror the member functions.
+
+template <class W, class S>
+inline void BLAKE2_IncrementCounter(S& state, size_t count)
+{
+    W* t = state.t();
+    t[0] += static_cast<W>(count);
+    t[1] += !!(t[0] < count);
+}
+
+template <class W, class S, class P>
+inline void BLAKE2_InitState(S& state, const P& block, const W iv[8])
+{
+    state.Reset();
+    PutBlock<W, LittleEndian, true> put(block.data(), state.h());
+    put(iv[0])(iv[1])(iv[2])(iv[3])(iv[4])(iv[5])(iv[6])(iv[7]);
+}
+
+template <class W, class S>
+void BLAKE2_UpdateState(S& state, const byte *input, size_t length)
+{
+    const size_t BLOCKSIZE = S::BLOCKSIZE;
+    if (length > BLOCKSIZE - state.m_len)
+    {
+        if (state.m_len != 0)
+        {
+            const size_t fill = BLOCKSIZE - state.m_len;
+            std::memcpy(state.m_buf+state.m_len, input, fill);
+
+            BLAKE2_IncrementCounter<W>(state, BLOCKSIZE);
+            BLAKE2_Compress(state.m_buf, state);
+            state.m_len = 0;
+
+            length -= fill, input += fill;
+        }
+
+        while (length > BLOCKSIZE)
+        {
+            BLAKE2_IncrementCounter<W>(state, BLOCKSIZE);
+            BLAKE2_Compress(input, state);
+            length -= BLOCKSIZE, input += BLOCKSIZE;
+        }
+    }
+
+    if (length)
+    {
+        std::memcpy(state.m_buf+state.m_len, input, length);
+        state.m_len += length;
+    }
+}
+
+template <class W, class S>
+void BLAKE2_FinalState(S& state, bool lastNode, byte *hash, size_t size)
+{
+    W* f = state.f();
+    f[0] = ~static_cast<W>(0);
+    if (lastNode)
+        f[1] = ~static_cast<W>(0);
+
+    BLAKE2_IncrementCounter<W>(state, state.m_len);
+    std::memset(state.m_buf + state.m_len, 0x00, S::BLOCKSIZE - state.m_len);
+    BLAKE2_Compress(state.m_buf, state);
+
+    std::memcpy(hash, state.h(), size);
+}
+
+ANONYMOUS_NAMESPACE_END
+
 unsigned int BLAKE2b::OptimalDataAlignment() const
 {
 #if defined(CRYPTOPP_SSE41_AVAILABLE)
@@ -684,53 +811,400 @@ void BLAKE2b::IncrementCounter(size_t count)
 
 void BLAKE2s::Compress(const byte *input)
 {
-#if CRYPTOPP_SSE41_AVAILABLE
-    if(HasSSE41())
+    BLAKE2_Compress(input, m_state);
+}
+
+void BLAKE2b::Compress(const byte *input)
+{
+    BLAKE2_Compress(input, m_state);
+}
+
+// *************************************************************
+
+BLAKE2sp::BLAKE2sp(unsigned int digestSize)
+    : m_len(0), m_digestSize(digestSize), m_keyLength(0), m_held(false)
+{
+    CRYPTOPP_ASSERT(digestSize <= DIGESTSIZE);
+
+    UncheckedSetKey(NULLPTR, 0, MakeParameters
+        (Name::DigestSize(), (int)digestSize));
+}
+
+BLAKE2sp::BLAKE2sp(const byte *key, size_t keyLength, const byte* salt, size_t saltLength,
+    const byte* personalization, size_t personalizationLength, unsigned int digestSize)
+    : m_len(0), m_digestSize(digestSize), m_keyLength(static_cast<unsigned int>(keyLength)), m_held(false)
+{
+    CRYPTOPP_ASSERT(keyLength <= MAX_KEYLENGTH);
+    CRYPTOPP_ASSERT(digestSize <= DIGESTSIZE);
+    CRYPTOPP_ASSERT(saltLength <= SALTSIZE);
+    CRYPTOPP_ASSERT(personalizationLength <= PERSONALIZATIONSIZE);
+
+    UncheckedSetKey(key, static_cast<unsigned int>(keyLength), MakeParameters
+        (Name::DigestSize(),(int)digestSize)
+        (Name::Salt(), ConstByteArrayParameter(salt, saltLength))
+        (Name::Personalization(), ConstByteArrayParameter(personalization, personalizationLength)));
+}
+
+unsigned int BLAKE2sp::OptimalDataAlignment() const
+{
+    return GetAlignmentOf<word32>();
+}
+
+std::string BLAKE2sp::AlgorithmProvider() const
+{
+#if CRYPTOPP_AVX2_AVAILABLE
+    if (HasAVX2())
+        return "AVX2";
+#endif
+    return BLAKE2s().AlgorithmProvider();
+}
+
+void BLAKE2sp::UncheckedSetKey(const byte *key, unsigned int length, const CryptoPP::NameValuePairs& params)
+{
+    if (key && length)
     {
-        return BLAKE2_Compress32_SSE4(input, m_state);
+        m_key.New(BLOCKSIZE);
+        std::memcpy(m_key, key, length);
+        std::memset(m_key + length, 0x00, BLOCKSIZE - length);
+        m_keyLength = length;
     }
-#endif
-#if CRYPTOPP_ARM_NEON_AVAILABLE
-    if(HasNEON())
+    else
     {
-        return BLAKE2_Compress32_NEON(input, m_state);
+        m_key.resize(0);
+        m_keyLength = 0;
     }
-#endif
-#if CRYPTOPP_POWER7_AVAILABLE
-    if(HasPower7())
+
+    m_digestSize = static_cast<unsigned int>(params.GetIntValueWithDefault(
+                       Name::DigestSize(), static_cast<int>(m_digestSize)));
+
+    m_block.Reset(m_digestSize, m_keyLength);
+
+    ConstByteArrayParameter t;
+    if (params.GetValue(Name::Salt(), t) && t.begin() && t.size())
+        memcpy_s(m_block.salt(), SALTSIZE, t.begin(), t.size());
+
+    if (params.GetValue(Name::Personalization(), t) && t.begin() && t.size())
+        memcpy_s(m_block.personalization(), PERSONALIZATIONSIZE, t.begin(), t.size());
+
+    Restart();
+}
+
+void BLAKE2sp::Restart()
+{
+    // Leaf i has node offset i, and the last leaf is the last node
+    ParameterBlock block(m_block);
+    block.m_data[ParameterBlock::FanoutOff] = PARALLELISM;
+    block.m_data[ParameterBlock::DepthOff] = 2;
+    block.m_data[ParameterBlock::InnerOff] = DIGESTSIZE;
+
+    for (unsigned int i = 0; i < PARALLELISM; ++i)
     {
-        return BLAKE2_Compress32_POWER7(input, m_state);
+        block.m_data[ParameterBlock::NodeOff] = static_cast<byte>(i);
+        BLAKE2_InitState(m_leaves[i], block, BLAKE2S_IV);
     }
-#elif CRYPTOPP_ALTIVEC_AVAILABLE
-    if(HasAltivec())
+
+    // Every leaf is keyed. The key blocks are held back like
+    // a stripe of input, because they are the last blocks of
+    // the leaves when the message is empty.
+    m_held = (m_keyLength != 0);
+    for (unsigned int i = 0; m_held && i < PARALLELISM; ++i)
+        std::memcpy(m_last+i*BLOCKSIZE, m_key, BLOCKSIZE);
+
+    m_len = 0;
+}
+
+void BLAKE2sp::Update(const byte *input, size_t length)
+{
+    CRYPTOPP_ASSERT(input != NULLPTR || length == 0);
+    const size_t STRIPESIZE = PARALLELISM*BLOCKSIZE;
+
+    if (m_len != 0 && length >= STRIPESIZE - m_len)
     {
-        return BLAKE2_Compress32_ALTIVEC(input, m_state);
+        // Complete current stripe
+        const size_t fill = STRIPESIZE - m_len;
+        std::memcpy(m_buf+m_len, input, fill);
+
+        Compress(m_buf, 1);
+        m_len = 0;
+
+        length -= fill, input += fill;
+    }
+
+    // Compress in-place to avoid copies
+    if (m_len == 0 && length >= STRIPESIZE)
+    {
+        const size_t stripes = length / STRIPESIZE;
+        Compress(input, stripes);
+        length -= stripes*STRIPESIZE, input += stripes*STRIPESIZE;
+    }
+
+    // Copy tail bytes
+    if (length)
+    {
+        CRYPTOPP_ASSERT(length < STRIPESIZE - m_len);
+        std::memcpy(m_buf+m_len, input, length);
+        m_len += length;
     }
-#endif
-    return BLAKE2_Compress32_CXX(input, m_state);
 }
 
-void BLAKE2b::Compress(const byte *input)
+void BLAKE2sp::Compress(const byte *input, size_t stripes)
 {
-#if CRYPTOPP_SSE41_AVAILABLE
-    if(HasSSE41())
+    CRYPTOPP_ASSERT(stripes != 0);
+    const size_t STRIPESIZE = PARALLELISM*BLOCKSIZE;
+
+#if CRYPTOPP_AVX2_AVAILABLE
+    if (HasAVX2())
     {
-        return BLAKE2_Compress64_SSE4(input, m_state);
+        if (m_held)
+            BLAKE2_Compress32x8_AVX2(m_last, 1, m_leaves);
+        if (stripes > 1)
+            BLAKE2_Compress32x8_AVX2(input, stripes-1, m_leaves);
     }
+    else
 #endif
-#if CRYPTOPP_ARM_NEON_AVAILABLE
-    if(HasNEON())
     {
-        return BLAKE2_Compress64_NEON(input, m_state);
+        for (unsigned int i = 0; m_held && i < PARALLELISM; ++i)
+        {
+            BLAKE2_IncrementCounter<word32>(m_leaves[i], BLOCKSIZE);
+            BLAKE2_Compress(m_last+i*BLOCKSIZE, m_leaves[i]);
+        }
+        for (size_t j = 0; j+1 < stripes; ++j)
+        {
+            for (unsigned int i = 0; i < PARALLELISM; ++i)
+            {
+                BLAKE2_IncrementCounter<word32>(m_leaves[i], BLOCKSIZE);
+                BLAKE2_Compress(input+j*STRIPESIZE+i*BLOCKSIZE, m_leaves[i]);
+            }
+        }
+    }
+
+    std::memcpy(m_last, input+(stripes-1)*STRIPESIZE, STRIPESIZE);
+    m_held = true;
+}
+
+void BLAKE2sp::TruncatedFinal(byte *hash, size_t size)
+{
+    CRYPTOPP_ASSERT(hash != NULLPTR);
+    this->ThrowIfInvalidTruncatedSize(size);
+
+    // Deal the held back and buffered stripes to the leaves and finish them
+    FixedSizeSecBlock<byte, PARALLELISM*DIGESTSIZE> digests;
+    for (unsigned int i = 0; i < PARALLELISM; ++i)
+    {
+        if (m_held)
+            BLAKE2_UpdateState<word32>(m_leaves[i], m_last+i*BLOCKSIZE, BLOCKSIZE);
+        if (m_len > i*BLOCKSIZE)
+            BLAKE2_UpdateState<word32>(m_leaves[i], m_buf+i*BLOCKSIZE, STDMIN(m_len-i*BLOCKSIZE, size_t(BLOCKSIZE)));
+        BLAKE2_FinalState<word32>(m_leaves[i], i == PARALLELISM-1, digests+i*DIGESTSIZE, DIGESTSIZE);
     }
+
+    // The root is at depth 1. It takes the key length but not the key.
+    ParameterBlock block(m_block);
+    block.m_data[ParameterBlock::FanoutOff] = PARALLELISM;
+    block.m_data[ParameterBlock::DepthOff] = 2;
+    block.m_data[ParameterBlock::NodeDepthOff] = 1;
+    block.m_data[ParameterBlock::InnerOff] = DIGESTSIZE;
+
+    State root;
+    BLAKE2_InitState(root, block, BLAKE2S_IV);
+    BLAKE2_UpdateState<word32>(root, digests, digests.size());
+    BLAKE2_FinalState<word32>(root, true, hash, size);
+
+    Restart();
+}
+
+// *************************************************************
+
+BLAKE2bp::BLAKE2bp(unsigned int digestSize)
+    : m_len(0), m_digestSize(digestSize), m_keyLength(0), m_held(false)
+{
+    CRYPTOPP_ASSERT(digestSize <= DIGESTSIZE);
+
+    UncheckedSetKey(NULLPTR, 0, MakeParameters
+        (Name::DigestSize(), (int)digestSize));
+}
+
+BLAKE2bp::BLAKE2bp(const byte *key, size_t keyLength, const byte* salt, size_t saltLength,
+    const byte* personalization, size_t personalizationLength, unsigned int digestSize)
+    : m_len(0), m_digestSize(digestSize), m_keyLength(static_cast<unsigned int>(keyLength)), m_held(false)
+{
+    CRYPTOPP_ASSERT(keyLength <= MAX_KEYLENGTH);
+    CRYPTOPP_ASSERT(digestSize <= DIGESTSIZE);
+    CRYPTOPP_ASSERT(saltLength <= SALTSIZE);
+    CRYPTOPP_ASSERT(personalizationLength <= PERSONALIZATIONSIZE);
+
+    UncheckedSetKey(key, static_cast<unsigned int>(keyLength), MakeParameters
+        (Name::DigestSize(),(int)digestSize)
+        (Name::Salt(), ConstByteArrayParameter(salt, saltLength))
+        (Name::Personalization(), ConstByteArrayParameter(personalization, personalizationLength)));
+}
+
+unsigned int BLAKE2bp::OptimalDataAlignment() const
+{
+    return GetAlignmentOf<word64>();
+}
+
+std::string BLAKE2bp::AlgorithmProvider() const
+{
+#if CRYPTOPP_AVX2_AVAILABLE
+    if (HasAVX2())
+        return "AVX2";
 #endif
-#if CRYPTOPP_POWER8_AVAILABLE
-    if(HasPower8())
+    return BLAKE2b().AlgorithmProvider();
+}
+
+void BLAKE2bp::UncheckedSetKey(const byte *key, unsigned int length, const CryptoPP::NameValuePairs& params)
+{
+    if (key && length)
     {
-        return BLAKE2_Compress64_POWER8(input, m_state);
+        m_key.New(BLOCKSIZE);
+        std::memcpy(m_key, key, length);
+        std::memset(m_key + length, 0x00, BLOCKSIZE - length);
+        m_keyLength = length;
+    }
+    else
+    {
+        m_key.resize(0);
+        m_keyLength = 0;
+    }
+
+    m_digestSize = static_cast<unsigned int>(params.GetIntValueWithDefault(
+                       Name::DigestSize(), static_cast<int>(m_digestSize)));
+
+    m_block.Reset(m_digestSize, m_keyLength);
+
+    ConstByteArrayParameter t;
+    if (params.GetValue(Name::Salt(), t) && t.begin() && t.size())
+        memcpy_s(m_block.salt(), SALTSIZE, t.begin(), t.size());
+
+    if (params.GetValue(Name::Personalization(), t) && t.begin() && t.size())
+        memcpy_s(m_block.personalization(), PERSONALIZATIONSIZE, t.begin(), t.size());
+
+    Restart();
+}
+
+void BLAKE2bp::Restart()
+{
+    // Leaf i has node offset i, and the last leaf is the last node
+    ParameterBlock block(m_block);
+    block.m_data[ParameterBlock::FanoutOff] = PARALLELISM;
+    block.m_data[ParameterBlock::DepthOff] = 2;
+    block.m_data[ParameterBlock::InnerOff] = DIGESTSIZE;
+
+    for (unsigned int i = 0; i < PARALLELISM; ++i)
+    {
+        block.m_data[ParameterBlock::NodeOff] = static_cast<byte>(i);
+        BLAKE2_InitState(m_leaves[i], block, BLAKE2B_IV);
+    }
+
+    // Every leaf is keyed. The key blocks are held back like
+    // a stripe of input, because they are the last blocks of
+    // the leaves when the message is empty.
+    m_held = (m_keyLength != 0);
+    for (unsigned int i = 0; m_held && i < PARALLELISM; ++i)
+        std::memcpy(m_last+i*BLOCKSIZE, m_key, BLOCKSIZE);
+
+    m_len = 0;
+}
+
+void BLAKE2bp::Update(const byte *input, size_t length)
+{
+    CRYPTOPP_ASSERT(input != NULLPTR || length == 0);
+    const size_t STRIPESIZE = PARALLELISM*BLOCKSIZE;
+
+    if (m_len != 0 && length >= STRIPESIZE - m_len)
+    {
+        // Complete current stripe
+        const size_t fill = STRIPESIZE - m_len;
+        std::memcpy(m_buf+m_len, input, fill);
+
+        Compress(m_buf, 1);
+        m_len = 0;
+
+        length -= fill, input += fill;
+    }
+
+    // Compress in-place to avoid copies
+    if (m_len == 0 && length >= STRIPESIZE)
+    {
+        const size_t stripes = length / STRIPESIZE;
+        Compress(input, stripes);
+        length -= stripes*STRIPESIZE, input += stripes*STRIPESIZE;
     }
+
+    // Copy tail bytes
+    if (length)
+    {
+        CRYPTOPP_ASSERT(length < STRIPESIZE - m_len);
+        std::memcpy(m_buf+m_len, input, length);
+        m_len += length;
+    }
+}
+
+void BLAKE2bp::Compress(const byte *input, size_t stripes)
+{
+    CRYPTOPP_ASSERT(stripes != 0);
+    const size_t STRIPESIZE = PARALLELISM*BLOCKSIZE;
+
+#if CRYPTOPP_AVX2_AVAILABLE
+    if (HasAVX2())
+    {
+        if (m_held)
+            BLAKE2_Compress64x4_AVX2(m_last, 1, m_leaves);
+        if (stripes > 1)
+            BLAKE2_Compress64x4_AVX2(input, stripes-1, m_leaves);
+    }
+    else
 #endif
-    return BLAKE2_Compress64_CXX(input, m_state);
+    {
+        for (unsigned int i = 0; m_held && i < PARALLELISM; ++i)
+        {
+            BLAKE2_IncrementCounter<word64>(m_leaves[i], BLOCKSIZE);
+            BLAKE2_Compress(m_last+i*BLOCKSIZE, m_leaves[i]);
+        }
+        for (size_t j = 0; j+1 < stripes; ++j)
+        {
+            for (unsigned int i = 0; i < PARALLELISM; ++i)
+            {
+                BLAKE2_IncrementCounter<word64>(m_leaves[i], BLOCKSIZE);
+                BLAKE2_Compress(input+j*STRIPESIZE+i*BLOCKSIZE, m_leaves[i]);
+            }
+        }
+    }
+
+    std::memcpy(m_last, input+(stripes-1)*STRIPESIZE, STRIPESIZE);
+    m_held = true;
+}
+
+void BLAKE2bp::TruncatedFinal(byte *hash, size_t size)
+{
+    CRYPTOPP_ASSERT(hash != NULLPTR);
+    this->ThrowIfInvalidTruncatedSize(size);
+
+    // Deal the held back and buffered stripes to the leaves and finish them
+    FixedSizeSecBlock<byte, PARALLELISM*DIGESTSIZE> digests;
+    for (unsigned int i = 0; i < PARALLELISM; ++i)
+    {
+        if (m_held)
+            BLAKE2_UpdateState<word64>(m_leaves[i], m_last+i*BLOCKSIZE, BLOCKSIZE);
+        if (m_len > i*BLOCKSIZE)
+            BLAKE2_UpdateState<word64>(m_leaves[i], m_buf+i*BLOCKSIZE, STDMIN(m_len-i*BLOCKSIZE, size_t(BLOCKSIZE)));
+        BLAKE2_FinalState<word64>(m_leaves[i], i == PARALLELISM-1, digests+i*DIGESTSIZE, DIGESTSIZE);
+    }
+
+    // The root is at depth 1. It takes the key length but not the key.
+    ParameterBlock block(m_block);
+    block.m_data[ParameterBlock::FanoutOff] = PARALLELISM;
+    block.m_data[ParameterBlock::DepthOff] = 2;
+    block.m_data[ParameterBlock::NodeDepthOff] = 1;
+    block.m_data[ParameterBlock::InnerOff] = DIGESTSIZE;
+
+    State root;
+    BLAKE2_InitState(root, block, BLAKE2B_IV);
+    BLAKE2_UpdateState<word64>(root, digests, digests.size());
+    BLAKE2_FinalState<word64>(root, true, hash, size);
+
+    Restart();
 }
 
 void BLAKE2_Compress64_CXX(const byte* input, BLAKE2b_State& state)
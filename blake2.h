@@ -4,7 +4,7 @@
 //            implementation at http://github.com/BLAKE2/BLAKE2.
 
 /// \file blake2.h
-/// \brief Classes for BLAKE2b and BLAKE2s message digests and keyed message digests
+/// \brief Classes for BLAKE2b, BLAKE2s, BLAKE2bp and BLAKE2sp message digests and keyed message digests
 /// \details This implementation follows Aumasson, Neves, Wilcox-O'Hearn and Winnerlein's
 ///   <A HREF="http://blake2.net/blake2.pdf">BLAKE2: simpler, smaller, fast as MD5</A> (2013.01.29).
 ///   Static algorithm name return either "BLAKE2b" or "BLAKE2s". An object algorithm name follows
@@ -56,6 +56,22 @@ struct BLAKE2b_Info : public VariableKeyLength<64,0,64,1,SimpleKeyingInterface::
     CRYPTOPP_STATIC_CONSTEXPR const char* StaticAlgorithmName() {return "BLAKE2b";}
 };
 
+/// \brief BLAKE2sp hash information
+/// \since Crypto++ 8.3
+struct BLAKE2sp_Info : public BLAKE2s_Info
+{
+    CRYPTOPP_CONSTANT(PARALLELISM = 8);
+    CRYPTOPP_STATIC_CONSTEXPR const char* StaticAlgorithmName() {return "BLAKE2sp";}
+};
+
+/// \brief BLAKE2bp hash information
+/// \since Crypto++ 8.3
+struct BLAKE2bp_Info : public BLAKE2b_Info
+{
+    CRYPTOPP_CONSTANT(PARALLELISM = 4);
+    CRYPTOPP_STATIC_CONSTEXPR const char* StaticAlgorithmName() {return "BLAKE2bp";}
+};
+
 /// \brief BLAKE2s parameter block
 struct CRYPTOPP_NO_VTABLE BLAKE2s_ParameterBlock
 {
@@ -439,6 +455,168 @@ private:
     bool m_treeMode;
 };
 
+/// \brief The BLAKE2sp cryptographic hash function
+/// \details BLAKE2sp is the parallel tree mode of BLAKE2s from the BLAKE2 paper. The
+///   message is split into 64-byte blocks which are dealt round robin to 8 leaves,
+///   and a root node hashes the 8 leaf digests. The digest differs from BLAKE2s.
+/// \details The leaves are independent, so on x86 and x64 the AVX2 code compresses all 8
+///   leaves at once, one leaf per 32-bit lane of a YMM register. Otherwise each
+///   leaf is compressed in turn with the BLAKE2s code.
+/// \details BLAKE2sp can function as both a hash and keyed hash, like BLAKE2s.
+/// \sa Aumasson, Neves, Wilcox-O'Hearn and Winnerlein's
+///   <A HREF="http://blake2.net/blake2.pdf">BLAKE2: simpler, smaller, fast as MD5</A> (2013.01.29).
+/// \since Crypto++ 8.3
+class BLAKE2sp : public SimpleKeyingInterfaceImpl<MessageAuthenticationCode, BLAKE2sp_Info>
+{
+public:
+    CRYPTOPP_CONSTANT(DEFAULT_KEYLENGTH = BLAKE2sp_Info::DEFAULT_KEYLENGTH);
+    CRYPTOPP_CONSTANT(MIN_KEYLENGTH = BLAKE2sp_Info::MIN_KEYLENGTH);
+    CRYPTOPP_CONSTANT(MAX_KEYLENGTH = BLAKE2sp_Info::MAX_KEYLENGTH);
+
+    CRYPTOPP_CONSTANT(DIGESTSIZE = BLAKE2sp_Info::DIGESTSIZE);
+    CRYPTOPP_CONSTANT(BLOCKSIZE = BLAKE2sp_Info::BLOCKSIZE);
+    CRYPTOPP_CONSTANT(SALTSIZE = BLAKE2sp_Info::SALTSIZE);
+    CRYPTOPP_CONSTANT(PERSONALIZATIONSIZE = BLAKE2sp_Info::PERSONALIZATIONSIZE);
+    CRYPTOPP_CONSTANT(PARALLELISM = BLAKE2sp_Info::PARALLELISM);
+
+    typedef BLAKE2s_State State;
+    typedef BLAKE2s_ParameterBlock ParameterBlock;
+
+    CRYPTOPP_STATIC_CONSTEXPR const char* StaticAlgorithmName() {return "BLAKE2sp";}
+
+    virtual ~BLAKE2sp() {}
+
+    /// \brief Construct a BLAKE2sp hash
+    /// \param digestSize the digest size, in bytes
+    /// \since Crypto++ 8.3
+    BLAKE2sp(unsigned int digestSize = DIGESTSIZE);
+
+    /// \brief Construct a BLAKE2sp hash
+    /// \param key a byte array used to key the cipher
+    /// \param keyLength the size of the byte array
+    /// \param salt a byte array used as salt
+    /// \param saltLength the size of the byte array
+    /// \param personalization a byte array used as personalization string
+    /// \param personalizationLength the size of the byte array
+    /// \param digestSize the digest size, in bytes
+    /// \since Crypto++ 8.3
+    BLAKE2sp(const byte *key, size_t keyLength, const byte* salt = NULLPTR, size_t saltLength = 0,
+        const byte* personalization = NULLPTR, size_t personalizationLength = 0,
+        unsigned int digestSize = DIGESTSIZE);
+
+    /// \brief Retrieve the object's name
+    /// \returns the object's algorithm name, like "BLAKE2sp-256"
+    std::string AlgorithmName() const {return std::string(BLAKE2sp_Info::StaticAlgorithmName()) + "-" + IntToString(DigestSize()*8);}
+
+    unsigned int BlockSize() const {return BLOCKSIZE;}
+    unsigned int DigestSize() const {return m_digestSize;}
+    unsigned int OptimalDataAlignment() const;
+
+    void Update(const byte *input, size_t length);
+    void Restart();
+    void TruncatedFinal(byte *hash, size_t size);
+
+    std::string AlgorithmProvider() const;
+
+protected:
+    // Compresses whole stripes of PARALLELISM blocks, one block per leaf.
+    // The last stripe is held back in m_last until more input arrives.
+    void Compress(const byte *input, size_t stripes);
+
+    void UncheckedSetKey(const byte* key, unsigned int length, const CryptoPP::NameValuePairs& params);
+
+private:
+    State m_leaves[PARALLELISM];
+    ParameterBlock m_block;
+    FixedSizeAlignedSecBlock<byte, PARALLELISM*BLOCKSIZE, true> m_buf;
+    FixedSizeAlignedSecBlock<byte, PARALLELISM*BLOCKSIZE, true> m_last;
+    AlignedSecByteBlock m_key;
+    size_t m_len;
+    word32 m_digestSize, m_keyLength;
+    bool m_held;
+};
+
+/// \brief The BLAKE2bp cryptographic hash function
+/// \details BLAKE2bp is the parallel tree mode of BLAKE2b from the BLAKE2 paper. The
+///   message is split into 128-byte blocks which are dealt round robin to 4 leaves,
+///   and a root node hashes the 4 leaf digests. The digest differs from BLAKE2b.
+/// \details The leaves are independent, so on x86 and x64 the AVX2 code compresses all 4
+///   leaves at once, one leaf per 64-bit lane of a YMM register. Otherwise each
+///   leaf is compressed in turn with the BLAKE2b code.
+/// \details BLAKE2bp can function as both a hash and keyed hash, like BLAKE2b.
+/// \sa Aumasson, Neves, Wilcox-O'Hearn and Winnerlein's
+///   <A HREF="http://blake2.net/blake2.pdf">BLAKE2: simpler, smaller, fast as MD5</A> (2013.01.29).
+/// \since Crypto++ 8.3
+class BLAKE2bp : public SimpleKeyingInterfaceImpl<MessageAuthenticationCode, BLAKE2bp_Info>
+{
+public:
+    CRYPTOPP_CONSTANT(DEFAULT_KEYLENGTH = BLAKE2bp_Info::DEFAULT_KEYLENGTH);
+    CRYPTOPP_CONSTANT(MIN_KEYLENGTH = BLAKE2bp_Info::MIN_KEYLENGTH);
+    CRYPTOPP_CONSTANT(MAX_KEYLENGTH = BLAKE2bp_Info::MAX_KEYLENGTH);
+
+    CRYPTOPP_CONSTANT(DIGESTSIZE = BLAKE2bp_Info::DIGESTSIZE);
+    CRYPTOPP_CONSTANT(BLOCKSIZE = BLAKE2bp_Info::BLOCKSIZE);
+    CRYPTOPP_CONSTANT(SALTSIZE = BLAKE2bp_Info::SALTSIZE);
+    CRYPTOPP_CONSTANT(PERSONALIZATIONSIZE = BLAKE2bp_Info::PERSONALIZATIONSIZE);
+    CRYPTOPP_CONSTANT(PARALLELISM = BLAKE2bp_Info::PARALLELISM);
+
+    typedef BLAKE2b_State State;
+    typedef BLAKE2b_ParameterBlock ParameterBlock;
+
+    CRYPTOPP_STATIC_CONSTEXPR const char* StaticAlgorithmName() {return "BLAKE2bp";}
+
+    virtual ~BLAKE2bp() {}
+
+    /// \brief Construct a BLAKE2bp hash
+    /// \param digestSize the digest size, in bytes
+    /// \since Crypto++ 8.3
+    BLAKE2bp(unsigned int digestSize = DIGESTSIZE);
+
+    /// \brief Construct a BLAKE2bp hash
+    /// \param key a byte array used to key the cipher
+    /// \param keyLength the size of the byte array
+    /// \param salt a byte array used as salt
+    /// \param saltLength the size of the byte array
+    /// \param personalization a byte array used as personalization string
+    /// \param personalizationLength the size of the byte array
+    /// \param digestSize the digest size, in bytes
+    /// \since Crypto++ 8.3
+    BLAKE2bp(const byte *key, size_t keyLength, const byte* salt = NULLPTR, size_t saltLength = 0,
+        const byte* personalization = NULLPTR, size_t personalizationLength = 0,
+        unsigned int digestSize = DIGESTSIZE);
+
+    /// \brief Retrieve the object's name
+    /// \returns the object's algorithm name, like "BLAKE2bp-512"
+    std::string AlgorithmName() const {return std::string(BLAKE2bp_Info::StaticAlgorithmName()) + "-" + IntToString(DigestSize()*8);}
+
+    unsigned int BlockSize() const {return BLOCKSIZE;}
+    unsigned int DigestSize() const {return m_digestSize;}
+    unsigned int OptimalDataAlignment() const;
+
+    void Update(const byte *input, size_t length);
+    void Restart();
+    void TruncatedFinal(byte *hash, size_t size);
+
+    std::string AlgorithmProvider() const;
+
+protected:
+    // Compresses whole stripes of PARALLELISM blocks, one block per leaf.
+    // The last stripe is held back in m_last until more input arrives.
+    void Compress(const byte *input, size_t stripes);
+
+    void UncheckedSetKey(const byte* key, unsigned int length, const CryptoPP::NameValuePairs& params);
+
+private:
+    State m_leaves[PARALLELISM];
+    ParameterBlock m_block;
+    FixedSizeAlignedSecBlock<byte, PARALLELISM*BLOCKSIZE, true> m_buf;
+    FixedSizeAlignedSecBlock<byte, PARALLELISM*BLOCKSIZE, true> m_last;
+    AlignedSecByteBlock m_key;
+    size_t m_len;
+    word32 m_digestSize, m_keyLength;
+    bool m_held;
+};
+
 NAMESPACE_END
 
 #endif
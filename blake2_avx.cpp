@@ -0,0 +1,319 @@
+// blake2_avx.cpp - written and placed in the public domain by
+//                  the Crypto++ project.
+//
+//    This source file uses intrinsics and built-ins to gain access to
+//    AVX2 instructions. A separate source file is needed because
+//    additional CXXFLAGS are required to enable the appropriate
+//    instructions sets in some build configurations.
+//
+//    The code compresses the leaves of BLAKE2sp and BLAKE2bp side by
+//    side, one leaf per lane of a YMM register: eight BLAKE2s leaves in
+//    32-bit lanes, or four BLAKE2b leaves in 64-bit lanes. The caller in
+//    blake2.cpp hands over whole stripes of one block per leaf. All the
+//    leaves have compressed the same number of blocks, so they share the
+//    counter, and the finalization flags are clear.
+
+#include "pch.h"
+#include "config.h"
+#include "misc.h"
+#include "blake2.h"
+
+#if (CRYPTOPP_AVX2_AVAILABLE)
+# include <emmintrin.h>
+# include <immintrin.h>
+#endif
+
+// Squash MS LNK4221 and libtool warnings
+extern const char BLAKE2_AVX_FNAME[] = __FILE__;
+
+// Clang intrinsic casts, http://bugs.llvm.org/show_bug.cgi?id=20670
+#define M256_CAST(x) ((__m256i *)(void *)(x))
+#define CONST_M256_CAST(x) ((const __m256i *)(const void *)(x))
+
+NAMESPACE_BEGIN(CryptoPP)
+
+#if (CRYPTOPP_AVX2_AVAILABLE)
+
+extern const word32 BLAKE2S_IV[8];
+extern const word64 BLAKE2B_IV[8];
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+const byte SIGMA[12][16] = {
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 },
+    { 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 },
+    {  7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 },
+    {  9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 },
+    {  2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 },
+    { 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 },
+    { 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 },
+    {  6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 },
+    { 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13 , 0 },
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 }
+};
+
+// Rotations by a multiple of 8 are byte shuffles
+inline __m256i RotateRight32_16(const __m256i val)
+{
+    const __m256i mask = _mm256_set_epi8(
+        13,12,15,14, 9,8,11,10, 5,4,7,6, 1,0,3,2,
+        13,12,15,14, 9,8,11,10, 5,4,7,6, 1,0,3,2);
+    return _mm256_shuffle_epi8(val, mask);
+}
+
+inline __m256i RotateRight32_8(const __m256i val)
+{
+    const __m256i mask = _mm256_set_epi8(
+        12,15,14,13, 8,11,10,9, 4,7,6,5, 0,3,2,1,
+        12,15,14,13, 8,11,10,9, 4,7,6,5, 0,3,2,1);
+    return _mm256_shuffle_epi8(val, mask);
+}
+
+template <unsigned int R>
+inline __m256i RotateRight32(const __m256i val)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(val, R), _mm256_slli_epi32(val, 32-R));
+}
+
+inline __m256i RotateRight64_32(const __m256i val)
+{
+    return _mm256_shuffle_epi32(val, _MM_SHUFFLE(2,3,0,1));
+}
+
+inline __m256i RotateRight64_24(const __m256i val)
+{
+    const __m256i mask = _mm256_set_epi8(
+        10,9,8,15,14,13,12,11, 2,1,0,7,6,5,4,3,
+        10,9,8,15,14,13,12,11, 2,1,0,7,6,5,4,3);
+    return _mm256_shuffle_epi8(val, mask);
+}
+
+inline __m256i RotateRight64_16(const __m256i val)
+{
+    const __m256i mask = _mm256_set_epi8(
+        9,8,15,14,13,12,11,10, 1,0,7,6,5,4,3,2,
+        9,8,15,14,13,12,11,10, 1,0,7,6,5,4,3,2);
+    return _mm256_shuffle_epi8(val, mask);
+}
+
+inline __m256i RotateRight64_63(const __m256i val)
+{
+    return _mm256_or_si256(_mm256_srli_epi64(val, 63), _mm256_add_epi64(val, val));
+}
+
+inline void G32(__m256i v[16], const __m256i m[16], unsigned int r, unsigned int i,
+    unsigned int a, unsigned int b, unsigned int c, unsigned int d)
+{
+    v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), m[SIGMA[r][2*i+0]]);
+    v[d] = RotateRight32_16(_mm256_xor_si256(v[d], v[a]));
+    v[c] = _mm256_add_epi32(v[c], v[d]);
+    v[b] = RotateRight32<12>(_mm256_xor_si256(v[b], v[c]));
+    v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), m[SIGMA[r][2*i+1]]);
+    v[d] = RotateRight32_8(_mm256_xor_si256(v[d], v[a]));
+    v[c] = _mm256_add_epi32(v[c], v[d]);
+    v[b] = RotateRight32<7>(_mm256_xor_si256(v[b], v[c]));
+}
+
+inline void G64(__m256i v[16], const __m256i m[16], unsigned int r, unsigned int i,
+    unsigned int a, unsigned int b, unsigned int c, unsigned int d)
+{
+    v[a] = _mm256_add_epi64(_mm256_add_epi64(v[a], v[b]), m[SIGMA[r][2*i+0]]);
+    v[d] = RotateRight64_32(_mm256_xor_si256(v[d], v[a]));
+    v[c] = _mm256_add_epi64(v[c], v[d]);
+    v[b] = RotateRight64_24(_mm256_xor_si256(v[b], v[c]));
+    v[a] = _mm256_add_epi64(_mm256_add_epi64(v[a], v[b]), m[SIGMA[r][2*i+1]]);
+    v[d] = RotateRight64_16(_mm256_xor_si256(v[d], v[a]));
+    v[c] = _mm256_add_epi64(v[c], v[d]);
+    v[b] = RotateRight64_63(_mm256_xor_si256(v[b], v[c]));
+}
+
+// Load 32 bytes from each of 8 lanes and transpose so
+// M[i] holds little-endian word i of all 8 lanes.
+inline void LoadMessage32x8(__m256i M[8], const byte *input, size_t stride)
+{
+    __m256i r[8], t[8];
+    for (unsigned int i=0; i<8; i++)
+        r[i] = _mm256_loadu_si256(CONST_M256_CAST(input+i*stride));
+
+    for (unsigned int i=0; i<8; i+=2)
+    {
+        t[i+0] = _mm256_unpacklo_epi32(r[i], r[i+1]);
+        t[i+1] = _mm256_unpackhi_epi32(r[i], r[i+1]);
+    }
+    for (unsigned int i=0; i<8; i+=4)
+    {
+        r[i+0] = _mm256_unpacklo_epi64(t[i+0], t[i+2]);
+        r[i+1] = _mm256_unpackhi_epi64(t[i+0], t[i+2]);
+        r[i+2] = _mm256_unpacklo_epi64(t[i+1], t[i+3]);
+        r[i+3] = _mm256_unpackhi_epi64(t[i+1], t[i+3]);
+    }
+    for (unsigned int i=0; i<4; i++)
+    {
+        M[i+0] = _mm256_permute2x128_si256(r[i], r[i+4], 0x20);
+        M[i+4] = _mm256_permute2x128_si256(r[i], r[i+4], 0x31);
+    }
+}
+
+// Load 32 bytes from each of 4 lanes and transpose so
+// M[i] holds little-endian word i of all 4 lanes.
+inline void LoadMessage64x4(__m256i M[4], const byte *input, size_t stride)
+{
+    const __m256i r0 = _mm256_loadu_si256(CONST_M256_CAST(input+0*stride));
+    const __m256i r1 = _mm256_loadu_si256(CONST_M256_CAST(input+1*stride));
+    const __m256i r2 = _mm256_loadu_si256(CONST_M256_CAST(input+2*stride));
+    const __m256i r3 = _mm256_loadu_si256(CONST_M256_CAST(input+3*stride));
+
+    const __m256i t0 = _mm256_unpacklo_epi64(r0, r1);
+    const __m256i t1 = _mm256_unpackhi_epi64(r0, r1);
+    const __m256i t2 = _mm256_unpacklo_epi64(r2, r3);
+    const __m256i t3 = _mm256_unpackhi_epi64(r2, r3);
+
+    M[0] = _mm256_permute2x128_si256(t0, t2, 0x20);
+    M[1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+    M[2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+    M[3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+}
+
+ANONYMOUS_NAMESPACE_END
+
+void BLAKE2_Compress32x8_AVX2(const byte* input, size_t stripes, BLAKE2s_State* states)
+{
+    const unsigned int BLOCKSIZE = BLAKE2s_State::BLOCKSIZE;
+    CRYPTOPP_ALIGN_DATA(32) word32 temp[8][8];
+
+    // Transpose the chaining values so H[i] holds word i of all leaves
+    __m256i H[8];
+    for (unsigned int j=0; j<8; j++)
+    {
+        const word32* h = states[j].h();
+        for (unsigned int i=0; i<8; i++)
+            temp[i][j] = h[i];
+    }
+    for (unsigned int i=0; i<8; i++)
+        H[i] = _mm256_load_si256(CONST_M256_CAST(temp[i]));
+
+    word32 t0 = states[0].t()[0], t1 = states[0].t()[1];
+    CRYPTOPP_ASSERT(states[0].f()[0] == 0 && states[0].f()[1] == 0);
+
+    for ( ; stripes; --stripes, input += 8*BLOCKSIZE)
+    {
+        t0 += BLOCKSIZE;
+        t1 += !!(t0 < BLOCKSIZE);
+
+        __m256i m[16], v[16];
+        LoadMessage32x8(m+0, input+ 0, BLOCKSIZE);
+        LoadMessage32x8(m+8, input+32, BLOCKSIZE);
+
+        for (unsigned int i=0; i<8; i++)
+            v[i] = H[i];
+        for (unsigned int i=0; i<4; i++)
+            v[i+8] = _mm256_set1_epi32(static_cast<int>(BLAKE2S_IV[i]));
+        v[12] = _mm256_set1_epi32(static_cast<int>(BLAKE2S_IV[4] ^ t0));
+        v[13] = _mm256_set1_epi32(static_cast<int>(BLAKE2S_IV[5] ^ t1));
+        v[14] = _mm256_set1_epi32(static_cast<int>(BLAKE2S_IV[6]));
+        v[15] = _mm256_set1_epi32(static_cast<int>(BLAKE2S_IV[7]));
+
+        for (unsigned int r=0; r<10; r++)
+        {
+            G32(v, m, r, 0, 0, 4,  8, 12);
+            G32(v, m, r, 1, 1, 5,  9, 13);
+            G32(v, m, r, 2, 2, 6, 10, 14);
+            G32(v, m, r, 3, 3, 7, 11, 15);
+            G32(v, m, r, 4, 0, 5, 10, 15);
+            G32(v, m, r, 5, 1, 6, 11, 12);
+            G32(v, m, r, 6, 2, 7,  8, 13);
+            G32(v, m, r, 7, 3, 4,  9, 14);
+        }
+
+        for (unsigned int i=0; i<8; i++)
+            H[i] = _mm256_xor_si256(H[i], _mm256_xor_si256(v[i], v[i+8]));
+    }
+
+    for (unsigned int i=0; i<8; i++)
+        _mm256_store_si256(M256_CAST(temp[i]), H[i]);
+    for (unsigned int j=0; j<8; j++)
+    {
+        word32* h = states[j].h();
+        for (unsigned int i=0; i<8; i++)
+            h[i] = temp[i][j];
+        states[j].t()[0] = t0;
+        states[j].t()[1] = t1;
+    }
+
+    SecureWipeArray(&temp[0][0], 64);
+}
+
+void BLAKE2_Compress64x4_AVX2(const byte* input, size_t stripes, BLAKE2b_State* states)
+{
+    const unsigned int BLOCKSIZE = BLAKE2b_State::BLOCKSIZE;
+    CRYPTOPP_ALIGN_DATA(32) word64 temp[8][4];
+
+    // Transpose the chaining values so H[i] holds word i of all leaves
+    __m256i H[8];
+    for (unsigned int j=0; j<4; j++)
+    {
+        const word64* h = states[j].h();
+        for (unsigned int i=0; i<8; i++)
+            temp[i][j] = h[i];
+    }
+    for (unsigned int i=0; i<8; i++)
+        H[i] = _mm256_load_si256(CONST_M256_CAST(temp[i]));
+
+    word64 t0 = states[0].t()[0], t1 = states[0].t()[1];
+    CRYPTOPP_ASSERT(states[0].f()[0] == 0 && states[0].f()[1] == 0);
+
+    for ( ; stripes; --stripes, input += 4*BLOCKSIZE)
+    {
+        t0 += BLOCKSIZE;
+        t1 += !!(t0 < BLOCKSIZE);
+
+        __m256i m[16], v[16];
+        LoadMessage64x4(m+ 0, input+ 0, BLOCKSIZE);
+        LoadMessage64x4(m+ 4, input+32, BLOCKSIZE);
+        LoadMessage64x4(m+ 8, input+64, BLOCKSIZE);
+        LoadMessage64x4(m+12, input+96, BLOCKSIZE);
+
+        for (unsigned int i=0; i<8; i++)
+            v[i] = H[i];
+        for (unsigned int i=0; i<4; i++)
+            v[i+8] = _mm256_set1_epi64x(static_cast<long long>(BLAKE2B_IV[i]));
+        v[12] = _mm256_set1_epi64x(static_cast<long long>(BLAKE2B_IV[4] ^ t0));
+        v[13] = _mm256_set1_epi64x(static_cast<long long>(BLAKE2B_IV[5] ^ t1));
+        v[14] = _mm256_set1_epi64x(static_cast<long long>(BLAKE2B_IV[6]));
+        v[15] = _mm256_set1_epi64x(static_cast<long long>(BLAKE2B_IV[7]));
+
+        for (unsigned int r=0; r<12; r++)
+        {
+            G64(v, m, r, 0, 0, 4,  8, 12);
+            G64(v, m, r, 1, 1, 5,  9, 13);
+            G64(v, m, r, 2, 2, 6, 10, 14);
+            G64(v, m, r, 3, 3, 7, 11, 15);
+            G64(v, m, r, 4, 0, 5, 10, 15);
+            G64(v, m, r, 5, 1, 6, 11, 12);
+            G64(v, m, r, 6, 2, 7,  8, 13);
+            G64(v, m, r, 7, 3, 4,  9, 14);
+        }
+
+        for (unsigned int i=0; i<8; i++)
+            H[i] = _mm256_xor_si256(H[i], _mm256_xor_si256(v[i], v[i+8]));
+    }
+
+    for (unsigned int i=0; i<8; i++)
+        _mm256_store_si256(M256_CAST(temp[i]), H[i]);
+    for (unsigned int j=0; j<4; j++)
+    {
+        word64* h = states[j].h();
+        for (unsigned int i=0; i<8; i++)
+            h[i] = temp[i][j];
+        states[j].t()[0] = t0;
+        states[j].t()[1] = t1;
+    }
+
+    SecureWipeArray(&temp[0][0], 32);
+}
+
+#endif  // CRYPTOPP_AVX2_AVAILABLE
+
+NAMESPACE_END
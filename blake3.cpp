@@ -0,0 +1,517 @@
+// blake3.cpp - written and placed in the public domain by
+//              the Crypto++ project. Based on O'Connor, Aumasson,
+//              Neves and Wilcox-O'Hearn's reference BLAKE3
+//              implementation at http://github.com/BLAKE3-team/BLAKE3.
+
+#include "pch.h"
+#include "config.h"
+
+#include "cryptlib.h"
+#include "argnames.h"
+#include "algparam.h"
+#include "blake3.h"
+#include "parallel.h"
+#include "misc.h"
+#include "cpu.h"
+
+NAMESPACE_BEGIN(CryptoPP)
+
+// Implemented in blake2.cpp
+extern const word32 BLAKE2S_IV[8];
+
+#if CRYPTOPP_AVX2_AVAILABLE
+extern void BLAKE3_HashMany_AVX2(const byte *const inputs[8], size_t blocks, const word32 key[8],
+    word64 counter, bool incrementCounter, byte flags, byte flagsStart, byte flagsEnd, byte *out);
+#endif
+
+#if CRYPTOPP_AVX512_AVAILABLE
+extern void BLAKE3_HashMany_AVX512(const byte *const inputs[16], size_t blocks, const word32 key[8],
+    word64 counter, bool incrementCounter, byte flags, byte flagsStart, byte flagsEnd, byte *out);
+#endif
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+enum {CHUNK_START = 1, CHUNK_END = 2, PARENT = 4, ROOT = 8, KEYED_HASH = 16};
+
+// The message word permutation applied to each round
+const byte SCHEDULE[7][16] = {
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    {  2,  6,  3, 10,  7,  0,  4, 13,  1, 11, 12,  5,  9, 14, 15,  8 },
+    {  3,  4, 10, 12, 13,  2,  7, 14,  6,  5,  9,  0, 11, 15,  8,  1 },
+    { 10,  7, 12,  9, 14,  3, 13, 15,  4,  0, 11,  2,  5,  8,  1,  6 },
+    { 12, 13,  9, 11, 15, 10, 14,  8,  7,  2,  5,  3,  0,  1,  6,  4 },
+    {  9, 14, 11,  5,  8, 12, 15,  1, 13,  3,  0, 10,  2,  6,  4,  7 },
+    { 11, 15,  5,  0,  1,  9,  8,  6, 14, 10,  2, 12,  3,  4,  7, 13 }
+};
+
+inline void BLAKE3_G(word32 v[16], unsigned int a, unsigned int b, unsigned int c,
+    unsigned int d, word32 x, word32 y)
+{
+    v[a] = v[a] + v[b] + x;
+    v[d] = rotrConstant<16>(v[d] ^ v[a]);
+    v[c] = v[c] + v[d];
+    v[b] = rotrConstant<12>(v[b] ^ v[c]);
+    v[a] = v[a] + v[b] + y;
+    v[d] = rotrConstant<8>(v[d] ^ v[a]);
+    v[c] = v[c] + v[d];
+    v[b] = rotrConstant<7>(v[b] ^ v[c]);
+}
+
+// Runs the compression function and returns the full 16-word state
+void BLAKE3_Compress(word32 v[16], const word32 cv[8], const byte block[64],
+    size_t blockLen, word64 counter, byte flags)
+{
+    word32 m[16];
+    for (unsigned int i = 0; i < 16; ++i)
+        m[i] = GetWord<word32>(false, LITTLE_ENDIAN_ORDER, block+4*i);
+
+    for (unsigned int i = 0; i < 8; ++i)
+        v[i] = cv[i];
+    for (unsigned int i = 0; i < 4; ++i)
+        v[i+8] = BLAKE2S_IV[i];
+    v[12] = static_cast<word32>(counter);
+    v[13] = static_cast<word32>(counter >> 32);
+    v[14] = static_cast<word32>(blockLen);
+    v[15] = flags;
+
+    for (unsigned int r = 0; r < 7; ++r)
+    {
+        const byte* s = SCHEDULE[r];
+        BLAKE3_G(v, 0, 4,  8, 12, m[s[ 0]], m[s[ 1]]);
+        BLAKE3_G(v, 1, 5,  9, 13, m[s[ 2]], m[s[ 3]]);
+        BLAKE3_G(v, 2, 6, 10, 14, m[s[ 4]], m[s[ 5]]);
+        BLAKE3_G(v, 3, 7, 11, 15, m[s[ 6]], m[s[ 7]]);
+        BLAKE3_G(v, 0, 5, 10, 15, m[s[ 8]], m[s[ 9]]);
+        BLAKE3_G(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+        BLAKE3_G(v, 2, 7,  8, 13, m[s[12]], m[s[13]]);
+        BLAKE3_G(v, 3, 4,  9, 14, m[s[14]], m[s[15]]);
+    }
+}
+
+inline void BLAKE3_CompressInPlace(word32 cv[8], const byte block[64],
+    size_t blockLen, word64 counter, byte flags)
+{
+    word32 v[16];
+    BLAKE3_Compress(v, cv, block, blockLen, counter, flags);
+    for (unsigned int i = 0; i < 8; ++i)
+        cv[i] = v[i] ^ v[i+8];
+}
+
+inline void BLAKE3_PutChainingValue(byte *out, const word32 cv[8])
+{
+    for (unsigned int i = 0; i < 8; ++i)
+        PutWord(false, LITTLE_ENDIAN_ORDER, out+4*i, cv[i]);
+}
+
+// Hashes whole blocks of one input to a chaining value
+void BLAKE3_HashOne(const byte *input, size_t blocks, const word32 key[8], word64 counter,
+    byte flags, byte flagsStart, byte flagsEnd, byte *out)
+{
+    word32 cv[8];
+    std::memcpy(cv, key, sizeof(cv));
+
+    byte blockFlags = flags | flagsStart;
+    for ( ; blocks; --blocks, input += 64)
+    {
+        if (blocks == 1)
+            blockFlags |= flagsEnd;
+        BLAKE3_CompressInPlace(cv, input, 64, counter, blockFlags);
+        blockFlags = flags;
+    }
+
+    BLAKE3_PutChainingValue(out, cv);
+}
+
+// Hashes whole blocks of several inputs, with the same number of blocks
+// each, to consecutive chaining values. The counter is either the same
+// for all inputs, or it increments with each input. An output may
+// overwrite the inputs before it.
+void BLAKE3_HashMany(const byte *const *inputs, size_t count, size_t blocks, const word32 key[8],
+    word64 counter, bool incrementCounter, byte flags, byte flagsStart, byte flagsEnd, byte *out)
+{
+#if CRYPTOPP_AVX512_AVAILABLE
+    if (HasAVX512F() && HasAVX512BW() && HasAVX512VL())
+    {
+        for ( ; count >= 16; count -= 16, inputs += 16, out += 16*32)
+        {
+            BLAKE3_HashMany_AVX512(inputs, blocks, key, counter, incrementCounter,
+                flags, flagsStart, flagsEnd, out);
+            counter += incrementCounter ? 16 : 0;
+        }
+    }
+#endif
+#if CRYPTOPP_AVX2_AVAILABLE
+    if (HasAVX2())
+    {
+        for ( ; count >= 8; count -= 8, inputs += 8, out += 8*32)
+        {
+            BLAKE3_HashMany_AVX2(inputs, blocks, key, counter, incrementCounter,
+                flags, flagsStart, flagsEnd, out);
+            counter += incrementCounter ? 8 : 0;
+        }
+    }
+#endif
+
+    for ( ; count; --count, ++inputs, out += 32)
+    {
+        BLAKE3_HashOne(*inputs, blocks, key, counter, flags, flagsStart, flagsEnd, out);
+        counter += incrementCounter ? 1 : 0;
+    }
+}
+
+// The last compression of a chunk or parent. Depending on its place
+// in the tree, it yields a chaining value or the root output.
+struct BLAKE3_Output
+{
+    void ChainingValue(byte *out) const
+    {
+        word32 v[8];
+        std::memcpy(v, cv, sizeof(v));
+        BLAKE3_CompressInPlace(v, block, blockLen, counter, flags);
+        BLAKE3_PutChainingValue(out, v);
+    }
+
+    void RootBytes(byte *out, size_t size) const
+    {
+        word32 v[16];
+        for (word64 outputCounter = 0; size; ++outputCounter)
+        {
+            BLAKE3_Compress(v, cv, block, blockLen, outputCounter, flags | ROOT);
+            for (unsigned int i = 0; i < 8; ++i)
+            {
+                v[i] ^= v[i+8];
+                v[i+8] ^= cv[i];
+            }
+
+            byte temp[64];
+            for (unsigned int i = 0; i < 16; ++i)
+                PutWord(false, LITTLE_ENDIAN_ORDER, temp+4*i, v[i]);
+
+            const size_t n = STDMIN(size, size_t(64));
+            std::memcpy(out, temp, n);
+            out += n, size -= n;
+        }
+    }
+
+    word32 cv[8];
+    byte block[64];
+    word64 counter;
+    size_t blockLen;
+    byte flags;
+};
+
+inline unsigned int BLAKE3_PopCount(word64 x)
+{
+    unsigned int count = 0;
+    for ( ; x; x &= x - 1)
+        ++count;
+    return count;
+}
+
+ANONYMOUS_NAMESPACE_END
+
+BLAKE3::BLAKE3(unsigned int digestSize)
+    : m_chunkCounter(0), m_len(0), m_blocks(0), m_stackLen(0)
+    , m_digestSize(digestSize), m_threads(1), m_flags(0)
+{
+    UncheckedSetKey(NULLPTR, 0, MakeParameters
+        (Name::DigestSize(), (int)digestSize));
+}
+
+BLAKE3::BLAKE3(const byte *key, size_t keyLength, unsigned int digestSize)
+    : m_chunkCounter(0), m_len(0), m_blocks(0), m_stackLen(0)
+    , m_digestSize(digestSize), m_threads(1), m_flags(0)
+{
+    CRYPTOPP_ASSERT(keyLength == 0 || keyLength == MAX_KEYLENGTH);
+
+    UncheckedSetKey(key, static_cast<unsigned int>(keyLength), MakeParameters
+        (Name::DigestSize(), (int)digestSize));
+}
+
+unsigned int BLAKE3::OptimalDataAlignment() const
+{
+    return GetAlignmentOf<word32>();
+}
+
+std::string BLAKE3::AlgorithmProvider() const
+{
+#if CRYPTOPP_AVX512_AVAILABLE
+    if (HasAVX512F() && HasAVX512BW() && HasAVX512VL())
+        return "AVX512";
+#endif
+#if CRYPTOPP_AVX2_AVAILABLE
+    if (HasAVX2())
+        return "AVX2";
+#endif
+    return "C++";
+}
+
+void BLAKE3::SetThreads(unsigned int threads)
+{
+    m_threads = threads ? threads : DefaultThreadCount();
+}
+
+void BLAKE3::UncheckedSetKey(const byte *key, unsigned int length, const CryptoPP::NameValuePairs& params)
+{
+    if (key && length)
+    {
+        CRYPTOPP_ASSERT(length == MAX_KEYLENGTH);
+        for (unsigned int i = 0; i < 8; ++i)
+            m_key[i] = GetWord<word32>(false, LITTLE_ENDIAN_ORDER, key+4*i);
+        m_flags = KEYED_HASH;
+    }
+    else
+    {
+        std::memcpy(m_key, BLAKE2S_IV, m_key.SizeInBytes());
+        m_flags = 0;
+    }
+
+    m_digestSize = static_cast<unsigned int>(params.GetIntValueWithDefault(
+                       Name::DigestSize(), static_cast<int>(m_digestSize)));
+
+    Restart();
+}
+
+void BLAKE3::Restart()
+{
+    std::memcpy(m_cv, m_key, m_cv.SizeInBytes());
+    m_chunkCounter = 0;
+    m_len = m_blocks = 0;
+    m_stackLen = 0;
+}
+
+void BLAKE3::UpdateChunk(const byte *input, size_t length)
+{
+    CRYPTOPP_ASSERT(ChunkLength() + length <= CHUNKSIZE);
+
+    while (length)
+    {
+        // The last block of a chunk is held back for the CHUNK_END flag
+        if (m_len == BLOCKSIZE)
+        {
+            BLAKE3_CompressInPlace(m_cv, m_buf, BLOCKSIZE, m_chunkCounter,
+                m_flags | (m_blocks == 0 ? CHUNK_START : 0));
+            m_blocks++, m_len = 0;
+        }
+
+        // Compress in-place to avoid copies
+        while (m_len == 0 && length > BLOCKSIZE)
+        {
+            BLAKE3_CompressInPlace(m_cv, input, BLOCKSIZE, m_chunkCounter,
+                m_flags | (m_blocks == 0 ? CHUNK_START : 0));
+            m_blocks++;
+            input += BLOCKSIZE, length -= BLOCKSIZE;
+        }
+
+        const size_t take = STDMIN(size_t(BLOCKSIZE) - m_len, length);
+        std::memcpy(m_buf+m_len, input, take);
+        m_len += take;
+        input += take, length -= take;
+    }
+}
+
+void BLAKE3::PushChainingValue(const byte cv[32], word64 chunkCounter)
+{
+    MergeChainingValues(chunkCounter);
+    CRYPTOPP_ASSERT(m_stackLen < m_stack.size()/32);
+    std::memcpy(m_stack+32*m_stackLen, cv, 32);
+    m_stackLen++;
+}
+
+void BLAKE3::MergeChainingValues(word64 totalChunks)
+{
+    // A completed subtree of 2^k chunks is one entry on the stack, so
+    // the stack holds one entry for every bit set in the chunk count
+    const size_t entries = BLAKE3_PopCount(totalChunks);
+    while (m_stackLen > entries)
+    {
+        byte* parent = m_stack+32*(m_stackLen-2);
+        BLAKE3_HashOne(parent, 1, m_key, 0, m_flags | PARENT, 0, 0, parent);
+        m_stackLen--;
+    }
+}
+
+void BLAKE3::HashSubtree(const byte *input, size_t chunks, word64 chunkCounter, byte *cvPair) const
+{
+    CRYPTOPP_ASSERT(chunks >= 2 && chunks <= SUBTREE_CHUNKS);
+    CRYPTOPP_ASSERT((chunks & (chunks-1)) == 0);
+
+    const byte* inputs[SUBTREE_CHUNKS];
+    SecByteBlock cvs(chunks*32);
+
+    for (size_t i = 0; i < chunks; ++i)
+        inputs[i] = input+i*CHUNKSIZE;
+    BLAKE3_HashMany(inputs, chunks, CHUNKSIZE/BLOCKSIZE, m_key, chunkCounter, true,
+        m_flags, CHUNK_START, CHUNK_END, cvs);
+
+    // Each level of parents overwrites the level below it
+    for ( ; chunks > 2; chunks /= 2)
+    {
+        for (size_t i = 0; i < chunks/2; ++i)
+            inputs[i] = cvs+i*64;
+        BLAKE3_HashMany(inputs, chunks/2, 1, m_key, 0, false,
+            m_flags | PARENT, 0, 0, cvs);
+    }
+
+    std::memcpy(cvPair, cvs, 64);
+}
+
+class BLAKE3::SubtreeTask : public ParallelTask
+{
+public:
+    SubtreeTask(const BLAKE3 &hash, const byte *input, byte *cvPairs)
+        : m_hash(hash), m_input(input), m_cvPairs(cvPairs) {}
+
+    void Run(size_t index)
+    {
+        const size_t SUBTREESIZE = SUBTREE_CHUNKS*CHUNKSIZE;
+        m_hash.HashSubtree(m_input+index*SUBTREESIZE, SUBTREE_CHUNKS,
+            m_hash.m_chunkCounter+index*SUBTREE_CHUNKS, m_cvPairs+index*64);
+    }
+
+private:
+    const BLAKE3 &m_hash;
+    const byte *m_input;
+    byte *m_cvPairs;
+};
+
+void BLAKE3::HashSubtrees(const byte *input, size_t count, byte *cvPairs) const
+{
+    SubtreeTask task(*this, input, cvPairs);
+    RunParallelTasks(task, count);
+}
+
+void BLAKE3::Update(const byte *input, size_t length)
+{
+    CRYPTOPP_ASSERT(input != NULLPTR || length == 0);
+
+    // Complete the current chunk
+    if (ChunkLength() > 0)
+    {
+        const size_t take = STDMIN(size_t(CHUNKSIZE) - ChunkLength(), length);
+        UpdateChunk(input, take);
+        input += take, length -= take;
+
+        if (length == 0)
+            return;
+
+        // More input follows, so this is not the root
+        BLAKE3_Output output;
+        std::memcpy(output.cv, m_cv, sizeof(output.cv));
+        std::memcpy(output.block, m_buf, BLOCKSIZE);
+        output.counter = m_chunkCounter;
+        output.blockLen = m_len;
+        output.flags = m_flags | (m_blocks == 0 ? CHUNK_START : 0) | CHUNK_END;
+
+        byte cv[32];
+        output.ChainingValue(cv);
+        PushChainingValue(cv, m_chunkCounter);
+
+        std::memcpy(m_cv, m_key, m_cv.SizeInBytes());
+        m_chunkCounter++;
+        m_len = m_blocks = 0;
+    }
+
+    // Hash the largest whole subtrees that fit. A subtree must start
+    // at a multiple of its size. The last chunk is kept for TruncatedFinal.
+    const size_t SUBTREESIZE = SUBTREE_CHUNKS*CHUNKSIZE;
+    while (length > CHUNKSIZE)
+    {
+        const size_t batch = STDMIN(size_t(m_threads), length/SUBTREESIZE);
+        if (batch > 1 && m_chunkCounter % SUBTREE_CHUNKS == 0)
+        {
+            SecByteBlock cvPairs(batch*64);
+            HashSubtrees(input, batch, cvPairs);
+
+            for (size_t i = 0; i < batch; ++i)
+            {
+                PushChainingValue(cvPairs+i*64, m_chunkCounter);
+                PushChainingValue(cvPairs+i*64+32, m_chunkCounter + SUBTREE_CHUNKS/2);
+                m_chunkCounter += SUBTREE_CHUNKS;
+            }
+
+            input += batch*SUBTREESIZE, length -= batch*SUBTREESIZE;
+            continue;
+        }
+
+        size_t chunks = STDMIN(size_t(SUBTREE_CHUNKS), length/CHUNKSIZE);
+        while (chunks & (chunks-1))
+            chunks &= chunks-1;
+        while (m_chunkCounter & (chunks-1))
+            chunks /= 2;
+
+        if (chunks == 1)
+        {
+            byte cv[32];
+            BLAKE3_HashOne(input, CHUNKSIZE/BLOCKSIZE, m_key, m_chunkCounter,
+                m_flags, CHUNK_START, CHUNK_END, cv);
+            PushChainingValue(cv, m_chunkCounter);
+        }
+        else
+        {
+            byte cvPair[64];
+            HashSubtree(input, chunks, m_chunkCounter, cvPair);
+            PushChainingValue(cvPair, m_chunkCounter);
+            PushChainingValue(cvPair+32, m_chunkCounter + chunks/2);
+        }
+
+        m_chunkCounter += chunks;
+        input += chunks*CHUNKSIZE, length -= chunks*CHUNKSIZE;
+    }
+
+    if (length)
+    {
+        UpdateChunk(input, length);
+        MergeChainingValues(m_chunkCounter);
+    }
+}
+
+void BLAKE3::TruncatedFinal(byte *hash, size_t size)
+{
+    CRYPTOPP_ASSERT(hash != NULLPTR);
+    this->ThrowIfInvalidTruncatedSize(size);
+
+    BLAKE3_Output output;
+    size_t remaining = m_stackLen;
+    if (m_stackLen == 0 || ChunkLength() > 0)
+    {
+        std::memcpy(output.cv, m_cv, sizeof(output.cv));
+        std::memcpy(output.block, m_buf, m_len);
+        std::memset(output.block+m_len, 0x00, BLOCKSIZE-m_len);
+        output.counter = m_chunkCounter;
+        output.blockLen = m_len;
+        output.flags = m_flags | (m_blocks == 0 ? CHUNK_START : 0) | CHUNK_END;
+    }
+    else
+    {
+        // The input ended with a subtree, whose children are
+        // the top two entries of the stack
+        CRYPTOPP_ASSERT(m_stackLen >= 2);
+        remaining = m_stackLen-2;
+        std::memcpy(output.cv, m_key, sizeof(output.cv));
+        std::memcpy(output.block, m_stack+32*remaining, 64);
+        output.counter = 0;
+        output.blockLen = 64;
+        output.flags = m_flags | PARENT;
+    }
+
+    // Fold the stack into the right edge of the tree
+    while (remaining--)
+    {
+        byte cv[32];
+        output.ChainingValue(cv);
+
+        std::memcpy(output.cv, m_key, sizeof(output.cv));
+        std::memcpy(output.block, m_stack+32*remaining, 32);
+        std::memcpy(output.block+32, cv, 32);
+        output.counter = 0;
+        output.blockLen = 64;
+        output.flags = m_flags | PARENT;
+    }
+
+    output.RootBytes(hash, size);
+
+    Restart();
+}
+
+NAMESPACE_END
@@ -0,0 +1,148 @@
+// blake3.h - written and placed in the public domain by
+//            the Crypto++ project. Based on O'Connor, Aumasson,
+//            Neves and Wilcox-O'Hearn's reference BLAKE3
+//            implementation at http://github.com/BLAKE3-team/BLAKE3.
+
+/// \file blake3.h
+/// \brief Classes for the BLAKE3 message digest and keyed message digest
+/// \details BLAKE3 compresses 1024-byte chunks of the message with a reduced round
+///   BLAKE2s compression function, and combines the chunk chaining values in a
+///   binary tree. The chunks are independent, so the implementation hashes several
+///   chunks at once with SIMD, and it can hash subtrees on several threads.
+/// \details This implementation provides the hash and keyed hash modes. The key
+///   derivation mode is not provided.
+/// \sa O'Connor, Aumasson, Neves and Wilcox-O'Hearn's
+///   <A HREF="https://github.com/BLAKE3-team/BLAKE3-specs/blob/master/blake3.pdf">BLAKE3:
+///   one function, fast everywhere</A> (2020.01.09)
+/// \since Crypto++ 8.3
+
+#ifndef CRYPTOPP_BLAKE3_H
+#define CRYPTOPP_BLAKE3_H
+
+#include "cryptlib.h"
+#include "secblock.h"
+#include "seckey.h"
+
+NAMESPACE_BEGIN(CryptoPP)
+
+/// \brief BLAKE3 hash information
+/// \details BLAKE3 takes either no key, or a 32-byte key for the keyed hash mode.
+/// \since Crypto++ 8.3
+struct BLAKE3_Info : public VariableKeyLength<32,0,32,32,SimpleKeyingInterface::NOT_RESYNCHRONIZABLE>
+{
+    typedef VariableKeyLength<32,0,32,32,SimpleKeyingInterface::NOT_RESYNCHRONIZABLE> KeyBase;
+    CRYPTOPP_CONSTANT(MIN_KEYLENGTH = KeyBase::MIN_KEYLENGTH);
+    CRYPTOPP_CONSTANT(MAX_KEYLENGTH = KeyBase::MAX_KEYLENGTH);
+    CRYPTOPP_CONSTANT(DEFAULT_KEYLENGTH = KeyBase::DEFAULT_KEYLENGTH);
+
+    CRYPTOPP_CONSTANT(BLOCKSIZE = 64);
+    CRYPTOPP_CONSTANT(CHUNKSIZE = 1024);
+    CRYPTOPP_CONSTANT(DIGESTSIZE = 32);
+
+    CRYPTOPP_STATIC_CONSTEXPR const char* StaticAlgorithmName() {return "BLAKE3";}
+};
+
+/// \brief The BLAKE3 cryptographic hash function
+/// \details BLAKE3 can function as both a hash and keyed hash. If you want only the hash,
+///   then use the BLAKE3 constructor that accepts no parameters or digest size. If you
+///   want a keyed hash, then use the constructor that accepts the key as a parameter.
+/// \details The output of BLAKE3 is extendable, so any digest size can be selected. A
+///   shorter digest is a prefix of a longer one.
+/// \details On x86 and x64 the AVX2 code hashes 8 chunks at once, and the AVX-512 code
+///   hashes 16 chunks at once. Large messages can also be hashed on several threads with
+///   SetThreads(). The subtrees are hashed with RunParallelTasks().
+/// \sa O'Connor, Aumasson, Neves and Wilcox-O'Hearn's
+///   <A HREF="https://github.com/BLAKE3-team/BLAKE3-specs/blob/master/blake3.pdf">BLAKE3:
+///   one function, fast everywhere</A> (2020.01.09)
+/// \since Crypto++ 8.3
+class BLAKE3 : public SimpleKeyingInterfaceImpl<MessageAuthenticationCode, BLAKE3_Info>
+{
+public:
+    CRYPTOPP_CONSTANT(DEFAULT_KEYLENGTH = BLAKE3_Info::DEFAULT_KEYLENGTH);
+    CRYPTOPP_CONSTANT(MIN_KEYLENGTH = BLAKE3_Info::MIN_KEYLENGTH);
+    CRYPTOPP_CONSTANT(MAX_KEYLENGTH = BLAKE3_Info::MAX_KEYLENGTH);
+
+    CRYPTOPP_CONSTANT(DIGESTSIZE = BLAKE3_Info::DIGESTSIZE);
+    CRYPTOPP_CONSTANT(BLOCKSIZE = BLAKE3_Info::BLOCKSIZE);
+    CRYPTOPP_CONSTANT(CHUNKSIZE = BLAKE3_Info::CHUNKSIZE);
+
+    /// \brief Chunks in the largest subtree hashed as a unit
+    /// \details Update() hashes whole subtrees of up to this many chunks at once, and
+    ///   the subtrees are the units of work for the threads.
+    CRYPTOPP_CONSTANT(SUBTREE_CHUNKS = 512);
+
+    CRYPTOPP_STATIC_CONSTEXPR const char* StaticAlgorithmName() {return "BLAKE3";}
+
+    virtual ~BLAKE3() {}
+
+    /// \brief Construct a BLAKE3 hash
+    /// \param digestSize the digest size, in bytes
+    /// \since Crypto++ 8.3
+    BLAKE3(unsigned int digestSize = DIGESTSIZE);
+
+    /// \brief Construct a BLAKE3 keyed hash
+    /// \param key a byte array used to key the hash
+    /// \param keyLength the size of the byte array, either 0 or 32
+    /// \param digestSize the digest size, in bytes
+    /// \since Crypto++ 8.3
+    BLAKE3(const byte *key, size_t keyLength, unsigned int digestSize = DIGESTSIZE);
+
+    /// \brief Retrieve the object's name
+    /// \returns the object's algorithm name, like "BLAKE3-256"
+    std::string AlgorithmName() const {return std::string(BLAKE3_Info::StaticAlgorithmName()) + "-" + IntToString(DigestSize()*8);}
+
+    unsigned int BlockSize() const {return BLOCKSIZE;}
+    unsigned int DigestSize() const {return m_digestSize;}
+    unsigned int OptimalDataAlignment() const;
+
+    void Update(const byte *input, size_t length);
+    void Restart();
+    void TruncatedFinal(byte *hash, size_t size);
+
+    std::string AlgorithmProvider() const;
+
+    /// \brief Set the number of threads
+    /// \param threads the number of subtrees hashed concurrently
+    /// \details 0 threads means one thread per processor. The default is 1 thread.
+    ///   Only messages of several SUBTREE_CHUNKS chunks benefit from more threads.
+    void SetThreads(unsigned int threads);
+
+    /// \brief Retrieves the number of threads
+    /// \returns the number of subtrees hashed concurrently
+    unsigned int GetThreads() const {return m_threads;}
+
+protected:
+    void UncheckedSetKey(const byte* key, unsigned int length, const CryptoPP::NameValuePairs& params);
+
+    // Adds the chaining value of a chunk or subtree to the stack
+    void PushChainingValue(const byte cv[32], word64 chunkCounter);
+    // Combines the completed subtrees on the stack
+    void MergeChainingValues(word64 totalChunks);
+
+    // Absorbs input into the current chunk
+    void UpdateChunk(const byte *input, size_t length);
+    size_t ChunkLength() const {return m_blocks*BLOCKSIZE + m_len;}
+
+    // Hashes a subtree of chunks down to the chaining values of its two children
+    void HashSubtree(const byte *input, size_t chunks, word64 chunkCounter, byte *cvPair) const;
+    // Hashes consecutive subtrees of SUBTREE_CHUNKS chunks on several threads
+    void HashSubtrees(const byte *input, size_t count, byte *cvPairs) const;
+
+    class SubtreeTask;
+
+private:
+    // Chaining values are kept as little-endian bytes so
+    // two adjacent values on the stack form a parent block
+    FixedSizeSecBlock<word32, 8> m_key;
+    FixedSizeSecBlock<word32, 8> m_cv;
+    FixedSizeSecBlock<byte, 54*32> m_stack;
+    FixedSizeAlignedSecBlock<byte, BLOCKSIZE, true> m_buf;
+    word64 m_chunkCounter;
+    size_t m_len, m_blocks, m_stackLen;
+    word32 m_digestSize, m_threads;
+    byte m_flags;
+};
+
+NAMESPACE_END
+
+#endif
@@ -0,0 +1,181 @@
+// blake3_avx.cpp - written and placed in the public domain by
+//                  the Crypto++ project.
+//
+//    This source file uses intrinsics and built-ins to gain access to
+//    AVX2 instructions. A separate source file is needed because
+//    additional CXXFLAGS are required to enable the appropriate
+//    instructions sets in some build configurations.
+//
+//    The code hashes 8 BLAKE3 inputs at a time, one input per 32-bit
+//    lane of a YMM register. The inputs are whole chunks or parent
+//    blocks of the same length. The caller in blake3.cpp builds the
+//    tree and hashes partial chunks.
+
+#include "pch.h"
+#include "config.h"
+#include "misc.h"
+
+#if (CRYPTOPP_AVX2_AVAILABLE)
+# include <emmintrin.h>
+# include <immintrin.h>
+#endif
+
+// Squash MS LNK4221 and libtool warnings
+extern const char BLAKE3_AVX_FNAME[] = __FILE__;
+
+// Clang intrinsic casts, http://bugs.llvm.org/show_bug.cgi?id=20670
+#define M256_CAST(x) ((__m256i *)(void *)(x))
+#define CONST_M256_CAST(x) ((const __m256i *)(const void *)(x))
+
+NAMESPACE_BEGIN(CryptoPP)
+
+#if (CRYPTOPP_AVX2_AVAILABLE)
+
+extern const word32 BLAKE2S_IV[8];
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+const byte SCHEDULE[7][16] = {
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    {  2,  6,  3, 10,  7,  0,  4, 13,  1, 11, 12,  5,  9, 14, 15,  8 },
+    {  3,  4, 10, 12, 13,  2,  7, 14,  6,  5,  9,  0, 11, 15,  8,  1 },
+    { 10,  7, 12,  9, 14,  3, 13, 15,  4,  0, 11,  2,  5,  8,  1,  6 },
+    { 12, 13,  9, 11, 15, 10, 14,  8,  7,  2,  5,  3,  0,  1,  6,  4 },
+    {  9, 14, 11,  5,  8, 12, 15,  1, 13,  3,  0, 10,  2,  6,  4,  7 },
+    { 11, 15,  5,  0,  1,  9,  8,  6, 14, 10,  2, 12,  3,  4,  7, 13 }
+};
+
+// Rotations by a multiple of 8 are byte shuffles
+inline __m256i RotateRight32_16(const __m256i val)
+{
+    const __m256i mask = _mm256_set_epi8(
+        13,12,15,14, 9,8,11,10, 5,4,7,6, 1,0,3,2,
+        13,12,15,14, 9,8,11,10, 5,4,7,6, 1,0,3,2);
+    return _mm256_shuffle_epi8(val, mask);
+}
+
+inline __m256i RotateRight32_8(const __m256i val)
+{
+    const __m256i mask = _mm256_set_epi8(
+        12,15,14,13, 8,11,10,9, 4,7,6,5, 0,3,2,1,
+        12,15,14,13, 8,11,10,9, 4,7,6,5, 0,3,2,1);
+    return _mm256_shuffle_epi8(val, mask);
+}
+
+template <unsigned int R>
+inline __m256i RotateRight32(const __m256i val)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(val, R), _mm256_slli_epi32(val, 32-R));
+}
+
+inline void G(__m256i v[16], unsigned int a, unsigned int b, unsigned int c,
+    unsigned int d, const __m256i x, const __m256i y)
+{
+    v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), x);
+    v[d] = RotateRight32_16(_mm256_xor_si256(v[d], v[a]));
+    v[c] = _mm256_add_epi32(v[c], v[d]);
+    v[b] = RotateRight32<12>(_mm256_xor_si256(v[b], v[c]));
+    v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), y);
+    v[d] = RotateRight32_8(_mm256_xor_si256(v[d], v[a]));
+    v[c] = _mm256_add_epi32(v[c], v[d]);
+    v[b] = RotateRight32<7>(_mm256_xor_si256(v[b], v[c]));
+}
+
+// Load 32 bytes at offset from each of 8 lanes and transpose
+// so M[i] holds little-endian word i of all 8 lanes.
+inline void LoadMessage8(__m256i M[8], const byte *const inputs[8], size_t offset)
+{
+    __m256i r[8], t[8];
+    for (unsigned int i=0; i<8; i++)
+        r[i] = _mm256_loadu_si256(CONST_M256_CAST(inputs[i]+offset));
+
+    for (unsigned int i=0; i<8; i+=2)
+    {
+        t[i+0] = _mm256_unpacklo_epi32(r[i], r[i+1]);
+        t[i+1] = _mm256_unpackhi_epi32(r[i], r[i+1]);
+    }
+    for (unsigned int i=0; i<8; i+=4)
+    {
+        r[i+0] = _mm256_unpacklo_epi64(t[i+0], t[i+2]);
+        r[i+1] = _mm256_unpackhi_epi64(t[i+0], t[i+2]);
+        r[i+2] = _mm256_unpacklo_epi64(t[i+1], t[i+3]);
+        r[i+3] = _mm256_unpackhi_epi64(t[i+1], t[i+3]);
+    }
+    for (unsigned int i=0; i<4; i++)
+    {
+        M[i+0] = _mm256_permute2x128_si256(r[i], r[i+4], 0x20);
+        M[i+4] = _mm256_permute2x128_si256(r[i], r[i+4], 0x31);
+    }
+}
+
+ANONYMOUS_NAMESPACE_END
+
+void BLAKE3_HashMany_AVX2(const byte *const inputs[8], size_t blocks, const word32 key[8],
+    word64 counter, bool incrementCounter, byte flags, byte flagsStart, byte flagsEnd, byte *out)
+{
+    CRYPTOPP_ALIGN_DATA(32) word32 temp[8][8];
+
+    for (unsigned int j=0; j<8; j++)
+    {
+        const word64 c = counter + (incrementCounter ? j : 0);
+        temp[0][j] = static_cast<word32>(c);
+        temp[1][j] = static_cast<word32>(c >> 32);
+    }
+    const __m256i counterLow = _mm256_load_si256(CONST_M256_CAST(temp[0]));
+    const __m256i counterHigh = _mm256_load_si256(CONST_M256_CAST(temp[1]));
+
+    __m256i H[8];
+    for (unsigned int i=0; i<8; i++)
+        H[i] = _mm256_set1_epi32(static_cast<int>(key[i]));
+
+    for (size_t b=0; b<blocks; b++)
+    {
+        byte blockFlags = flags;
+        if (b == 0)
+            blockFlags |= flagsStart;
+        if (b+1 == blocks)
+            blockFlags |= flagsEnd;
+
+        __m256i m[16], v[16];
+        LoadMessage8(m+0, inputs, 64*b+ 0);
+        LoadMessage8(m+8, inputs, 64*b+32);
+
+        for (unsigned int i=0; i<8; i++)
+            v[i] = H[i];
+        for (unsigned int i=0; i<4; i++)
+            v[i+8] = _mm256_set1_epi32(static_cast<int>(BLAKE2S_IV[i]));
+        v[12] = counterLow;
+        v[13] = counterHigh;
+        v[14] = _mm256_set1_epi32(64);
+        v[15] = _mm256_set1_epi32(blockFlags);
+
+        for (unsigned int r=0; r<7; r++)
+        {
+            const byte* s = SCHEDULE[r];
+            G(v, 0, 4,  8, 12, m[s[ 0]], m[s[ 1]]);
+            G(v, 1, 5,  9, 13, m[s[ 2]], m[s[ 3]]);
+            G(v, 2, 6, 10, 14, m[s[ 4]], m[s[ 5]]);
+            G(v, 3, 7, 11, 15, m[s[ 6]], m[s[ 7]]);
+            G(v, 0, 5, 10, 15, m[s[ 8]], m[s[ 9]]);
+            G(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+            G(v, 2, 7,  8, 13, m[s[12]], m[s[13]]);
+            G(v, 3, 4,  9, 14, m[s[14]], m[s[15]]);
+        }
+
+        for (unsigned int i=0; i<8; i++)
+            H[i] = _mm256_xor_si256(v[i], v[i+8]);
+    }
+
+    // Transpose the chaining values so lane j is written to out+32*j
+    for (unsigned int i=0; i<8; i++)
+        _mm256_store_si256(M256_CAST(temp[i]), H[i]);
+    for (unsigned int j=0; j<8; j++)
+    {
+        for (unsigned int i=0; i<8; i++)
+            PutWord(false, LITTLE_ENDIAN_ORDER, out+32*j+4*i, temp[i][j]);
+    }
+}
+
+#endif  // CRYPTOPP_AVX2_AVAILABLE
+
+NAMESPACE_END
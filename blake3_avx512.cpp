@@ -0,0 +1,173 @@
+// blake3_avx512.cpp - written and placed in the public domain by
+//                     the Crypto++ project.
+//
+//    This source file uses intrinsics and built-ins to gain access to
+//    AVX-512 instructions. A separate source file is needed because
+//    additional CXXFLAGS are required to enable the appropriate
+//    instructions sets in some build configurations.
+//
+//    The code hashes 16 BLAKE3 inputs at a time, one input per 32-bit
+//    lane of a ZMM register. AVX-512 provides rotates, so the rounds
+//    need no shuffles. The caller in blake3.cpp builds the tree and
+//    hashes partial chunks.
+
+#include "pch.h"
+#include "config.h"
+#include "misc.h"
+
+#if (CRYPTOPP_AVX512_AVAILABLE)
+# include <emmintrin.h>
+# include <immintrin.h>
+#endif
+
+// Squash MS LNK4221 and libtool warnings
+extern const char BLAKE3_AVX512_FNAME[] = __FILE__;
+
+// GCC 12 warns the __Y operand in avx512fintrin.h is used
+// uninitialized. It is the self-initialized placeholder of the
+// _mm512_undefined intrinsics and not a variable in this file.
+#if CRYPTOPP_GCC_DIAGNOSTIC_AVAILABLE
+# pragma GCC diagnostic ignored "-Wuninitialized"
+# if (CRYPTOPP_GCC_VERSION >= 40700)
+#  pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+# endif
+#endif
+
+NAMESPACE_BEGIN(CryptoPP)
+
+#if (CRYPTOPP_AVX512_AVAILABLE)
+
+extern const word32 BLAKE2S_IV[8];
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+const byte SCHEDULE[7][16] = {
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    {  2,  6,  3, 10,  7,  0,  4, 13,  1, 11, 12,  5,  9, 14, 15,  8 },
+    {  3,  4, 10, 12, 13,  2,  7, 14,  6,  5,  9,  0, 11, 15,  8,  1 },
+    { 10,  7, 12,  9, 14,  3, 13, 15,  4,  0, 11,  2,  5,  8,  1,  6 },
+    { 12, 13,  9, 11, 15, 10, 14,  8,  7,  2,  5,  3,  0,  1,  6,  4 },
+    {  9, 14, 11,  5,  8, 12, 15,  1, 13,  3,  0, 10,  2,  6,  4,  7 },
+    { 11, 15,  5,  0,  1,  9,  8,  6, 14, 10,  2, 12,  3,  4,  7, 13 }
+};
+
+inline void G(__m512i v[16], unsigned int a, unsigned int b, unsigned int c,
+    unsigned int d, const __m512i x, const __m512i y)
+{
+    v[a] = _mm512_add_epi32(_mm512_add_epi32(v[a], v[b]), x);
+    v[d] = _mm512_ror_epi32(_mm512_xor_si512(v[d], v[a]), 16);
+    v[c] = _mm512_add_epi32(v[c], v[d]);
+    v[b] = _mm512_ror_epi32(_mm512_xor_si512(v[b], v[c]), 12);
+    v[a] = _mm512_add_epi32(_mm512_add_epi32(v[a], v[b]), y);
+    v[d] = _mm512_ror_epi32(_mm512_xor_si512(v[d], v[a]), 8);
+    v[c] = _mm512_add_epi32(v[c], v[d]);
+    v[b] = _mm512_ror_epi32(_mm512_xor_si512(v[b], v[c]), 7);
+}
+
+// Load 64 bytes at offset from each lane and transpose so
+// M[i] holds little-endian word i of all 16 lanes.
+inline void LoadMessage16(__m512i M[16], const byte *const inputs[16], size_t offset)
+{
+    __m512i r[16], t[16];
+    for (unsigned int i=0; i<16; i++)
+        r[i] = _mm512_loadu_si512(inputs[i]+offset);
+
+    for (unsigned int i=0; i<16; i+=2)
+    {
+        t[i+0] = _mm512_unpacklo_epi32(r[i], r[i+1]);
+        t[i+1] = _mm512_unpackhi_epi32(r[i], r[i+1]);
+    }
+    for (unsigned int i=0; i<16; i+=4)
+    {
+        r[i+0] = _mm512_unpacklo_epi64(t[i+0], t[i+2]);
+        r[i+1] = _mm512_unpackhi_epi64(t[i+0], t[i+2]);
+        r[i+2] = _mm512_unpacklo_epi64(t[i+1], t[i+3]);
+        r[i+3] = _mm512_unpackhi_epi64(t[i+1], t[i+3]);
+    }
+
+    // Lane k of r[4*i+j] holds word 4*k+j of inputs 4*i..4*i+3.
+    // Transpose the 128-bit lanes to finish.
+    for (unsigned int j=0; j<4; j++)
+    {
+        const __m512i v0 = _mm512_shuffle_i32x4(r[j+0], r[j+4], 0x44);
+        const __m512i v1 = _mm512_shuffle_i32x4(r[j+0], r[j+4], 0xEE);
+        const __m512i v2 = _mm512_shuffle_i32x4(r[j+8], r[j+12], 0x44);
+        const __m512i v3 = _mm512_shuffle_i32x4(r[j+8], r[j+12], 0xEE);
+
+        M[j+ 0] = _mm512_shuffle_i32x4(v0, v2, 0x88);
+        M[j+ 4] = _mm512_shuffle_i32x4(v0, v2, 0xDD);
+        M[j+ 8] = _mm512_shuffle_i32x4(v1, v3, 0x88);
+        M[j+12] = _mm512_shuffle_i32x4(v1, v3, 0xDD);
+    }
+}
+
+ANONYMOUS_NAMESPACE_END
+
+void BLAKE3_HashMany_AVX512(const byte *const inputs[16], size_t blocks, const word32 key[8],
+    word64 counter, bool incrementCounter, byte flags, byte flagsStart, byte flagsEnd, byte *out)
+{
+    CRYPTOPP_ALIGN_DATA(64) word32 temp[8][16];
+
+    for (unsigned int j=0; j<16; j++)
+    {
+        const word64 c = counter + (incrementCounter ? j : 0);
+        temp[0][j] = static_cast<word32>(c);
+        temp[1][j] = static_cast<word32>(c >> 32);
+    }
+    const __m512i counterLow = _mm512_load_si512(temp[0]);
+    const __m512i counterHigh = _mm512_load_si512(temp[1]);
+
+    __m512i H[8];
+    for (unsigned int i=0; i<8; i++)
+        H[i] = _mm512_set1_epi32(static_cast<int>(key[i]));
+
+    for (size_t b=0; b<blocks; b++)
+    {
+        byte blockFlags = flags;
+        if (b == 0)
+            blockFlags |= flagsStart;
+        if (b+1 == blocks)
+            blockFlags |= flagsEnd;
+
+        __m512i m[16], v[16];
+        LoadMessage16(m, inputs, 64*b);
+
+        for (unsigned int i=0; i<8; i++)
+            v[i] = H[i];
+        for (unsigned int i=0; i<4; i++)
+            v[i+8] = _mm512_set1_epi32(static_cast<int>(BLAKE2S_IV[i]));
+        v[12] = counterLow;
+        v[13] = counterHigh;
+        v[14] = _mm512_set1_epi32(64);
+        v[15] = _mm512_set1_epi32(blockFlags);
+
+        for (unsigned int r=0; r<7; r++)
+        {
+            const byte* s = SCHEDULE[r];
+            G(v, 0, 4,  8, 12, m[s[ 0]], m[s[ 1]]);
+            G(v, 1, 5,  9, 13, m[s[ 2]], m[s[ 3]]);
+            G(v, 2, 6, 10, 14, m[s[ 4]], m[s[ 5]]);
+            G(v, 3, 7, 11, 15, m[s[ 6]], m[s[ 7]]);
+            G(v, 0, 5, 10, 15, m[s[ 8]], m[s[ 9]]);
+            G(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+            G(v, 2, 7,  8, 13, m[s[12]], m[s[13]]);
+            G(v, 3, 4,  9, 14, m[s[14]], m[s[15]]);
+        }
+
+        for (unsigned int i=0; i<8; i++)
+            H[i] = _mm512_xor_si512(v[i], v[i+8]);
+    }
+
+    // Transpose the chaining values so lane j is written to out+32*j
+    for (unsigned int i=0; i<8; i++)
+        _mm512_store_si512(temp[i], H[i]);
+    for (unsigned int j=0; j<16; j++)
+    {
+        for (unsigned int i=0; i<8; i++)
+            PutWord(false, LITTLE_ENDIAN_ORDER, out+32*j+4*i, temp[i][j]);
+    }
+}
+
+#endif  // CRYPTOPP_AVX512_AVAILABLE
+
+NAMESPACE_END
@@ -21,6 +21,9 @@ NAMESPACE_BEGIN(CryptoPP)
 extern void ChaCha_OperateKeystream_NEON(const word32 *state, const byte* input, byte *output, unsigned int rounds);
 #endif
 
+#if (CRYPTOPP_AVX512_AVAILABLE)
+extern void ChaCha_OperateKeystream_AVX512(const word32 *state, const byte* input, byte *output, unsigned int rounds);
+#endif
 #if (CRYPTOPP_AVX2_AVAILABLE)
 extern void ChaCha_OperateKeystream_AVX2(const word32 *state, const byte* input, byte *output, unsigned int rounds);
 #endif
@@ -99,6 +102,24 @@ void ChaCha_OperateKeystream(KeystreamOperation operation,
 {
     do
     {
+#if (CRYPTOPP_AVX512_AVAILABLE)
+        if (HasAVX512F() && HasAVX512BW() && HasAVX512VL())
+        {
+            while (iterationCount >= 16 && MultiBlockSafe(state[12], 16))
+            {
+                const bool xorInput = (operation & INPUT_NULL) != INPUT_NULL;
+                ChaCha_OperateKeystream_AVX512(state, xorInput ? input : NULLPTR, output, rounds);
+
+                // MultiBlockSafe avoids overflow on the counter words
+                state[12] += 16;
+
+                input += (!!xorInput) * 16 * BYTES_PER_ITERATION;
+                output += 16 * BYTES_PER_ITERATION;
+                iterationCount -= 16;
+            }
+        }
+#endif
+
 #if (CRYPTOPP_AVX2_AVAILABLE)
         if (HasAVX2())
         {
@@ -252,6 +273,11 @@ void HChaCha_OperateKeystream(const word32 state[16], word32 output[8])
 
 std::string ChaCha_AlgorithmProvider()
 {
+#if (CRYPTOPP_AVX512_AVAILABLE)
+    if (HasAVX512F() && HasAVX512BW() && HasAVX512VL())
+        return "AVX512";
+    else
+#endif
 #if (CRYPTOPP_AVX2_AVAILABLE)
     if (HasAVX2())
         return "AVX2";
@@ -281,6 +307,11 @@ std::string ChaCha_AlgorithmProvider()
 
 unsigned int ChaCha_GetAlignment()
 {
+#if (CRYPTOPP_AVX512_AVAILABLE)
+    if (HasAVX512F() && HasAVX512BW() && HasAVX512VL())
+        return 16;
+    else
+#endif
 #if (CRYPTOPP_AVX2_AVAILABLE)
     if (HasAVX2())
         return 16;
@@ -301,6 +332,11 @@ unsigned int ChaCha_GetAlignment()
 
 unsigned int ChaCha_GetOptimalBlockSize()
 {
+#if (CRYPTOPP_AVX512_AVAILABLE)
+    if (HasAVX512F() && HasAVX512BW() && HasAVX512VL())
+        return 16 * BYTES_PER_ITERATION;
+    else
+#endif
 #if (CRYPTOPP_AVX2_AVAILABLE)
     if (HasAVX2())
         return 8 * BYTES_PER_ITERATION;
@@ -495,6 +531,17 @@ void ChaChaTLS_Policy::OperateKeystream(KeystreamOperation operation,
     // CRYPTOPP_ASSERT(discard==0);
 }
 
+// Used by the one-shot ChaCha20Poly1305 functions, which keep their own
+// state. The block counter is state[12]. The keystream is written to
+// output when input is NULL, otherwise output = input ^ keystream.
+void ChaChaTLS_OperateKeystream(word32 state[16], byte *output, const byte *input, size_t iterationCount)
+{
+    word32 discard=0;
+    const KeystreamOperation operation = input ? XOR_KEYSTREAM : WRITE_KEYSTREAM;
+    ChaCha_OperateKeystream(operation, state, state[12], discard,
+            20, output, input, iterationCount);
+}
+
 ////////////////////////////// IETF XChaCha20 //////////////////////////////
 
 std::string XChaCha20_Policy::AlgorithmName() const
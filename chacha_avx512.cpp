@@ -0,0 +1,145 @@
+// chacha_avx512.cpp - written and placed in the public domain by
+//                     the Crypto++ project.
+//
+//    This source file uses intrinsics and built-ins to gain access to
+//    AVX-512 instructions. A separate source file is needed because
+//    additional CXXFLAGS are required to enable the appropriate
+//    instructions sets in some build configurations.
+//
+//    The code produces 16 ChaCha blocks at a time. Each ZMM register
+//    holds one word of the state for all 16 blocks, so the rounds need
+//    no shuffles, and AVX-512 provides the rotates. The words are
+//    transposed into blocks at the end. The caller ensures the low
+//    counter word does not wrap within the 16 blocks.
+
+#include "pch.h"
+#include "config.h"
+
+#include "chacha.h"
+#include "misc.h"
+
+#if defined(CRYPTOPP_AVX512_AVAILABLE)
+# include <emmintrin.h>
+# include <immintrin.h>
+#endif
+
+// Squash MS LNK4221 and libtool warnings
+extern const char CHACHA_AVX512_FNAME[] = __FILE__;
+
+// GCC 12 warns the __Y operand in avx512fintrin.h is used
+// uninitialized. It is the self-initialized placeholder of the
+// _mm512_undefined intrinsics and not a variable in this file.
+#if CRYPTOPP_GCC_DIAGNOSTIC_AVAILABLE
+# pragma GCC diagnostic ignored "-Wuninitialized"
+# if (CRYPTOPP_GCC_VERSION >= 40700)
+#  pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+# endif
+#endif
+
+NAMESPACE_BEGIN(CryptoPP)
+
+#if (CRYPTOPP_AVX512_AVAILABLE)
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+inline void QuarterRound(__m512i &a, __m512i &b, __m512i &c, __m512i &d)
+{
+    a = _mm512_add_epi32(a, b); d = _mm512_rol_epi32(_mm512_xor_si512(d, a), 16);
+    c = _mm512_add_epi32(c, d); b = _mm512_rol_epi32(_mm512_xor_si512(b, c), 12);
+    a = _mm512_add_epi32(a, b); d = _mm512_rol_epi32(_mm512_xor_si512(d, a), 8);
+    c = _mm512_add_epi32(c, d); b = _mm512_rol_epi32(_mm512_xor_si512(b, c), 7);
+}
+
+// Transpose four rows of words into 128-bit lanes. On return the
+// 128-bit lane k of R[m] holds the four words of block 4k+m.
+inline void Transpose4x4(__m512i &r0, __m512i &r1, __m512i &r2, __m512i &r3)
+{
+    const __m512i t0 = _mm512_unpacklo_epi32(r0, r1);
+    const __m512i t1 = _mm512_unpackhi_epi32(r0, r1);
+    const __m512i t2 = _mm512_unpacklo_epi32(r2, r3);
+    const __m512i t3 = _mm512_unpackhi_epi32(r2, r3);
+
+    r0 = _mm512_unpacklo_epi64(t0, t2);
+    r1 = _mm512_unpackhi_epi64(t0, t2);
+    r2 = _mm512_unpacklo_epi64(t1, t3);
+    r3 = _mm512_unpackhi_epi64(t1, t3);
+}
+
+inline void StoreBlock(byte *output, const byte *input, const __m512i block)
+{
+    if (input)
+    {
+        _mm512_storeu_si512(output, _mm512_xor_si512(block,
+            _mm512_loadu_si512(input)));
+    }
+    else
+    {
+        _mm512_storeu_si512(output, block);
+    }
+}
+
+ANONYMOUS_NAMESPACE_END
+
+void ChaCha_OperateKeystream_AVX512(const word32 *state, const byte* input, byte *output, unsigned int rounds)
+{
+    __m512i s[16], x[16];
+    for (unsigned int i=0; i<16; ++i)
+        s[i] = _mm512_set1_epi32(static_cast<int>(state[i]));
+
+    // Block j uses counter state[12]+j
+    s[12] = _mm512_add_epi32(s[12], _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+
+    for (unsigned int i=0; i<16; ++i)
+        x[i] = s[i];
+
+    for (int i = static_cast<int>(rounds); i > 0; i -= 2)
+    {
+        QuarterRound(x[0], x[4],  x[8], x[12]);
+        QuarterRound(x[1], x[5],  x[9], x[13]);
+        QuarterRound(x[2], x[6], x[10], x[14]);
+        QuarterRound(x[3], x[7], x[11], x[15]);
+
+        QuarterRound(x[0], x[5], x[10], x[15]);
+        QuarterRound(x[1], x[6], x[11], x[12]);
+        QuarterRound(x[2], x[7],  x[8], x[13]);
+        QuarterRound(x[3], x[4],  x[9], x[14]);
+    }
+
+    for (unsigned int i=0; i<16; ++i)
+        x[i] = _mm512_add_epi32(x[i], s[i]);
+
+    Transpose4x4(x[0], x[1], x[2], x[3]);
+    Transpose4x4(x[4], x[5], x[6], x[7]);
+    Transpose4x4(x[8], x[9], x[10], x[11]);
+    Transpose4x4(x[12], x[13], x[14], x[15]);
+
+    // Gather the 128-bit lanes of each block
+    for (unsigned int m=0; m<4; ++m)
+    {
+        const __m512i a = _mm512_shuffle_i32x4(x[m], x[4+m], _MM_SHUFFLE(1, 0, 1, 0));
+        const __m512i b = _mm512_shuffle_i32x4(x[m], x[4+m], _MM_SHUFFLE(3, 2, 3, 2));
+        const __m512i c = _mm512_shuffle_i32x4(x[8+m], x[12+m], _MM_SHUFFLE(1, 0, 1, 0));
+        const __m512i d = _mm512_shuffle_i32x4(x[8+m], x[12+m], _MM_SHUFFLE(3, 2, 3, 2));
+
+        const size_t blocks[4] = {m, 4+m, 8+m, 12+m};
+        const __m512i out[4] = {
+            _mm512_shuffle_i32x4(a, c, _MM_SHUFFLE(2, 0, 2, 0)),
+            _mm512_shuffle_i32x4(a, c, _MM_SHUFFLE(3, 1, 3, 1)),
+            _mm512_shuffle_i32x4(b, d, _MM_SHUFFLE(2, 0, 2, 0)),
+            _mm512_shuffle_i32x4(b, d, _MM_SHUFFLE(3, 1, 3, 1))
+        };
+
+        for (unsigned int k=0; k<4; ++k)
+        {
+            const size_t offset = blocks[k]*64;
+            StoreBlock(output+offset, input ? input+offset : NULLPTR, out[k]);
+        }
+    }
+
+    // https://software.intel.com/en-us/articles/avoiding-avx-sse-transition-penalties
+    _mm256_zeroupper();
+}
+
+#endif  // CRYPTOPP_AVX512_AVAILABLE
+
+NAMESPACE_END
@@ -12,6 +12,18 @@
 
 NAMESPACE_BEGIN(CryptoPP)
 
+// The ChaChaTLS keystream over a caller supplied state
+extern void ChaChaTLS_OperateKeystream(word32 state[16], byte *output, const byte *input, size_t iterationCount);
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+// Bytes encrypted and authenticated at a time by the one-shot functions.
+// A multiple of the widest keystream kernel, and small enough that the
+// ciphertext is still in L1 when Poly1305 reads it.
+const size_t STITCH_SIZE = 4096;
+
+ANONYMOUS_NAMESPACE_END
+
 ////////////////////////////// IETF ChaChaTLS //////////////////////////////
 
 // RekeyCipherAndMac is heavier-weight than we like. The Authenc framework was
@@ -94,8 +106,90 @@ void ChaCha20Poly1305_Base::AuthenticateLastFooterBlock(byte *mac, size_t macSiz
 	m_state = State_KeySet;
 }
 
+// The one-shot functions key ChaCha and Poly1305 directly rather than
+// through RekeyCipherAndMac, and skip the AuthenticatedSymmetricCipherBase
+// state machine. The message is processed in chunks, and each chunk of
+// ciphertext is absorbed by Poly1305 right after it is encrypted, or right
+// before it is decrypted, so the data makes one trip through memory.
+void ChaCha20Poly1305_Base::ProcessOneShot(bool encrypt, byte *output, byte *mac, size_t macSize, const byte *iv, int ivLength, const byte *aad, size_t aadLength, const byte *input, size_t length)
+{
+	CRYPTOPP_ASSERT(m_state >= State_KeySet);
+	CRYPTOPP_ASSERT(m_userKey.size() == 32);
+
+	const size_t ivSize = ThrowIfInvalidIVLength(ivLength);
+	CRYPTOPP_ASSERT(ivSize == 12); CRYPTOPP_UNUSED(ivSize);
+	if (length > MaxMessageLength())
+		throw InvalidArgument(AlgorithmName() + ": message length exceeds maximum");
+
+	// State words are defined in RFC 8439, Section 2.3
+	FixedSizeSecBlock<word32, 16> state;
+	state[0] = 0x61707865; state[1] = 0x3320646e;
+	state[2] = 0x79622d32; state[3] = 0x6b206574;
+
+	GetBlock<word32, LittleEndian> getKey(m_userKey);
+	getKey(state[4])(state[5])(state[6])(state[7])
+		(state[8])(state[9])(state[10])(state[11]);
+
+	GetBlock<word32, LittleEndian> getIV(iv);
+	state[12] = 0;
+	getIV(state[13])(state[14])(state[15]);
+
+	// Block 0 keys the MAC, and the message starts at block 1
+	FixedSizeSecBlock<byte, 64> block;
+	ChaChaTLS_OperateKeystream(state, block, NULLPTR, 1);
+
+	MessageAuthenticationCode &poly1305 = AccessMAC();
+	poly1305.SetKey(block, 32);
+
+	// Pad to a multiple of 16 or 0
+	const byte zero[16] = {0};
+	poly1305.Update(aad, aadLength);
+	poly1305.Update(zero, (16U - (aadLength % 16)) % 16);
+
+	size_t remaining = length;
+	while (remaining)
+	{
+		const size_t n = STDMIN(remaining, STITCH_SIZE);
+		const size_t blocks = n / 64, tail = n % 64;
+
+		if (!encrypt)
+			poly1305.Update(input, n);
+
+		if (blocks)
+			ChaChaTLS_OperateKeystream(state, output, input, blocks);
+		if (tail)
+		{
+			ChaChaTLS_OperateKeystream(state, block, NULLPTR, 1);
+			xorbuf(output+blocks*64, input+blocks*64, block, tail);
+		}
+
+		if (encrypt)
+			poly1305.Update(output, n);
+
+		input += n; output += n;
+		remaining -= n;
+	}
+
+	CRYPTOPP_ALIGN_DATA(8) byte lengths[2*sizeof(word64)];
+	PutWord(true, LITTLE_ENDIAN_ORDER, lengths+0, static_cast<word64>(aadLength));
+	PutWord(true, LITTLE_ENDIAN_ORDER, lengths+8, static_cast<word64>(length));
+	poly1305.Update(zero, (16U - (length % 16)) % 16);
+	poly1305.Update(lengths, sizeof(lengths));
+	poly1305.TruncatedFinal(mac, macSize);
+
+	// Same as after TruncatedFinal. The next message needs an IV.
+	m_state = State_KeySet;
+}
+
 void ChaCha20Poly1305_Base::EncryptAndAuthenticate(byte *ciphertext, byte *mac, size_t macSize, const byte *iv, int ivLength, const byte *aad, size_t aadLength, const byte *message, size_t messageLength)
 {
+	// Let Resynchronize throw for a missing key
+	if (m_state >= State_KeySet)
+	{
+		ProcessOneShot(true, ciphertext, mac, macSize, iv, ivLength, aad, aadLength, message, messageLength);
+		return;
+	}
+
 	Resynchronize(iv, ivLength);
 	Update(aad, aadLength);
 	ProcessString(ciphertext, message, messageLength);
@@ -104,6 +198,15 @@ void ChaCha20Poly1305_Base::EncryptAndAuthenticate(byte *ciphertext, byte *mac,
 
 bool ChaCha20Poly1305_Base::DecryptAndVerify(byte *message, const byte *mac, size_t macLength, const byte *iv, int ivLength, const byte *aad, size_t aadLength, const byte *ciphertext, size_t ciphertextLength)
 {
+	// Let Resynchronize throw for a missing key
+	if (m_state >= State_KeySet)
+	{
+		ThrowIfInvalidTruncatedSize(macLength);
+		byte computed[16];
+		ProcessOneShot(false, message, computed, macLength, iv, ivLength, aad, aadLength, ciphertext, ciphertextLength);
+		return VerifyBufsEqual(computed, mac, macLength);
+	}
+
 	Resynchronize(iv, ivLength);
 	Update(aad, aadLength);
 	ProcessString(message, ciphertext, ciphertextLength);
@@ -80,6 +80,10 @@ public:
 	/// \param messageLength the size of the messagetext buffer, in bytes
 	/// \details EncryptAndAuthenticate() encrypts and generates the MAC in one call. The function
 	///   truncates the MAC if <tt>macSize < TagSize()</tt>.
+	/// \details Once the key is set, EncryptAndAuthenticate() does not use the incremental
+	///   interface. It keys ChaCha20 and Poly1305 directly, and Poly1305 absorbs each 4 KB of
+	///   ciphertext right after it is encrypted, while it is still in cache. Like TruncatedFinal(),
+	///   it leaves the object waiting for a new IV.
 	virtual void EncryptAndAuthenticate(byte *ciphertext, byte *mac, size_t macSize, const byte *iv, int ivLength, const byte *aad, size_t aadLength, const byte *message, size_t messageLength);
 
 	/// \brief Decrypts and verifies a MAC in one call
@@ -97,6 +101,8 @@ public:
 	/// <tt>message</tt> is a decryption buffer and should be at least as large as the ciphertext buffer.
 	/// \details The function returns true iff MAC is valid. DecryptAndVerify() assumes the MAC
 	///  is truncated if <tt>macLength < TagSize()</tt>.
+	/// \details Once the key is set, DecryptAndVerify() authenticates and decrypts the
+	///  ciphertext in a single pass, like EncryptAndAuthenticate().
 	virtual bool DecryptAndVerify(byte *message, const byte *mac, size_t macSize, const byte *iv, int ivLength, const byte *aad, size_t aadLength, const byte *ciphertext, size_t ciphertextLength);
 
 protected:
@@ -112,6 +118,7 @@ protected:
 
 	// See comments in chachapoly.cpp
 	void RekeyCipherAndMac(const byte *userKey, size_t userKeyLength, const NameValuePairs &params);
+	void ProcessOneShot(bool encrypt, byte *output, byte *mac, size_t macSize, const byte *iv, int ivLength, const byte *aad, size_t aadLength, const byte *input, size_t length);
 
 	virtual const MessageAuthenticationCode & GetMAC() const = 0;
 	virtual MessageAuthenticationCode & AccessMAC() = 0;
@@ -155,6 +155,25 @@
 #define CRYPTOPP_AVX2_AVAILABLE 1
 #endif
 
+// Requires Binutils 2.26. CRYPTOPP_AVX512_AVAILABLE signals AVX512F,
+// AVX512BW and AVX512VL, which is the Skylake-X baseline.
+#if !defined(CRYPTOPP_DISABLE_AVX512) && defined(CRYPTOPP_AVX2_AVAILABLE) && \
+	(defined(__AVX512F__) || (CRYPTOPP_MSC_VERSION >= 1910) || \
+	(CRYPTOPP_GCC_VERSION >= 50000) || (__INTEL_COMPILER >= 1600) || \
+	(CRYPTOPP_LLVM_CLANG_VERSION >= 30900) || (CRYPTOPP_APPLE_CLANG_VERSION >= 80000))
+#define CRYPTOPP_AVX512_AVAILABLE 1
+#endif
+
+// Requires Binutils 2.30. VAES and VPCLMULQDQ arrived together on
+// Ice Lake and Zen 3, so the library treats them as one feature set.
+#if !defined(CRYPTOPP_DISABLE_VAES) && defined(CRYPTOPP_AVX2_AVAILABLE) && \
+	defined(CRYPTOPP_AESNI_AVAILABLE) && defined(CRYPTOPP_CLMUL_AVAILABLE) && \
+	(defined(__VAES__) || (CRYPTOPP_MSC_VERSION >= 1920) || \
+	(CRYPTOPP_GCC_VERSION >= 80000) || (__INTEL_COMPILER >= 1900) || \
+	(CRYPTOPP_LLVM_CLANG_VERSION >= 60000) || (CRYPTOPP_APPLE_CLANG_VERSION >= 100000))
+#define CRYPTOPP_VAES_AVAILABLE 1
+#endif
+
 // Guessing at SHA for SunCC. Its not in Sun Studio 12.6. Also see
 // http://stackoverflow.com/questions/45872180/which-xarch-for-sha-extensions-on-solaris
 #if !defined(CRYPTOPP_DISABLE_SHANI) && defined(CRYPTOPP_SSE42_AVAILABLE) && \
@@ -200,6 +219,8 @@
 #  undef CRYPTOPP_RDSEED_AVAILABLE
 #  undef CRYPTOPP_AVX_AVAILABLE
 #  undef CRYPTOPP_AVX2_AVAILABLE
+#  undef CRYPTOPP_AVX512_AVAILABLE
+#  undef CRYPTOPP_VAES_AVAILABLE
 # endif
 # if (CRYPTOPP_BOOL_X64)
 #  undef CRYPTOPP_CLMUL_AVAILABLE
@@ -209,6 +230,8 @@
 #  undef CRYPTOPP_RDSEED_AVAILABLE
 #  undef CRYPTOPP_AVX_AVAILABLE
 #  undef CRYPTOPP_AVX2_AVAILABLE
+#  undef CRYPTOPP_AVX512_AVAILABLE
+#  undef CRYPTOPP_VAES_AVAILABLE
 # endif
 #endif
 
@@ -221,6 +244,7 @@
 // http://github.com/weidai11/cryptopp/issues/226
 #if defined(__SUNPRO_CC) && (__SUNPRO_CC <= 0x5150)
 # undef CRYPTOPP_CLMUL_AVAILABLE
+# undef CRYPTOPP_VAES_AVAILABLE
 #endif
 
 #endif  // CRYPTOPP_DISABLE_ASM
@@ -185,6 +185,12 @@
 # define CRYPTOPP_CXX11_NULLPTR 1
 #endif // nullptr_t compilers
 
+// thread_local: MS at VS2015 (19.00); GCC at 4.8; Clang at 3.3; Xcode 8.0; Intel 15.0; SunCC 5.13.
+#if (CRYPTOPP_MSC_VERSION >= 1900) || __has_feature(cxx_thread_local) || \
+	(__INTEL_COMPILER >= 1500) || (CRYPTOPP_GCC_VERSION >= 40800) || (__SUNPRO_CC >= 0x5130)
+# define CRYPTOPP_CXX11_THREAD_LOCAL 1
+#endif // thread_local
+
 #endif // CRYPTOPP_CXX11
 
 // ***************** C++14 and above ********************
@@ -288,6 +288,11 @@ bool CRYPTOPP_SECTION_INIT g_hasCLMUL = false;
 bool CRYPTOPP_SECTION_INIT g_hasMOVBE = false;
 bool CRYPTOPP_SECTION_INIT g_hasAVX = false;
 bool CRYPTOPP_SECTION_INIT g_hasAVX2 = false;
+bool CRYPTOPP_SECTION_INIT g_hasAVX512F = false;
+bool CRYPTOPP_SECTION_INIT g_hasAVX512BW = false;
+bool CRYPTOPP_SECTION_INIT g_hasAVX512VL = false;
+bool CRYPTOPP_SECTION_INIT g_hasVAES = false;
+bool CRYPTOPP_SECTION_INIT g_hasVPCLMULQDQ = false;
 bool CRYPTOPP_SECTION_INIT g_hasADX = false;
 bool CRYPTOPP_SECTION_INIT g_hasSHA = false;
 bool CRYPTOPP_SECTION_INIT g_hasRDRAND = false;
@@ -463,6 +468,7 @@ void DetectX86Features()
 	// Coverity finding CID 171239. Initialize arrays.
 	// Indexes: EAX=0, EBX=1, ECX=2, EDX=3
 	word32 cpuid0[4]={0}, cpuid1[4]={0}, cpuid2[4]={0};
+	word64 xcr0 = 0;
 
 #if defined(CRYPTOPP_DISABLE_ASM)
 	// Not available
@@ -496,6 +502,7 @@ void DetectX86Features()
 
 	CRYPTOPP_CONSTANT(AVX_FLAG = (3 << 27));     // ECX
 	CRYPTOPP_CONSTANT(YMM_FLAG = (3 <<  1));     // CR0
+	CRYPTOPP_CONSTANT(ZMM_FLAG = (7 <<  5));     // CR0
 
 #if (CRYPTOPP_BOOL_X32 || CRYPTOPP_BOOL_X64)
 	// 64-bit core instruction set includes SSE2. Just check
@@ -530,7 +537,7 @@ void DetectX86Features()
 	// https://software.intel.com/en-us/blogs/2011/04/14/is-avx-enabled
 	if ((cpuid1[ECX_REG] & AVX_FLAG) == AVX_FLAG)
 	{
-		word64 xcr0 = XGetBV(0);
+		xcr0 = XGetBV(0);
 		g_hasAVX = (xcr0 & YMM_FLAG) == YMM_FLAG;
 	}
 
@@ -541,6 +548,11 @@ void DetectX86Features()
 		CRYPTOPP_CONSTANT(   ADX_FLAG = (1 << 19));
 		CRYPTOPP_CONSTANT(   SHA_FLAG = (1 << 29));
 		CRYPTOPP_CONSTANT(  AVX2_FLAG = (1 <<  5));
+		CRYPTOPP_CONSTANT(AVX512F_FLAG  = (1 << 16));
+		CRYPTOPP_CONSTANT(AVX512BW_FLAG = (1 << 30));
+		CRYPTOPP_CONSTANT(AVX512VL_FLAG = (1 << 31));
+		CRYPTOPP_CONSTANT(   VAES_FLAG  = (1 <<  9));  // ECX
+		CRYPTOPP_CONSTANT(VPCLMUL_FLAG  = (1 << 10));  // ECX
 
 		g_isP4 = ((cpuid1[0] >> 8) & 0xf) == 0xf;
 		g_cacheLineSize = 8 * GETBYTE(cpuid1[1], 1);
@@ -554,6 +566,11 @@ void DetectX86Features()
 				g_hasADX    = (cpuid2[EBX_REG] & ADX_FLAG) != 0;
 				g_hasSHA    = (cpuid2[EBX_REG] & SHA_FLAG) != 0;
 				g_hasAVX2   = (cpuid2[EBX_REG] & AVX2_FLAG) != 0;
+				g_hasAVX512F  = (cpuid2[EBX_REG] & AVX512F_FLAG) != 0;
+				g_hasAVX512BW = (cpuid2[EBX_REG] & AVX512BW_FLAG) != 0;
+				g_hasAVX512VL = (cpuid2[EBX_REG] & AVX512VL_FLAG) != 0;
+				g_hasVAES     = (cpuid2[ECX_REG] & VAES_FLAG) != 0;
+				g_hasVPCLMULQDQ = (cpuid2[ECX_REG] & VPCLMUL_FLAG) != 0;
 			}
 		}
 	}
@@ -564,6 +581,11 @@ void DetectX86Features()
 		CRYPTOPP_CONSTANT(   ADX_FLAG = (1 << 19));
 		CRYPTOPP_CONSTANT(   SHA_FLAG = (1 << 29));
 		CRYPTOPP_CONSTANT(  AVX2_FLAG = (1 <<  5));
+		CRYPTOPP_CONSTANT(AVX512F_FLAG  = (1 << 16));
+		CRYPTOPP_CONSTANT(AVX512BW_FLAG = (1 << 30));
+		CRYPTOPP_CONSTANT(AVX512VL_FLAG = (1 << 31));
+		CRYPTOPP_CONSTANT(   VAES_FLAG  = (1 <<  9));  // ECX
+		CRYPTOPP_CONSTANT(VPCLMUL_FLAG  = (1 << 10));  // ECX
 
 		CpuId(0x80000005, 0, cpuid2);
 		g_cacheLineSize = GETBYTE(cpuid2[ECX_REG], 0);
@@ -577,6 +599,11 @@ void DetectX86Features()
 				g_hasADX    = (cpuid2[EBX_REG] & ADX_FLAG) != 0;
 				g_hasSHA    = (cpuid2[EBX_REG] & SHA_FLAG) != 0;
 				g_hasAVX2   = (cpuid2[EBX_REG] & AVX2_FLAG) != 0;
+				g_hasAVX512F  = (cpuid2[EBX_REG] & AVX512F_FLAG) != 0;
+				g_hasAVX512BW = (cpuid2[EBX_REG] & AVX512BW_FLAG) != 0;
+				g_hasAVX512VL = (cpuid2[EBX_REG] & AVX512VL_FLAG) != 0;
+				g_hasVAES     = (cpuid2[ECX_REG] & VAES_FLAG) != 0;
+				g_hasVPCLMULQDQ = (cpuid2[ECX_REG] & VPCLMUL_FLAG) != 0;
 			}
 		}
 
@@ -631,6 +658,15 @@ void DetectX86Features()
 	// cpu support and OS support, while AVX2 only tests cpu support.
 	g_hasAVX2 &= g_hasAVX;
 
+	// AVX-512 also needs the OS to save the opmask and upper ZMM registers.
+	// VAES and VPCLMULQDQ are VEX or EVEX encoded, so they need AVX, and
+	// the library only uses them alongside AES-NI and CLMUL.
+	g_hasAVX512F &= g_hasAVX2 && (xcr0 & ZMM_FLAG) == ZMM_FLAG;
+	g_hasAVX512BW &= g_hasAVX512F;
+	g_hasAVX512VL &= g_hasAVX512F;
+	g_hasVAES &= g_hasAVX && g_hasAESNI;
+	g_hasVPCLMULQDQ &= g_hasAVX && g_hasCLMUL;
+
 done:
 
 #if defined(_SC_LEVEL1_DCACHE_LINESIZE)
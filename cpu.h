@@ -90,6 +90,11 @@ extern CRYPTOPP_DLL bool g_hasAESNI;
 extern CRYPTOPP_DLL bool g_hasCLMUL;
 extern CRYPTOPP_DLL bool g_hasAVX;
 extern CRYPTOPP_DLL bool g_hasAVX2;
+extern CRYPTOPP_DLL bool g_hasAVX512F;
+extern CRYPTOPP_DLL bool g_hasAVX512BW;
+extern CRYPTOPP_DLL bool g_hasAVX512VL;
+extern CRYPTOPP_DLL bool g_hasVAES;
+extern CRYPTOPP_DLL bool g_hasVPCLMULQDQ;
 extern CRYPTOPP_DLL bool g_hasSHA;
 extern CRYPTOPP_DLL bool g_hasADX;
 extern CRYPTOPP_DLL bool g_isP4;
@@ -283,6 +288,89 @@ inline bool HasAVX2()
 #endif
 }
 
+/// \brief Determine AVX-512 Foundation availability
+/// \returns true if AVX512F is determined to be available, false otherwise
+/// \details HasAVX512F() is a runtime check performed using CPUID. The
+///  function also verifies the OS saves the opmask and ZMM registers.
+/// \since Crypto++ 8.3
+/// \note This function is only available on Intel IA-32 platforms
+inline bool HasAVX512F()
+{
+#if CRYPTOPP_AVX512_AVAILABLE
+	if (!g_x86DetectionDone)
+		DetectX86Features();
+	return g_hasAVX512F;
+#else
+	return false;
+#endif
+}
+
+/// \brief Determine AVX-512 Byte and Word availability
+/// \returns true if AVX512BW is determined to be available, false otherwise
+/// \details HasAVX512BW() is a runtime check performed using CPUID
+/// \since Crypto++ 8.3
+/// \note This function is only available on Intel IA-32 platforms
+inline bool HasAVX512BW()
+{
+#if CRYPTOPP_AVX512_AVAILABLE
+	if (!g_x86DetectionDone)
+		DetectX86Features();
+	return g_hasAVX512BW;
+#else
+	return false;
+#endif
+}
+
+/// \brief Determine AVX-512 Vector Length availability
+/// \returns true if AVX512VL is determined to be available, false otherwise
+/// \details HasAVX512VL() is a runtime check performed using CPUID
+/// \since Crypto++ 8.3
+/// \note This function is only available on Intel IA-32 platforms
+inline bool HasAVX512VL()
+{
+#if CRYPTOPP_AVX512_AVAILABLE
+	if (!g_x86DetectionDone)
+		DetectX86Features();
+	return g_hasAVX512VL;
+#else
+	return false;
+#endif
+}
+
+/// \brief Determine VAES availability
+/// \returns true if VAES is determined to be available, false otherwise
+/// \details HasVAES() is a runtime check performed using CPUID. VAES
+///  provides AES instructions on 256-bit YMM and 512-bit ZMM registers.
+/// \since Crypto++ 8.3
+/// \note This function is only available on Intel IA-32 platforms
+inline bool HasVAES()
+{
+#if CRYPTOPP_VAES_AVAILABLE
+	if (!g_x86DetectionDone)
+		DetectX86Features();
+	return g_hasVAES;
+#else
+	return false;
+#endif
+}
+
+/// \brief Determine VPCLMULQDQ availability
+/// \returns true if VPCLMULQDQ is determined to be available, false otherwise
+/// \details HasVPCLMULQDQ() is a runtime check performed using CPUID.
+///  VPCLMULQDQ provides carryless multiplies on YMM and ZMM registers.
+/// \since Crypto++ 8.3
+/// \note This function is only available on Intel IA-32 platforms
+inline bool HasVPCLMULQDQ()
+{
+#if CRYPTOPP_VAES_AVAILABLE
+	if (!g_x86DetectionDone)
+		DetectX86Features();
+	return g_hasVPCLMULQDQ;
+#else
+	return false;
+#endif
+}
+
 /// \brief Determine RDRAND availability
 /// \returns true if RDRAND is determined to be available, false otherwise
 /// \details HasRDRAND() is a runtime check performed using CPUID
@@ -19,6 +19,23 @@ extern void CRC32C_Update_ARMV8(const byte *s, size_t n, word32& c);
 extern void CRC32C_Update_SSE42(const byte *s, size_t n, word32& c);
 #endif
 
+// crc_simd.cpp
+#if (CRYPTOPP_CLMUL_AVAILABLE)
+extern void CRC32_Update_CLMUL(const byte *s, size_t n, word32& c);
+extern void CRC32C_Update_CLMUL(const byte *s, size_t n, word32& c);
+#endif
+
+// crc_simd.cpp
+#if (CRYPTOPP_ARM_PMULL_AVAILABLE)
+extern void CRC32_Update_PMULL(const byte *s, size_t n, word32& c);
+extern void CRC32C_Update_PMULL(const byte *s, size_t n, word32& c);
+#endif
+
+#if (CRYPTOPP_CLMUL_AVAILABLE) || (CRYPTOPP_ARM_PMULL_AVAILABLE)
+// The folding code needs 64 bytes and consumes multiples of 16 bytes
+const size_t CRC_FOLD_MINIMUM = 64;
+#endif
+
 /* Table of CRC-32's of all single byte values (made by makecrc.c) */
 const word32 CRC32::m_tab[] = {
 #if (CRYPTOPP_LITTLE_ENDIAN)
@@ -132,6 +149,10 @@ const word32 CRC32::m_tab[] = {
 
 std::string CRC32::AlgorithmProvider() const
 {
+#if (CRYPTOPP_CLMUL_AVAILABLE)
+	if (HasCLMUL())
+		return "CLMUL";
+#endif
 #if (CRYPTOPP_ARM_CRC32_AVAILABLE)
 	if (HasCRC32())
 		return "ARMv8";
@@ -146,6 +167,22 @@ CRC32::CRC32()
 
 void CRC32::Update(const byte *s, size_t n)
 {
+#if (CRYPTOPP_CLMUL_AVAILABLE)
+	if (HasCLMUL() && n >= CRC_FOLD_MINIMUM)
+	{
+		const size_t m = RoundDownToMultipleOf(n, size_t(16));
+		CRC32_Update_CLMUL(s, m, m_crc);
+		s += m; n -= m;
+	}
+#elif (CRYPTOPP_ARM_PMULL_AVAILABLE)
+	if (HasPMULL() && n >= CRC_FOLD_MINIMUM)
+	{
+		const size_t m = RoundDownToMultipleOf(n, size_t(16));
+		CRC32_Update_PMULL(s, m, m_crc);
+		s += m; n -= m;
+	}
+#endif
+
 #if (CRYPTOPP_ARM_CRC32_AVAILABLE)
 	if (HasCRC32())
 	{
@@ -300,6 +337,10 @@ const word32 CRC32C::m_tab[] = {
 
 std::string CRC32C::AlgorithmProvider() const
 {
+#if (CRYPTOPP_CLMUL_AVAILABLE)
+	if (HasCLMUL())
+		return "CLMUL";
+#endif
 #if (CRYPTOPP_ARM_CRC32_AVAILABLE)
 	if (HasCRC32())
 		return "ARMv8";
@@ -318,6 +359,22 @@ CRC32C::CRC32C()
 
 void CRC32C::Update(const byte *s, size_t n)
 {
+#if (CRYPTOPP_CLMUL_AVAILABLE)
+	if (HasCLMUL() && n >= CRC_FOLD_MINIMUM)
+	{
+		const size_t m = RoundDownToMultipleOf(n, size_t(16));
+		CRC32C_Update_CLMUL(s, m, m_crc);
+		s += m; n -= m;
+	}
+#elif (CRYPTOPP_ARM_PMULL_AVAILABLE)
+	if (HasPMULL() && n >= CRC_FOLD_MINIMUM)
+	{
+		const size_t m = RoundDownToMultipleOf(n, size_t(16));
+		CRC32C_Update_PMULL(s, m, m_crc);
+		s += m; n -= m;
+	}
+#endif
+
 #if (CRYPTOPP_SSE42_AVAILABLE)
 	if (HasSSE42())
 	{
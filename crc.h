@@ -22,6 +22,8 @@ const word32 CRC32_NEGL = 0xffffffffL;
 
 /// \brief CRC-32 Checksum Calculation
 /// \details Uses CRC polynomial 0xEDB88320
+/// \details Update() folds large buffers with carry-less multiplies
+///  when the CPU provides CLMUL or PMULL.
 class CRC32 : public HashTransformation
 {
 public:
@@ -48,6 +50,8 @@ private:
 
 /// \brief CRC-32C Checksum Calculation
 /// \details Uses CRC polynomial 0x82F63B78
+/// \details Update() folds large buffers with carry-less multiplies
+///  when the CPU provides CLMUL or PMULL.
 /// \since Crypto++ 5.6.4
 class CRC32C : public HashTransformation
 {
@@ -5,6 +5,13 @@
 //    ARMv8a CRC-32 and CRC-32C instructions. A separate source file
 //    is needed because additional CXXFLAGS are required to enable
 //    the appropriate instructions sets in some build configurations.
+//
+//    The CLMUL and PMULL code folds the message with carry-less
+//    multiplies as described by Gopal, Ozturk, Guilford, Wolrich,
+//    Feghali, Dixon and Karakoyunlu in "Fast CRC Computation for
+//    Generic Polynomials Using PCLMULQDQ Instruction". Four 128-bit
+//    accumulators are folded forward 64 bytes at a time, folded into
+//    one accumulator and reduced to 32 bits with a Barrett reduction.
 
 #include "pch.h"
 #include "config.h"
@@ -14,6 +21,11 @@
 # include <nmmintrin.h>
 #endif
 
+#if (CRYPTOPP_CLMUL_AVAILABLE)
+# include <emmintrin.h>
+# include <wmmintrin.h>
+#endif
+
 #if (CRYPTOPP_ARM_NEON_HEADER)
 # include <arm_neon.h>
 #endif
@@ -23,6 +35,10 @@
 # include <arm_acle.h>
 #endif
 
+#if (CRYPTOPP_ARM_PMULL_AVAILABLE)
+# include "arm_simd.h"
+#endif
+
 #ifdef CRYPTOPP_GNU_STYLE_INLINE_ASSEMBLY
 # include <signal.h>
 # include <setjmp.h>
@@ -35,6 +51,10 @@
 // Squash MS LNK4221 and libtool warnings
 extern const char CRC_SIMD_FNAME[] = __FILE__;
 
+// Clang intrinsic casts, http://bugs.llvm.org/show_bug.cgi?id=20670
+#define M128_CAST(x) ((__m128i *)(void *)(x))
+#define CONST_M128_CAST(x) ((const __m128i *)(const void *)(x))
+
 NAMESPACE_BEGIN(CryptoPP)
 
 #ifdef CRYPTOPP_GNU_STYLE_INLINE_ASSEMBLY
@@ -144,6 +164,176 @@ void CRC32C_Update_ARMV8(const byte *s, size_t n, word32& c)
 }
 #endif
 
+#if (CRYPTOPP_CLMUL_AVAILABLE) || (CRYPTOPP_ARM_PMULL_AVAILABLE)
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+// Folding constants for the bit-reflected polynomials. The pairs are
+// {x^(512+32), x^(512-32)} and {x^(128+32), x^(128-32)} mod P shifted
+// left by one, then x^64 mod P, and finally P and floor(x^64 / P).
+CRYPTOPP_ALIGN_DATA(16)
+const word64 CRC32_FOLD[8] = {
+    W64LIT(0x0154442bd4), W64LIT(0x01c6e41596),
+    W64LIT(0x01751997d0), W64LIT(0x00ccaa009e),
+    W64LIT(0x0163cd6124), W64LIT(0x0000000000),
+    W64LIT(0x01db710641), W64LIT(0x01f7011641)
+};
+
+CRYPTOPP_ALIGN_DATA(16)
+const word64 CRC32C_FOLD[8] = {
+    W64LIT(0x00740eef02), W64LIT(0x009e4addf8),
+    W64LIT(0x00f20c0dfe), W64LIT(0x014cd00bd6),
+    W64LIT(0x00dd45aab8), W64LIT(0x0000000000),
+    W64LIT(0x0105ec76f1), W64LIT(0x00dea713f1)
+};
+
+ANONYMOUS_NAMESPACE_END
+
+#endif  // CRYPTOPP_CLMUL_AVAILABLE or CRYPTOPP_ARM_PMULL_AVAILABLE
+
+#if (CRYPTOPP_ARM_PMULL_AVAILABLE)
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+inline uint64x2_t Load(const byte *s)
+{
+    return vreinterpretq_u64_u8(vld1q_u8(s));
+}
+
+// a*k.low ^ a*k.high, moving a forward by the distance of k
+inline uint64x2_t Fold(const uint64x2_t a, const uint64x2_t k)
+{
+    return veorq_u64(PMULL_00(a, k), PMULL_11(a, k));
+}
+
+// Shift right by bytes, like _mm_srli_si128
+template <unsigned int C>
+inline uint64x2_t ShiftRight(const uint64x2_t a)
+{
+    return vreinterpretq_u64_u8(vextq_u8(vreinterpretq_u8_u64(a), vdupq_n_u8(0), C));
+}
+
+// n is a multiple of 16 and at least 64
+word32 FoldCRC_PMULL(const byte *s, size_t n, word32 c, const word64 k[8])
+{
+    uint64x2_t x1 = Load(s+ 0), x2 = Load(s+16);
+    uint64x2_t x3 = Load(s+32), x4 = Load(s+48);
+    x1 = veorq_u64(x1, vreinterpretq_u64_u32(vsetq_lane_u32(c, vdupq_n_u32(0), 0)));
+    s += 64; n -= 64;
+
+    uint64x2_t x0 = vld1q_u64(k+0);
+    for (; n >= 64; s += 64, n -= 64)
+    {
+        x1 = veorq_u64(Fold(x1, x0), Load(s+ 0));
+        x2 = veorq_u64(Fold(x2, x0), Load(s+16));
+        x3 = veorq_u64(Fold(x3, x0), Load(s+32));
+        x4 = veorq_u64(Fold(x4, x0), Load(s+48));
+    }
+
+    x0 = vld1q_u64(k+2);
+    x1 = veorq_u64(Fold(x1, x0), x2);
+    x1 = veorq_u64(Fold(x1, x0), x3);
+    x1 = veorq_u64(Fold(x1, x0), x4);
+    for (; n >= 16; s += 16, n -= 16)
+        x1 = veorq_u64(Fold(x1, x0), Load(s));
+
+    // 128 bits to 64 bits
+    const uint64x2_t m = vdupq_n_u64(W64LIT(0xffffffff));
+    x1 = veorq_u64(ShiftRight<8>(x1), PMULL_10(x1, x0));
+    x0 = vld1q_u64(k+4);
+    x1 = veorq_u64(PMULL_00(vandq_u64(x1, m), x0), ShiftRight<4>(x1));
+
+    // Barrett reduction
+    x0 = vld1q_u64(k+6);
+    x2 = PMULL_10(vandq_u64(x1, m), x0);
+    x2 = PMULL_00(vandq_u64(x2, m), x0);
+    x1 = veorq_u64(x1, x2);
+
+    return vgetq_lane_u32(vreinterpretq_u32_u64(x1), 1);
+}
+
+ANONYMOUS_NAMESPACE_END
+
+void CRC32_Update_PMULL(const byte *s, size_t n, word32& c)
+{
+    c = FoldCRC_PMULL(s, n, c, CRC32_FOLD);
+}
+
+void CRC32C_Update_PMULL(const byte *s, size_t n, word32& c)
+{
+    c = FoldCRC_PMULL(s, n, c, CRC32C_FOLD);
+}
+#endif  // CRYPTOPP_ARM_PMULL_AVAILABLE
+
+#if (CRYPTOPP_CLMUL_AVAILABLE)
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+inline __m128i Load(const byte *s)
+{
+    return _mm_loadu_si128(CONST_M128_CAST(s));
+}
+
+// a*k.low ^ a*k.high, moving a forward by the distance of k
+inline __m128i Fold(const __m128i a, const __m128i k)
+{
+    return _mm_xor_si128(_mm_clmulepi64_si128(a, k, 0x00),
+                         _mm_clmulepi64_si128(a, k, 0x11));
+}
+
+// n is a multiple of 16 and at least 64
+word32 FoldCRC_CLMUL(const byte *s, size_t n, word32 c, const word64 k[8])
+{
+    __m128i x1 = Load(s+ 0), x2 = Load(s+16);
+    __m128i x3 = Load(s+32), x4 = Load(s+48);
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(c)));
+    s += 64; n -= 64;
+
+    __m128i x0 = _mm_load_si128(CONST_M128_CAST(k+0));
+    for (; n >= 64; s += 64, n -= 64)
+    {
+        x1 = _mm_xor_si128(Fold(x1, x0), Load(s+ 0));
+        x2 = _mm_xor_si128(Fold(x2, x0), Load(s+16));
+        x3 = _mm_xor_si128(Fold(x3, x0), Load(s+32));
+        x4 = _mm_xor_si128(Fold(x4, x0), Load(s+48));
+    }
+
+    x0 = _mm_load_si128(CONST_M128_CAST(k+2));
+    x1 = _mm_xor_si128(Fold(x1, x0), x2);
+    x1 = _mm_xor_si128(Fold(x1, x0), x3);
+    x1 = _mm_xor_si128(Fold(x1, x0), x4);
+    for (; n >= 16; s += 16, n -= 16)
+        x1 = _mm_xor_si128(Fold(x1, x0), Load(s));
+
+    // 128 bits to 64 bits
+    const __m128i m = _mm_set_epi32(0, -1, 0, -1);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), _mm_clmulepi64_si128(x1, x0, 0x10));
+    x0 = _mm_load_si128(CONST_M128_CAST(k+4));
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, m), x0, 0x00),
+                       _mm_srli_si128(x1, 4));
+
+    // Barrett reduction
+    x0 = _mm_load_si128(CONST_M128_CAST(k+6));
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, m), x0, 0x10);
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, m), x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return static_cast<word32>(_mm_cvtsi128_si32(_mm_srli_si128(x1, 4)));
+}
+
+ANONYMOUS_NAMESPACE_END
+
+void CRC32_Update_CLMUL(const byte *s, size_t n, word32& c)
+{
+    c = FoldCRC_CLMUL(s, n, c, CRC32_FOLD);
+}
+
+void CRC32C_Update_CLMUL(const byte *s, size_t n, word32& c)
+{
+    c = FoldCRC_CLMUL(s, n, c, CRC32C_FOLD);
+}
+#endif  // CRYPTOPP_CLMUL_AVAILABLE
+
 #if (CRYPTOPP_SSE42_AVAILABLE)
 void CRC32C_Update_SSE42(const byte *s, size_t n, word32& c)
 {
@@ -472,6 +472,35 @@ size_t BufferedTransformation::ChannelPut2(const std::string &channel, const byt
 	return size;
 }
 
+size_t BufferedTransformation::Put2V(const ConstByteSpan *spans, size_t count, int messageEnd, bool blocking)
+{
+	if (!blocking)
+		throw BlockingInputOnly(AlgorithmName());
+
+	if (count == 0)
+		return Put2(NULLPTR, 0, messageEnd, blocking);
+
+	for (size_t i=0; i<count; i++)
+		Put2(spans[i].data, spans[i].size, i+1 == count ? messageEnd : 0, blocking);
+	return 0;
+}
+
+size_t BufferedTransformation::ChannelPut2V(const std::string &channel, const ConstByteSpan *spans, size_t count, int messageEnd, bool blocking)
+{
+	if (channel.empty())
+		return Put2V(spans, count, messageEnd, blocking);
+
+	if (!blocking)
+		throw BlockingInputOnly(AlgorithmName());
+
+	if (count == 0)
+		return ChannelPut2(channel, NULLPTR, 0, messageEnd, blocking);
+
+	for (size_t i=0; i<count; i++)
+		ChannelPut2(channel, spans[i].data, spans[i].size, i+1 == count ? messageEnd : 0, blocking);
+	return 0;
+}
+
 size_t BufferedTransformation::ChannelPutModifiable2(const std::string &channel, byte *inString, size_t length, int messageEnd, bool blocking)
 {
 	size_t size = 0;
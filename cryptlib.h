@@ -1604,6 +1604,19 @@ public:
 	bool Wait(unsigned long milliseconds, CallStack const& callStack);
 };
 
+/// \brief Pointer and length of one fragment of vectored input
+/// \details An array of ConstByteSpan describes a scatter-gather buffer. It is
+///  passed to BufferedTransformation::PutV() and ChannelPutV(), which process
+///  the fragments in order as if they were one contiguous buffer.
+/// \since Crypto++ 8.3
+struct ConstByteSpan
+{
+	/// \brief Pointer to the fragment
+	const byte *data;
+	/// \brief Size of the fragment, in bytes
+	size_t size;
+};
+
 /// \brief Interface for buffered transformations
 /// \details BufferedTransformation is a generalization of BlockTransformation,
 ///  StreamTransformation and HashTransformation.
@@ -1757,6 +1770,33 @@ public:
 		virtual size_t PutModifiable2(byte *inString, size_t length, int messageEnd, bool blocking)
 			{return Put2(inString, length, messageEnd, blocking);}
 
+		/// \brief Input a scatter-gather buffer for processing
+		/// \param spans the fragments to process, in order
+		/// \param count the number of fragments
+		/// \param blocking specifies whether the object should block when processing input
+		/// \return the number of bytes that remain to be processed (i.e., bytes not processed).
+		///  0 indicates all bytes were processed.
+		/// \details Internally, PutV() calls Put2V().
+		/// \since Crypto++ 8.3
+		size_t PutV(const ConstByteSpan *spans, size_t count, bool blocking=true)
+			{return Put2V(spans, count, 0, blocking);}
+
+		/// \brief Input a scatter-gather buffer for processing
+		/// \param spans the fragments to process, in order
+		/// \param count the number of fragments
+		/// \param messageEnd means how many filters to signal MessageEnd() to, including this one
+		/// \param blocking specifies whether the object should block when processing input
+		/// \return the number of bytes that remain to be processed (i.e., bytes not processed).
+		///  0 indicates all bytes were processed.
+		/// \details The result is the same as calling Put2() on each fragment, with messageEnd
+		///  passed along with the last one. The base class implementation does exactly that.
+		///  ByteQueue, HashFilter and FilterWithBufferedInput process the fragments in
+		///  place without joining them first.
+		/// \details Vectored input is blocking only. The base class implementation throws
+		///  BlockingInputOnly if blocking is false.
+		/// \since Crypto++ 8.3
+		virtual size_t Put2V(const ConstByteSpan *spans, size_t count, int messageEnd, bool blocking);
+
 		/// \brief Exception thrown by objects that have \a not implemented nonblocking input processing
 		/// \details BlockingInputOnly inherits from NotImplemented
 		struct BlockingInputOnly : public NotImplemented
@@ -2189,6 +2229,17 @@ public:
 		size_t ChannelPutModifiable(const std::string &channel, byte *inString, size_t length, bool blocking=true)
 			{return ChannelPutModifiable2(channel, inString, length, 0, blocking);}
 
+		/// \brief Input a scatter-gather buffer for processing on a channel
+		/// \param channel the channel to process the data
+		/// \param spans the fragments to process, in order
+		/// \param count the number of fragments
+		/// \param blocking specifies whether the object should block when processing input
+		/// \return 0 indicates all bytes were processed during the call. Non-0 indicates the
+		///  number of bytes that were not processed.
+		/// \since Crypto++ 8.3
+		size_t ChannelPutV(const std::string &channel, const ConstByteSpan *spans, size_t count, bool blocking=true)
+			{return ChannelPut2V(channel, spans, count, 0, blocking);}
+
 		/// \brief Input a 16-bit word for processing on a channel.
 		/// \param channel the channel to process the data.
 		/// \param value the 16-bit value to be processed.
@@ -2270,6 +2321,18 @@ public:
 		/// \return the number of bytes that remain to be processed (i.e., bytes not processed)
 		virtual size_t ChannelPutModifiable2(const std::string &channel, byte *inString, size_t length, int messageEnd, bool blocking);
 
+		/// \brief Input a scatter-gather buffer for processing on a channel
+		/// \param channel the channel to process the data
+		/// \param spans the fragments to process, in order
+		/// \param count the number of fragments
+		/// \param messageEnd means how many filters to signal MessageEnd() to, including this one
+		/// \param blocking specifies whether the object should block when processing input
+		/// \return the number of bytes that remain to be processed (i.e., bytes not processed)
+		/// \details The base class implementation calls Put2V() for the default channel, and
+		///  ChannelPut2() on each fragment otherwise.
+		/// \since Crypto++ 8.3
+		virtual size_t ChannelPut2V(const std::string &channel, const ConstByteSpan *spans, size_t count, int messageEnd, bool blocking);
+
 		/// \brief Flush buffered input and/or output on a channel
 		/// \param channel the channel to flush the data
 		/// \param hardFlush is used to indicate whether all data should be flushed
@@ -704,6 +704,32 @@ void TestAuthenticatedSymmetricCipher(TestData &v, const NameValuePairs &overrid
 			std::cout << "\nMAC incorrectly verified\n";
 			SignalTestFailure();
 		}
+
+		// EncryptAndAuthenticate and DecryptAndVerify take the whole message
+		ConstByteArrayParameter iv;
+		if (test == "Encrypt" && footer.empty() && pairs.GetValue(Name::IV(), iv))
+		{
+			const std::string expected = ciphertext+mac;
+			const size_t macSize = encryptor->DigestSize();
+			std::string encrypted2(plaintext.size(), '\0'), decrypted2(plaintext.size(), '\0');
+			SecByteBlock tag(macSize);
+
+			encryptor->EncryptAndAuthenticate(BytePtr(encrypted2), tag, macSize, iv.begin(), (int)iv.size(),
+				ConstBytePtr(header), BytePtrSize(header), ConstBytePtr(plaintext), BytePtrSize(plaintext));
+			if (encrypted2+std::string((const char*)tag.begin(), tag.size()) != expected)
+			{
+				std::cout << "\nEncryptAndAuthenticate failed\n";
+				SignalTestFailure();
+			}
+
+			const bool verified = decryptor->DecryptAndVerify(BytePtr(decrypted2), ConstBytePtr(expected)+plaintext.size(), macSize,
+				iv.begin(), (int)iv.size(), ConstBytePtr(header), BytePtrSize(header), ConstBytePtr(expected), plaintext.size());
+			if (!verified || decrypted2 != plaintext)
+			{
+				std::cout << "\nDecryptAndVerify failed\n";
+				SignalTestFailure();
+			}
+		}
 	}
 	else
 	{
@@ -1508,6 +1508,293 @@ ge25519_scalarmult_base_niels(ge25519 *r, const byte basepoint_table[256][96], c
     }
 }
 
+
+/* helpers for batch verification, are allowed to be vartime */
+
+/* out = a - b, a must be larger than b */
+void
+sub256_modm_batch(bignum256modm out, const bignum256modm a, const bignum256modm b, size_t limbsize) {
+    size_t i = 0;
+    bignum256modm_element_t carry = 0;
+    for (; i < limbsize; i++) {
+        out[i] = (a[i] - b[i]) - carry;
+        carry = (out[i] >> 63);
+        out[i] &= 0xffffffffffffff;
+    }
+    out[i] = (a[i] - b[i]) - carry;
+}
+
+/* is a < b */
+int
+lt256_modm_batch(const bignum256modm a, const bignum256modm b, size_t limbsize) {
+    bignum256modm_element_t t, carry = 0;
+    for (size_t i = 0; i <= limbsize; i++) {
+        t = (a[i] - b[i]) - carry;
+        carry = (t >> 63);
+    }
+    return (int)carry;
+}
+
+/* is a <= b */
+int
+lte256_modm_batch(const bignum256modm a, const bignum256modm b, size_t limbsize) {
+    bignum256modm_element_t t, carry = 0;
+    for (size_t i = 0; i <= limbsize; i++) {
+        t = (b[i] - a[i]) - carry;
+        carry = (t >> 63);
+    }
+    return (int)!carry;
+}
+
+/* is a == 0 */
+int
+iszero256_modm_batch(const bignum256modm a) {
+    for (size_t i = 0; i < bignum256modm_limb_size; i++) {
+        if (a[i])
+            return 0;
+    }
+    return 1;
+}
+
+/* is a == 1 */
+int
+isone256_modm_batch(const bignum256modm a) {
+    for (size_t i = 0; i < bignum256modm_limb_size; i++) {
+        if (a[i] != ((i) ? 0 : 1))
+            return 0;
+    }
+    return 1;
+}
+
+/* can a fit in to (at most) 128 bits */
+int
+isatmost128bits256_modm_batch(const bignum256modm a) {
+    word64 mask =
+        ((a[4]                   )  |
+         (a[3]                   )  |
+         (a[2] & 0xffffffffff0000));
+
+    return (mask == 0);
+}
+
+/* is the encoding of a point canonical, y < p and x = 0 has no sign */
+int
+ge25519_is_canonical_vartime(const byte p[32]) {
+    size_t i;
+    int high = ((p[31] & 0x7f) == 0x7f), one = (p[0] == 1);
+    for (i = 1; i < 31; i++) {
+        high &= (p[i] == 0xff);
+        one &= (p[i] == 0);
+    }
+    one &= ((p[31] & 0x7f) == 0);
+
+    /* y >= 2^255 - 19 */
+    if (high && p[0] >= 0xed)
+        return 0;
+
+    /* x = 0 when y = 1 or y = -1, so the sign bit must be clear */
+    if ((p[31] & 0x80) && (one || (high && p[0] == 0xec)))
+        return 0;
+    return 1;
+}
+
+int
+ge25519_is_neutral_vartime(const ge25519 *p) {
+    const byte zero[32] = {0};
+    byte point_buffer[3][32];
+    curve25519_contract(point_buffer[0], p->x);
+    curve25519_contract(point_buffer[1], p->y);
+    curve25519_contract(point_buffer[2], p->z);
+    return (memcmp(point_buffer[0], zero, 32) == 0) &&
+           (memcmp(point_buffer[1], point_buffer[2], 32) == 0);
+}
+
+/* Bos-Coster multi-scalar multiplication from ed25519-donna's batch */
+/* verification. The heap keeps the scalars ordered so the largest   */
+/* two can be found quickly. [a]P + [b]Q = [a-b]P + [b](P+Q)          */
+
+const size_t max_batch_size = 64;
+const size_t heap_batch_size = (max_batch_size * 2) + 1;
+
+typedef size_t heap_index_t;
+
+struct batch_heap {
+    byte r[heap_batch_size][16]; /* 128 bit random values */
+    ge25519 points[heap_batch_size];
+    bignum256modm scalars[heap_batch_size];
+    heap_index_t heap[heap_batch_size];
+    size_t size;
+};
+
+/* swap two values in the heap */
+void
+heap_swap(heap_index_t *heap, size_t a, size_t b) {
+    heap_index_t temp;
+    temp = heap[a];
+    heap[a] = heap[b];
+    heap[b] = temp;
+}
+
+/* add the scalar at the end of the list to the heap */
+void
+heap_insert_next(batch_heap *heap) {
+    size_t node = heap->size, parent;
+    heap_index_t *pheap = heap->heap;
+    bignum256modm *scalars = heap->scalars;
+
+    /* insert at the bottom */
+    pheap[node] = (heap_index_t)node;
+
+    /* sift node up to its sorted spot */
+    parent = (node - 1) / 2;
+    while (node && lt256_modm_batch(scalars[pheap[parent]], scalars[pheap[node]], bignum256modm_limb_size - 1)) {
+        heap_swap(pheap, parent, node);
+        node = parent;
+        parent = (node - 1) / 2;
+    }
+    heap->size++;
+}
+
+/* update the heap when the root element is updated */
+void
+heap_updated_root(batch_heap *heap, size_t limbsize) {
+    size_t node, parent, childr, childl;
+    heap_index_t *pheap = heap->heap;
+    bignum256modm *scalars = heap->scalars;
+
+    /* sift root to the bottom */
+    parent = 0;
+    node = 1;
+    childl = 1;
+    childr = 2;
+    while ((childr < heap->size)) {
+        node = lt256_modm_batch(scalars[pheap[childl]], scalars[pheap[childr]], limbsize) ? childr : childl;
+        heap_swap(pheap, parent, node);
+        parent = node;
+        childl = (parent * 2) + 1;
+        childr = childl + 1;
+    }
+
+    /* sift root back up to its sorted spot */
+    parent = (node - 1) / 2;
+    while (node && lte256_modm_batch(scalars[pheap[parent]], scalars[pheap[node]], limbsize)) {
+        heap_swap(pheap, parent, node);
+        node = parent;
+        parent = (node - 1) / 2;
+    }
+}
+
+/* build the heap with count elements, count must be >= 3 */
+void
+heap_build(batch_heap *heap, size_t count) {
+    heap->heap[0] = 0;
+    heap->size = 0;
+    while (heap->size < count)
+        heap_insert_next(heap);
+}
+
+/* extend the heap to contain new_count elements */
+void
+heap_extend(batch_heap *heap, size_t new_count) {
+    while (heap->size < new_count)
+        heap_insert_next(heap);
+}
+
+/* get the top 2 elements of the heap */
+void
+heap_get_top2(batch_heap *heap, heap_index_t *max1, heap_index_t *max2, size_t limbsize) {
+    heap_index_t h0 = heap->heap[0], h1 = heap->heap[1], h2 = heap->heap[2];
+    if (lt256_modm_batch(heap->scalars[h1], heap->scalars[h2], limbsize))
+        h1 = h2;
+    *max1 = h0;
+    *max2 = h1;
+}
+
+/* computes [scalar]point with double and add for the last scalar */
+void
+ge25519_multi_scalarmult_vartime_final(ge25519 *r, const ge25519 *point, const bignum256modm scalar) {
+    const bignum256modm_element_t topbit = ((bignum256modm_element_t)1 << (bignum256modm_bits_per_limb - 1));
+    size_t limb = bignum256modm_limb_size - 1;
+    bignum256modm_element_t flag;
+
+    if (isone256_modm_batch(scalar)) {
+        /* this will happen most of the time after bos-coster */
+        *r = *point;
+        return;
+    } else if (iszero256_modm_batch(scalar)) {
+        /* this will only happen if all scalars == 0 */
+        memset(r, 0, sizeof(*r));
+        r->y[0] = 1;
+        r->z[0] = 1;
+        return;
+    }
+
+    *r = *point;
+
+    /* find the limb where first bit is set */
+    while (!scalar[limb])
+        limb--;
+
+    /* find the first bit */
+    flag = topbit;
+    while ((scalar[limb] & flag) == 0)
+        flag >>= 1;
+
+    /* exponentiate */
+    for (;;) {
+        flag >>= 1;
+        if (!flag) {
+            if (!limb--)
+                break;
+            flag = topbit;
+        }
+
+        ge25519_double(r, r);
+        if (scalar[limb] & flag)
+            ge25519_add(r, r, point);
+    }
+}
+
+/* computes [s0]p0 + [s1]p1 + ... using the heap, count must be >= 5 */
+void
+ge25519_multi_scalarmult_vartime(ge25519 *r, batch_heap *heap, size_t count) {
+    heap_index_t max1, max2;
+
+    /* start with the full limb size */
+    size_t limbsize = bignum256modm_limb_size - 1;
+
+    /* whether the heap has been extended to include the 128 bit scalars */
+    int extended = 0;
+
+    /* grab an odd number of scalars to build the heap, unknown limb sizes */
+    heap_build(heap, ((count + 1) / 2) | 1);
+
+    for (;;) {
+        heap_get_top2(heap, &max1, &max2, limbsize);
+
+        /* only one scalar remaining, we're done */
+        if (iszero256_modm_batch(heap->scalars[max2]))
+            break;
+
+        /* exhausted another limb? */
+        if (!heap->scalars[max1][limbsize])
+            limbsize -= 1;
+
+        /* can we extend to the 128 bit scalars? */
+        if (!extended && isatmost128bits256_modm_batch(heap->scalars[max1])) {
+            heap_extend(heap, count);
+            heap_get_top2(heap, &max1, &max2, limbsize);
+            extended = 1;
+        }
+
+        sub256_modm_batch(heap->scalars[max1], heap->scalars[max1], heap->scalars[max2], limbsize);
+        ge25519_add(&heap->points[max2], &heap->points[max2], &heap->points[max1]);
+        heap_updated_root(heap, limbsize);
+    }
+
+    ge25519_multi_scalarmult_vartime_final(r, &heap->points[max1], heap->scalars[max1]);
+}
+
 ANONYMOUS_NAMESPACE_END
 NAMESPACE_END  // Ed25519
 NAMESPACE_END  // Donna
@@ -1797,6 +2084,91 @@ ed25519_sign_open_CXX(std::istream& stream, const byte pk[32], const byte RS[64]
     return ed25519_verify(RS, checkR, 32) ? 0 : -1;
 }
 
+int
+ed25519_sign_open_batch_CXX(RandomNumberGenerator &rng, const byte *const *m, const size_t *mlen,
+                            const byte *const *pk, const byte *const *RS, size_t num, bool *valid) {
+
+    using namespace CryptoPP::Donna::Ed25519;
+
+    ALIGN(ALIGN_SPEC) batch_heap batch;
+    ALIGN(ALIGN_SPEC) ge25519 p;
+    bignum256modm *r_scalars;
+    hash_512bits hram;
+    size_t i, batchsize;
+    int ret = 0;
+
+    for (i = 0; i < num; i++)
+        valid[i] = true;
+
+    while (num > 3) {
+        batchsize = (num > max_batch_size) ? max_batch_size : num;
+        int fallback = 0;
+
+        /* the batch must not accept what ed25519_sign_open_CXX rejects, */
+        /* so S must be less than 2^253 and R must be canonical          */
+        for (i = 0; i < batchsize && !fallback; i++)
+            fallback = (RS[i][63] & 224) || !ge25519_is_canonical_vartime(RS[i]);
+
+        if (!fallback) {
+            /* generate r (scalars[batchsize+1]..scalars[2*batchsize] */
+            rng.GenerateBlock(batch.r[0], batchsize * 16);
+            r_scalars = &batch.scalars[batchsize + 1];
+            for (i = 0; i < batchsize; i++)
+                expand256_modm(r_scalars[i], batch.r[i], 16);
+
+            /* compute scalars[0] = ((r1s1 + r2s2 + ...)) */
+            for (i = 0; i < batchsize; i++) {
+                expand256_modm(batch.scalars[i], RS[i] + 32, 32);
+                mul256_modm(batch.scalars[i], batch.scalars[i], r_scalars[i]);
+            }
+            for (i = 1; i < batchsize; i++)
+                add256_modm(batch.scalars[0], batch.scalars[0], batch.scalars[i]);
+
+            /* compute scalars[1]..scalars[batchsize] as r[i]*H(R[i],A[i],m[i]) */
+            for (i = 0; i < batchsize; i++) {
+                ed25519_hram(hram, RS[i], pk[i], m[i], mlen[i]);
+                expand256_modm(batch.scalars[i+1], hram, 64);
+                mul256_modm(batch.scalars[i+1], batch.scalars[i+1], r_scalars[i]);
+            }
+
+            /* compute points */
+            batch.points[0] = ge25519_basepoint;
+            for (i = 0; i < batchsize && !fallback; i++)
+                fallback = !ge25519_unpack_negative_vartime(&batch.points[i+1], pk[i]);
+            for (i = 0; i < batchsize && !fallback; i++)
+                fallback = !ge25519_unpack_negative_vartime(&batch.points[batchsize+i+1], RS[i]);
+        }
+
+        /* check that (r1s1 + r2s2 + ...)B - r1H1A1 - r1R1 - r2H2A2 - r2R2 - ... = 0 */
+        if (!fallback) {
+            ge25519_multi_scalarmult_vartime(&p, &batch, (batchsize * 2) + 1);
+            fallback = !ge25519_is_neutral_vartime(&p);
+        }
+
+        /* verify one at a time to find the bad signatures */
+        if (fallback) {
+            for (i = 0; i < batchsize; i++) {
+                valid[i] = ed25519_sign_open_CXX(m[i], mlen[i], pk[i], RS[i]) == 0;
+                ret |= !valid[i];
+            }
+        }
+
+        m += batchsize;
+        mlen += batchsize;
+        pk += batchsize;
+        RS += batchsize;
+        num -= batchsize;
+        valid += batchsize;
+    }
+
+    for (i = 0; i < num; i++) {
+        valid[i] = ed25519_sign_open_CXX(m[i], mlen[i], pk[i], RS[i]) == 0;
+        ret |= !valid[i];
+    }
+
+    return ret ? -1 : 0;
+}
+
 int
 ed25519_sign_open(std::istream& stream, const byte publicKey[32], const byte signature[64])
 {
@@ -1809,6 +2181,13 @@ ed25519_sign_open(const byte *message, size_t messageLength, const byte publicKe
     return ed25519_sign_open_CXX(message, messageLength, publicKey, signature);
 }
 
+int
+ed25519_sign_open_batch(RandomNumberGenerator &rng, const byte *const messages[], const size_t messageLengths[],
+                        const byte *const publicKeys[], const byte *const signatures[], size_t count, bool valid[])
+{
+    return ed25519_sign_open_batch_CXX(rng, messages, messageLengths, publicKeys, signatures, count, valid);
+}
+
 NAMESPACE_END  // Donna
 NAMESPACE_END  // CryptoPP
 
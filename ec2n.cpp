@@ -259,6 +259,78 @@ const EC2N::Point& EC2N::Double(const Point &P) const
 	return m_R;
 }
 
+void EC2N::AccumulateBatch(Point *const *a, const Point *const *b, size_t count) const
+{
+	// Each affine addition needs the inverse of x1+x2, or x for a
+	// doubling. Collect the denominators and invert them together.
+	const Field &field = *m_field;
+	std::vector<size_t> index;
+	std::vector<FieldElement> num, den;
+	index.reserve(count); num.reserve(count); den.reserve(count);
+
+	size_t i;
+	for (i=0; i<count; i++)
+	{
+		Point &P = *a[i];
+		const Point &Q = *b[i];
+
+		if (Q.identity)
+			continue;
+		if (P.identity)
+		{
+			P = Q;
+			continue;
+		}
+
+		if (field.Equal(P.x, Q.x))
+		{
+			if (!field.Equal(P.y, Q.y) || !field.IsUnit(P.x))
+			{
+				P = Identity();
+				continue;
+			}
+
+			// lambda = x + y/x
+			num.push_back(P.y);
+			den.push_back(P.x);
+		}
+		else
+		{
+			// lambda = (y1 + y2) / (x1 + x2)
+			num.push_back(field.Add(P.y, Q.y));
+			den.push_back(field.Add(P.x, Q.x));
+		}
+		index.push_back(i);
+	}
+
+	ParallelInvert(field, den.begin(), den.end());
+
+	for (i=0; i<index.size(); i++)
+	{
+		Point &P = *a[index[i]];
+		const Point &Q = *b[index[i]];
+
+		FieldElement t = field.Multiply(num[i], den[i]);
+		if (field.Equal(P.x, Q.x))
+			field.Accumulate(t, P.x);
+
+		// x3 = t^2 + t + x1 + x2 + a, y3 = t*(x1 + x3) + x3 + y1
+		FieldElement x = field.Square(t);
+		field.Accumulate(x, t);
+		field.Accumulate(x, P.x);
+		field.Accumulate(x, Q.x);
+		field.Accumulate(x, m_a);
+
+		FieldElement y = field.Add(P.x, x);
+		y = field.Multiply(t, y);
+		field.Accumulate(y, x);
+		field.Accumulate(y, P.y);
+
+		P.x.swap(x);
+		P.y.swap(y);
+	}
+}
+
 // ********************************************************
 
 #if 0
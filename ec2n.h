@@ -57,6 +57,7 @@ public:
 	bool InversionIsFast() const {return true;}
 	const Point& Add(const Point &P, const Point &Q) const;
 	const Point& Double(const Point &P) const;
+	void AccumulateBatch(Point *const *a, const Point *const *b, size_t count) const;
 
 	Point Multiply(const Integer &k, const Point &P) const
 		{return ScalarMultiply(P, k);}
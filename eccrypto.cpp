@@ -85,6 +85,19 @@ inline bool CheckMOVCondition(const Integer &q, const Integer &r)
 	}
 	return true;
 }
+
+// The dedicated arithmetic has its own table for the generator, and
+// is faster than the generic precomputation
+inline bool HasDedicatedArithmetic(const ECP &ec)
+{
+	return ec.HasDedicatedArithmetic();
+}
+
+inline bool HasDedicatedArithmetic(const EC2N &ec)
+{
+	CRYPTOPP_UNUSED(ec);
+	return false;
+}
 ANONYMOUS_NAMESPACE_END
 
 // ******************************************************************
@@ -591,6 +604,15 @@ void DL_GroupParameters_EC<EC>::DEREncode(BufferedTransformation &bt) const
 	}
 }
 
+template <class EC>
+bool DL_GroupParameters_EC<EC>::GetPrecomputationKey(std::string &key) const
+{
+	// A named curve is keyed by its OID, other curves by their parameters
+	StringSink sink(key);
+	DEREncode(sink);
+	return true;
+}
+
 template <class EC>
 Integer DL_GroupParameters_EC<EC>::GetCofactor() const
 {
@@ -662,6 +684,24 @@ bool DL_GroupParameters_EC<EC>::ValidateElement(unsigned int level, const Elemen
 	return pass;
 }
 
+template <class EC>
+typename DL_GroupParameters_EC<EC>::Element DL_GroupParameters_EC<EC>::ExponentiateBase(const Integer &exponent) const
+{
+	if (HasDedicatedArithmetic(GetCurve()))
+		return GetCurve().ScalarMultiply(this->GetSubgroupGenerator(), exponent);
+	return DL_GroupParametersImpl<EcPrecomputation<EC> >::ExponentiateBase(exponent);
+}
+
+template <class EC>
+void DL_GroupParameters_EC<EC>::Precompute(unsigned int precomputationStorage)
+{
+	// ExponentiateBase() never reads the table, so neither compute
+	// it nor add it to the cache
+	if (HasDedicatedArithmetic(GetCurve()))
+		return;
+	DL_GroupParametersImpl<EcPrecomputation<EC> >::Precompute(precomputationStorage);
+}
+
 template <class EC>
 void DL_GroupParameters_EC<EC>::SimultaneousExponentiate(Element *results, const Element &base, const Integer *exponents, unsigned int exponentsCount) const
 {
@@ -695,6 +735,24 @@ std::ostream& operator<<(std::ostream& os, const DL_GroupParameters_EC<ECP>::Ele
 
 // ******************************************************************
 
+template <class EC>
+typename DL_PublicKey_EC<EC>::Element DL_PublicKey_EC<EC>::ExponentiatePublicElement(const Integer &exponent) const
+{
+	const DL_GroupParameters_EC<EC> &params = this->GetGroupParameters();
+	if (HasDedicatedArithmetic(params.GetCurve()))
+		return params.GetCurve().ScalarMultiply(this->GetPublicElement(), exponent);
+	return DL_PublicKeyImpl<DL_GroupParameters_EC<EC> >::ExponentiatePublicElement(exponent);
+}
+
+template <class EC>
+typename DL_PublicKey_EC<EC>::Element DL_PublicKey_EC<EC>::CascadeExponentiateBaseAndPublicElement(const Integer &baseExp, const Integer &publicExp) const
+{
+	const DL_GroupParameters_EC<EC> &params = this->GetGroupParameters();
+	if (HasDedicatedArithmetic(params.GetCurve()))
+		return params.GetCurve().CascadeScalarMultiply(params.GetSubgroupGenerator(), baseExp, this->GetPublicElement(), publicExp);
+	return DL_PublicKeyImpl<DL_GroupParameters_EC<EC> >::CascadeExponentiateBaseAndPublicElement(baseExp, publicExp);
+}
+
 template <class EC>
 void DL_PublicKey_EC<EC>::BERDecodePublicKey(BufferedTransformation &bt, bool parametersPresent, size_t size)
 {
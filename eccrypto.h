@@ -131,7 +131,10 @@ public:
 	Integer ConvertElementToInteger(const Element &element) const;
 	Integer GetMaxExponent() const {return GetSubgroupOrder()-1;}
 	bool IsIdentity(const Element &element) const {return element.identity;}
+	Element ExponentiateBase(const Integer &exponent) const;
 	void SimultaneousExponentiate(Element *results, const Element &base, const Integer *exponents, unsigned int exponentsCount) const;
+	// Does nothing for curves with dedicated arithmetic, which do not use the table
+	void Precompute(unsigned int precomputationStorage=16);
 	static std::string CRYPTOPP_API StaticAlgorithmNamePrefix() {return "EC";}
 
 	// ASN1Key
@@ -163,6 +166,7 @@ public:
 protected:
 	unsigned int FieldElementLength() const {return GetCurve().GetField().MaxElementByteLength();}
 	unsigned int ExponentLength() const {return m_n.ByteCount();}
+	bool GetPrecomputationKey(std::string &key) const;
 
 	OID m_oid;			// set if parameters loaded from a recommended curve
 	Integer m_n;		// order of base point
@@ -198,6 +202,10 @@ public:
 	void Initialize(const EC &ec, const Element &G, const Integer &n, const Element &Q)
 		{this->AccessGroupParameters().Initialize(ec, G, n); this->SetPublicElement(Q);}
 
+	// DL_PublicKey
+	Element ExponentiatePublicElement(const Integer &exponent) const;
+	Element CascadeExponentiateBaseAndPublicElement(const Integer &baseExp, const Integer &publicExp) const;
+
 	// X509PublicKey
 	void BERDecodePublicKey(BufferedTransformation &bt, bool parametersPresent, size_t size);
 	void DEREncodePublicKey(BufferedTransformation &bt) const;
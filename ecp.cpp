@@ -10,6 +10,7 @@
 #include "nbtheory.h"
 #include "modarith.h"
 #include "filters.h"
+#include "nistp.h"
 #include "algebra.cpp"
 
 ANONYMOUS_NAMESPACE_BEGIN
@@ -543,19 +544,21 @@ ANONYMOUS_NAMESPACE_END
 NAMESPACE_BEGIN(CryptoPP)
 
 ECP::ECP(const ECP &ecp, bool convertToMontgomeryRepresentation)
+	: m_dedicated(0)
 {
 	if (convertToMontgomeryRepresentation && !ecp.GetField().IsMontgomeryRepresentation())
 	{
 		m_fieldPtr.reset(new MontgomeryRepresentation(ecp.GetField().GetModulus()));
 		m_a = GetField().ConvertIn(ecp.m_a);
 		m_b = GetField().ConvertIn(ecp.m_b);
+		m_dedicated = ecp.m_dedicated;
 	}
 	else
 		operator=(ecp);
 }
 
 ECP::ECP(BufferedTransformation &bt)
-	: m_fieldPtr(new Field(bt))
+	: m_fieldPtr(new Field(bt)), m_dedicated(0)
 {
 	BERSequenceDecoder seq(bt);
 	GetField().BERDecodeElement(seq, m_a);
@@ -568,6 +571,14 @@ ECP::ECP(BufferedTransformation &bt)
 		BERDecodeBitString(seq, seed, unused);
 	}
 	seq.MessageEnd();
+
+	m_dedicated = DedicatedCurve();
+}
+
+unsigned int ECP::DedicatedCurve() const
+{
+	const Field &field = GetField();
+	return NISTP::IdentifyCurve(field.GetModulus(), field.ConvertOut(m_a), field.ConvertOut(m_b));
 }
 
 void ECP::DEREncode(BufferedTransformation &bt) const
@@ -752,43 +763,6 @@ const ECP::Point& ECP::Double(const Point &P) const
 	return (m_R = add(P));
 }
 
-template <class T, class Iterator> void ParallelInvert(const AbstractRing<T> &ring, Iterator begin, Iterator end)
-{
-	size_t n = end-begin;
-	if (n == 1)
-		*begin = ring.MultiplicativeInverse(*begin);
-	else if (n > 1)
-	{
-		std::vector<T> vec((n+1)/2);
-		unsigned int i;
-		Iterator it;
-
-		for (i=0, it=begin; i<n/2; i++, it+=2)
-			vec[i] = ring.Multiply(*it, *(it+1));
-		if (n%2 == 1)
-			vec[n/2] = *it;
-
-		ParallelInvert(ring, vec.begin(), vec.end());
-
-		for (i=0, it=begin; i<n/2; i++, it+=2)
-		{
-			if (!vec[i])
-			{
-				*it = ring.MultiplicativeInverse(*it);
-				*(it+1) = ring.MultiplicativeInverse(*(it+1));
-			}
-			else
-			{
-				std::swap(*it, *(it+1));
-				*it = ring.Multiply(*it, vec[i]);
-				*(it+1) = ring.Multiply(*(it+1), vec[i]);
-			}
-		}
-		if (n%2 == 1)
-			*it = vec[n/2];
-	}
-}
-
 class ProjectiveDoubling
 {
 public:
@@ -846,6 +820,14 @@ struct ZIterator
 
 ECP::Point ECP::ScalarMultiply(const Point &P, const Integer &k) const
 {
+	if (m_dedicated)
+	{
+		const ModularArithmetic &field = GetField();
+		if (field.IsMontgomeryRepresentation())
+			return ToMontgomery(field, NISTP::ScalarMultiply(m_dedicated, FromMontgomery(field, P), k));
+		return NISTP::ScalarMultiply(m_dedicated, P, k);
+	}
+
 	Element result;
 	if (k.BitCount() <= 5)
 		AbstractGroup<ECPPoint>::SimultaneousMultiply(&result, P, &k, 1);
@@ -856,6 +838,13 @@ ECP::Point ECP::ScalarMultiply(const Point &P, const Integer &k) const
 
 void ECP::SimultaneousMultiply(ECP::Point *results, const ECP::Point &P, const Integer *expBegin, unsigned int expCount) const
 {
+	if (m_dedicated)
+	{
+		for (unsigned int i=0; i<expCount; i++)
+			results[i] = ScalarMultiply(P, expBegin[i]);
+		return;
+	}
+
 	if (!GetField().IsMontgomeryRepresentation())
 	{
 		ECP ecpmr(*this, true);
@@ -952,8 +941,98 @@ void ECP::SimultaneousMultiply(ECP::Point *results, const ECP::Point &P, const I
 	}
 }
 
+ECP::Point ECP::MultiScalarMultiply(const Point *bases, const Integer *exponents, size_t count) const
+{
+	if (!GetField().IsMontgomeryRepresentation())
+	{
+		ECP ecpmr(*this, true);
+		const ModularArithmetic &mr = ecpmr.GetField();
+		std::vector<Point> basesmr(count);
+		for (size_t i=0; i<count; i++)
+			basesmr[i] = ToMontgomery(mr, bases[i]);
+		return FromMontgomery(mr, ecpmr.MultiScalarMultiply(count ? &basesmr[0] : NULLPTR, exponents, count));
+	}
+	else
+		return AbstractGroup<Point>::MultiScalarMultiply(bases, exponents, count);
+}
+
+void ECP::AccumulateBatch(Point *const *a, const Point *const *b, size_t count) const
+{
+	// Each affine addition needs the inverse of x2-x1, or 2y for a
+	// doubling. Collect the denominators and invert them together.
+	const Field &field = GetField();
+	std::vector<size_t> index;
+	std::vector<FieldElement> num, den;
+	index.reserve(count); num.reserve(count); den.reserve(count);
+
+	size_t i;
+	for (i=0; i<count; i++)
+	{
+		Point &P = *a[i];
+		const Point &Q = *b[i];
+
+		if (Q.identity)
+			continue;
+		if (P.identity)
+		{
+			P = Q;
+			continue;
+		}
+
+		if (field.Equal(P.x, Q.x))
+		{
+			if (!field.Equal(P.y, Q.y) || P.y.IsZero())
+			{
+				P = Identity();
+				continue;
+			}
+
+			// lambda = (3x^2 + a) / 2y
+			const FieldElement t = field.Square(P.x);
+			num.push_back(field.Add(field.Add(field.Double(t), t), m_a));
+			den.push_back(field.Double(P.y));
+		}
+		else
+		{
+			// lambda = (y2 - y1) / (x2 - x1)
+			num.push_back(field.Subtract(Q.y, P.y));
+			den.push_back(field.Subtract(Q.x, P.x));
+		}
+		index.push_back(i);
+	}
+
+	ParallelInvert(field, den.begin(), den.end());
+
+	for (i=0; i<index.size(); i++)
+	{
+		Point &P = *a[index[i]];
+		const Point &Q = *b[index[i]];
+
+		const FieldElement lambda = field.Multiply(num[i], den[i]);
+		FieldElement x = field.Square(lambda);
+		field.Reduce(x, P.x);
+		field.Reduce(x, Q.x);
+
+		FieldElement y = field.Subtract(P.x, x);
+		y = field.Multiply(lambda, y);
+		field.Reduce(y, P.y);
+
+		P.x.swap(x);
+		P.y.swap(y);
+	}
+}
+
 ECP::Point ECP::CascadeScalarMultiply(const Point &P, const Integer &k1, const Point &Q, const Integer &k2) const
 {
+	if (m_dedicated)
+	{
+		const ModularArithmetic &field = GetField();
+		if (field.IsMontgomeryRepresentation())
+			return ToMontgomery(field, NISTP::CascadeScalarMultiply(m_dedicated,
+				FromMontgomery(field, P), k1, FromMontgomery(field, Q), k2));
+		return NISTP::CascadeScalarMultiply(m_dedicated, P, k1, Q, k2);
+	}
+
 	if (!GetField().IsMontgomeryRepresentation())
 	{
 		ECP ecpmr(*this, true);
@@ -33,7 +33,7 @@ public:
 	virtual ~ECP() {}
 
 	/// \brief Construct an ECP
-	ECP() {}
+	ECP() : m_dedicated(0) {}
 
 	/// \brief Construct an ECP
 	/// \param ecp the other ECP object
@@ -50,7 +50,7 @@ public:
 	/// \param a Field::Element
 	/// \param b Field::Element
 	ECP(const Integer &modulus, const FieldElement &a, const FieldElement &b)
-		: m_fieldPtr(new Field(modulus)), m_a(a.IsNegative() ? modulus+a : a), m_b(b) {}
+		: m_fieldPtr(new Field(modulus)), m_a(a.IsNegative() ? modulus+a : a), m_b(b), m_dedicated(DedicatedCurve()) {}
 
 	/// \brief Construct an ECP from BER encoded parameters
 	/// \param bt BufferedTransformation derived object
@@ -78,6 +78,8 @@ public:
 	Point ScalarMultiply(const Point &P, const Integer &k) const;
 	Point CascadeScalarMultiply(const Point &P, const Integer &k1, const Point &Q, const Integer &k2) const;
 	void SimultaneousMultiply(Point *results, const Point &base, const Integer *exponents, unsigned int exponentsCount) const;
+	Point MultiScalarMultiply(const Point *bases, const Integer *exponents, size_t count) const;
+	void AccumulateBatch(Point *const *a, const Point *const *b, size_t count) const;
 
 	Point Multiply(const Integer &k, const Point &P) const
 		{return ScalarMultiply(P, k);}
@@ -103,12 +105,26 @@ public:
 	const FieldElement & GetA() const {return m_a;}
 	const FieldElement & GetB() const {return m_b;}
 
+	/// \brief Determine if the curve uses dedicated arithmetic
+	/// \returns true if the curve is secp256r1 or secp384r1 and the dedicated arithmetic
+	///   is available, false otherwise
+	/// \details ScalarMultiply(), CascadeScalarMultiply() and SimultaneousMultiply() use
+	///   fixed-width, constant-time field arithmetic for these curves. The curve is
+	///   recognized by its modulus and coefficients, so it does not matter whether it
+	///   was loaded by OID or from explicit parameters.
+	/// \sa nistp.h
+	/// \since Crypto++ 8.3
+	bool HasDedicatedArithmetic() const {return m_dedicated != 0;}
+
 	bool operator==(const ECP &rhs) const
 		{return GetField() == rhs.GetField() && m_a == rhs.m_a && m_b == rhs.m_b;}
 
 private:
+	unsigned int DedicatedCurve() const;
+
 	clonable_ptr<Field> m_fieldPtr;
 	FieldElement m_a, m_b;
+	unsigned int m_dedicated;	// curve of the dedicated arithmetic, 0 for none
 	mutable Point m_R;
 };
 
@@ -11,6 +11,18 @@
 
 NAMESPACE_BEGIN(CryptoPP)
 
+// Window tables with windowSize bit windows. Signed digits need half the
+// multiples and one more window for the final carry.
+static inline unsigned int WindowMultiples(unsigned int windowSize, bool signedDigits)
+{
+	return signedDigits ? (1U << (windowSize-1)) : (1U << windowSize) - 1;
+}
+
+static inline size_t WindowCount(unsigned int maxExpBits, unsigned int windowSize, bool signedDigits)
+{
+	return (maxExpBits+windowSize-1)/windowSize + (signedDigits ? 1 : 0);
+}
+
 template <class T> void DL_FixedBasePrecomputationImpl<T>::SetBase(const DL_GroupPrecomputation<Element> &group, const Element &i_base)
 {
 	m_base = group.NeedConversions() ? group.ConvertIn(i_base) : i_base;
@@ -19,38 +31,87 @@ template <class T> void DL_FixedBasePrecomputationImpl<T>::SetBase(const DL_Grou
 	{
 		m_bases.resize(1);
 		m_bases[0] = m_base;
+		m_multiples = 0;
 	}
 
 	if (group.NeedConversions())
 		m_base = i_base;
 }
 
-template <class T> void DL_FixedBasePrecomputationImpl<T>::Precompute(const DL_GroupPrecomputation<Element> &group, unsigned int maxExpBits, unsigned int storage)
+template <class T> void DL_FixedBasePrecomputationImpl<T>::Precompute(const DL_GroupPrecomputation<Element> &i_group, unsigned int maxExpBits, unsigned int storage)
 {
 	CRYPTOPP_ASSERT(m_bases.size() > 0);
-	CRYPTOPP_ASSERT(storage <= maxExpBits);
 
-	if (storage > 1)
+	const AbstractGroup<T> &group = i_group.GetGroup();
+	const bool signedDigits = group.InversionIsFast();
+
+	unsigned int windowSize = 0;
+	for (unsigned int w=2; w<16 && WindowCount(maxExpBits, w, signedDigits)*WindowMultiples(w, signedDigits) <= storage; w++)
+		windowSize = w;
+
+	if (windowSize == 0)
 	{
-		m_windowSize = (maxExpBits+storage-1)/storage;
-		m_exponentBase = Integer::Power2(m_windowSize);
+		storage = STDMIN(storage, maxExpBits);
+		if (storage > 1)
+		{
+			m_windowSize = (maxExpBits+storage-1)/storage;
+			m_exponentBase = Integer::Power2(m_windowSize);
+		}
+
+		m_multiples = 0;
+		m_bases.resize(storage);
+		for (unsigned i=1; i<storage; i++)
+			m_bases[i] = group.ScalarMultiply(m_bases[i-1], m_exponentBase);
+		return;
 	}
 
-	m_bases.resize(storage);
-	for (unsigned i=1; i<storage; i++)
-		m_bases[i] = group.GetGroup().ScalarMultiply(m_bases[i-1], m_exponentBase);
+	// Window i holds multiples 1 to m_multiples of base*2^(w*i)
+	const size_t windows = WindowCount(maxExpBits, windowSize, signedDigits);
+	m_windowSize = windowSize;
+	m_exponentBase = Integer::Power2(windowSize);
+	m_multiples = WindowMultiples(windowSize, signedDigits);
+	m_bases.resize(windows*m_multiples);
+
+	for (size_t i=1; i<windows; i++)
+		m_bases[i*m_multiples] = group.ScalarMultiply(m_bases[(i-1)*m_multiples], m_exponentBase);
+
+	// Multiple j of every window is computed in one batch
+	std::vector<Element *> a(windows);
+	std::vector<const Element *> b(windows);
+	for (size_t j=1; j<m_multiples; j++)
+	{
+		for (size_t i=0; i<windows; i++)
+		{
+			Element *row = &m_bases[i*m_multiples];
+			row[j] = row[j-1];
+			a[i] = row+j;
+			b[i] = row;
+		}
+		group.AccumulateBatch(&a[0], &b[0], windows);
+	}
 }
 
 template <class T> void DL_FixedBasePrecomputationImpl<T>::Load(const DL_GroupPrecomputation<Element> &group, BufferedTransformation &bt)
 {
 	BERSequenceDecoder seq(bt);
-	word32 version;
-	BERDecodeUnsigned<word32>(seq, version, INTEGER, 1, 1);
+	word32 version, multiples = 0;
+	BERDecodeUnsigned<word32>(seq, version, INTEGER, 1, 2);
 	m_exponentBase.BERDecode(seq);
 	m_windowSize = m_exponentBase.BitCount() - 1;
+	if (version == 2)
+	{
+		// A window table must match the digits Exponentiate() selects
+		const bool signedDigits = group.GetGroup().InversionIsFast();
+		BERDecodeUnsigned<word32>(seq, multiples, INTEGER, 1, 1U << 15);
+		if (m_windowSize < 2 || m_windowSize >= 16 || multiples != WindowMultiples(m_windowSize, signedDigits))
+			BERDecodeError();
+	}
+	m_multiples = multiples;
 	m_bases.clear();
 	while (!seq.EndReached())
 		m_bases.push_back(group.BERDecodeElement(seq));
+	if (m_bases.empty() || (m_multiples && m_bases.size() % m_multiples != 0))
+		BERDecodeError();
 	if (!m_bases.empty() && group.NeedConversions())
 		m_base = group.ConvertOut(m_bases[0]);
 	seq.MessageEnd();
@@ -59,8 +120,10 @@ template <class T> void DL_FixedBasePrecomputationImpl<T>::Load(const DL_GroupPr
 template <class T> void DL_FixedBasePrecomputationImpl<T>::Save(const DL_GroupPrecomputation<Element> &group, BufferedTransformation &bt) const
 {
 	DERSequenceEncoder seq(bt);
-	DEREncodeUnsigned<word32>(seq, 1);	// version
+	DEREncodeUnsigned<word32>(seq, m_multiples ? 2 : 1);	// version
 	m_exponentBase.DEREncode(seq);
+	if (m_multiples)
+		DEREncodeUnsigned<word32>(seq, m_multiples);
 	for (unsigned i=0; i<m_bases.size(); i++)
 		group.DEREncodeElement(seq, m_bases[i]);
 	seq.MessageEnd();
@@ -89,12 +152,75 @@ template <class T> void DL_FixedBasePrecomputationImpl<T>::PrepareCascade(const
 	eb.push_back(BaseAndExponent<Element>(m_bases[i], e));
 }
 
-template <class T> T DL_FixedBasePrecomputationImpl<T>::Exponentiate(const DL_GroupPrecomputation<Element> &group, const Integer &exponent) const
+template <class T> T DL_FixedBasePrecomputationImpl<T>::WindowExponentiate(const DL_GroupPrecomputation<Element> &i_group, const Integer &exponent) const
 {
+	const AbstractGroup<T> &group = i_group.GetGroup();
+	const bool signedDigits = group.InversionIsFast();
+	const size_t windows = m_bases.size() / m_multiples;
+	const size_t digits = signedDigits ? windows-1 : windows;
+
+	if (exponent.IsNegative() || exponent.BitCount() > digits*m_windowSize)
+		return group.ScalarMultiply(m_bases[0], exponent);
+
+	// Select one multiple from each window. A signed digit lies in
+	// [-2^(w-1)+1, 2^(w-1)], and a negative digit carries into the
+	// next window.
+	std::vector<Element> terms;
+	terms.reserve(windows);
+	word32 carry = 0;
+	for (size_t i=0; i<windows; i++)
+	{
+		word32 digit = static_cast<word32>(exponent.GetBits(i*m_windowSize, m_windowSize)) + carry;
+		carry = 0;
+		if (signedDigits && digit > m_multiples)
+		{
+			digit = (word32(1) << m_windowSize) - digit;
+			carry = 1;
+			if (digit)
+				terms.push_back(group.Inverse(m_bases[i*m_multiples+digit-1]));
+		}
+		else if (digit)
+			terms.push_back(m_bases[i*m_multiples+digit-1]);
+	}
+	CRYPTOPP_ASSERT(carry == 0);
+
+	if (terms.empty())
+		return group.Identity();
+
+	// Add the terms pairwise so each level is one AccumulateBatch()
+	std::vector<Element *> a;
+	std::vector<const Element *> b;
+	a.reserve(terms.size()/2);
+	b.reserve(terms.size()/2);
+	for (size_t count = terms.size(); count > 1; )
+	{
+		const size_t half = count/2;
+		a.clear(); b.clear();
+		for (size_t i=0; i<half; i++)
+		{
+			a.push_back(&terms[i]);
+			b.push_back(&terms[count-half+i]);
+		}
+		group.AccumulateBatch(&a[0], &b[0], half);
+		count -= half;
+	}
+	return terms[0];
+}
+
+template <class T> T DL_FixedBasePrecomputationImpl<T>::InternalExponentiate(const DL_GroupPrecomputation<Element> &group, const Integer &exponent) const
+{
+	if (m_multiples)
+		return WindowExponentiate(group, exponent);
+
 	std::vector<BaseAndExponent<Element> > eb;	// array of segments of the exponent and precalculated bases
 	eb.reserve(m_bases.size());
 	PrepareCascade(group, eb, exponent);
-	return group.ConvertOut(GeneralCascadeMultiplication<Element>(group.GetGroup(), eb.begin(), eb.end()));
+	return GeneralCascadeMultiplication<Element>(group.GetGroup(), eb.begin(), eb.end());
+}
+
+template <class T> T DL_FixedBasePrecomputationImpl<T>::Exponentiate(const DL_GroupPrecomputation<Element> &group, const Integer &exponent) const
+{
+	return group.ConvertOut(InternalExponentiate(group, exponent));
 }
 
 template <class T> T
@@ -103,6 +229,15 @@ template <class T> T
 {
 	std::vector<BaseAndExponent<Element> > eb;	// array of segments of the exponent and precalculated bases
 	const DL_FixedBasePrecomputationImpl<T> &pc2 = static_cast<const DL_FixedBasePrecomputationImpl<T> &>(i_pc2);
+
+	// A window table does no doublings to share, so add the results
+	if (m_multiples || pc2.m_multiples)
+	{
+		const Element r1 = InternalExponentiate(group, exponent);
+		const Element r2 = pc2.InternalExponentiate(group, exponent2);
+		return group.ConvertOut(group.GetGroup().Add(r1, r2));
+	}
+
 	eb.reserve(m_bases.size() + pc2.m_bases.size());
 	PrepareCascade(group, eb, exponent);
 	pc2.PrepareCascade(group, eb, exponent2);
@@ -84,6 +84,11 @@ public:
 	/// \param storage the suggested number of objects for the precompute table
 	/// \details The exact semantics of Precompute() varies, but it typically means calculate
 	///   a table of n objects that can be used later to speed up computation.
+	/// \details DL_FixedBasePrecomputationImpl stores \p storage powers of the base when
+	///   <tt>storage \<= maxExpBits</tt>. A larger \p storage selects a window table, which
+	///   holds every multiple of the base that a window of the exponent can select. The
+	///   window is the widest one whose table fits in \p storage objects. Exponentiation
+	///   with a window table needs no doublings.
 	/// \details If a derived class does not override Precompute(), then the base class throws
 	///   NotImplemented.
 	/// \sa SupportsPrecomputation(), LoadPrecomputation(), SavePrecomputation()
@@ -130,7 +135,7 @@ public:
 
 	virtual ~DL_FixedBasePrecomputationImpl() {}
 
-	DL_FixedBasePrecomputationImpl() : m_windowSize(0) {}
+	DL_FixedBasePrecomputationImpl() : m_windowSize(0), m_multiples(0) {}
 
 	// DL_FixedBasePrecomputation
 	bool IsInitialized() const
@@ -146,9 +151,12 @@ public:
 
 private:
 	void PrepareCascade(const DL_GroupPrecomputation<Element> &group, std::vector<BaseAndExponent<Element> > &eb, const Integer &exponent) const;
+	Element WindowExponentiate(const DL_GroupPrecomputation<Element> &group, const Integer &exponent) const;
+	Element InternalExponentiate(const DL_GroupPrecomputation<Element> &group, const Integer &exponent) const;
 
 	Element m_base;
 	unsigned int m_windowSize;
+	unsigned int m_multiples;		// multiples per window in a window table, 0 for powers only
 	Integer m_exponentBase;			// what base to represent the exponent in
 	std::vector<Element> m_bases;	// precalculated bases
 };
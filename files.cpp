@@ -8,6 +8,25 @@
 
 #include <limits>
 
+#if defined(CRYPTOPP_UNIX_AVAILABLE)
+# include <sys/types.h>
+# include <sys/stat.h>
+# include <sys/mman.h>
+# include <sys/uio.h>
+# include <errno.h>
+# include <fcntl.h>
+# include <unistd.h>
+#elif defined(CRYPTOPP_MAPPED_FILE_AVAILABLE)
+# include <windows.h>
+#endif
+
+#if defined(CRYPTOPP_UNIX_AVAILABLE) && defined(CRYPTOPP_CXX11_SYNCHRONIZATION)
+# include <condition_variable>
+# include <mutex>
+# include <thread>
+# include <system_error>
+#endif
+
 NAMESPACE_BEGIN(CryptoPP)
 
 #if defined(CRYPTOPP_DEBUG) && !defined(CRYPTOPP_DOXYGEN_PROCESSING)
@@ -16,6 +35,13 @@ void Files_TestInstantiations()
 	FileStore f0;
 	FileSource f1;
 	FileSink f2;
+#if defined(CRYPTOPP_MAPPED_FILE_AVAILABLE)
+	MappedFileStore f3;
+	MappedFileSource f4;
+#endif
+#if defined(CRYPTOPP_UNIX_AVAILABLE)
+	PosixFileSink f5;
+#endif
 }
 #endif
 
@@ -176,6 +202,212 @@ lword FileStore::Skip(lword skipMax)
 	return (lword)m_stream->tellg() - oldPos;
 }
 
+#if defined(CRYPTOPP_MAPPED_FILE_AVAILABLE)
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+// Views start on a multiple of the window size, and the window size is
+// a multiple of 2 MB, so every view is aligned for large pages
+const size_t LARGE_PAGE_SIZE = 2*1024*1024;
+
+ANONYMOUS_NAMESPACE_END
+
+void MappedFileStore::Clear()
+{
+#if defined(CRYPTOPP_UNIX_AVAILABLE)
+	m_file = -1;
+#else
+	m_file = m_mapping = NULLPTR;
+#endif
+	m_size = m_position = 0;
+	m_windowSize = DEFAULT_WINDOW_SIZE;
+	m_view = NULLPTR;
+	m_viewStart = 0;
+	m_viewSize = 0;
+}
+
+void MappedFileStore::Unmap() const
+{
+	if (m_view)
+	{
+#if defined(CRYPTOPP_UNIX_AVAILABLE)
+		munmap(const_cast<byte *>(m_view), m_viewSize);
+#else
+		UnmapViewOfFile(m_view);
+#endif
+	}
+	m_view = NULLPTR;
+	m_viewStart = 0;
+	m_viewSize = 0;
+}
+
+void MappedFileStore::Close()
+{
+	Unmap();
+#if defined(CRYPTOPP_UNIX_AVAILABLE)
+	if (m_file != -1)
+		close(m_file);
+#else
+	if (m_mapping)
+		CloseHandle(m_mapping);
+	if (m_file)
+		CloseHandle(m_file);
+#endif
+	Clear();
+}
+
+void MappedFileStore::StoreInitialize(const NameValuePairs &parameters)
+{
+	Close();
+
+	const char *fileName = NULLPTR;
+#if defined(CRYPTOPP_UNIX_AVAILABLE) || _MSC_VER >= 1400
+	const wchar_t *fileNameWide = NULLPTR;
+	if (!parameters.GetValue(Name::InputFileNameWide(), fileNameWide))
+#endif
+		if (!parameters.GetValue(Name::InputFileName(), fileName))
+			return;
+
+	size_t windowSize = parameters.GetValueWithDefault("MappedFileWindowSize", size_t(DEFAULT_WINDOW_SIZE));
+	m_windowSize = RoundUpToMultipleOf(STDMAX(windowSize, LARGE_PAGE_SIZE), LARGE_PAGE_SIZE);
+
+#if defined(CRYPTOPP_UNIX_AVAILABLE)
+	std::string narrowed;
+	if (fileNameWide)
+		fileName = (narrowed = StringNarrow(fileNameWide)).c_str();
+
+	// Child processes do not inherit the descriptor
+	int mode = O_RDONLY;
+#if defined(O_CLOEXEC)
+	mode |= O_CLOEXEC;
+#endif
+	m_file = open(fileName, mode);
+	if (m_file == -1)
+		throw OpenErr(fileName);
+
+	struct stat st;
+	if (fstat(m_file, &st) != 0 || !S_ISREG(st.st_mode))
+	{
+		Close();
+		throw OpenErr(fileName);
+	}
+	m_size = static_cast<lword>(st.st_size);
+#else
+	const DWORD share = FILE_SHARE_READ, flags = FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN;
+	HANDLE file;
+# if _MSC_VER >= 1400
+	if (fileNameWide)
+	{
+		file = CreateFileW(fileNameWide, GENERIC_READ, share, NULLPTR, OPEN_EXISTING, flags, NULLPTR);
+		if (file == INVALID_HANDLE_VALUE)
+			throw OpenErr(StringNarrow(fileNameWide, false));
+	}
+	else
+# endif
+	{
+		file = CreateFileA(fileName, GENERIC_READ, share, NULLPTR, OPEN_EXISTING, flags, NULLPTR);
+		if (file == INVALID_HANDLE_VALUE)
+			throw OpenErr(fileName);
+	}
+	m_file = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size))
+	{
+		Close();
+		throw MapErr();
+	}
+	m_size = static_cast<lword>(size.QuadPart);
+
+	// A zero length file cannot be mapped, and it has nothing to retrieve
+	if (m_size)
+	{
+		m_mapping = CreateFileMapping(file, NULLPTR, PAGE_READONLY, 0, 0, NULLPTR);
+		if (!m_mapping)
+		{
+			Close();
+			throw MapErr();
+		}
+	}
+#endif
+}
+
+const byte * MappedFileStore::Map(lword position, size_t &length) const
+{
+	CRYPTOPP_ASSERT(position < m_size);
+
+	if (!m_view || position < m_viewStart || position >= m_viewStart + m_viewSize)
+	{
+		Unmap();
+
+		const lword start = RoundDownToMultipleOf(position, lword(m_windowSize));
+		const size_t size = static_cast<size_t>(STDMIN(lword(m_windowSize), m_size - start));
+
+#if defined(CRYPTOPP_UNIX_AVAILABLE)
+		off_t offset;
+		if (!SafeConvert(start, offset))
+			throw MapErr();
+		void *view = mmap(NULLPTR, size, PROT_READ, MAP_SHARED, m_file, offset);
+		if (view == MAP_FAILED)
+			throw MapErr();
+		posix_madvise(view, size, POSIX_MADV_SEQUENTIAL);
+#else
+		void *view = MapViewOfFile(m_mapping, FILE_MAP_READ, DWORD(start >> 32), DWORD(start), size);
+		if (!view)
+			throw MapErr();
+#endif
+		m_view = static_cast<const byte *>(view);
+		m_viewStart = start;
+		m_viewSize = size;
+	}
+
+	const size_t offset = static_cast<size_t>(position - m_viewStart);
+	length = m_viewSize - offset;
+	return m_view + offset;
+}
+
+size_t MappedFileStore::TransferTo2(BufferedTransformation &target, lword &transferBytes, const std::string &channel, bool blocking)
+{
+	lword position = 0;
+	size_t blockedBytes = CopyRangeTo2(target, position, transferBytes, channel, blocking);
+	m_position += position;
+	transferBytes = position;
+
+	// Release the view once the file is exhausted
+	if (m_position == m_size)
+		Unmap();
+	return blockedBytes;
+}
+
+size_t MappedFileStore::CopyRangeTo2(BufferedTransformation &target, lword &begin, lword end, const std::string &channel, bool blocking) const
+{
+	const lword available = m_size - m_position;
+	end = STDMIN(end, available);
+
+	while (begin < end)
+	{
+		size_t length;
+		const byte *view = Map(m_position + begin, length);
+		length = UnsignedMin(length, end - begin);
+
+		size_t blockedBytes = target.ChannelPut2(channel, view, length, 0, blocking);
+		if (blockedBytes)
+			return blockedBytes;
+		begin += length;
+	}
+
+	return 0;
+}
+
+lword MappedFileStore::Skip(lword skipMax)
+{
+	const lword skipped = STDMIN(skipMax, m_size - m_position);
+	m_position += skipped;
+	return skipped;
+}
+
+#endif  // CRYPTOPP_MAPPED_FILE_AVAILABLE
+
 void FileSink::IsolatedInitialize(const NameValuePairs &parameters)
 {
 	m_stream = NULLPTR;
@@ -253,6 +485,342 @@ size_t FileSink::Put2(const byte *inString, size_t length, int messageEnd, bool
 	return 0;
 }
 
+#if defined(CRYPTOPP_UNIX_AVAILABLE)
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+// Writes all of the vectors, and returns 0 or the errno of the failed call
+int WriteVector(int fd, struct iovec *iov, int count)
+{
+	while (count)
+	{
+		ssize_t written = writev(fd, iov, count);
+		if (written < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return errno;
+		}
+
+		size_t remaining = static_cast<size_t>(written);
+		while (count && remaining >= iov->iov_len)
+		{
+			remaining -= iov->iov_len;
+			iov++, count--;
+		}
+		if (count)
+		{
+			iov->iov_base = static_cast<byte *>(iov->iov_base) + remaining;
+			iov->iov_len -= remaining;
+		}
+	}
+	return 0;
+}
+
+int WriteAll(int fd, const byte *buffer, size_t length)
+{
+	struct iovec iov = {const_cast<byte *>(buffer), length};
+	return length ? WriteVector(fd, &iov, 1) : 0;
+}
+
+ANONYMOUS_NAMESPACE_END
+
+#if defined(CRYPTOPP_CXX11_SYNCHRONIZATION)
+// Writes one buffer at a time on a background thread. Submit() waits
+// for the previous buffer, so the sink can fill the other one.
+struct PosixFileSink::Writer
+{
+	Writer(int fd) : m_fd(fd), m_data(NULLPTR), m_length(0), m_error(0), m_stop(false),
+		m_thread(&Writer::Run, this) {}
+
+	~Writer()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_ready.notify_one();
+		m_thread.join();
+	}
+
+	// Returns the error of an earlier write, if any
+	int Submit(const byte *data, size_t length)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (m_data)
+			m_done.wait(lock);
+		if (!m_error)
+		{
+			m_data = data;
+			m_length = length;
+			m_ready.notify_one();
+		}
+		return m_error;
+	}
+
+	int Wait()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (m_data)
+			m_done.wait(lock);
+		return m_error;
+	}
+
+	void Run()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		for (;;)
+		{
+			while (!m_data && !m_stop)
+				m_ready.wait(lock);
+			if (!m_data)
+				return;
+
+			const byte *data = m_data;
+			size_t length = m_length;
+			lock.unlock();
+			int error = WriteAll(m_fd, data, length);
+			lock.lock();
+
+			m_error = m_error ? m_error : error;
+			m_data = NULLPTR;
+			m_done.notify_all();
+		}
+	}
+
+	int m_fd;
+	const byte *m_data;
+	size_t m_length;
+	int m_error;
+	bool m_stop;
+	std::mutex m_mutex;
+	std::condition_variable m_ready, m_done;
+	std::thread m_thread;
+};
+#else
+struct PosixFileSink::Writer
+{
+	int Submit(const byte *, size_t) {return EINVAL;}
+	int Wait() {return 0;}
+};
+#endif
+
+PosixFileSink::PosixFileSink()
+	: m_fd(-1), m_owned(false), m_direct(false), m_flags(0), m_bufferSize(0), m_fill(0), m_current(0)
+{
+	m_buffers[0] = m_buffers[1] = NULLPTR;
+}
+
+PosixFileSink::PosixFileSink(const char *filename, word32 flags, size_t bufferSize)
+	: m_fd(-1), m_owned(false), m_direct(false), m_flags(0), m_bufferSize(0), m_fill(0), m_current(0)
+{
+	m_buffers[0] = m_buffers[1] = NULLPTR;
+	IsolatedInitialize(MakeParameters(Name::OutputFileName(), filename ? filename : "")
+		("PosixFileSinkFlags", flags)("BufferSize", bufferSize));
+}
+
+PosixFileSink::PosixFileSink(int fd, word32 flags, size_t bufferSize)
+	: m_fd(-1), m_owned(false), m_direct(false), m_flags(0), m_bufferSize(0), m_fill(0), m_current(0)
+{
+	m_buffers[0] = m_buffers[1] = NULLPTR;
+	IsolatedInitialize(MakeParameters("OutputFileDescriptor", fd)
+		("PosixFileSinkFlags", flags)("BufferSize", bufferSize));
+}
+
+PosixFileSink::~PosixFileSink()
+{
+	try
+	{
+		if (m_fd != -1)
+			Drain();
+	}
+	catch (const Exception&)
+	{
+	}
+	Close();
+}
+
+void PosixFileSink::Close()
+{
+	m_writer.reset();
+	if (m_owned && m_fd != -1)
+		close(m_fd);
+	m_fd = -1;
+	m_owned = m_direct = false;
+	m_fill = 0;
+	m_current = 0;
+}
+
+void PosixFileSink::IsolatedInitialize(const NameValuePairs &parameters)
+{
+	Close();
+
+	m_flags = parameters.GetValueWithDefault("PosixFileSinkFlags", word32(0));
+	size_t bufferSize = parameters.GetValueWithDefault("BufferSize", size_t(DEFAULT_BUFFER_SIZE));
+	m_bufferSize = RoundUpToMultipleOf(STDMAX(bufferSize, size_t(DIRECT_ALIGNMENT)), size_t(DIRECT_ALIGNMENT));
+
+	// Two buffers for the background writer, aligned for O_DIRECT
+	const size_t buffers = (m_flags & ASYNC_WRITE) ? 2 : 1;
+	m_storage.New(buffers*m_bufferSize + DIRECT_ALIGNMENT);
+	m_buffers[0] = m_storage + (DIRECT_ALIGNMENT - reinterpret_cast<size_t>(m_storage.begin()) % DIRECT_ALIGNMENT) % DIRECT_ALIGNMENT;
+	m_buffers[1] = m_buffers[0] + (buffers-1)*m_bufferSize;
+
+	const char *fileName = NULLPTR;
+	const wchar_t *fileNameWide = NULLPTR;
+	if (!parameters.GetValue(Name::OutputFileNameWide(), fileNameWide))
+		if (!parameters.GetValue(Name::OutputFileName(), fileName))
+		{
+			parameters.GetValue("OutputFileDescriptor", m_fd);
+			return;
+		}
+
+	std::string narrowed;
+	if (fileNameWide)
+		fileName = (narrowed = StringNarrow(fileNameWide)).c_str();
+
+	int mode = O_WRONLY | O_CREAT | O_TRUNC;
+#if defined(O_CLOEXEC)
+	mode |= O_CLOEXEC;
+#endif
+#if defined(O_DIRECT)
+	if (m_flags & DIRECT_IO)
+	{
+		// Some file systems, like tmpfs, do not support O_DIRECT
+		m_fd = open(fileName, mode | O_DIRECT, 0666);
+		m_direct = (m_fd != -1);
+	}
+#endif
+	if (m_fd == -1)
+		m_fd = open(fileName, mode, 0666);
+	if (m_fd == -1)
+		throw OpenErr(fileName);
+	m_owned = true;
+}
+
+void PosixFileSink::Write(const byte *buffer, size_t length)
+{
+	if (WriteAll(m_fd, buffer, length) != 0)
+		throw WriteErr();
+}
+
+void PosixFileSink::Submit()
+{
+	CRYPTOPP_ASSERT(m_fill == m_bufferSize);
+
+#if defined(CRYPTOPP_CXX11_SYNCHRONIZATION)
+	if ((m_flags & ASYNC_WRITE) && !m_writer.get())
+	{
+		try
+		{
+			m_writer.reset(new Writer(m_fd));
+		}
+		catch (const std::system_error&)
+		{
+			// Fall back to writing on the calling thread
+			m_flags &= ~word32(ASYNC_WRITE);
+		}
+	}
+#endif
+
+	if (m_writer.get())
+	{
+		if (m_writer->Submit(m_buffers[m_current], m_fill) != 0)
+			throw WriteErr();
+		m_current ^= 1;
+	}
+	else
+		Write(m_buffers[m_current], m_fill);
+	m_fill = 0;
+}
+
+void PosixFileSink::Drain()
+{
+	if (m_writer.get() && m_writer->Wait() != 0)
+		throw WriteErr();
+
+	const byte *buffer = m_buffers[m_current];
+	size_t length = m_fill;
+	m_fill = 0;
+
+#if defined(O_DIRECT)
+	if (m_direct && length % DIRECT_ALIGNMENT)
+	{
+		// Write the whole blocks directly, and the partial block through
+		// the page cache. The file offset is no longer aligned after it.
+		const size_t aligned = RoundDownToMultipleOf(length, size_t(DIRECT_ALIGNMENT));
+		Write(buffer, aligned);
+		buffer += aligned;
+		length -= aligned;
+
+		const int flags = fcntl(m_fd, F_GETFL);
+		if (flags == -1 || fcntl(m_fd, F_SETFL, flags & ~O_DIRECT) == -1)
+			throw WriteErr();
+		m_direct = false;
+	}
+#endif
+
+	Write(buffer, length);
+}
+
+size_t PosixFileSink::Put2(const byte *inString, size_t length, int messageEnd, bool blocking)
+{
+	CRYPTOPP_UNUSED(blocking);
+	if (m_fd == -1)
+		throw Err("PosixFileSink: file not opened");
+
+	while (length)
+	{
+		// Coalesce the buffered bytes and a large input into one writev. Direct
+		// and background writes need the input copied into an aligned buffer.
+		if (!m_direct && !(m_flags & ASYNC_WRITE) && m_fill + length >= m_bufferSize)
+		{
+			struct iovec iov[2] = {{m_buffers[m_current], m_fill}, {const_cast<byte *>(inString), length}};
+			if (WriteVector(m_fd, iov + (m_fill ? 0 : 1), m_fill ? 2 : 1) != 0)
+				throw WriteErr();
+			m_fill = 0;
+			break;
+		}
+
+		const size_t copied = STDMIN(m_bufferSize - m_fill, length);
+		std::memcpy(m_buffers[m_current] + m_fill, inString, copied);
+		m_fill += copied;
+		inString += copied;
+		length -= copied;
+
+		if (m_fill == m_bufferSize)
+			Submit();
+	}
+
+	if (messageEnd)
+	{
+		Drain();
+#if defined(__APPLE__)
+		if ((m_flags & SYNC_DATA) && fsync(m_fd) != 0)
+#else
+		if ((m_flags & SYNC_DATA) && fdatasync(m_fd) != 0)
+#endif
+			throw WriteErr();
+	}
+
+	return 0;
+}
+
+bool PosixFileSink::IsolatedFlush(bool hardFlush, bool blocking)
+{
+	CRYPTOPP_UNUSED(blocking);
+	if (m_fd == -1)
+		throw Err("PosixFileSink: file not opened");
+
+	if (hardFlush)
+		Drain();
+	else if (m_writer.get() && m_writer->Wait() != 0)
+		throw WriteErr();
+
+	return false;
+}
+
+#endif  // CRYPTOPP_UNIX_AVAILABLE
+
 NAMESPACE_END
 
 #endif
@@ -121,6 +121,133 @@ public:
 	std::istream* GetStream() {return m_store.GetStream();}
 };
 
+#if defined(CRYPTOPP_UNIX_AVAILABLE) || defined(CRYPTOPP_DOXYGEN_PROCESSING)
+# define CRYPTOPP_MAPPED_FILE_AVAILABLE 1
+#elif defined(CRYPTOPP_WIN32_AVAILABLE)
+# if !defined(WINAPI_FAMILY)
+#  define CRYPTOPP_MAPPED_FILE_AVAILABLE 1
+# elif (WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP))
+#  define CRYPTOPP_MAPPED_FILE_AVAILABLE 1
+# endif
+#endif
+
+#if defined(CRYPTOPP_MAPPED_FILE_AVAILABLE)
+
+/// \brief Memory mapped implementation of Store interface
+/// \details MappedFileStore maps a read-only window of the file into memory and
+///   passes the mapped bytes to the attached transformation without copying them.
+///   Filters which process their input in place, like HashFilter and
+///   StreamTransformationFilter, read straight from the page cache.
+/// \details The window is moved through the file as the data is retrieved. Its size
+///   is a multiple of 2 MB so each view starts on a large page boundary, and the
+///   operating system is told the view will be read sequentially.
+/// \details The file must not be truncated while it is mapped. On Unix, reading a
+///   page past the new end of the file raises SIGBUS.
+/// \since Crypto++ 8.3
+class CRYPTOPP_DLL MappedFileStore : public Store, public NotCopyable
+{
+public:
+	/// \brief Exception thrown when file-based error is encountered
+	class Err : public Exception
+	{
+	public:
+		Err(const std::string &s) : Exception(IO_ERROR, s) {}
+	};
+	/// \brief Exception thrown when file-based open error is encountered
+	class OpenErr : public Err {public: OpenErr(const std::string &filename) : Err("MappedFileStore: error opening file for reading: " + filename) {}};
+	/// \brief Exception thrown when file-based mapping error is encountered
+	class MapErr : public Err {public: MapErr() : Err("MappedFileStore: error mapping file") {}};
+
+	/// \brief Default size of the mapped window
+	CRYPTOPP_CONSTANT(DEFAULT_WINDOW_SIZE = 64*1024*1024);
+
+	/// \brief Construct a MappedFileStore
+	MappedFileStore() {Clear();}
+
+	/// \brief Construct a MappedFileStore
+	/// \param filename the narrow name of the file to open
+	/// \param windowSize the size of the mapped window, in bytes
+	MappedFileStore(const char *filename, size_t windowSize=DEFAULT_WINDOW_SIZE)
+		{Clear(); StoreInitialize(MakeParameters(Name::InputFileName(), filename ? filename : "")("MappedFileWindowSize", windowSize));}
+
+#if defined(CRYPTOPP_UNIX_AVAILABLE) || defined(CRYPTOPP_DOXYGEN_PROCESSING) || _MSC_VER >= 1400
+	/// \brief Construct a MappedFileStore
+	/// \param filename the Unicode name of the file to open
+	/// \param windowSize the size of the mapped window, in bytes
+	/// \details On non-Windows OS, this function assumes that setlocale() has been called.
+	MappedFileStore(const wchar_t *filename, size_t windowSize=DEFAULT_WINDOW_SIZE)
+		{Clear(); StoreInitialize(MakeParameters(Name::InputFileNameWide(), filename)("MappedFileWindowSize", windowSize));}
+#endif
+
+	~MappedFileStore() {Close();}
+
+	/// \brief Retrieves the size of the file
+	/// \returns the size of the file, in bytes
+	lword FileSize() const {return m_size;}
+
+	lword MaxRetrievable() const {return m_size - m_position;}
+	size_t TransferTo2(BufferedTransformation &target, lword &transferBytes, const std::string &channel=DEFAULT_CHANNEL, bool blocking=true);
+	size_t CopyRangeTo2(BufferedTransformation &target, lword &begin, lword end=LWORD_MAX, const std::string &channel=DEFAULT_CHANNEL, bool blocking=true) const;
+	lword Skip(lword skipMax=ULONG_MAX);
+
+private:
+	void StoreInitialize(const NameValuePairs &parameters);
+	void Clear();
+	void Close();
+	void Unmap() const;
+	const byte * Map(lword position, size_t &length) const;
+
+#if defined(CRYPTOPP_UNIX_AVAILABLE)
+	int m_file;
+#else
+	void *m_file, *m_mapping;
+#endif
+	lword m_size, m_position;
+	size_t m_windowSize;
+	mutable const byte *m_view;
+	mutable lword m_viewStart;
+	mutable size_t m_viewSize;
+};
+
+/// \brief Memory mapped implementation of Source interface
+/// \details MappedFileSource pumps a file to its attached transformation from a
+///   MappedFileStore. It is a drop-in replacement for FileSource for regular files
+///   which avoids the stream and the intermediate buffer.
+/// \sa MappedFileStore
+/// \since Crypto++ 8.3
+class CRYPTOPP_DLL MappedFileSource : public SourceTemplate<MappedFileStore>
+{
+public:
+	typedef MappedFileStore::Err Err;
+	typedef MappedFileStore::OpenErr OpenErr;
+	typedef MappedFileStore::MapErr MapErr;
+
+	/// \brief Construct a MappedFileSource
+	MappedFileSource(BufferedTransformation *attachment = NULLPTR)
+		: SourceTemplate<MappedFileStore>(attachment) {}
+
+	/// \brief Construct a MappedFileSource
+	/// \param filename the narrow name of the file to open
+	/// \param pumpAll flag indicating if source data should be pumped to its attached transformation
+	/// \param attachment an optional attached transformation
+	/// \param windowSize the size of the mapped window, in bytes
+	MappedFileSource(const char *filename, bool pumpAll, BufferedTransformation *attachment = NULLPTR, size_t windowSize=MappedFileStore::DEFAULT_WINDOW_SIZE)
+		: SourceTemplate<MappedFileStore>(attachment) {SourceInitialize(pumpAll, MakeParameters(Name::InputFileName(), filename)("MappedFileWindowSize", windowSize));}
+
+#if defined(CRYPTOPP_UNIX_AVAILABLE) || defined(CRYPTOPP_DOXYGEN_PROCESSING) || _MSC_VER >= 1400
+	/// \brief Construct a MappedFileSource
+	/// \param filename the Unicode name of the file to open
+	/// \param pumpAll flag indicating if source data should be pumped to its attached transformation
+	/// \param attachment an optional attached transformation
+	/// \param windowSize the size of the mapped window, in bytes
+	/// \details On non-Windows OS, this function assumes that setlocale() has been called.
+	MappedFileSource(const wchar_t *filename, bool pumpAll, BufferedTransformation *attachment = NULLPTR, size_t windowSize=MappedFileStore::DEFAULT_WINDOW_SIZE)
+		: SourceTemplate<MappedFileStore>(attachment) {SourceInitialize(pumpAll, MakeParameters(Name::InputFileNameWide(), filename)("MappedFileWindowSize", windowSize));}
+#endif
+};
+
+#endif  // CRYPTOPP_MAPPED_FILE_AVAILABLE
+
 /// \brief Implementation of Store interface
 /// \details file-based implementation of Sink interface
 class CRYPTOPP_DLL FileSink : public Sink, public NotCopyable
@@ -172,6 +299,102 @@ private:
 	std::ostream *m_stream;
 };
 
+#if defined(CRYPTOPP_UNIX_AVAILABLE) || defined(CRYPTOPP_DOXYGEN_PROCESSING)
+
+/// \brief File descriptor based implementation of Sink interface
+/// \details PosixFileSink writes to a file descriptor with write(2) and writev(2),
+///   bypassing the buffering of std::ostream. Input is collected in a large
+///   buffer aligned to DIRECT_ALIGNMENT. When the buffered bytes and a new input
+///   together fill the buffer, both are written with a single writev() call.
+/// \details The behavior can be changed with flags:
+///   <ul>
+///   <li>DIRECT_IO opens the file with O_DIRECT, so writes bypass the page cache.
+///     If the file system rejects O_DIRECT, the file is opened without it. Only
+///     whole buffers are written directly. A partial block written by a hard
+///     flush or at the end of a message turns O_DIRECT off for the rest of the file.
+///   <li>SYNC_DATA calls fdatasync() at the end of each message.
+///   <li>ASYNC_WRITE writes full buffers on a background thread while the next
+///     buffer fills. Write errors are reported by the next call to Put2() or
+///     IsolatedFlush().
+///   </ul>
+/// \since Crypto++ 8.3
+class CRYPTOPP_DLL PosixFileSink : public Sink, public NotCopyable
+{
+public:
+	/// \brief Exception thrown when file-based error is encountered
+	class Err : public Exception
+	{
+	public:
+		Err(const std::string &s) : Exception(IO_ERROR, s) {}
+	};
+	/// \brief Exception thrown when file-based open error is encountered
+	class OpenErr : public Err {public: OpenErr(const std::string &filename) : Err("PosixFileSink: error opening file for writing: " + filename) {}};
+	/// \brief Exception thrown when file-based write error is encountered
+	class WriteErr : public Err {public: WriteErr() : Err("PosixFileSink: error writing file") {}};
+
+	/// \brief Write behavior flags
+	enum Flags {
+		/// \brief Write around the page cache with O_DIRECT
+		DIRECT_IO=1,
+		/// \brief Call fdatasync() at the end of each message
+		SYNC_DATA=2,
+		/// \brief Write full buffers on a background thread
+		ASYNC_WRITE=4
+	};
+
+	/// \brief Default size of the write buffer
+	CRYPTOPP_CONSTANT(DEFAULT_BUFFER_SIZE = 1024*1024);
+	/// \brief Alignment of the write buffer and of direct writes
+	CRYPTOPP_CONSTANT(DIRECT_ALIGNMENT = 4096);
+
+	/// \brief Construct a PosixFileSink
+	PosixFileSink();
+
+	/// \brief Construct a PosixFileSink
+	/// \param filename the narrow name of the file to open
+	/// \param flags a combination of Flags
+	/// \param bufferSize the size of the write buffer, in bytes
+	/// \details The file is created if it does not exist, and truncated if it does.
+	PosixFileSink(const char *filename, word32 flags=0, size_t bufferSize=DEFAULT_BUFFER_SIZE);
+
+	/// \brief Construct a PosixFileSink
+	/// \param fd an open file descriptor
+	/// \param flags a combination of Flags
+	/// \param bufferSize the size of the write buffer, in bytes
+	/// \details The descriptor is not closed by the PosixFileSink. DIRECT_IO is
+	///   ignored because the descriptor was opened by the caller.
+	PosixFileSink(int fd, word32 flags=0, size_t bufferSize=DEFAULT_BUFFER_SIZE);
+
+	~PosixFileSink();
+
+	/// \brief Retrieves the file descriptor
+	/// \returns the file descriptor, or -1 if no file is open
+	int GetDescriptor() const {return m_fd;}
+
+	void IsolatedInitialize(const NameValuePairs &parameters);
+	size_t Put2(const byte *inString, size_t length, int messageEnd, bool blocking);
+	bool IsolatedFlush(bool hardFlush, bool blocking);
+
+private:
+	struct Writer;
+
+	void Close();
+	void Write(const byte *buffer, size_t length);
+	void Submit();
+	void Drain();
+
+	int m_fd;
+	bool m_owned, m_direct;
+	word32 m_flags;
+	size_t m_bufferSize, m_fill;
+	unsigned int m_current;
+	SecByteBlock m_storage;
+	byte *m_buffers[2];
+	member_ptr<Writer> m_writer;
+};
+
+#endif  // CRYPTOPP_UNIX_AVAILABLE
+
 NAMESPACE_END
 
 #endif
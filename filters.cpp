@@ -336,6 +336,21 @@ void FilterWithBufferedInput::IsolatedInitialize(const NameValuePairs &parameter
 	m_firstInputDone = false;
 }
 
+size_t FilterWithBufferedInput::Put2V(const ConstByteSpan *spans, size_t count, int messageEnd, bool blocking)
+{
+	// A blocked fragment is resumed by calling Put2() with the same
+	// arguments, which the caller cannot do for one fragment of many
+	if (!blocking)
+		throw BlockingInputOnly(AlgorithmName());
+
+	if (count == 0)
+		return PutMaybeModifiable(NULLPTR, 0, messageEnd, blocking, false);
+
+	for (size_t i=0; i<count; i++)
+		PutMaybeModifiable(const_cast<byte *>(spans[i].data), spans[i].size, i+1 == count ? messageEnd : 0, blocking, false);
+	return 0;
+}
+
 bool FilterWithBufferedInput::IsolatedFlush(bool hardFlush, bool blocking)
 {
 	if (!blocking)
@@ -887,6 +902,23 @@ size_t HashFilter::Put2(const byte *inString, size_t length, int messageEnd, boo
 	FILTER_END_NO_MESSAGE_END;
 }
 
+size_t HashFilter::Put2V(const ConstByteSpan *spans, size_t count, int messageEnd, bool blocking)
+{
+	if (!blocking)
+		throw BlockingInputOnly(AlgorithmName());
+
+	// The message is passed on as the same fragments, and the digest
+	// is output by Put2() when the message ends
+	if (m_putMessage)
+		AttachedTransformation()->ChannelPut2V(m_messagePutChannel, spans, count, 0, blocking);
+	for (size_t i=0; i<count; i++)
+	{
+		if (spans[i].data && spans[i].size)
+			m_hashModule.Update(spans[i].data, spans[i].size);
+	}
+	return messageEnd ? Put2(NULLPTR, 0, messageEnd, blocking) : 0;
+}
+
 // *************************************************************
 
 HashVerificationFilter::HashVerificationFilter(HashTransformation &hm, BufferedTransformation *attachment, word32 flags, int truncatedDigestSize)
@@ -987,6 +1019,17 @@ size_t AuthenticatedEncryptionFilter::ChannelPut2(const std::string &channel, co
 	throw InvalidChannelName("AuthenticatedEncryptionFilter", channel);
 }
 
+size_t AuthenticatedEncryptionFilter::ChannelPut2V(const std::string &channel, const ConstByteSpan *spans, size_t count, int messageEnd, bool blocking)
+{
+	if (channel.empty())
+		return StreamTransformationFilter::Put2V(spans, count, messageEnd, blocking);
+
+	if (channel == AAD_CHANNEL)
+		return m_hf.Put2V(spans, count, 0, blocking);
+
+	throw InvalidChannelName("AuthenticatedEncryptionFilter", channel);
+}
+
 void AuthenticatedEncryptionFilter::LastPut(const byte *inString, size_t length)
 {
 	StreamTransformationFilter::LastPut(inString, length);
@@ -1046,6 +1089,21 @@ size_t AuthenticatedDecryptionFilter::ChannelPut2(const std::string &channel, co
 	throw InvalidChannelName("AuthenticatedDecryptionFilter", channel);
 }
 
+size_t AuthenticatedDecryptionFilter::ChannelPut2V(const std::string &channel, const ConstByteSpan *spans, size_t count, int messageEnd, bool blocking)
+{
+	if (channel.empty())
+	{
+		if (m_lastSize > 0)
+			m_hashVerifier.ForceNextPut();
+		return FilterWithBufferedInput::Put2V(spans, count, messageEnd, blocking);
+	}
+
+	if (channel == AAD_CHANNEL)
+		return m_hashVerifier.Put2V(spans, count, 0, blocking);
+
+	throw InvalidChannelName("AuthenticatedDecryptionFilter", channel);
+}
+
 void AuthenticatedDecryptionFilter::FirstPut(const byte *inString)
 {
 	m_hashVerifier.Put(inString, m_firstSize);
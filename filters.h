@@ -366,6 +366,11 @@ public:
 		return PutMaybeModifiable(inString, length, messageEnd, blocking, true);
 	}
 
+	/// \brief Input a scatter-gather buffer for processing
+	/// \details Each fragment is divided into blocks where it lies. Only a block that
+	///  straddles two fragments is collected in the internal buffer.
+	size_t Put2V(const ConstByteSpan *spans, size_t count, int messageEnd, bool blocking);
+
 	/// \brief Flushes data buffered by this object, without signal propagation
 	/// \param hardFlush indicates whether all data should be flushed
 	/// \param blocking specifies whether the object should block when processing input
@@ -595,6 +600,7 @@ public:
 	std::string AlgorithmName() const {return m_hashModule.AlgorithmName();}
 	void IsolatedInitialize(const NameValuePairs &parameters);
 	size_t Put2(const byte *inString, size_t length, int messageEnd, bool blocking);
+	size_t Put2V(const ConstByteSpan *spans, size_t count, int messageEnd, bool blocking);
 	byte * CreatePutSpace(size_t &size) {return m_hashModule.CreateUpdateSpace(size);}
 
 private:
@@ -698,6 +704,7 @@ public:
 	void IsolatedInitialize(const NameValuePairs &parameters);
 	byte * ChannelCreatePutSpace(const std::string &channel, size_t &size);
 	size_t ChannelPut2(const std::string &channel, const byte *begin, size_t length, int messageEnd, bool blocking);
+	size_t ChannelPut2V(const std::string &channel, const ConstByteSpan *spans, size_t count, int messageEnd, bool blocking);
 
 	/// \brief Input the last block of data
 	/// \param inString the input byte buffer
@@ -763,6 +770,7 @@ public:
 	size_t ChannelPut2(const std::string &channel, const byte *begin, size_t length, int messageEnd, bool blocking);
 	size_t ChannelPutModifiable2(const std::string &channel, byte *begin, size_t length, int messageEnd, bool blocking)
 		{ return ChannelPut2(channel, begin, length, messageEnd, blocking); }
+	size_t ChannelPut2V(const std::string &channel, const ConstByteSpan *spans, size_t count, int messageEnd, bool blocking);
 	/// \brief Get verifier result
 	/// \return true if the digest on the previosus message was valid, false otherwise
 	bool GetLastResult() const {return m_hashVerifier.GetLastResult();}
@@ -19,6 +19,7 @@
 
 #include "gcm.h"
 #include "cpu.h"
+#include "rijndael.h"
 
 #if defined(CRYPTOPP_DISABLE_GCM_ASM)
 # undef CRYPTOPP_X86_ASM_AVAILABLE
@@ -86,6 +87,13 @@ const unsigned int s_cltableSizeInBlocks = 8;
 extern void GCM_ReverseHashBufferIfNeeded_CLMUL(byte *hashBuffer);
 #endif  // CRYPTOPP_CLMUL_AVAILABLE
 
+#if CRYPTOPP_CLMUL_AVAILABLE && CRYPTOPP_AESNI_AVAILABLE
+extern size_t GCM_AES_EncryptBlocks_AESNI(const word32 *subKeys, unsigned int rounds, byte *counter,
+    const byte *inBlocks, byte *outBlocks, size_t length, const byte *mtable, byte *hbuffer);
+extern size_t GCM_AES_DecryptBlocks_AESNI(const word32 *subKeys, unsigned int rounds, byte *counter,
+    const byte *inBlocks, byte *outBlocks, size_t length, const byte *mtable, byte *hbuffer);
+#endif  // CRYPTOPP_CLMUL_AVAILABLE && CRYPTOPP_AESNI_AVAILABLE
+
 #if CRYPTOPP_ARM_PMULL_AVAILABLE
 extern void GCM_SetKeyWithoutResync_PMULL(const byte *hashKey, byte *mulTable, unsigned int tableSize);
 extern size_t GCM_AuthenticateBlocks_PMULL(const byte *data, size_t len, const byte *mtable, byte *hbuffer);
@@ -826,6 +834,31 @@ size_t GCM_Base::AuthenticateBlocks(const byte *data, size_t len)
     return len%16;
 }
 
+size_t GCM_Base::ProcessAndAuthenticateBlocks(byte *outString, const byte *inString, size_t length)
+{
+#if CRYPTOPP_CLMUL_AVAILABLE && CRYPTOPP_AESNI_AVAILABLE
+    // The stitched kernel needs the AES-NI key schedule, which
+    // Rijndael only uses when SSE4.1 is available, too.
+    if (length >= 8*REQUIRED_BLOCKSIZE && HasCLMUL() && HasAESNI() && HasSSE41())
+    {
+        const Rijndael::Encryption *aes = dynamic_cast<const Rijndael::Encryption *>(&GetBlockCipher());
+        byte *counter = m_ctr.BlockAlignedCounter();
+        if (aes && counter)
+        {
+            if (IsForwardTransformation())
+                return GCM_AES_EncryptBlocks_AESNI(aes->m_key, aes->m_rounds, counter,
+                    inString, outString, length, MulTable(), HashBuffer());
+            else
+                return GCM_AES_DecryptBlocks_AESNI(aes->m_key, aes->m_rounds, counter,
+                    inString, outString, length, MulTable(), HashBuffer());
+        }
+    }
+#endif
+
+    CRYPTOPP_UNUSED(outString), CRYPTOPP_UNUSED(inString);
+    return length;
+}
+
 void GCM_Base::AuthenticateLastHeaderBlock()
 {
     if (m_bufferedDataLength > 0)
@@ -75,6 +75,7 @@ protected:
 	void AuthenticateLastHeaderBlock();
 	void AuthenticateLastConfidentialBlock();
 	void AuthenticateLastFooterBlock(byte *mac, size_t macSize);
+	size_t ProcessAndAuthenticateBlocks(byte *outString, const byte *inString, size_t length);
 	SymmetricCipher & AccessSymmetricCipher() {return m_ctr;}
 
 	virtual BlockCipher & AccessBlockCipher() =0;
@@ -88,6 +89,11 @@ protected:
 
 	class CRYPTOPP_DLL GCTR : public CTR_Mode_ExternalCipher::Encryption
 	{
+	public:
+		// The counter for the next block, or NULL if keystream is buffered
+		byte * BlockAlignedCounter()
+			{return m_leftOver == 0 ? m_counterArray.begin() : NULLPTR;}
+
 	protected:
 		void IncrementCounterBy256();
 	};
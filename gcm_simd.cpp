@@ -563,6 +563,178 @@ void GCM_ReverseHashBufferIfNeeded_CLMUL(byte *hashBuffer)
     _mm_storeu_si128(M128_CAST(hashBuffer), _mm_shuffle_epi8(
         _mm_loadu_si128(CONST_M128_CAST(hashBuffer)), mask));
 }
+
+#if CRYPTOPP_AESNI_AVAILABLE
+
+// Stitched AES-CTR and GHASH for GCM<AES>. The data is processed in
+// groups of 8 blocks. The AES rounds for one group are interleaved
+// with the carryless multiplies for 8 ciphertext blocks so the AES
+// and CLMUL units work at the same time. The 8 products are summed
+// with H^8..H^1 and reduced once per group. On decryption the hashed
+// ciphertext is the input group; on encryption it is the previous
+// output group, which is still in registers.
+
+inline void GCM_MultiplyAccumulate_CLMUL(const __m128i &x, const __m128i &h,
+    __m128i &c0, __m128i &c1, __m128i &c2)
+{
+    c0 = _mm_xor_si128(c0, _mm_clmulepi64_si128(x,h,0));
+    c1 = _mm_xor_si128(c1, _mm_xor_si128(_mm_clmulepi64_si128(x,h,1), _mm_clmulepi64_si128(x,h,0x10)));
+    c2 = _mm_xor_si128(c2, _mm_clmulepi64_si128(x,h,0x11));
+}
+
+// mtable holds the powers in pairs, with the low and high halves split
+// across 16-byte entries. See GCM_SetKeyWithoutResync_CLMUL.
+inline void GCM_LoadHashPowers_CLMUL(const byte *mtable, __m128i h[8])
+{
+    for (unsigned int i=0; i<4; i++)
+    {
+        const __m128i t0 = _mm_loadu_si128(CONST_M128_CAST(mtable+i*32+ 0));
+        const __m128i t1 = _mm_loadu_si128(CONST_M128_CAST(mtable+i*32+16));
+        h[2*i+0] = _mm_unpacklo_epi64(t0, t1);
+        h[2*i+1] = _mm_unpackhi_epi64(t0, t1);
+    }
+}
+
+// GCM increments the low 32 bits of the counter, big-endian
+inline void GCM_CounterBlocks_AESNI(const __m128i &ctr, const __m128i &mask, __m128i b[8])
+{
+    for (int i=0; i<8; i++)
+        b[i] = _mm_shuffle_epi8(_mm_add_epi32(ctr, _mm_set_epi32(0,0,0,i)), mask);
+}
+
+size_t GCM_AES_EncryptBlocks_AESNI(const word32 *subKeys, unsigned int rounds, byte *counter,
+    const byte *inBlocks, byte *outBlocks, size_t length, const byte *mtable, byte *hbuffer)
+{
+    const __m128i r = _mm_set_epi32(0xc2000000, 0x00000000, 0xe1000000, 0x00000000);
+    const __m128i m1 = _mm_set_epi32(0x00010203, 0x04050607, 0x08090a0b, 0x0c0d0e0f);
+    const __m128i* skeys = CONST_M128_CAST(subKeys);
+    const __m128i eight = _mm_set_epi32(0,0,0,8);
+
+    __m128i h[8], b[8], d[8];
+    GCM_LoadHashPowers_CLMUL(mtable, h);
+
+    __m128i x = _mm_loadu_si128(CONST_M128_CAST(hbuffer));
+    __m128i ctr = _mm_shuffle_epi8(_mm_loadu_si128(CONST_M128_CAST(counter)), m1);
+    bool pending = false;
+
+    while (length >= 128)
+    {
+        __m128i c0 = _mm_setzero_si128(), c1 = c0, c2 = c0;
+        __m128i rk = _mm_loadu_si128(skeys);
+
+        GCM_CounterBlocks_AESNI(ctr, m1, b);
+        ctr = _mm_add_epi32(ctr, eight);
+        for (int i=0; i<8; i++)
+            b[i] = _mm_xor_si128(b[i], rk);
+
+        for (unsigned int j=1; j<rounds; j++)
+        {
+            rk = _mm_loadu_si128(skeys+j);
+            for (int i=0; i<8; i++)
+                b[i] = _mm_aesenc_si128(b[i], rk);
+
+            // Hash the previous group, one block per round
+            if (pending && j <= 8)
+                GCM_MultiplyAccumulate_CLMUL(d[j-1], h[8-j], c0, c1, c2);
+        }
+
+        if (pending)
+            x = GCM_Reduce_CLMUL(c0, c1, c2, r);
+
+        rk = _mm_loadu_si128(skeys+rounds);
+        for (int i=0; i<8; i++)
+        {
+            b[i] = _mm_aesenclast_si128(b[i], rk);
+            b[i] = _mm_xor_si128(b[i], _mm_loadu_si128(CONST_M128_CAST(inBlocks+i*16)));
+            _mm_storeu_si128(M128_CAST(outBlocks+i*16), b[i]);
+            d[i] = _mm_shuffle_epi8(b[i], m1);
+        }
+        d[0] = _mm_xor_si128(d[0], x);
+        pending = true;
+
+        inBlocks += 128;
+        outBlocks += 128;
+        length -= 128;
+    }
+
+    // Hash the last group
+    if (pending)
+    {
+        __m128i c0 = _mm_setzero_si128(), c1 = c0, c2 = c0;
+        for (int i=0; i<8; i++)
+            GCM_MultiplyAccumulate_CLMUL(d[i], h[7-i], c0, c1, c2);
+
+        x = GCM_Reduce_CLMUL(c0, c1, c2, r);
+    }
+
+    _mm_storeu_si128(M128_CAST(counter), _mm_shuffle_epi8(ctr, m1));
+    _mm_storeu_si128(M128_CAST(hbuffer), x);
+    return length;
+}
+
+size_t GCM_AES_DecryptBlocks_AESNI(const word32 *subKeys, unsigned int rounds, byte *counter,
+    const byte *inBlocks, byte *outBlocks, size_t length, const byte *mtable, byte *hbuffer)
+{
+    const __m128i r = _mm_set_epi32(0xc2000000, 0x00000000, 0xe1000000, 0x00000000);
+    const __m128i m1 = _mm_set_epi32(0x00010203, 0x04050607, 0x08090a0b, 0x0c0d0e0f);
+    const __m128i* skeys = CONST_M128_CAST(subKeys);
+    const __m128i eight = _mm_set_epi32(0,0,0,8);
+
+    __m128i h[8], b[8], d[8];
+    GCM_LoadHashPowers_CLMUL(mtable, h);
+
+    __m128i x = _mm_loadu_si128(CONST_M128_CAST(hbuffer));
+    __m128i ctr = _mm_shuffle_epi8(_mm_loadu_si128(CONST_M128_CAST(counter)), m1);
+
+    while (length >= 128)
+    {
+        __m128i c0 = _mm_setzero_si128(), c1 = c0, c2 = c0;
+        __m128i rk = _mm_loadu_si128(skeys);
+
+        // Load the ciphertext before any store in case of in-place operation
+        for (int i=0; i<8; i++)
+            d[i] = _mm_loadu_si128(CONST_M128_CAST(inBlocks+i*16));
+
+        GCM_CounterBlocks_AESNI(ctr, m1, b);
+        ctr = _mm_add_epi32(ctr, eight);
+        for (int i=0; i<8; i++)
+            b[i] = _mm_xor_si128(b[i], rk);
+
+        for (unsigned int j=1; j<rounds; j++)
+        {
+            rk = _mm_loadu_si128(skeys+j);
+            for (int i=0; i<8; i++)
+                b[i] = _mm_aesenc_si128(b[i], rk);
+
+            // Hash this group, one block per round
+            if (j <= 8)
+            {
+                __m128i t = _mm_shuffle_epi8(d[j-1], m1);
+                if (j == 1) t = _mm_xor_si128(t, x);
+                GCM_MultiplyAccumulate_CLMUL(t, h[8-j], c0, c1, c2);
+            }
+        }
+
+        x = GCM_Reduce_CLMUL(c0, c1, c2, r);
+
+        rk = _mm_loadu_si128(skeys+rounds);
+        for (int i=0; i<8; i++)
+        {
+            b[i] = _mm_aesenclast_si128(b[i], rk);
+            _mm_storeu_si128(M128_CAST(outBlocks+i*16), _mm_xor_si128(b[i], d[i]));
+        }
+
+        inBlocks += 128;
+        outBlocks += 128;
+        length -= 128;
+    }
+
+    _mm_storeu_si128(M128_CAST(counter), _mm_shuffle_epi8(ctr, m1));
+    _mm_storeu_si128(M128_CAST(hbuffer), x);
+    return length;
+}
+
+#endif  // CRYPTOPP_AESNI_AVAILABLE
 #endif  // CRYPTOPP_CLMUL_AVAILABLE
 
 // ***************************** POWER8 ***************************** //
@@ -224,8 +224,11 @@ void DL_GroupParameters_IntegerBased::GenerateRandom(RandomNumberGenerator &rng,
 		if (!alg.GetIntValue("SubgroupOrderSize", subgroupOrderSize))
 			subgroupOrderSize = GetDefaultSubgroupOrderSize(modulusSize);
 
+		const int threads = alg.GetIntValueWithDefault("Threads", 1);
+
 		PrimeAndGenerator pg;
-		pg.Generate(GetFieldType() == 1 ? 1 : -1, rng, modulusSize, subgroupOrderSize);
+		pg.Generate(GetFieldType() == 1 ? 1 : -1, rng, modulusSize, subgroupOrderSize,
+			static_cast<unsigned int>(STDMAX(threads, 0)));
 		p = pg.Prime();
 		q = pg.SubPrime();
 		g = pg.Generator();
@@ -283,6 +286,15 @@ void DL_GroupParameters_IntegerBased::DEREncode(BufferedTransformation &bt) cons
 	parameters.MessageEnd();
 }
 
+bool DL_GroupParameters_IntegerBased::GetPrecomputationKey(std::string &key) const
+{
+	// The field type separates groups with the same parameters
+	StringSink sink(key);
+	sink.Put(static_cast<byte>(GetFieldType()));
+	DEREncode(sink);
+	return true;
+}
+
 bool DL_GroupParameters_IntegerBased::GetVoidValue(const char *name, const std::type_info &valueType, void *pValue) const
 {
 	return GetValueHelper<DL_GroupParameters<Element> >(this, name, valueType, pValue)
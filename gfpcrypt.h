@@ -170,6 +170,7 @@ protected:
     // GF(p) = 1, GF(p^2) = 2
     virtual int GetFieldType() const =0;
     virtual unsigned int GetDefaultSubgroupOrderSize(unsigned int modulusSize) const;
+    bool GetPrecomputationKey(std::string &key) const;
 
 private:
     Integer m_q;
@@ -72,6 +72,7 @@
 #include "sha.h"
 #include "cpu.h"
 #include "misc.h"
+#include "hrtimer.h"
 
 #include <iostream>
 
@@ -2407,14 +2408,47 @@ void MultiplyTop(word *R, word *T, const word *L, const word *A, const word *B,
 	}
 }
 
+// Operand sizes, in words, at which the Toom-4 and the number theoretic
+// transform tiers take over from Karatsuba. See SetMultiplyThresholds().
+// Other threads may change them while a multiplication is running, so a
+// multiplication reads them once and passes them down its recursion.
+#if defined(CRYPTOPP_CXX11_ATOMICS)
+static std::atomic<size_t> s_toom4Threshold(1024);
+static std::atomic<size_t> s_nttThreshold(131072);
+#else
+static size_t s_toom4Threshold = 1024;
+static size_t s_nttThreshold = 131072;
+#endif
+
+static void Toom4Multiply(word *R, const word *A, const word *B, size_t N, size_t toom4, size_t ntt);
+static bool NTTMultiply(word *R, const word *A, const word *B, size_t N);
+
+// R[2*N] - result = A*B
+// T[2*N] - temporary work space
+// A[N] --- multiplier
+// B[N] --- multiplicant
+// Squares when A == B. toom4 and ntt are the thresholds.
+
+inline void TieredMultiply(word *R, word *T, const word *A, const word *B, size_t N, size_t toom4, size_t ntt)
+{
+	if (N >= ntt && NTTMultiply(R, A, B, N))
+		return;
+	if (N >= toom4)
+		Toom4Multiply(R, A, B, N, toom4, ntt);
+	else if (A != B)
+		RecursiveMultiply(R, T, A, B, N);
+	else
+		RecursiveSquare(R, T, A, N);
+}
+
 inline void Multiply(word *R, word *T, const word *A, const word *B, size_t N)
 {
-	RecursiveMultiply(R, T, A, B, N);
+	TieredMultiply(R, T, A, B, N, s_toom4Threshold, s_nttThreshold);
 }
 
 inline void Square(word *R, word *T, const word *A, size_t N)
 {
-	RecursiveSquare(R, T, A, N);
+	Multiply(R, T, A, A, N);
 }
 
 inline void MultiplyBottom(word *R, word *T, const word *A, const word *B, size_t N)
@@ -2422,6 +2456,418 @@ inline void MultiplyBottom(word *R, word *T, const word *A, const word *B, size_
 	RecursiveMultiplyBottom(R, T, A, B, N);
 }
 
+// ********************************************************
+
+// Toom-4 splits the operands into four pieces of K words and evaluates
+// them at 0, 1, -1, 2, -2, 1/2 and infinity. K is a power of 2 because
+// N is, so the seven products are made by Multiply() on K words and a
+// small correction for the few bits above K words. The interpolation is
+// performed on L words in two's complement, so signed intermediate values
+// and the exact divisions by 2, 3, 4, 9 and 15 need no special care.
+
+// R[K+2] = X + 2**s * Y
+// T[K+2] - temporary work space
+// X[K], Y[K] - pieces
+
+static void Toom4Combine(word *R, word *T, const word *X, const word *Y, size_t K, unsigned int s)
+{
+	CopyWords(T, Y, K);
+	T[K] = ShiftWordsLeftByBits(T, K, s);
+	T[K+1] = 0;
+
+	CopyWords(R, X, K);
+	R[K] = R[K+1] = 0;
+	Add(R, R, T, K+2);
+}
+
+// R[K+2] = |X - Y|, returns true if X < Y
+
+static bool Toom4Difference(word *R, const word *X, const word *Y, size_t K)
+{
+	if (Compare(X, Y, K+2) >= 0)
+	{
+		Subtract(R, X, Y, K+2);
+		return false;
+	}
+
+	Subtract(R, Y, X, K+2);
+	return true;
+}
+
+// E[5*(K+2)] - magnitudes at 1, -1, 2, -2 and 8 times 1/2
+// neg[5] --- signs at the same points
+// T[3*K+6] - temporary work space
+
+static void Toom4Evaluate(word *E, bool neg[5], word *T, const word *A, size_t K)
+{
+	const size_t S = K+2;
+	word *X = T, *Y = T+S, *U = T+2*S;
+
+	// a0+a2 and a1+a3
+	Toom4Combine(X, U, A, A+2*K, K, 0);
+	Toom4Combine(Y, U, A+K, A+3*K, K, 0);
+	Add(E, X, Y, S);
+	neg[0] = false;
+	neg[1] = Toom4Difference(E+S, X, Y, K);
+
+	// a0+4*a2 and 2*a1+8*a3
+	Toom4Combine(X, U, A, A+2*K, K, 2);
+	Toom4Combine(Y, U, A+K, A+3*K, K, 2);
+	ShiftWordsLeftByBits(Y, S, 1);
+	Add(E+2*S, X, Y, S);
+	neg[2] = false;
+	neg[3] = Toom4Difference(E+3*S, X, Y, K);
+
+	// 8*a0+2*a2 and 4*a1+a3
+	Toom4Combine(X, U, A+2*K, A, K, 2);
+	Toom4Combine(Y, U, A+3*K, A+K, K, 2);
+	ShiftWordsLeftByBits(X, S, 1);
+	Add(E+4*S, X, Y, S);
+	neg[4] = false;
+}
+
+// P[2*K+4] - result = X*Y
+// T[3*K+2] - temporary work space
+// X[K+2] --- multiplier, at most 4 bits above K words
+// Y[K+2] --- multiplicant, at most 4 bits above K words
+
+static void Toom4PointMultiply(word *P, word *T, const word *X, const word *Y, size_t K, size_t toom4, size_t ntt)
+{
+	CRYPTOPP_ASSERT(X[K+1] == 0 && Y[K+1] == 0);
+	word *U = T+2*K;
+
+	TieredMultiply(P, T, X, Y, K, toom4, ntt);
+	SetWords(P+2*K, 0, 4);
+
+	if (X[K])
+	{
+		U[K] = LinearMultiply(U, Y, X[K], K);
+		U[K+1] = 0;
+		if (Add(P+K, P+K, U, K+2))
+			Increment(P+2*K+2, 2);
+	}
+	if (Y[K])
+	{
+		U[K] = LinearMultiply(U, X, Y[K], K);
+		U[K+1] = 0;
+		if (Add(P+K, P+K, U, K+2))
+			Increment(P+2*K+2, 2);
+	}
+	Increment(P+2*K, 4, X[K]*Y[K]);
+}
+
+// A[N] = A / d, in two's complement, for odd d dividing A
+// d must be less than 2**(WORD_BITS/2)
+
+static void DivideExact(word *A, size_t N, word d)
+{
+	const unsigned int h = WORD_BITS/2;
+	const word inv = AtomicInverseModPower2(d), mask = (word(1) << h) - 1;
+	CRYPTOPP_ASSERT(d <= mask);
+
+	word borrow = 0;
+	for (size_t i=0; i<N; i++)
+	{
+		const word s = A[i] - borrow;
+		borrow = (A[i] < borrow);
+		A[i] = s * inv;
+
+		// The high word of A[i]*d
+		borrow += ((A[i] >> h) * d + (((A[i] & mask) * d) >> h)) >> h;
+	}
+}
+
+// A[N] = A / 2**n, in two's complement, for 2**n dividing A
+
+static void ShiftRightExact(word *A, size_t N, unsigned int n)
+{
+	const bool negative = (A[N-1] >> (WORD_BITS-1)) != 0;
+
+	ShiftWordsRightByBits(A, N, n);
+	if (negative)
+		A[N-1] |= ~word(0) << (WORD_BITS-n);
+}
+
+// R[N] = R - 2**n * A
+// T[N] - temporary work space
+
+static void SubtractShifted(word *R, word *T, const word *A, unsigned int n, size_t N)
+{
+	CopyWords(T, A, N);
+	ShiftWordsLeftByBits(T, N, n);
+	Subtract(R, R, T, N);
+}
+
+// R[2*N] - result = A*B
+// A[N] --- multiplier
+// B[N] --- multiplicant
+// Squares when A == B. toom4 and ntt are the thresholds.
+
+static void Toom4Multiply(word *R, const word *A, const word *B, size_t N, size_t toom4, size_t ntt)
+{
+	CRYPTOPP_ASSERT(N>=16 && N%8==0);
+
+	const size_t K = N/4, S = K+2, L = 2*K+4;
+	IntegerSecBlock space(10*S + 9*L);
+
+	word *EA = space, *EB = EA+5*S, *V = EB+5*S, *T = V+7*L;
+	bool negA[5], negB[5];
+
+	Toom4Evaluate(EA, negA, T, A, K);
+	if (A != B)
+		Toom4Evaluate(EB, negB, T, B, K);
+	else
+		EB = EA, std::copy(negA, negA+5, negB);
+
+	word *r0 = V, *r1 = V+L, *rm1 = V+2*L, *r2 = V+3*L, *rm2 = V+4*L, *rh = V+5*L, *ri = V+6*L;
+	word *const r[5] = {r1, rm1, r2, rm2, rh};
+
+	TieredMultiply(r0, T, A, B, K, toom4, ntt);
+	SetWords(r0+2*K, 0, 4);
+	TieredMultiply(ri, T, A+3*K, B+3*K, K, toom4, ntt);
+	SetWords(ri+2*K, 0, 4);
+
+	for (unsigned int i=0; i<5; i++)
+	{
+		Toom4PointMultiply(r[i], T, EA+i*S, EB+i*S, K, toom4, ntt);
+		if (negA[i] != negB[i])
+			TwosComplement(r[i], L);
+	}
+
+	// r1 = c2+c4 and rm1 = c1+c3+c5
+	Add(T, r1, rm1, L);
+	Subtract(rm1, r1, rm1, L);
+	CopyWords(r1, T, L);
+	ShiftRightExact(r1, L, 1);
+	ShiftRightExact(rm1, L, 1);
+	Subtract(r1, r1, r0, L);
+	Subtract(r1, r1, ri, L);
+
+	// r2 = c2+4*c4 and rm2 = c1+4*c3+16*c5
+	Add(T, r2, rm2, L);
+	Subtract(rm2, r2, rm2, L);
+	CopyWords(r2, T, L);
+	ShiftRightExact(r2, L, 1);
+	ShiftRightExact(rm2, L, 2);
+	Subtract(r2, r2, r0, L);
+	SubtractShifted(r2, T, ri, 6, L);
+	ShiftRightExact(r2, L, 2);
+
+	// r2 = c4 and r1 = c2
+	Subtract(r2, r2, r1, L);
+	DivideExact(r2, L, 3);
+	Subtract(r1, r1, r2, L);
+
+	// rh = 16*c1+4*c3+c5
+	SubtractShifted(rh, T, r0, 6, L);
+	SubtractShifted(rh, T, r1, 4, L);
+	SubtractShifted(rh, T, r2, 2, L);
+	Subtract(rh, rh, ri, L);
+	ShiftRightExact(rh, L, 1);
+
+	// U = c3 = (17*(c1+c3+c5) - (c1+4*c3+16*c5) - (16*c1+4*c3+c5)) / 9
+	word *U = T+L;
+	CopyWords(U, rm1, L);
+	ShiftWordsLeftByBits(U, L, 4);
+	Add(U, U, rm1, L);
+	Subtract(U, U, rm2, L);
+	Subtract(U, U, rh, L);
+	DivideExact(U, L, 9);
+
+	// rm2 = c5-c1, rm1 = c1+c5, rh = c5 and rm1 = c1
+	Subtract(rm2, rm2, rh, L);
+	DivideExact(rm2, L, 15);
+	Subtract(rm1, rm1, U, L);
+	Add(rh, rm1, rm2, L);
+	ShiftRightExact(rh, L, 1);
+	Subtract(rm1, rm1, rh, L);
+
+	const word *const c[7] = {r0, rm1, r1, U, r2, rh, ri};
+	SetWords(R, 0, 2*N);
+	for (unsigned int i=0; i<7; i++)
+	{
+		const size_t offset = i*K, length = STDMIN(L, 2*N-offset);
+		if (Add(R+offset, R+offset, c[i], length) && offset+length < 2*N)
+			Increment(R+offset+length, 2*N-offset-length);
+	}
+}
+
+// ********************************************************
+
+// The number theoretic transform splits the operands into 16-bit digits
+// and convolves the digits modulo two primes with 2**23 and 2**26 roots
+// of unity. A convolution of D digits is less than D*2**32, so it is
+// recovered with the Chinese remainder theorem when D <= 2**22. The
+// forward transform leaves the values in bit reversed order and the
+// inverse transform takes them in that order, so no reordering is needed.
+
+// The primes are template arguments so the reductions are by constants
+static const word32 NTT_P1 = 998244353, NTT_P2 = 469762049;
+static const size_t NTT_MAX_LENGTH = size_t(1) << 23;
+
+inline word32 NTTMultiplyMod(word32 a, word32 b, word32 p)
+{
+	return word32(word64(a) * b % p);
+}
+
+static word32 NTTExponentiateMod(word32 a, word64 e, word32 p)
+{
+	word32 r = 1;
+	for (; e; e >>= 1, a = NTTMultiplyMod(a, a, p))
+		if (e & 1)
+			r = NTTMultiplyMod(r, a, p);
+	return r;
+}
+
+// Shoup's multiplication by a constant w with wp = floor(w * 2**32 / p)
+inline word32 NTTMultiplyConstant(word32 a, word32 w, word32 wp, word32 p)
+{
+	const word32 q = word32((word64(a) * wp) >> 32);
+	const word32 r = a*w - q*p;
+	return r >= p ? r-p : r;
+}
+
+// W[n] and WP[n] receive w**j for the (2*len)-th root of unity w
+// at W[len+j], for len = 1, 2, 4 ... n/2. The table for len is every
+// other entry of the table for 2*len. For the inverse transform
+// w**(-j) = -w**(len-j), and the Shoup constant of p-x is ~x'.
+
+template <word32 p>
+static void NTTRoots(word32 *W, word32 *WP, size_t n, bool inverse)
+{
+	const size_t half = n/2;
+	const word32 w = NTTExponentiateMod(3, (p-1)/n, p);
+
+	word32 x = 1;
+	for (size_t j=0; j<half; j++, x = NTTMultiplyMod(x, w, p))
+	{
+		W[half+j] = x;
+		WP[half+j] = word32((word64(x) << 32) / p);
+	}
+
+	if (inverse)
+	{
+		for (size_t j=1; j<half-j; j++)
+		{
+			std::swap(W[half+j], W[n-j]);
+			std::swap(WP[half+j], WP[n-j]);
+		}
+		for (size_t j=1; j<half; j++)
+		{
+			W[half+j] = p - W[half+j];
+			WP[half+j] = ~WP[half+j];
+		}
+	}
+
+	for (size_t len=half/2; len>=1; len/=2)
+		for (size_t j=0; j<len; j++)
+		{
+			W[len+j] = W[2*len+2*j];
+			WP[len+j] = WP[2*len+2*j];
+		}
+}
+
+template <word32 p>
+static void NTTForward(word32 *X, size_t n, const word32 *W, const word32 *WP)
+{
+	for (size_t len=n/2; len>=1; len/=2)
+		for (size_t i=0; i<n; i+=2*len)
+			for (size_t j=0; j<len; j++)
+			{
+				const word32 u = X[i+j], v = X[i+j+len], s = u+v;
+				X[i+j] = s >= p ? s-p : s;
+				X[i+j+len] = NTTMultiplyConstant(u-v+p, W[len+j], WP[len+j], p);
+			}
+}
+
+template <word32 p>
+static void NTTInverse(word32 *X, size_t n, const word32 *W, const word32 *WP)
+{
+	for (size_t len=1; len<n; len*=2)
+		for (size_t i=0; i<n; i+=2*len)
+			for (size_t j=0; j<len; j++)
+			{
+				const word32 u = X[i+j], v = NTTMultiplyConstant(X[i+j+len], W[len+j], WP[len+j], p);
+				const word32 s = u+v;
+				X[i+j] = s >= p ? s-p : s;
+				X[i+j+len] = u >= v ? u-v : u-v+p;
+			}
+}
+
+// X[n] = the 16-bit digits of A[N], zero padded
+
+static void NTTDigits(word32 *X, const word *A, size_t N, size_t n)
+{
+	const unsigned int D = WORD_BITS/16;
+
+	for (size_t i=0; i<N; i++)
+		for (unsigned int j=0; j<D; j++)
+			X[i*D+j] = word32(A[i] >> (16*j)) & 0xffff;
+	std::fill(X+N*D, X+n, word32(0));
+}
+
+// X[n] = the digits of A*B modulo p
+// T[3*n] - temporary work space
+
+template <word32 p>
+static void NTTConvolve(word32 *X, word32 *T, const word *A, const word *B, size_t N, size_t n)
+{
+	word32 *Y = T, *W = T+n, *WP = T+2*n;
+
+	NTTRoots<p>(W, WP, n, false);
+	NTTDigits(X, A, N, n);
+	NTTForward<p>(X, n, W, WP);
+	if (A != B)
+	{
+		NTTDigits(Y, B, N, n);
+		NTTForward<p>(Y, n, W, WP);
+	}
+	else
+		Y = X;
+
+	const word32 scale = NTTExponentiateMod(word32(n), p-2, p);
+	for (size_t i=0; i<n; i++)
+		X[i] = NTTMultiplyMod(NTTMultiplyMod(X[i], Y[i], p), scale, p);
+
+	NTTRoots<p>(W, WP, n, true);
+	NTTInverse<p>(X, n, W, WP);
+}
+
+// R[2*N] - result = A*B
+// A[N] --- multiplier
+// B[N] --- multiplicant
+// Squares when A == B. Returns false if N is too large.
+
+static bool NTTMultiply(word *R, const word *A, const word *B, size_t N)
+{
+	const size_t n = 2*N*(WORD_BITS/16);
+	if (n > NTT_MAX_LENGTH)
+		return false;
+
+	SecBlock<word32> space(5*n);
+	word32 *X1 = space, *X2 = X1+n, *T = X2+n;
+
+	NTTConvolve<NTT_P1>(X1, T, A, B, N, n);
+	NTTConvolve<NTT_P2>(X2, T, A, B, N, n);
+
+	// x = x1 + p1 * ((x2 - x1) / p1 mod p2), and propagate the carries
+	const word32 inverse = NTTExponentiateMod(NTT_P1 % NTT_P2, NTT_P2-2, NTT_P2);
+	const unsigned int D = WORD_BITS/16;
+	word64 carry = 0;
+
+	SetWords(R, 0, 2*N);
+	for (size_t i=0; i<n; i++)
+	{
+		const word32 t = NTTMultiplyMod(X2[i] + NTT_P2 - X1[i] % NTT_P2, inverse, NTT_P2);
+		carry += X1[i] + word64(NTT_P1) * t;
+		R[i/D] |= word(carry & 0xffff) << (16*(i%D));
+		carry >>= 16;
+	}
+
+	CRYPTOPP_ASSERT(carry == 0);
+	return true;
+}
+
 // R[NA+NB] - result = A*B
 // T[NA+NB] - temporary work space
 // A[NA] ---- multiplier
@@ -3627,6 +4073,7 @@ bool Integer::GenerateRandomNoThrow(RandomNumberGenerator &i_rng, const NameValu
 		case PRIME:
 		{
 			const PrimeSelector *pSelector = params.GetValueWithDefault(Name::PointerToPrimeSelector(), (const PrimeSelector *)NULLPTR);
+			const unsigned int threads = static_cast<unsigned int>(STDMAX(params.GetIntValueWithDefault("Threads", 1), 0));
 
 			int i;
 			i = 0;
@@ -3636,11 +4083,11 @@ bool Integer::GenerateRandomNoThrow(RandomNumberGenerator &i_rng, const NameValu
 				{
 					// check if there are any suitable primes in [min, max]
 					Integer first = min;
-					if (FirstPrime(first, max, equiv, mod, pSelector))
+					if (FirstPrime(first, max, equiv, mod, pSelector, threads))
 					{
 						// if there is only one suitable prime, we're done
 						*this = first;
-						if (!FirstPrime(first, max, equiv, mod, pSelector))
+						if (!FirstPrime(first, max, equiv, mod, pSelector, threads))
 							return true;
 					}
 					else
@@ -3648,7 +4095,7 @@ bool Integer::GenerateRandomNoThrow(RandomNumberGenerator &i_rng, const NameValu
 				}
 
 				Randomize(rng, min, max);
-				if (FirstPrime(*this, STDMIN(*this+mod*PrimeSearchInterval(max), max), equiv, mod, pSelector))
+				if (FirstPrime(*this, STDMIN(*this+mod*PrimeSearchInterval(max), max), equiv, mod, pSelector, threads))
 					return true;
 			}
 		}
@@ -4484,6 +4931,70 @@ word Integer::InverseMod(word mod) const
 	return 0;
 }
 
+void Integer::SetMultiplyThresholds(size_t toom4, size_t ntt)
+{
+	s_toom4Threshold = STDMAX(toom4, size_t(16));
+	s_nttThreshold = STDMAX(ntt, size_t(16));
+}
+
+void Integer::GetMultiplyThresholds(size_t &toom4, size_t &ntt)
+{
+	toom4 = s_toom4Threshold;
+	ntt = s_nttThreshold;
+}
+
+// Seconds for one multiplication of N words with the given thresholds,
+// averaged over at least 10 ms
+static double TimeMultiply(word *R, word *T, const word *A, const word *B, size_t N, size_t toom4, size_t ntt)
+{
+	Timer timer;
+	timer.StartTimer();
+
+	double elapsed;
+	unsigned int count = 0;
+	do
+	{
+		TieredMultiply(R, T, A, B, N, toom4, ntt);
+		count++;
+	}
+	while ((elapsed = timer.ElapsedTimeAsDouble()) < 0.01);
+
+	return elapsed / count;
+}
+
+void Integer::CalibrateMultiplyThresholds()
+{
+	const size_t maxWords = size_t(1) << 17;
+	IntegerSecBlock A(maxWords), B(maxWords), R(2*maxWords), T(2*maxWords);
+
+	// Any operands will do because the running time is not data dependent
+	word x = 1;
+	for (size_t i=0; i<maxWords; i++)
+	{
+		A[i] = x = x*69069+1;
+		B[i] = x = x*69069+1;
+	}
+
+	// The candidates are timed with their own thresholds, so other
+	// threads keep using the current ones until calibration ends
+	size_t toom4 = SIZE_MAX, ntt = SIZE_MAX;
+	for (size_t N=32; N<=maxWords && toom4==SIZE_MAX; N*=2)
+	{
+		const double karatsuba = TimeMultiply(R, T, A, B, N, SIZE_MAX, SIZE_MAX);
+		if (TimeMultiply(R, T, A, B, N, N, SIZE_MAX) < karatsuba)
+			toom4 = N;
+	}
+
+	for (size_t N=32; N<=maxWords && ntt==SIZE_MAX; N*=2)
+	{
+		const double lower = TimeMultiply(R, T, A, B, N, toom4, SIZE_MAX);
+		if (TimeMultiply(R, T, A, B, N, toom4, N) < lower)
+			ntt = N;
+	}
+
+	SetMultiplyThresholds(toom4, ntt);
+}
+
 // ********************************************************
 
 ModularArithmetic::ModularArithmetic(BufferedTransformation &bt)
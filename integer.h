@@ -485,6 +485,9 @@ public:
 		///     if (x.GenerateRandomNoThrow(prng, params) == false)
 		///         throw std::runtime_error("Failed to generate prime number");
 		/// </pre>
+		/// \details When a prime is requested the parameter <tt>Threads</tt> sets the number of
+		///   threads used to test candidates. The default is 1, and 0 means one thread per
+		///   processor. The result does not depend on the number of threads. Also see FirstPrime().
 		bool GenerateRandomNoThrow(RandomNumberGenerator &rng, const NameValuePairs &params = g_nullNameValuePairs);
 
 		/// \brief Generate a random number
@@ -690,6 +693,41 @@ public:
 		///  modulo the word <tt>n</tt>. If no Integer exists then word 0 is returned.
 		/// \sa a_times_b_mod_c() and a_exp_b_mod_c()
 		word InverseMod(word n) const;
+
+		/// \brief Set the multiplication thresholds
+		/// \param toom4 the operand size, in words, at which Toom-4 multiplication is used
+		/// \param ntt the operand size, in words, at which number theoretic transform
+		///  multiplication is used
+		/// \details Operands below both thresholds are multiplied using Karatsuba's method.
+		///  Toom-4 performs 7 multiplications of a quarter of the size, and the number
+		///  theoretic transform is asymptotically fastest. Operand sizes are rounded up to
+		///  a power of 2, so only powers of 2 are meaningful thresholds. <tt>SIZE_MAX</tt>
+		///  disables a method, and values less than 16 are raised to 16.
+		/// \details The thresholds are global. When <tt>CRYPTOPP_CXX11_ATOMICS</tt> is
+		///  defined they are atomic, and a multiplication reads them once when it starts,
+		///  so they can be changed while other threads perform Integer arithmetic.
+		///  Otherwise set them before other threads perform Integer arithmetic.
+		/// \sa GetMultiplyThresholds(), CalibrateMultiplyThresholds()
+		/// \since Crypto++ 8.3
+		static void CRYPTOPP_API SetMultiplyThresholds(size_t toom4, size_t ntt);
+
+		/// \brief Retrieve the multiplication thresholds
+		/// \param toom4 the operand size, in words, at which Toom-4 multiplication is used
+		/// \param ntt the operand size, in words, at which number theoretic transform
+		///  multiplication is used
+		/// \sa SetMultiplyThresholds(), CalibrateMultiplyThresholds()
+		/// \since Crypto++ 8.3
+		static void CRYPTOPP_API GetMultiplyThresholds(size_t &toom4, size_t &ntt);
+
+		/// \brief Calibrate the multiplication thresholds
+		/// \details CalibrateMultiplyThresholds() times each method against the methods
+		///  below it at increasing operand sizes, and sets the thresholds to the first
+		///  size at which the method is faster. Calibration takes about a second. It
+		///  does not change the thresholds until it finishes, and then it is subject to
+		///  the same restrictions as SetMultiplyThresholds().
+		/// \sa SetMultiplyThresholds(), GetMultiplyThresholds()
+		/// \since Crypto++ 8.3
+		static void CRYPTOPP_API CalibrateMultiplyThresholds();
 	//@}
 
 	/// \name INPUT/OUTPUT
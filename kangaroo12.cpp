@@ -0,0 +1,206 @@
+// kangaroo12.cpp - written and placed in the public domain by
+//                  the Crypto++ project.
+
+#include "pch.h"
+#include "config.h"
+
+#include "kangaroo12.h"
+#include "misc.h"
+
+NAMESPACE_BEGIN(CryptoPP)
+
+// The Keccak core function with fewer rounds
+extern void KeccakP1600(word64 *state, unsigned int rounds);
+// Sponges over many independent messages
+extern void KeccakSpongeMany(unsigned int rate, unsigned int rounds, byte pad,
+    byte *outputs, size_t outputLength, const byte *const *messages, const size_t *lengths, size_t count);
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+// Domain separation bytes of the single node, final node and leaves
+const byte K12_SINGLE_NODE = 0x07, K12_FINAL_NODE = 0x06, K12_LEAF = 0x0B;
+// Size of a leaf chaining value
+const unsigned int K12_CV_SIZE = 32;
+
+// length_encode(x): the big-endian bytes of x without leading zeros,
+// followed by the number of bytes. Returns the size of the encoding.
+unsigned int LengthEncode(byte out[9], lword x)
+{
+    unsigned int n = 0;
+    for (lword t = x; t; t >>= 8)
+        n++;
+    for (unsigned int i=0; i<n; i++)
+        out[i] = GETBYTE(x, n-1-i);
+    out[n] = static_cast<byte>(n);
+    return n+1;
+}
+
+ANONYMOUS_NAMESPACE_END
+
+KangarooTwelve::KangarooTwelve(unsigned int digestSize)
+    : m_digestSize(digestSize)
+{
+    Restart();
+}
+
+KangarooTwelve::KangarooTwelve(const byte *customization, size_t customizationLength, unsigned int digestSize)
+    : m_customization(customization, customizationLength), m_digestSize(digestSize)
+{
+    Restart();
+}
+
+void KangarooTwelve::Restart()
+{
+    std::memset(m_state, 0, m_state.SizeInBytes());
+    m_length = m_chunks = 0;
+    m_leafLength = 0;
+    m_counter = 0;
+}
+
+void KangarooTwelve::ThrowIfInvalidTruncatedSize(size_t size) const
+{
+    if (size > UINT_MAX)
+        throw InvalidArgument(std::string("HashTransformation: can't truncate a ") +
+            IntToString(UINT_MAX) + " byte digest to " + IntToString(size) + " bytes");
+}
+
+void KangarooTwelve::AbsorbFinalNode(const byte *input, size_t length)
+{
+    size_t spaceLeft;
+    while (length >= (spaceLeft = BLOCKSIZE - m_counter))
+    {
+        if (spaceLeft)
+            xorbuf(m_state.BytePtr() + m_counter, input, spaceLeft);
+        KeccakP1600(m_state, ROUNDS);
+        input += spaceLeft;
+        length -= spaceLeft;
+        m_counter = 0;
+    }
+
+    if (length)
+        xorbuf(m_state.BytePtr() + m_counter, input, length);
+    m_counter += (unsigned int)length;
+}
+
+void KangarooTwelve::HashLeaves(const byte *input, size_t length)
+{
+    CRYPTOPP_ASSERT(length > 0 && length <= LEAVES*CHUNKSIZE);
+
+    const byte *chunks[LEAVES];
+    size_t lengths[LEAVES];
+    byte cvs[LEAVES*K12_CV_SIZE];
+
+    size_t count = 0;
+    for (size_t offset = 0; offset < length; offset += CHUNKSIZE, count++)
+    {
+        chunks[count] = input + offset;
+        lengths[count] = STDMIN(size_t(CHUNKSIZE), length - offset);
+    }
+
+    KeccakSpongeMany(BLOCKSIZE, ROUNDS, K12_LEAF, cvs, K12_CV_SIZE, chunks, lengths, count);
+    AbsorbFinalNode(cvs, count*K12_CV_SIZE);
+    m_chunks += count;
+}
+
+void KangarooTwelve::AbsorbInput(const byte *input, size_t length)
+{
+    // The first chunk goes to the final node
+    if (m_length < CHUNKSIZE)
+    {
+        const size_t n = STDMIN(length, size_t(CHUNKSIZE - m_length));
+        AbsorbFinalNode(input, n);
+        m_length += n;
+        input += n;
+        length -= n;
+    }
+
+    if (length == 0)
+        return;
+
+    // Data beyond the first chunk switches the final node to tree mode
+    if (m_length == CHUNKSIZE)
+    {
+        const byte marker[8] = {0x03, 0, 0, 0, 0, 0, 0, 0};
+        AbsorbFinalNode(marker, sizeof(marker));
+    }
+    m_length += length;
+
+    const size_t batch = LEAVES*CHUNKSIZE;
+    while (length)
+    {
+        // Whole batches need no copy when nothing is buffered
+        if (m_leafLength == 0 && length >= batch)
+        {
+            HashLeaves(input, batch);
+            input += batch;
+            length -= batch;
+            continue;
+        }
+
+        if (m_leaves.empty())
+            m_leaves.New(batch);
+
+        const size_t n = STDMIN(length, batch - m_leafLength);
+        std::memcpy(m_leaves + m_leafLength, input, n);
+        m_leafLength += n;
+        input += n;
+        length -= n;
+
+        if (m_leafLength == batch)
+        {
+            HashLeaves(m_leaves, batch);
+            m_leafLength = 0;
+        }
+    }
+}
+
+void KangarooTwelve::Update(const byte *input, size_t length)
+{
+    CRYPTOPP_ASSERT(!(input == NULLPTR && length != 0));
+    if (length == 0) { return; }
+
+    AbsorbInput(input, length);
+}
+
+void KangarooTwelve::TruncatedFinal(byte *hash, size_t size)
+{
+    CRYPTOPP_ASSERT(hash != NULLPTR);
+    ThrowIfInvalidTruncatedSize(size);
+
+    // The input is the message, the customization string and its length
+    byte encoded[9];
+    if (!m_customization.empty())
+        AbsorbInput(m_customization, m_customization.size());
+    AbsorbInput(encoded, LengthEncode(encoded, m_customization.size()));
+
+    byte pad = K12_SINGLE_NODE;
+    if (m_length > CHUNKSIZE)
+    {
+        if (m_leafLength)
+            HashLeaves(m_leaves, m_leafLength);
+        m_leafLength = 0;
+
+        const byte terminator[2] = {0xFF, 0xFF};
+        AbsorbFinalNode(encoded, LengthEncode(encoded, m_chunks));
+        AbsorbFinalNode(terminator, sizeof(terminator));
+        pad = K12_FINAL_NODE;
+    }
+
+    m_state.BytePtr()[m_counter] ^= pad;
+    m_state.BytePtr()[BLOCKSIZE-1] ^= 0x80;
+
+    while (size > 0)
+    {
+        KeccakP1600(m_state, ROUNDS);
+
+        const size_t segmentLen = STDMIN(size, (size_t)BLOCKSIZE);
+        std::memcpy(hash, m_state, segmentLen);
+
+        hash += segmentLen;
+        size -= segmentLen;
+    }
+
+    Restart();
+}
+
+NAMESPACE_END
@@ -0,0 +1,92 @@
+// kangaroo12.h - written and placed in the public domain by
+//                the Crypto++ project.
+
+/// \file kangaroo12.h
+/// \brief Classes for KangarooTwelve message digest
+/// \details KangarooTwelve is a tree hash built on Keccak-p[1600] with 12 rounds.
+///   Messages up to 8 KiB are hashed by a single sponge. Longer messages are cut
+///   into 8 KiB chunks, every chunk after the first is hashed by its own leaf
+///   sponge, and the final node absorbs the first chunk followed by the chaining
+///   values of the leaves. The leaves are independent, so they are hashed several
+///   at a time with the interleaved Keccak kernels.
+/// \sa SHAKE128, ParallelHash128,
+///   <a href="https://keccak.team/kangarootwelve.html">KangarooTwelve</a> and
+///   <a href="https://datatracker.ietf.org/doc/draft-irtf-cfrg-kangarootwelve/">KangarooTwelve
+///   and TurboSHAKE</a>
+/// \since Crypto++ 8.3
+
+#ifndef CRYPTOPP_KANGAROO12_H
+#define CRYPTOPP_KANGAROO12_H
+
+#include "cryptlib.h"
+#include "secblock.h"
+
+NAMESPACE_BEGIN(CryptoPP)
+
+/// \brief KangarooTwelve message digest
+/// \details KangarooTwelve is an extendable output function. TruncatedFinal
+///   produces the correct output for any output size, and DigestSize only sets
+///   the size returned by Final. Crypto++ limits the output size to
+///   <tt>UINT_MAX</tt> due underlying data types.
+/// \details On x86 and x64 the leaves of long messages are hashed 4 (AVX2) or
+///   8 (AVX-512) at a time. The object buffers up to 8 chunks, or 64 KiB, of
+///   input to fill the lanes. Updates of at least 64 KiB that start on a chunk
+///   boundary are hashed in place.
+/// \since Crypto++ 8.3
+class KangarooTwelve : public HashTransformation
+{
+public:
+    CRYPTOPP_CONSTANT(DIGESTSIZE = 32);
+    CRYPTOPP_CONSTANT(BLOCKSIZE = 168);
+    CRYPTOPP_CONSTANT(CHUNKSIZE = 8192);
+    CRYPTOPP_CONSTANT(ROUNDS = 12);
+    static std::string StaticAlgorithmName() { return "KangarooTwelve"; }
+
+    /// \brief Construct a KangarooTwelve message digest
+    /// \param digestSize the digest size, in bytes
+    KangarooTwelve(unsigned int digestSize=DIGESTSIZE);
+
+    /// \brief Construct a KangarooTwelve message digest
+    /// \param customization the customization string
+    /// \param customizationLength the size of the customization string, in bytes
+    /// \param digestSize the digest size, in bytes
+    KangarooTwelve(const byte *customization, size_t customizationLength, unsigned int digestSize=DIGESTSIZE);
+
+    unsigned int DigestSize() const {return m_digestSize;}
+    unsigned int OptimalDataAlignment() const {return GetAlignmentOf<word64>();}
+
+    /// \brief Provides the block size of the compression function
+    /// \return block size of the compression function, in bytes
+    /// \details BlockSize() returns the rate of the sponge.
+    unsigned int BlockSize() const { return BLOCKSIZE; }
+
+    std::string AlgorithmName() const { return StaticAlgorithmName(); }
+
+    void Update(const byte *input, size_t length);
+    void Restart();
+    void TruncatedFinal(byte *hash, size_t size);
+
+protected:
+    // Any output size is valid, but Crypto++
+    // uses an unsigned int for the size.
+    void ThrowIfInvalidTruncatedSize(size_t size) const;
+
+    CRYPTOPP_CONSTANT(LEAVES = 8);
+
+    // Absorbs input into the final node
+    void AbsorbFinalNode(const byte *input, size_t length);
+    // Routes the input to the final node or the leaves
+    void AbsorbInput(const byte *input, size_t length);
+    // Hashes chunks into leaves and absorbs their chaining values
+    void HashLeaves(const byte *input, size_t length);
+
+    FixedSizeSecBlock<word64, 25> m_state;
+    SecByteBlock m_customization, m_leaves;
+    lword m_length, m_chunks;
+    size_t m_leafLength;
+    unsigned int m_digestSize, m_counter;
+};
+
+NAMESPACE_END
+
+#endif
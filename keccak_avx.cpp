@@ -0,0 +1,129 @@
+// keccak_avx.cpp - written and placed in the public domain by
+//                  the Crypto++ project.
+//
+//    This source file uses intrinsics and built-ins to gain access to
+//    AVX2 instructions. A separate source file is needed because
+//    additional CXXFLAGS are required to enable the appropriate
+//    instructions sets in some build configurations.
+//
+//    The code runs Keccak-p[1600] on 4 states at a time, one state per
+//    64-bit lane of a YMM register. The states are interleaved, so word
+//    i of state j is state[i*4+j]. The caller in keccak_core.cpp drives
+//    the sponges and handles the byte order.
+
+#include "pch.h"
+#include "config.h"
+#include "misc.h"
+
+#if (CRYPTOPP_AVX2_AVAILABLE)
+# include <emmintrin.h>
+# include <immintrin.h>
+#endif
+
+// Squash MS LNK4221 and libtool warnings
+extern const char KECCAK_AVX_FNAME[] = __FILE__;
+
+NAMESPACE_BEGIN(CryptoPP)
+
+#if (CRYPTOPP_AVX2_AVAILABLE)
+
+// The F1600 round constants
+extern const word64 KeccakF1600Constants[24];
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+template <unsigned int R>
+inline __m256i ROL(const __m256i val)
+{
+    return _mm256_or_si256(_mm256_slli_epi64(val, R), _mm256_srli_epi64(val, 64-R));
+}
+
+template <>
+inline __m256i ROL<8>(const __m256i val)
+{
+    const __m256i mask = _mm256_set_epi8(14,13,12,11, 10,9,8,15, 6,5,4,3, 2,1,0,7,
+                                         14,13,12,11, 10,9,8,15, 6,5,4,3, 2,1,0,7);
+    return _mm256_shuffle_epi8(val, mask);
+}
+
+template <>
+inline __m256i ROL<56>(const __m256i val)
+{
+    const __m256i mask = _mm256_set_epi8(8,15,14,13, 12,11,10,9, 0,7,6,5, 4,3,2,1,
+                                         8,15,14,13, 12,11,10,9, 0,7,6,5, 4,3,2,1);
+    return _mm256_shuffle_epi8(val, mask);
+}
+
+inline __m256i XOR(const __m256i a, const __m256i b)
+{
+    return _mm256_xor_si256(a, b);
+}
+
+inline void Round(__m256i A[25], const word64 rc)
+{
+    __m256i B[25], C[5], D[5];
+
+    // theta
+    for (unsigned int x=0; x<5; x++)
+        C[x] = XOR(XOR(XOR(A[x], A[x+5]), XOR(A[x+10], A[x+15])), A[x+20]);
+    for (unsigned int x=0; x<5; x++)
+        D[x] = XOR(C[(x+4)%5], ROL<1>(C[(x+1)%5]));
+
+    // rho and pi
+    B[ 0] = XOR(A[ 0], D[0]);
+    B[10] = ROL< 1>(XOR(A[ 1], D[1]));
+    B[20] = ROL<62>(XOR(A[ 2], D[2]));
+    B[ 5] = ROL<28>(XOR(A[ 3], D[3]));
+    B[15] = ROL<27>(XOR(A[ 4], D[4]));
+    B[16] = ROL<36>(XOR(A[ 5], D[0]));
+    B[ 1] = ROL<44>(XOR(A[ 6], D[1]));
+    B[11] = ROL< 6>(XOR(A[ 7], D[2]));
+    B[21] = ROL<55>(XOR(A[ 8], D[3]));
+    B[ 6] = ROL<20>(XOR(A[ 9], D[4]));
+    B[ 7] = ROL< 3>(XOR(A[10], D[0]));
+    B[17] = ROL<10>(XOR(A[11], D[1]));
+    B[ 2] = ROL<43>(XOR(A[12], D[2]));
+    B[12] = ROL<25>(XOR(A[13], D[3]));
+    B[22] = ROL<39>(XOR(A[14], D[4]));
+    B[23] = ROL<41>(XOR(A[15], D[0]));
+    B[ 8] = ROL<45>(XOR(A[16], D[1]));
+    B[18] = ROL<15>(XOR(A[17], D[2]));
+    B[ 3] = ROL<21>(XOR(A[18], D[3]));
+    B[13] = ROL< 8>(XOR(A[19], D[4]));
+    B[14] = ROL<18>(XOR(A[20], D[0]));
+    B[24] = ROL< 2>(XOR(A[21], D[1]));
+    B[ 9] = ROL<61>(XOR(A[22], D[2]));
+    B[19] = ROL<56>(XOR(A[23], D[3]));
+    B[ 4] = ROL<14>(XOR(A[24], D[4]));
+
+    // chi
+    for (unsigned int y=0; y<25; y+=5)
+    {
+        for (unsigned int x=0; x<5; x++)
+            A[y+x] = XOR(B[y+x], _mm256_andnot_si256(B[y+(x+1)%5], B[y+(x+2)%5]));
+    }
+
+    // iota
+    A[0] = XOR(A[0], _mm256_set1_epi64x(static_cast<long long>(rc)));
+}
+
+ANONYMOUS_NAMESPACE_END
+
+void KeccakP1600x4_AVX2(word64 *state, unsigned int rounds)
+{
+    CRYPTOPP_ASSERT(rounds <= 24);
+
+    __m256i A[25];
+    for (unsigned int i=0; i<25; i++)
+        A[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state+i*4));
+
+    for (unsigned int round = 24-rounds; round < 24; round++)
+        Round(A, KeccakF1600Constants[round]);
+
+    for (unsigned int i=0; i<25; i++)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(state+i*4), A[i]);
+}
+
+#endif  // CRYPTOPP_AVX2_AVAILABLE
+
+NAMESPACE_END
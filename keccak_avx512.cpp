@@ -0,0 +1,130 @@
+// keccak_avx512.cpp - written and placed in the public domain by
+//                     the Crypto++ project.
+//
+//    This source file uses intrinsics and built-ins to gain access to
+//    AVX-512 instructions. A separate source file is needed because
+//    additional CXXFLAGS are required to enable the appropriate
+//    instructions sets in some build configurations.
+//
+//    The code runs Keccak-p[1600] on 8 states at a time, one state per
+//    64-bit lane of a ZMM register. AVX-512 provides rotates, and chi and
+//    the theta parities map onto ternary logic. The states are interleaved,
+//    so word i of state j is state[i*8+j].
+
+#include "pch.h"
+#include "config.h"
+#include "misc.h"
+
+#if (CRYPTOPP_AVX512_AVAILABLE)
+# include <emmintrin.h>
+# include <immintrin.h>
+#endif
+
+// Squash MS LNK4221 and libtool warnings
+extern const char KECCAK_AVX512_FNAME[] = __FILE__;
+
+// GCC 12 warns the __Y operand in avx512fintrin.h is used
+// uninitialized. It is the self-initialized placeholder of the
+// _mm512_undefined intrinsics and not a variable in this file.
+#if CRYPTOPP_GCC_DIAGNOSTIC_AVAILABLE
+# pragma GCC diagnostic ignored "-Wuninitialized"
+# if (CRYPTOPP_GCC_VERSION >= 40700)
+#  pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+# endif
+#endif
+
+NAMESPACE_BEGIN(CryptoPP)
+
+#if (CRYPTOPP_AVX512_AVAILABLE)
+
+// The F1600 round constants
+extern const word64 KeccakF1600Constants[24];
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+// a ^ b ^ c
+inline __m512i XOR3(const __m512i a, const __m512i b, const __m512i c)
+{
+    return _mm512_ternarylogic_epi64(a, b, c, 0x96);
+}
+
+// a ^ (~b & c)
+inline __m512i CHI(const __m512i a, const __m512i b, const __m512i c)
+{
+    return _mm512_ternarylogic_epi64(a, b, c, 0xD2);
+}
+
+#define ROL(x, r) _mm512_rol_epi64((x), (r))
+#define XOR(a, b) _mm512_xor_si512((a), (b))
+
+inline void Round(__m512i A[25], const word64 rc)
+{
+    __m512i B[25], C[5], D[5];
+
+    // theta
+    for (unsigned int x=0; x<5; x++)
+        C[x] = XOR3(XOR3(A[x], A[x+5], A[x+10]), A[x+15], A[x+20]);
+    for (unsigned int x=0; x<5; x++)
+        D[x] = XOR(C[(x+4)%5], ROL(C[(x+1)%5], 1));
+
+    // rho and pi
+    B[ 0] = XOR(A[ 0], D[0]);
+    B[10] = ROL(XOR(A[ 1], D[1]),  1);
+    B[20] = ROL(XOR(A[ 2], D[2]), 62);
+    B[ 5] = ROL(XOR(A[ 3], D[3]), 28);
+    B[15] = ROL(XOR(A[ 4], D[4]), 27);
+    B[16] = ROL(XOR(A[ 5], D[0]), 36);
+    B[ 1] = ROL(XOR(A[ 6], D[1]), 44);
+    B[11] = ROL(XOR(A[ 7], D[2]),  6);
+    B[21] = ROL(XOR(A[ 8], D[3]), 55);
+    B[ 6] = ROL(XOR(A[ 9], D[4]), 20);
+    B[ 7] = ROL(XOR(A[10], D[0]),  3);
+    B[17] = ROL(XOR(A[11], D[1]), 10);
+    B[ 2] = ROL(XOR(A[12], D[2]), 43);
+    B[12] = ROL(XOR(A[13], D[3]), 25);
+    B[22] = ROL(XOR(A[14], D[4]), 39);
+    B[23] = ROL(XOR(A[15], D[0]), 41);
+    B[ 8] = ROL(XOR(A[16], D[1]), 45);
+    B[18] = ROL(XOR(A[17], D[2]), 15);
+    B[ 3] = ROL(XOR(A[18], D[3]), 21);
+    B[13] = ROL(XOR(A[19], D[4]),  8);
+    B[14] = ROL(XOR(A[20], D[0]), 18);
+    B[24] = ROL(XOR(A[21], D[1]),  2);
+    B[ 9] = ROL(XOR(A[22], D[2]), 61);
+    B[19] = ROL(XOR(A[23], D[3]), 56);
+    B[ 4] = ROL(XOR(A[24], D[4]), 14);
+
+    // chi
+    for (unsigned int y=0; y<25; y+=5)
+    {
+        for (unsigned int x=0; x<5; x++)
+            A[y+x] = CHI(B[y+x], B[y+(x+1)%5], B[y+(x+2)%5]);
+    }
+
+    // iota
+    A[0] = XOR(A[0], _mm512_set1_epi64(static_cast<long long>(rc)));
+}
+
+#undef ROL
+#undef XOR
+
+ANONYMOUS_NAMESPACE_END
+
+void KeccakP1600x8_AVX512(word64 *state, unsigned int rounds)
+{
+    CRYPTOPP_ASSERT(rounds <= 24);
+
+    __m512i A[25];
+    for (unsigned int i=0; i<25; i++)
+        A[i] = _mm512_loadu_si512(state+i*8);
+
+    for (unsigned int round = 24-rounds; round < 24; round++)
+        Round(A, KeccakF1600Constants[round]);
+
+    for (unsigned int i=0; i<25; i++)
+        _mm512_storeu_si512(state+i*8, A[i]);
+}
+
+#endif  // CRYPTOPP_AVX512_AVAILABLE
+
+NAMESPACE_END
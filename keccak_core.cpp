@@ -15,14 +15,31 @@ http://creativecommons.org/publicdomain/zero/1.0/
 
 #include "pch.h"
 #include "keccak.h"
+#include "secblock.h"
+#include "misc.h"
+#include "cpu.h"
 
 NAMESPACE_BEGIN(CryptoPP)
 
 // The Keccak core function
 extern void KeccakF1600(word64 *state);
+// The Keccak core function with fewer rounds
+extern void KeccakP1600(word64 *state, unsigned int rounds);
 // The F1600 round constants
 extern const word64 KeccakF1600Constants[24];
 
+// Sponges over many independent messages
+extern void KeccakSpongeMany(unsigned int rate, unsigned int rounds, byte pad,
+    byte *outputs, size_t outputLength, const byte *const *messages, const size_t *lengths, size_t count);
+
+#if (CRYPTOPP_AVX2_AVAILABLE)
+extern void KeccakP1600x4_AVX2(word64 *state, unsigned int rounds);
+#endif
+
+#if (CRYPTOPP_AVX512_AVAILABLE)
+extern void KeccakP1600x8_AVX512(word64 *state, unsigned int rounds);
+#endif
+
 NAMESPACE_END
 
 NAMESPACE_BEGIN(CryptoPP)
@@ -44,8 +61,12 @@ const word64 KeccakF1600Constants[24] =
     W64LIT(0x0000000080000001), W64LIT(0x8000000080008008)
 };
 
-void KeccakF1600(word64 *state)
+// Keccak-p[1600] with the last rounds of Keccak-f[1600]. The
+// loop is unrolled twice, so the number of rounds must be even.
+void KeccakP1600(word64 *state, unsigned int rounds)
 {
+    CRYPTOPP_ASSERT(rounds <= 24 && rounds % 2 == 0);
+
     word64 Aba, Abe, Abi, Abo, Abu;
     word64 Aga, Age, Agi, Ago, Agu;
     word64 Aka, Ake, Aki, Ako, Aku;
@@ -62,7 +83,7 @@ void KeccakF1600(word64 *state)
     typedef BlockGetAndPut<word64, LittleEndian, true, true> Block;
     Block::Get(state)(Aba)(Abe)(Abi)(Abo)(Abu)(Aga)(Age)(Agi)(Ago)(Agu)(Aka)(Ake)(Aki)(Ako)(Aku)(Ama)(Ame)(Ami)(Amo)(Amu)(Asa)(Ase)(Asi)(Aso)(Asu);
 
-    for( unsigned int round = 0; round < 24; round += 2 )
+    for( unsigned int round = 24 - rounds; round < 24; round += 2 )
     {
         //    prepareTheta
         BCa = Aba^Aga^Aka^Ama^Asa;
@@ -258,4 +279,215 @@ void KeccakF1600(word64 *state)
     Block::Put(NULLPTR, state)(Aba)(Abe)(Abi)(Abo)(Abu)(Aga)(Age)(Agi)(Ago)(Agu)(Aka)(Ake)(Aki)(Ako)(Aku)(Ama)(Ame)(Ami)(Amo)(Amu)(Asa)(Ase)(Asi)(Aso)(Asu);
 }
 
+void KeccakF1600(word64 *state)
+{
+    KeccakP1600(state, 24);
+}
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+// Per-lane bookkeeping for the sponges. A lane absorbs the whole
+// blocks of its message in place and then a padded final block.
+// The permutation that follows the final block also provides the
+// first block of output.
+struct KeccakLane
+{
+    const byte *data;
+    byte *output;
+    size_t length, outputLength;
+    bool absorbing;
+};
+
+inline void KeccakLaneStart(KeccakLane &lane, const byte *message, size_t length, byte *output, size_t outputLength)
+{
+    lane.data = message;
+    lane.length = length;
+    lane.output = output;
+    lane.outputLength = outputLength;
+    lane.absorbing = true;
+}
+
+// XOR the next block of the lane into the interleaved state, where
+// word i of lane j is state[i*L+j]. The words are in host order.
+template <unsigned int L>
+inline void KeccakLaneAbsorb(word64 *state, unsigned int j, KeccakLane &lane, unsigned int rate, byte pad)
+{
+    if (!lane.absorbing)
+        return;
+
+    CRYPTOPP_ALIGN_DATA(8) byte last[200];
+    const byte *block = lane.data;
+    if (lane.length >= rate)
+    {
+        lane.data += rate;
+        lane.length -= rate;
+    }
+    else
+    {
+        std::memset(last, 0, rate);
+        if (lane.length)
+            std::memcpy(last, lane.data, lane.length);
+        last[lane.length] ^= pad;
+        last[rate-1] ^= 0x80;
+        block = last;
+        lane.absorbing = false;
+    }
+
+    for (unsigned int i=0; i<rate/8; i++)
+        state[i*L+j] ^= GetWord<word64>(false, LITTLE_ENDIAN_ORDER, block+i*8);
+}
+
+// Copy the next block of output after a permutation. Returns
+// true when the lane has squeezed all of its output.
+template <unsigned int L>
+inline bool KeccakLaneSqueeze(const word64 *state, unsigned int j, KeccakLane &lane, unsigned int rate)
+{
+    if (lane.absorbing)
+        return false;
+
+    CRYPTOPP_ALIGN_DATA(8) byte block[200];
+    const size_t length = STDMIN(lane.outputLength, size_t(rate));
+    for (size_t i=0; i<(length+7)/8; i++)
+        PutWord(false, LITTLE_ENDIAN_ORDER, block+i*8, state[i*L+j]);
+
+    std::memcpy(lane.output, block, length);
+    lane.output += length;
+    lane.outputLength -= length;
+    return lane.outputLength == 0;
+}
+
+// KeccakP1600 on a state of words in host order
+inline void KeccakP1600x1(word64 *state, unsigned int rounds)
+{
+    ConditionalByteReverse(LITTLE_ENDIAN_ORDER, state, state, 200);
+    KeccakP1600(state, rounds);
+    ConditionalByteReverse(LITTLE_ENDIAN_ORDER, state, state, 200);
+}
+
+// Finish the lane one permutation at a time. st is the lane
+// state in host order.
+inline void KeccakLaneFinish(word64 *st, KeccakLane &lane, unsigned int rate, unsigned int rounds, byte pad)
+{
+    do
+    {
+        KeccakLaneAbsorb<1>(st, 0, lane, rate, pad);
+        KeccakP1600x1(st, rounds);
+    }
+    while (!KeccakLaneSqueeze<1>(st, 0, lane, rate));
+}
+
+#if (CRYPTOPP_AVX2_AVAILABLE || CRYPTOPP_AVX512_AVAILABLE)
+
+// Schedule the messages across the lanes of the multi-lane kernel.
+// Idle lanes permute a stale state. Once the last message has been
+// handed out and fewer than half the lanes remain busy, the stragglers
+// are finished one permutation at a time.
+template <unsigned int LANES, class F>
+void KeccakSpongeMany_MultiLane(F func, unsigned int rate, unsigned int rounds, byte pad,
+    byte *outputs, size_t outputLength, const byte *const *messages, const size_t *lengths, size_t count)
+{
+    FixedSizeAlignedSecBlock<word64, 25*LANES> state;
+    KeccakLane lanes[LANES];
+    bool busy[LANES] = {false};
+
+    size_t next = 0;
+    unsigned int active = 0;
+    while (true)
+    {
+        // Hand out new messages to idle lanes
+        for (unsigned int j=0; j<LANES && next<count; j++)
+        {
+            if (busy[j])
+                continue;
+
+            KeccakLaneStart(lanes[j], messages[next], lengths[next], outputs+next*outputLength, outputLength);
+            for (unsigned int i=0; i<25; i++)
+                state[i*LANES+j] = 0;
+            busy[j] = true;
+            active++;
+            next++;
+        }
+
+        if (active == 0)
+            break;
+
+        if (next == count && active < LANES/2)
+        {
+            for (unsigned int j=0; j<LANES; j++)
+            {
+                if (!busy[j])
+                    continue;
+
+                FixedSizeSecBlock<word64, 25> st;
+                for (unsigned int i=0; i<25; i++)
+                    st[i] = state[i*LANES+j];
+                KeccakLaneFinish(st, lanes[j], rate, rounds, pad);
+            }
+            break;
+        }
+
+        for (unsigned int j=0; j<LANES; j++)
+        {
+            if (busy[j])
+                KeccakLaneAbsorb<LANES>(state, j, lanes[j], rate, pad);
+        }
+
+        func(state, rounds);
+
+        for (unsigned int j=0; j<LANES; j++)
+        {
+            if (busy[j] && KeccakLaneSqueeze<LANES>(state, j, lanes[j], rate))
+            {
+                busy[j] = false;
+                active--;
+            }
+        }
+    }
+}
+
+#endif  // CRYPTOPP_AVX2_AVAILABLE || CRYPTOPP_AVX512_AVAILABLE
+
+ANONYMOUS_NAMESPACE_END
+
+// Absorb each message into its own sponge with the given rate and
+// number of rounds, pad it with the domain byte and 0x80, and squeeze
+// outputLength bytes to outputs+i*outputLength. The rate is a multiple
+// of 8 and less than 200. On x86 and x64 the sponges run 4 (AVX2) or
+// 8 (AVX-512) at a time.
+void KeccakSpongeMany(unsigned int rate, unsigned int rounds, byte pad,
+    byte *outputs, size_t outputLength, const byte *const *messages, const size_t *lengths, size_t count)
+{
+    CRYPTOPP_ASSERT(rate % 8 == 0 && rate < 200);
+    CRYPTOPP_ASSERT(outputs || count == 0 || outputLength == 0);
+    CRYPTOPP_ASSERT(messages || count == 0);
+    CRYPTOPP_ASSERT(lengths || count == 0);
+
+#if (CRYPTOPP_AVX512_AVAILABLE)
+    if (HasAVX512F() && HasAVX512BW() && HasAVX512VL() && count >= 4)
+    {
+        KeccakSpongeMany_MultiLane<8>(KeccakP1600x8_AVX512, rate, rounds, pad,
+            outputs, outputLength, messages, lengths, count);
+        return;
+    }
+#endif
+#if (CRYPTOPP_AVX2_AVAILABLE)
+    if (HasAVX2() && count >= 2)
+    {
+        KeccakSpongeMany_MultiLane<4>(KeccakP1600x4_AVX2, rate, rounds, pad,
+            outputs, outputLength, messages, lengths, count);
+        return;
+    }
+#endif
+
+    for (size_t i=0; i<count; i++)
+    {
+        FixedSizeSecBlock<word64, 25> st;
+        std::memset(st, 0, st.SizeInBytes());
+
+        KeccakLane lane;
+        KeccakLaneStart(lane, messages[i], lengths[i], outputs+i*outputLength, outputLength);
+        KeccakLaneFinish(st, lane, rate, rounds, pad);
+    }
+}
+
 NAMESPACE_END
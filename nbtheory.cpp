@@ -9,11 +9,14 @@
 #include "modarith.h"
 #include "algparam.h"
 #include "smartptr.h"
+#include "parallel.h"
 #include "misc.h"
 #include "stdcpp.h"
 
 #ifdef _OPENMP
 # include <omp.h>
+#elif defined(CRYPTOPP_CXX11_SYNCHRONIZATION)
+# include <mutex>
 #endif
 
 NAMESPACE_BEGIN(CryptoPP)
@@ -376,7 +379,224 @@ void PrimeSieve::DoSieve()
 	}
 }
 
+// ********************************************************
+
+// A candidate test for SearchSieve(). Screen() is the inexpensive part of
+// the test and Prove() is the expensive part. A parallel search can abandon
+// a candidate between the two.
+class PrimeCandidateTest
+{
+public:
+	virtual ~PrimeCandidateTest() {}
+	virtual bool Screen(const Integer &c) const =0;
+	virtual bool Prove(const Integer &c) const =0;
+};
+
+#if defined(_OPENMP) || defined(CRYPTOPP_CXX11_SYNCHRONIZATION)
+
+// Tests the candidates of a PrimeSieve on several threads. Candidates
+// are handed out in sieve order and numbered, and the search keeps the
+// lowest numbered candidate that passes. That is the candidate a single
+// thread finds, so the result does not depend on the number of threads.
+// Once a candidate passes, the candidates numbered after it are abandoned.
+class ParallelPrimeSearch : public ParallelTask
+{
+public:
+	ParallelPrimeSearch(PrimeSieve &sieve, const PrimeCandidateTest &test);
+	~ParallelPrimeSearch();
+
+	// returns false if a worker failed
+	bool Search(unsigned int threads);
+	bool GetPrime(Integer &p) const;
+
+	// Every task is a worker that takes candidates until the search ends
+	void Run(size_t index) {CRYPTOPP_UNUSED(index); Work();}
+
+private:
+	class Lock
+	{
+	public:
+		Lock(ParallelPrimeSearch &search);
+		~Lock();
+	private:
+		ParallelPrimeSearch &m_search;
+	};
+
+	bool Acquire(Integer &c, word64 &index);
+	bool Cancelled(word64 index);
+	void Report(const Integer &c, word64 index);
+	void Fail();
+	void Work();
+
+	static const word64 NOT_FOUND = ~word64(0);
+
+	PrimeSieve &m_sieve;
+	const PrimeCandidateTest &m_test;
+	word64 m_next, m_found;
+	bool m_failed;
+	Integer m_prime;
+#if defined(_OPENMP)
+	omp_lock_t m_lock;
+#else
+	std::mutex m_mutex;
+#endif
+};
+
+ParallelPrimeSearch::ParallelPrimeSearch(PrimeSieve &sieve, const PrimeCandidateTest &test)
+	: m_sieve(sieve), m_test(test), m_next(0), m_found(NOT_FOUND), m_failed(false)
+{
+#if defined(_OPENMP)
+	omp_init_lock(&m_lock);
+#endif
+}
+
+ParallelPrimeSearch::~ParallelPrimeSearch()
+{
+#if defined(_OPENMP)
+	omp_destroy_lock(&m_lock);
+#endif
+}
+
+ParallelPrimeSearch::Lock::Lock(ParallelPrimeSearch &search) : m_search(search)
+{
+#if defined(_OPENMP)
+	omp_set_lock(&m_search.m_lock);
+#else
+	m_search.m_mutex.lock();
+#endif
+}
+
+ParallelPrimeSearch::Lock::~Lock()
+{
+#if defined(_OPENMP)
+	omp_unset_lock(&m_search.m_lock);
+#else
+	m_search.m_mutex.unlock();
+#endif
+}
+
+bool ParallelPrimeSearch::Acquire(Integer &c, word64 &index)
+{
+	Lock lock(*this);
+
+	// Candidates are handed out in order, so the candidates
+	// still in the sieve are numbered after a passing one
+	if (m_failed || m_found != NOT_FOUND || !m_sieve.NextCandidate(c))
+		return false;
+
+	index = m_next++;
+	return true;
+}
+
+bool ParallelPrimeSearch::Cancelled(word64 index)
+{
+	Lock lock(*this);
+	return m_failed || index > m_found;
+}
+
+void ParallelPrimeSearch::Report(const Integer &c, word64 index)
+{
+	Lock lock(*this);
+	if (index < m_found)
+	{
+		m_found = index;
+		m_prime = c;
+	}
+}
+
+void ParallelPrimeSearch::Fail()
+{
+	Lock lock(*this);
+	m_failed = true;
+}
+
+void ParallelPrimeSearch::Work()
+{
+	try
+	{
+		Integer c;
+		word64 index;
+		while (Acquire(c, index))
+		{
+			if (m_test.Screen(c) && !Cancelled(index) && m_test.Prove(c))
+				Report(c, index);
+		}
+	}
+	catch (...)
+	{
+		// The caller repeats the search on its own thread
+		Fail();
+	}
+}
+
+bool ParallelPrimeSearch::Search(unsigned int threads)
+{
+	RunParallelTasks(*this, threads);
+	return !m_failed;
+}
+
+bool ParallelPrimeSearch::GetPrime(Integer &p) const
+{
+	if (m_found == NOT_FOUND)
+		return false;
+	p = m_prime;
+	return true;
+}
+
+#endif  // _OPENMP or CRYPTOPP_CXX11_SYNCHRONIZATION
+
+// Returns the first candidate of the sieve that passes the test. threads is
+// the number of threads to use, and 0 means one per processor.
+static bool SearchSieve(const PrimeSieve &sieve, Integer &p, const PrimeCandidateTest &test, unsigned int threads)
+{
+#if defined(_OPENMP) || defined(CRYPTOPP_CXX11_SYNCHRONIZATION)
+	if (threads == 0)
+		threads = DefaultThreadCount();
+
+	if (threads > 1)
+	{
+		// Tables used by the tests are initialized here
+		// so the workers do not race to create them
+		unsigned int primeTableSize;
+		(void)GetPrimeTable(primeTableSize);
+
+		PrimeSieve copy(sieve);
+		ParallelPrimeSearch search(copy, test);
+		if (search.Search(threads))
+			return search.GetPrime(p);
+	}
+#else
+	CRYPTOPP_UNUSED(threads);
+#endif
+
+	PrimeSieve copy(sieve);
+	while (copy.NextCandidate(p))
+	{
+		if (test.Screen(p) && test.Prove(p))
+			return true;
+	}
+
+	return false;
+}
+
+class FirstPrimeTest : public PrimeCandidateTest
+{
+public:
+	FirstPrimeTest(const PrimeSelector *pSelector) : m_pSelector(pSelector) {}
+	bool Screen(const Integer &c) const
+		{return (!m_pSelector || m_pSelector->IsAcceptable(c)) && FastProbablePrimeTest(c);}
+	bool Prove(const Integer &c) const
+		{return IsPrime(c);}
+
+	const PrimeSelector *m_pSelector;
+};
+
 bool FirstPrime(Integer &p, const Integer &max, const Integer &equiv, const Integer &mod, const PrimeSelector *pSelector)
+{
+	return FirstPrime(p, max, equiv, mod, pSelector, 1);
+}
+
+bool FirstPrime(Integer &p, const Integer &max, const Integer &equiv, const Integer &mod, const PrimeSelector *pSelector, unsigned int threads)
 {
 	CRYPTOPP_ASSERT(!equiv.IsNegative() && equiv < mod);
 
@@ -421,7 +641,7 @@ bool FirstPrime(Integer &p, const Integer &max, const Integer &equiv, const Inte
 	CRYPTOPP_ASSERT(p > primeTable[primeTableSize-1]);
 
 	if (mod.IsOdd())
-		return FirstPrime(p, max, CRT(equiv, mod, 1, 2, 1), mod<<1, pSelector);
+		return FirstPrime(p, max, CRT(equiv, mod, 1, 2, 1), mod<<1, pSelector, threads);
 
 	p += (equiv-p)%mod;
 
@@ -429,14 +649,7 @@ bool FirstPrime(Integer &p, const Integer &max, const Integer &equiv, const Inte
 		return false;
 
 	PrimeSieve sieve(p, max, mod);
-
-	while (sieve.NextCandidate(p))
-	{
-		if ((!pSelector || pSelector->IsAcceptable(p)) && FastProbablePrimeTest(p) && IsPrime(p))
-			return true;
-	}
-
-	return false;
+	return SearchSieve(sieve, p, FirstPrimeTest(pSelector), threads);
 }
 
 // the following two functions are based on code and comments provided by Preda Mihailescu
@@ -1051,7 +1264,31 @@ unsigned int DiscreteLogWorkFactor(unsigned int n)
 
 // ********************************************************
 
+class SafePrimeTest : public PrimeCandidateTest
+{
+public:
+	SafePrimeTest(signed int delta) : m_delta(delta) {}
+	bool Screen(const Integer &p) const
+	{
+		CRYPTOPP_ASSERT(IsSmallPrime(p) || SmallDivisorsTest(p));
+		const Integer q = (p-m_delta) >> 1;
+		CRYPTOPP_ASSERT(IsSmallPrime(q) || SmallDivisorsTest(q));
+		return FastProbablePrimeTest(q) && FastProbablePrimeTest(p);
+	}
+	bool Prove(const Integer &p) const
+	{
+		return IsPrime((p-m_delta) >> 1) && IsPrime(p);
+	}
+
+	signed int m_delta;
+};
+
 void PrimeAndGenerator::Generate(signed int delta, RandomNumberGenerator &rng, unsigned int pbits, unsigned int qbits)
+{
+	Generate(delta, rng, pbits, qbits, 1);
+}
+
+void PrimeAndGenerator::Generate(signed int delta, RandomNumberGenerator &rng, unsigned int pbits, unsigned int qbits, unsigned int threads)
 {
 	// no prime exists for delta = -1, qbits = 4, and pbits = 5
 	CRYPTOPP_ASSERT(qbits > 4);
@@ -1067,19 +1304,9 @@ void PrimeAndGenerator::Generate(signed int delta, RandomNumberGenerator &rng, u
 		{
 			p.Randomize(rng, minP, maxP, Integer::ANY, 6+5*delta, 12);
 			PrimeSieve sieve(p, STDMIN(p+PrimeSearchInterval(maxP)*12, maxP), 12, delta);
-
-			while (sieve.NextCandidate(p))
-			{
-				CRYPTOPP_ASSERT(IsSmallPrime(p) || SmallDivisorsTest(p));
-				q = (p-delta) >> 1;
-				CRYPTOPP_ASSERT(IsSmallPrime(q) || SmallDivisorsTest(q));
-				if (FastProbablePrimeTest(q) && FastProbablePrimeTest(p) && IsPrime(q) && IsPrime(p))
-				{
-					success = true;
-					break;
-				}
-			}
+			success = SearchSieve(sieve, p, SafePrimeTest(delta), threads);
 		}
+		q = (p-delta) >> 1;
 
 		if (delta == 1)
 		{
@@ -1108,8 +1335,10 @@ void PrimeAndGenerator::Generate(signed int delta, RandomNumberGenerator &rng, u
 
 		do
 		{
-			q.Randomize(rng, minQ, maxQ, Integer::PRIME);
-		} while (!p.Randomize(rng, minP, maxP, Integer::PRIME, delta%q, q));
+			q.GenerateRandom(rng, MakeParameters("Min", minQ)("Max", maxQ)
+				("RandomNumberType", Integer::PRIME)("Threads", int(threads)));
+		} while (!p.GenerateRandomNoThrow(rng, MakeParameters("Min", minP)("Max", maxP)
+				("RandomNumberType", Integer::PRIME)("EquivalentTo", delta%q)("Mod", q)("Threads", int(threads))));
 
 		// find a random g of order q
 		if (delta==1)
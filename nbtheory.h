@@ -130,6 +130,24 @@ public:
 ///   in <tt>{x | p<=x<=max and x%mod==equiv}</tt>
 CRYPTOPP_DLL bool CRYPTOPP_API FirstPrime(Integer &p, const Integer &max, const Integer &equiv, const Integer &mod, const PrimeSelector *pSelector);
 
+/// \brief Finds a random prime of special form using threads
+/// \param p an Integer reference to receive the prime
+/// \param max the maximum value
+/// \param equiv the equivalence class based on the parameter mod
+/// \param mod the modulus used to reduce the equivalence class
+/// \param pSelector pointer to a PrimeSelector function for the application to signal suitability
+/// \param threads the number of threads used to test candidates
+/// \returns true if and only if FirstPrime() finds a prime and returns the prime through p. If FirstPrime()
+///   returns false, then no such prime exists and the value of p is undefined
+/// \details FirstPrime() tests the candidates that survive the sieve on \p threads threads. 0 means one
+///   thread per processor. Threads stop taking candidates once a prime is found, and the prime
+///   returned is the one a single thread finds. When \p threads is greater than 1 the selector must be
+///   safe to call concurrently.
+/// \details Threads are used when the library is built with OpenMP or C++11 synchronization.
+///   Otherwise the candidates are tested on the calling thread.
+/// \since Crypto++ 8.3
+CRYPTOPP_DLL bool CRYPTOPP_API FirstPrime(Integer &p, const Integer &max, const Integer &equiv, const Integer &mod, const PrimeSelector *pSelector, unsigned int threads);
+
 CRYPTOPP_DLL unsigned int CRYPTOPP_API PrimeSearchInterval(const Integer &max);
 
 CRYPTOPP_DLL AlgorithmParameters CRYPTOPP_API MakeParametersForTwoPrimesOfEqualSize(unsigned int productBitLength);
@@ -296,6 +314,18 @@ public:
 	/// \details Generate() generates a random prime p of the form <tt>2*r*q+delta</tt>, where q is also prime.
 	void Generate(signed int delta, RandomNumberGenerator &rng, unsigned int pbits, unsigned qbits);
 
+	/// \brief Generate a Prime and Generator using threads
+	/// \param delta +1 or -1
+	/// \param rng a RandomNumberGenerator derived class
+	/// \param pbits the number of bits in the prime p
+	/// \param qbits the number of bits in the prime q
+	/// \param threads the number of threads used to test candidates
+	/// \details Generate() generates a random prime p of the form <tt>2*r*q+delta</tt>, where q is also prime.
+	///   Candidates are tested on \p threads threads, and 0 means one thread per processor. The
+	///   primes and generator do not depend on the number of threads. Also see FirstPrime().
+	/// \since Crypto++ 8.3
+	void Generate(signed int delta, RandomNumberGenerator &rng, unsigned int pbits, unsigned qbits, unsigned int threads);
+
 	/// \brief Retrieve first prime
 	/// \returns Prime() returns the prime p.
 	const Integer& Prime() const {return p;}
@@ -0,0 +1,630 @@
+// nistp.cpp - written and placed in the public domain by
+//             the Crypto++ project.
+//
+//    The field elements are arrays of words in Montgomery form with
+//    R = 2^(N*WORD_BITS), and the multiplication is the CIOS method
+//    from Koc, Acar and Kaliski's "Analyzing and Comparing Montgomery
+//    Multiplication Algorithms". Additions and subtractions reduce with
+//    masks instead of branches.
+//
+//    The points are in projective coordinates and use the complete
+//    formulas for a = -3 from Renes, Costello and Batina, "Complete
+//    addition formulas for prime order elliptic curves", Algorithms 4
+//    and 6. The formulas have no exceptional cases, so the identity and
+//    doubling need no special handling. Scalar multiplication uses fixed
+//    4-bit windows and reads every table entry for every window.
+
+#include "pch.h"
+#include "config.h"
+
+#ifndef CRYPTOPP_IMPORTS
+
+#include "nistp.h"
+#include "secblock.h"
+#include "misc.h"
+
+// Squash MS LNK4221 and libtool warnings
+extern const char NISTP_FNAME[] = __FILE__;
+
+NAMESPACE_BEGIN(CryptoPP)
+NAMESPACE_BEGIN(NISTP)
+
+#if (CRYPTOPP_NISTP_AVAILABLE)
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+const char P256_P[] = "FFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFFh";
+const char P256_B[] = "5AC635D8AA3A93E7B3EBBD55769886BC651D06B0CC53B0F63BCE3C3E27D2604Bh";
+const char P256_GX[] = "6B17D1F2E12C4247F8BCE6E563A440F277037D812DEB33A0F4A13945D898C296h";
+const char P256_GY[] = "4FE342E2FE1A7F9B8EE7EB4A7C0F9E162BCE33576B315ECECBB6406837BF51F5h";
+
+const char P384_P[] = "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFE"
+                      "FFFFFFFF0000000000000000FFFFFFFFh";
+const char P384_B[] = "B3312FA7E23EE7E4988E056BE3F82D19181D9C6EFE8141120314088F5013875A"
+                      "C656398D8A2ED19D2A85C8EDD3EC2AEFh";
+const char P384_GX[] = "AA87CA22BE8B05378EB1C71EF320AD746E1D3B628BA79B9859F741E082542A38"
+                       "5502F25DBF55296C3A545E3872760AB7h";
+const char P384_GY[] = "3617DE4A96262C6F5D9E98BF9292DC29F8F41DBD289A147CE9DA3113B5F0B8C0"
+                       "0A60B1CE1D7E819D7A431D7C90EA0E5Fh";
+
+// All ones if x is 0, and 0 otherwise
+inline word ZeroMask(word x)
+{
+	return ((x | (0-x)) >> (WORD_BITS-1)) - 1;
+}
+
+// r = a + b + carry, returns the carry out
+inline word AddWords(word &r, word a, word b, word carry)
+{
+	const word s = a + carry;
+	r = s + b;
+	return static_cast<word>(s < carry) | static_cast<word>(r < b);
+}
+
+// r = a - b - borrow, returns the borrow out
+inline word SubtractWords(word &r, word a, word b, word borrow)
+{
+	const word d = a - b;
+	r = d - borrow;
+	return static_cast<word>(a < b) | static_cast<word>(d < borrow);
+}
+
+// r = r + a*b + carry, returns the carry out. The sum fits in a dword.
+inline word MultiplyAddWords(word &r, word a, word b, word carry)
+{
+	const dword p = static_cast<dword>(a) * b + r + carry;
+	r = static_cast<word>(p);
+	return static_cast<word>(p >> WORD_BITS);
+}
+
+template <unsigned int N>
+void Load(word *r, const Integer &a)
+{
+	for (unsigned int i=0; i<N; i++)
+		r[i] = static_cast<word>(a.GetBits(i*WORD_BITS, WORD_BITS));
+}
+
+/// \brief Field arithmetic modulo a prime of N words
+template <unsigned int N>
+class Field
+{
+public:
+	Field(const Integer &p, const Integer &b)
+	{
+		Load<N>(m_p, p);
+		Load<N>(m_e, p-2);
+
+		// Newton's iteration for p^-1 mod 2^WORD_BITS, starting
+		// from p itself which is correct to 3 bits
+		word inv = m_p[0];
+		for (unsigned int i=0; i<6; i++)
+			inv *= 2 - m_p[0]*inv;
+		m_n0 = 0-inv;
+
+		const Integer r = Integer::Power2(N*WORD_BITS) % p;
+		Load<N>(m_one, r);
+		Load<N>(m_r2, r.Squared() % p);
+		Load<N>(m_b, b*r % p);
+	}
+
+	const word * One() const {return m_one;}
+	const word * B() const {return m_b;}
+
+	void Add(word *r, const word *a, const word *b) const
+	{
+		word t[N], carry = 0;
+		for (unsigned int i=0; i<N; i++)
+			carry = AddWords(t[i], a[i], b[i], carry);
+		Reduce(r, t, carry);
+	}
+
+	void Subtract(word *r, const word *a, const word *b) const
+	{
+		word t[N], borrow = 0;
+		for (unsigned int i=0; i<N; i++)
+			borrow = SubtractWords(t[i], a[i], b[i], borrow);
+
+		// Add p back if the subtraction borrowed
+		const word mask = 0-borrow;
+		word carry = 0;
+		for (unsigned int i=0; i<N; i++)
+			carry = AddWords(r[i], t[i], m_p[i] & mask, carry);
+	}
+
+	// a*b/R mod p. The product is computed first and then reduced a
+	// word at a time, which keeps the words in place.
+	void Multiply(word *r, const word *a, const word *b) const
+	{
+		word t[2*N];
+		for (unsigned int j=0; j<N; j++)
+			t[j] = 0;
+		for (unsigned int i=0; i<N; i++)
+		{
+			word carry = 0;
+			for (unsigned int j=0; j<N; j++)
+				carry = MultiplyAddWords(t[i+j], a[j], b[i], carry);
+			t[i+N] = carry;
+		}
+
+		word top = 0;
+		for (unsigned int i=0; i<N; i++)
+		{
+			const word m = t[i] * m_n0;
+			word carry = 0;
+			for (unsigned int j=0; j<N; j++)
+				carry = MultiplyAddWords(t[i+j], m, m_p[j], carry);
+			top = AddWords(t[i+N], t[i+N], carry, top);
+		}
+		Reduce(r, t+N, top);
+	}
+
+	void Square(word *r, const word *a) const
+	{
+		Multiply(r, a, a);
+	}
+
+	// a^(p-2). The exponent is public, so the loop may branch on it.
+	void Inverse(word *r, const word *a) const
+	{
+		word t[N];
+		Copy(t, m_one);
+		for (unsigned int i=N*WORD_BITS; i-- > 0; )
+		{
+			Square(t, t);
+			if ((m_e[i/WORD_BITS] >> (i%WORD_BITS)) & 1)
+				Multiply(t, t, a);
+		}
+		Copy(r, t);
+	}
+
+	void ConvertIn(word *r, const Integer &a) const
+	{
+		word t[N];
+		Load<N>(t, a);
+		Multiply(r, t, m_r2);
+	}
+
+	Integer ConvertOut(const word *a) const
+	{
+		word t[N], unit[N] = {1};
+		Multiply(t, a, unit);
+
+		SecByteBlock encoded(N*WORD_SIZE);
+		for (unsigned int i=0; i<N; i++)
+			PutWord(false, BIG_ENDIAN_ORDER, encoded+(N-1-i)*WORD_SIZE, t[i]);
+		return Integer(encoded, encoded.size());
+	}
+
+	bool IsZero(const word *a) const
+	{
+		word t = 0;
+		for (unsigned int i=0; i<N; i++)
+			t |= a[i];
+		return t == 0;
+	}
+
+	static void Copy(word *r, const word *a)
+	{
+		for (unsigned int i=0; i<N; i++)
+			r[i] = a[i];
+	}
+
+private:
+	// Subtract p from the N+1 word value carry:t if it is not less than p
+	void Reduce(word *r, const word *t, word carry) const
+	{
+		word s[N], borrow = 0;
+		for (unsigned int i=0; i<N; i++)
+			borrow = SubtractWords(s[i], t[i], m_p[i], borrow);
+
+		const word mask = 0 - (carry | (borrow ^ 1));
+		for (unsigned int i=0; i<N; i++)
+			r[i] = (s[i] & mask) | (t[i] & ~mask);
+	}
+
+	word m_p[N], m_e[N], m_one[N], m_r2[N], m_b[N];
+	word m_n0;
+};
+
+/// \brief Point in projective coordinates
+template <unsigned int N>
+struct ProjectivePoint
+{
+	word x[N], y[N], z[N];
+};
+
+/// \brief Curve y^2 = x^3 - 3x + b with N word field elements
+template <unsigned int N>
+class Curve
+{
+public:
+	typedef ProjectivePoint<N> Point;
+
+	// Windows of 4 bits covering the field
+	enum {WINDOWS = N*WORD_BITS/4};
+
+	Curve(const char *p, const char *b, const char *gx, const char *gy)
+		: m_p(p), m_field(m_p, Integer(b)), m_gx(gx), m_gy(gy), m_base(WINDOWS*16)
+	{
+		// Multiples 0 to 15 of 16^i*G for each window i
+		Point g;
+		ConvertIn(g, ECPPoint(m_gx, m_gy));
+		for (unsigned int i=0; i<WINDOWS; i++)
+		{
+			Point *table = &m_base[i*16];
+			BuildTable(table, g);
+			for (unsigned int j=0; j<4; j++)
+				Double(g, g);
+		}
+	}
+
+	bool IsGenerator(const ECPPoint &P) const
+	{
+		return !P.identity && P.x == m_gx && P.y == m_gy;
+	}
+
+	ECPPoint ScalarMultiply(const ECPPoint &P, const Integer &k) const
+	{
+		if (k.IsNegative())
+			return Negate(ScalarMultiply(P, -k));
+
+		const unsigned int windows = Windows(k);
+		SecByteBlock digits(windows);
+		Recode(digits, windows, k);
+
+		Point R, T;
+		Identity(R);
+
+		if (windows == WINDOWS && IsGenerator(P))
+		{
+			for (unsigned int i=0; i<windows; i++)
+			{
+				Select(T, &m_base[i*16], digits[i]);
+				Add(R, R, T);
+			}
+		}
+		else
+		{
+			Point table[16];
+			ConvertIn(T, P);
+			BuildTable(table, T);
+
+			for (unsigned int i=windows; i-- > 0; )
+			{
+				if (i != windows-1)
+				{
+					for (unsigned int j=0; j<4; j++)
+						Double(R, R);
+				}
+				Select(T, table, digits[i]);
+				Add(R, R, T);
+			}
+		}
+
+		return ConvertOut(R);
+	}
+
+	ECPPoint CascadeScalarMultiply(const ECPPoint &P, const Integer &k1, const ECPPoint &Q, const Integer &k2) const
+	{
+		if (k1.IsNegative())
+			return CascadeScalarMultiply(Negate(P), -k1, Q, k2);
+		if (k2.IsNegative())
+			return CascadeScalarMultiply(P, k1, Negate(Q), -k2);
+
+		const unsigned int windows = STDMAX(Windows(k1), Windows(k2));
+		SecByteBlock digits1(windows), digits2(windows);
+		Recode(digits1, windows, k1);
+		Recode(digits2, windows, k2);
+
+		Point table1[16], table2[16], R, T;
+		ConvertIn(T, P);
+		BuildTable(table1, T);
+		ConvertIn(T, Q);
+		BuildTable(table2, T);
+		Identity(R);
+
+		for (unsigned int i=windows; i-- > 0; )
+		{
+			if (i != windows-1)
+			{
+				for (unsigned int j=0; j<4; j++)
+					Double(R, R);
+			}
+			Select(T, table1, digits1[i]);
+			Add(R, R, T);
+			Select(T, table2, digits2[i]);
+			Add(R, R, T);
+		}
+
+		return ConvertOut(R);
+	}
+
+private:
+	unsigned int Windows(const Integer &k) const
+	{
+		return STDMAX((unsigned int)WINDOWS, (k.BitCount()+3)/4);
+	}
+
+	// Split k into 4-bit digits, least significant first
+	static void Recode(byte *digits, unsigned int windows, const Integer &k)
+	{
+		const size_t size = (windows+1)/2;
+		SecByteBlock encoded(size);
+		k.Encode(encoded, size);
+		for (unsigned int i=0; i<windows; i++)
+			digits[i] = (encoded[size-1-i/2] >> (4*(i%2))) & 15;
+	}
+
+	ECPPoint Negate(const ECPPoint &P) const
+	{
+		return P.identity ? P : ECPPoint(P.x, P.y.IsZero() ? P.y : m_p-P.y);
+	}
+
+	void Identity(Point &R) const
+	{
+		for (unsigned int i=0; i<N; i++)
+			R.x[i] = R.z[i] = 0;
+		Field<N>::Copy(R.y, m_field.One());
+	}
+
+	void ConvertIn(Point &R, const ECPPoint &P) const
+	{
+		if (P.identity)
+			return Identity(R);
+
+		m_field.ConvertIn(R.x, P.x);
+		m_field.ConvertIn(R.y, P.y);
+		Field<N>::Copy(R.z, m_field.One());
+	}
+
+	ECPPoint ConvertOut(const Point &P) const
+	{
+		if (m_field.IsZero(P.z))
+			return ECPPoint();
+
+		word zi[N], x[N], y[N];
+		m_field.Inverse(zi, P.z);
+		m_field.Multiply(x, P.x, zi);
+		m_field.Multiply(y, P.y, zi);
+		return ECPPoint(m_field.ConvertOut(x), m_field.ConvertOut(y));
+	}
+
+	// table[i] = i*P for i in [0,16)
+	void BuildTable(Point *table, const Point &P) const
+	{
+		Identity(table[0]);
+		table[1] = P;
+		for (unsigned int i=2; i<16; i++)
+		{
+			if (i % 2 == 0)
+				Double(table[i], table[i/2]);
+			else
+				Add(table[i], table[i-1], P);
+		}
+	}
+
+	// R = table[index], reading every entry
+	static void Select(Point &R, const Point *table, word index)
+	{
+		for (unsigned int j=0; j<N; j++)
+			R.x[j] = R.y[j] = R.z[j] = 0;
+
+		for (unsigned int i=0; i<16; i++)
+		{
+			const word mask = ZeroMask(i ^ index);
+			for (unsigned int j=0; j<N; j++)
+			{
+				R.x[j] |= table[i].x[j] & mask;
+				R.y[j] |= table[i].y[j] & mask;
+				R.z[j] |= table[i].z[j] & mask;
+			}
+		}
+	}
+
+	// Algorithm 4, complete addition for a = -3
+	void Add(Point &R, const Point &P, const Point &Q) const
+	{
+		const Field<N> &f = m_field;
+		word xx[N], yy[N], zz[N], xy[N], yz[N], xz[N], t0[N], t1[N];
+		word bzz3[N], ymb[N], ypb[N], zz3[N], bxz3[N], xx3[N];
+
+		f.Multiply(xx, P.x, Q.x);
+		f.Multiply(yy, P.y, Q.y);
+		f.Multiply(zz, P.z, Q.z);
+
+		f.Add(t0, P.x, P.y);
+		f.Add(t1, Q.x, Q.y);
+		f.Multiply(xy, t0, t1);
+		f.Add(t0, xx, yy);
+		f.Subtract(xy, xy, t0);
+
+		f.Add(t0, P.y, P.z);
+		f.Add(t1, Q.y, Q.z);
+		f.Multiply(yz, t0, t1);
+		f.Add(t0, yy, zz);
+		f.Subtract(yz, yz, t0);
+
+		f.Add(t0, P.x, P.z);
+		f.Add(t1, Q.x, Q.z);
+		f.Multiply(xz, t0, t1);
+		f.Add(t0, xx, zz);
+		f.Subtract(xz, xz, t0);
+
+		// bzz3 = 3(xz - b*zz)
+		f.Multiply(t0, f.B(), zz);
+		f.Subtract(t0, xz, t0);
+		f.Add(bzz3, t0, t0);
+		f.Add(bzz3, bzz3, t0);
+		f.Subtract(ymb, yy, bzz3);
+		f.Add(ypb, yy, bzz3);
+
+		// bxz3 = 3(b*xz - 3zz - xx)
+		f.Add(zz3, zz, zz);
+		f.Add(zz3, zz3, zz);
+		f.Multiply(t0, f.B(), xz);
+		f.Subtract(t0, t0, zz3);
+		f.Subtract(t0, t0, xx);
+		f.Add(bxz3, t0, t0);
+		f.Add(bxz3, bxz3, t0);
+
+		// xx3 = 3xx - 3zz
+		f.Add(t0, xx, xx);
+		f.Add(t0, t0, xx);
+		f.Subtract(xx3, t0, zz3);
+
+		f.Multiply(t0, ypb, xy);
+		f.Multiply(t1, yz, bxz3);
+		f.Subtract(R.x, t0, t1);
+
+		f.Multiply(t0, ypb, ymb);
+		f.Multiply(t1, xx3, bxz3);
+		f.Add(R.y, t0, t1);
+
+		f.Multiply(t0, ymb, yz);
+		f.Multiply(t1, xy, xx3);
+		f.Add(R.z, t0, t1);
+	}
+
+	// Algorithm 6, doubling for a = -3
+	void Double(Point &R, const Point &P) const
+	{
+		const Field<N> &f = m_field;
+		word xx[N], yy[N], zz[N], xy2[N], xz2[N], yz2[N], t0[N], t1[N];
+		word bzz3[N], ymb[N], ypb[N], zz3[N], bxz6[N], xx3[N];
+
+		f.Square(xx, P.x);
+		f.Square(yy, P.y);
+		f.Square(zz, P.z);
+
+		f.Multiply(xy2, P.x, P.y);
+		f.Add(xy2, xy2, xy2);
+		f.Multiply(xz2, P.x, P.z);
+		f.Add(xz2, xz2, xz2);
+		f.Multiply(yz2, P.y, P.z);
+		f.Add(yz2, yz2, yz2);
+
+		// bzz3 = 3(b*zz - 2xz)
+		f.Multiply(t0, f.B(), zz);
+		f.Subtract(t0, t0, xz2);
+		f.Add(bzz3, t0, t0);
+		f.Add(bzz3, bzz3, t0);
+		f.Subtract(ymb, yy, bzz3);
+		f.Add(ypb, yy, bzz3);
+
+		// bxz6 = 3(2b*xz - 3zz - xx)
+		f.Add(zz3, zz, zz);
+		f.Add(zz3, zz3, zz);
+		f.Multiply(t0, f.B(), xz2);
+		f.Subtract(t0, t0, zz3);
+		f.Subtract(t0, t0, xx);
+		f.Add(bxz6, t0, t0);
+		f.Add(bxz6, bxz6, t0);
+
+		// xx3 = 3xx - 3zz
+		f.Add(t0, xx, xx);
+		f.Add(t0, t0, xx);
+		f.Subtract(xx3, t0, zz3);
+
+		f.Multiply(t0, ymb, xy2);
+		f.Multiply(t1, bxz6, yz2);
+		f.Subtract(R.x, t0, t1);
+
+		f.Multiply(t0, ypb, ymb);
+		f.Multiply(t1, xx3, bxz6);
+		f.Add(R.y, t0, t1);
+
+		// z = 4y^2 * 2yz
+		f.Multiply(t0, yz2, yy);
+		f.Add(t0, t0, t0);
+		f.Add(R.z, t0, t0);
+	}
+
+	const Integer m_p;
+	const Field<N> m_field;
+	const Integer m_gx, m_gy;
+	std::vector<Point> m_base;
+};
+
+typedef Curve<256/WORD_BITS> Curve256;
+typedef Curve<384/WORD_BITS> Curve384;
+
+struct NewCurve256
+{
+	Curve256* operator()() const
+		{return new Curve256(P256_P, P256_B, P256_GX, P256_GY);}
+};
+
+struct NewCurve384
+{
+	Curve384* operator()() const
+		{return new Curve384(P384_P, P384_B, P384_GX, P384_GY);}
+};
+
+inline const Curve256& GetCurve256()
+{
+	return Singleton<Curve256, NewCurve256>().Ref();
+}
+
+inline const Curve384& GetCurve384()
+{
+	return Singleton<Curve384, NewCurve384>().Ref();
+}
+
+ANONYMOUS_NAMESPACE_END
+
+unsigned int IdentifyCurve(const Integer &p, const Integer &a, const Integer &b)
+{
+	// Check the size first to avoid decoding the constants
+	const unsigned int bits = p.BitCount();
+	if (bits == 256 && p == Integer(P256_P) && a == p-3 && b == Integer(P256_B))
+		return 256;
+	if (bits == 384 && p == Integer(P384_P) && a == p-3 && b == Integer(P384_B))
+		return 384;
+	return 0;
+}
+
+ECPPoint ScalarMultiply(unsigned int curve, const ECPPoint &P, const Integer &k)
+{
+	CRYPTOPP_ASSERT(curve == 256 || curve == 384);
+	if (curve == 256)
+		return GetCurve256().ScalarMultiply(P, k);
+	else
+		return GetCurve384().ScalarMultiply(P, k);
+}
+
+ECPPoint CascadeScalarMultiply(unsigned int curve, const ECPPoint &P, const Integer &k1, const ECPPoint &Q, const Integer &k2)
+{
+	CRYPTOPP_ASSERT(curve == 256 || curve == 384);
+	if (curve == 256)
+		return GetCurve256().CascadeScalarMultiply(P, k1, Q, k2);
+	else
+		return GetCurve384().CascadeScalarMultiply(P, k1, Q, k2);
+}
+
+#else  // CRYPTOPP_NISTP_AVAILABLE
+
+unsigned int IdentifyCurve(const Integer &p, const Integer &a, const Integer &b)
+{
+	CRYPTOPP_UNUSED(p); CRYPTOPP_UNUSED(a); CRYPTOPP_UNUSED(b);
+	return 0;
+}
+
+ECPPoint ScalarMultiply(unsigned int curve, const ECPPoint &P, const Integer &k)
+{
+	CRYPTOPP_UNUSED(curve); CRYPTOPP_UNUSED(P); CRYPTOPP_UNUSED(k);
+	throw NotImplemented("NISTP: dedicated curve arithmetic is not available");
+}
+
+ECPPoint CascadeScalarMultiply(unsigned int curve, const ECPPoint &P, const Integer &k1, const ECPPoint &Q, const Integer &k2)
+{
+	CRYPTOPP_UNUSED(curve); CRYPTOPP_UNUSED(P); CRYPTOPP_UNUSED(k1);
+	CRYPTOPP_UNUSED(Q); CRYPTOPP_UNUSED(k2);
+	throw NotImplemented("NISTP: dedicated curve arithmetic is not available");
+}
+
+#endif  // CRYPTOPP_NISTP_AVAILABLE
+
+NAMESPACE_END  // NISTP
+NAMESPACE_END  // CryptoPP
+
+#endif  // CRYPTOPP_IMPORTS
@@ -0,0 +1,65 @@
+// nistp.h - written and placed in the public domain by
+//           the Crypto++ project.
+
+/// \file nistp.h
+/// \details Fixed-width arithmetic for the NIST prime curves
+/// \details This header provides the entry points into the dedicated
+///   arithmetic for secp256r1 (P-256) and secp384r1 (P-384). The field
+///   elements use a fixed number of words in Montgomery form, and the
+///   points use the complete projective formulas of Renes, Costello and
+///   Batina from "Complete addition formulas for prime order elliptic
+///   curves", so the scalar multiplications have no branches or memory
+///   accesses that depend on secret data.
+/// \details The ECP class uses the functions when it recognizes the curve.
+///   The functions are in the <tt>NISTP</tt> namespace and operate on
+///   points in affine coordinates with field elements in their natural
+///   form.
+/// \since Crypto++ 8.3
+
+#ifndef CRYPTOPP_NISTP_H
+#define CRYPTOPP_NISTP_H
+
+#include "config.h"
+#include "integer.h"
+#include "ecpoint.h"
+
+// The field arithmetic needs a double word type to multiply words
+#if defined(CRYPTOPP_NATIVE_DWORD_AVAILABLE) && !defined(CRYPTOPP_DISABLE_NISTP)
+# define CRYPTOPP_NISTP_AVAILABLE 1
+#endif
+
+NAMESPACE_BEGIN(CryptoPP)
+NAMESPACE_BEGIN(NISTP)
+
+/// \brief Identify a curve
+/// \param p the prime modulus
+/// \param a the coefficient a, in natural form
+/// \param b the coefficient b, in natural form
+/// \returns 256 for secp256r1, 384 for secp384r1, and 0 otherwise
+/// \details IdentifyCurve() returns 0 when the dedicated arithmetic is
+///   not available.
+unsigned int IdentifyCurve(const Integer &p, const Integer &a, const Integer &b);
+
+/// \brief Multiply a point
+/// \param curve the curve returned by IdentifyCurve()
+/// \param P the point
+/// \param k the multiplier
+/// \returns k*P
+/// \details ScalarMultiply() uses a table of fixed-base multiples when P
+///   is the generator of the curve. The time taken depends on the bit
+///   length of k only when k is larger than the field.
+ECPPoint ScalarMultiply(unsigned int curve, const ECPPoint &P, const Integer &k);
+
+/// \brief Multiply two points and add the results
+/// \param curve the curve returned by IdentifyCurve()
+/// \param P the first point
+/// \param k1 the first multiplier
+/// \param Q the second point
+/// \param k2 the second multiplier
+/// \returns k1*P + k2*Q
+ECPPoint CascadeScalarMultiply(unsigned int curve, const ECPPoint &P, const Integer &k1, const ECPPoint &Q, const Integer &k2);
+
+NAMESPACE_END  // NISTP
+NAMESPACE_END  // CryptoPP
+
+#endif  // CRYPTOPP_NISTP_H
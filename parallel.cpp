@@ -0,0 +1,347 @@
+// parallel.cpp - written and placed in the public domain by
+//                the Crypto++ project.
+
+#include "pch.h"
+#include "config.h"
+
+#ifndef CRYPTOPP_IMPORTS
+
+#include "parallel.h"
+#include "algparam.h"
+#include "misc.h"
+
+#ifdef _OPENMP
+# include <omp.h>
+#elif defined(CRYPTOPP_CXX11_SYNCHRONIZATION)
+# include <algorithm>
+# include <condition_variable>
+# include <deque>
+# include <mutex>
+# include <thread>
+#endif
+
+NAMESPACE_BEGIN(CryptoPP)
+
+#if !defined(_OPENMP) && defined(CRYPTOPP_CXX11_SYNCHRONIZATION)
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+// A batch waiting for the pool. Tasks are claimed in index order by the
+// workers and by the calling thread, and m_running counts the claimed
+// tasks that have not finished.
+struct TaskBatch
+{
+	TaskBatch(ParallelTask &task, size_t count)
+		: m_task(task), m_count(count), m_next(0), m_running(0), m_done(count, 0) {}
+
+	ParallelTask &m_task;
+	size_t m_count, m_next, m_running;
+	std::vector<byte> m_done;
+	std::condition_variable m_finished;
+};
+
+// Process-wide pool of worker threads. Workers are started when a batch
+// needs more of them than are idle, and then wait for the next batch.
+// The pool is never destroyed, so the workers are detached.
+class WorkerPool
+{
+public:
+	WorkerPool() : m_idle(0) {}
+
+	void Run(ParallelTask &task, size_t count);
+
+private:
+	static void RunTask(TaskBatch &batch, size_t index);
+	bool Claim(TaskBatch &batch, size_t &index);
+	void Finish(TaskBatch &batch);
+	void Work();
+
+	std::mutex m_mutex;
+	std::condition_variable m_available;
+	std::deque<TaskBatch*> m_batches;
+	size_t m_idle;
+};
+
+inline WorkerPool & GetWorkerPool()
+{
+	return const_cast<WorkerPool&>(Singleton<WorkerPool>().Ref());
+}
+
+void WorkerPool::RunTask(TaskBatch &batch, size_t index)
+{
+	try
+	{
+		batch.m_task.Run(index);
+		batch.m_done[index] = 1;
+	}
+	catch (...)
+	{
+		// The caller runs the task again on its own thread
+	}
+}
+
+// Called with m_mutex held
+bool WorkerPool::Claim(TaskBatch &batch, size_t &index)
+{
+	if (batch.m_next == batch.m_count)
+		return false;
+
+	index = batch.m_next++;
+	batch.m_running++;
+	if (batch.m_next == batch.m_count)
+		m_batches.erase(std::find(m_batches.begin(), m_batches.end(), &batch));
+	return true;
+}
+
+// Called with m_mutex held. The caller cannot destroy the batch
+// before the lock is released, so the notification is safe.
+void WorkerPool::Finish(TaskBatch &batch)
+{
+	if (--batch.m_running == 0)
+		batch.m_finished.notify_all();
+}
+
+void WorkerPool::Work()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	for (;;)
+	{
+		while (m_batches.empty())
+			m_available.wait(lock);
+
+		TaskBatch &batch = *m_batches.front();
+		size_t index;
+		Claim(batch, index);
+		m_idle--;
+
+		lock.unlock();
+		RunTask(batch, index);
+		lock.lock();
+
+		m_idle++;
+		Finish(batch);
+	}
+}
+
+void WorkerPool::Run(ParallelTask &task, size_t count)
+{
+	TaskBatch batch(task, count);
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_batches.push_back(&batch);
+
+		// Start workers until every task but one can be claimed by an idle worker
+		try
+		{
+			for ( ; m_idle < count-1; m_idle++)
+				std::thread(&WorkerPool::Work, this).detach();
+		}
+		catch (const std::exception&)
+		{
+			// The calling thread claims the tasks of the missing workers
+		}
+	}
+	m_available.notify_all();
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	size_t index;
+	while (Claim(batch, index))
+	{
+		lock.unlock();
+		RunTask(batch, index);
+		lock.lock();
+		Finish(batch);
+	}
+
+	while (batch.m_running != 0)
+		batch.m_finished.wait(lock);
+	lock.unlock();
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (!batch.m_done[i])
+			task.Run(i);
+	}
+}
+
+ANONYMOUS_NAMESPACE_END
+
+#endif
+
+void RunParallelTasks(ParallelTask &task, size_t count)
+{
+	if (count == 0)
+		return;
+
+	if (count == 1)
+	{
+		task.Run(0);
+		return;
+	}
+
+#if defined(_OPENMP)
+	std::vector<byte> done(count, 0);
+
+	#pragma omp parallel for num_threads(static_cast<int>(count))
+	for (int i = 0; i < static_cast<int>(count); ++i)
+	{
+		try
+		{
+			task.Run(i);
+			done[i] = 1;
+		}
+		catch (...)
+		{
+			// The caller runs the task again on its own thread
+		}
+	}
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (!done[i])
+			task.Run(i);
+	}
+#elif defined(CRYPTOPP_CXX11_SYNCHRONIZATION)
+	GetWorkerPool().Run(task, count);
+#else
+	for (size_t i = 0; i < count; ++i)
+		task.Run(i);
+#endif
+}
+
+unsigned int DefaultThreadCount()
+{
+#if defined(_OPENMP)
+	return static_cast<unsigned int>(STDMAX(omp_get_max_threads(), 1));
+#elif defined(CRYPTOPP_CXX11_SYNCHRONIZATION)
+	return STDMAX(std::thread::hardware_concurrency(), 1U);
+#else
+	return 1;
+#endif
+}
+
+class ParallelFilter::ChunkTask : public ParallelTask
+{
+public:
+	ChunkTask(ParallelFilter &filter, const byte *data, size_t length)
+		: m_filter(filter), m_data(data), m_length(length) {}
+
+	void Run(size_t index)
+		{m_filter.ProcessChunk(index, m_data, m_length);}
+
+private:
+	ParallelFilter &m_filter;
+	const byte *m_data;
+	size_t m_length;
+};
+
+ParallelFilter::ParallelFilter(const ChunkTransformationFactory &factory, BufferedTransformation *attachment, unsigned int threads, size_t chunkSize)
+	: Filter(attachment), m_factory(factory), m_threads(1), m_chunkSize(0), m_pendingLength(0)
+	, m_message(0), m_chunk(0)
+{
+	IsolatedInitialize(MakeParameters("Threads", (int)threads)("ChunkSize", chunkSize));
+}
+
+void ParallelFilter::IsolatedInitialize(const NameValuePairs &parameters)
+{
+	int threads = parameters.GetIntValueWithDefault("Threads", (int)m_threads);
+	if (threads < 0)
+		throw InvalidArgument("ParallelFilter: " + IntToString(threads) + " is an invalid number of threads");
+	m_chunkSize = parameters.GetValueWithDefault("ChunkSize", m_chunkSize ? m_chunkSize : size_t(DEFAULT_CHUNK_SIZE));
+	if (m_chunkSize == 0)
+		throw InvalidArgument("ParallelFilter: the chunk size must be positive");
+
+	m_threads = threads ? static_cast<unsigned int>(threads) : DefaultThreadCount();
+	m_pending.New(m_threads*m_chunkSize);
+	m_pendingLength = 0;
+	m_message = m_chunk = 0;
+
+	m_chunks.resize(0);
+	m_chunks.resize(m_threads);
+}
+
+void ParallelFilter::ProcessChunk(size_t index, const byte *data, size_t length)
+{
+	const size_t start = index*m_chunkSize;
+	CRYPTOPP_ASSERT(start < length);
+
+	m_chunks[index].reset(m_factory.NewChunkTransformation(m_message, m_chunk+index));
+	m_chunks[index]->PutMessageEnd(data+start, STDMIN(m_chunkSize, length-start));
+}
+
+void ParallelFilter::ProcessBatch(const byte *data, size_t length)
+{
+	const size_t chunks = (length + m_chunkSize - 1) / m_chunkSize;
+	CRYPTOPP_ASSERT(chunks <= m_chunks.size());
+
+	ChunkTask task(*this, data, length);
+	RunParallelTasks(task, chunks);
+
+	for (size_t i = 0; i < chunks; ++i)
+	{
+		m_chunks[i]->TransferTo(*AttachedTransformation());
+		m_chunks[i].reset();
+	}
+
+	m_chunk += chunks;
+}
+
+size_t ParallelFilter::Put2(const byte *inString, size_t length, int messageEnd, bool blocking)
+{
+	if (!blocking)
+		throw BlockingInputOnly("ParallelFilter");
+
+	const size_t batch = m_threads*m_chunkSize;
+	while (length > 0)
+	{
+		// Whole batches need no copy when nothing is pending
+		if (m_pendingLength == 0 && length >= batch)
+		{
+			ProcessBatch(inString, batch);
+			inString += batch;
+			length -= batch;
+			continue;
+		}
+
+		const size_t accepted = STDMIN(batch - m_pendingLength, length);
+		memcpy_s(m_pending+m_pendingLength, m_pending.size()-m_pendingLength, inString, accepted);
+		m_pendingLength += accepted;
+		inString += accepted;
+		length -= accepted;
+
+		if (m_pendingLength == batch)
+		{
+			ProcessBatch(m_pending, batch);
+			m_pendingLength = 0;
+		}
+	}
+
+	if (messageEnd)
+	{
+		if (m_pendingLength)
+			ProcessBatch(m_pending, m_pendingLength);
+		m_pendingLength = 0;
+		m_message++;
+		m_chunk = 0;
+		Output(0, NULLPTR, 0, messageEnd, blocking);
+	}
+
+	return 0;
+}
+
+bool ParallelFilter::IsolatedFlush(bool hardFlush, bool blocking)
+{
+	if (!blocking)
+		throw BlockingInputOnly("ParallelFilter");
+
+	if (hardFlush && m_pendingLength)
+	{
+		ProcessBatch(m_pending, m_pendingLength);
+		m_pendingLength = 0;
+	}
+	return false;
+}
+
+NAMESPACE_END
+
+#endif  // CRYPTOPP_IMPORTS
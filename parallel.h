@@ -0,0 +1,139 @@
+// parallel.h - written and placed in the public domain by
+//              the Crypto++ project.
+
+/// \file parallel.h
+/// \brief Worker thread pool and a filter that transforms chunks of a stream on several threads
+/// \details RunParallelTasks() runs a batch of tasks on a process-wide pool of worker
+///   threads. The library uses it wherever it splits work across threads.
+/// \details ParallelFilter splits its input into chunks and hands each chunk to a
+///   separate transformation. The transformations of a batch of chunks run
+///   concurrently, and their outputs are passed on in the order of the chunks.
+///   The chunks are independent, so the filter suits per-chunk work like hashing,
+///   compression, or encryption with a key or nonce derived from the chunk index.
+/// \since Crypto++ 8.3
+
+#ifndef CRYPTOPP_PARALLEL_H
+#define CRYPTOPP_PARALLEL_H
+
+#include "cryptlib.h"
+#include "filters.h"
+#include "secblock.h"
+#include "smartptr.h"
+
+NAMESPACE_BEGIN(CryptoPP)
+
+/// \brief A batch of tasks run by RunParallelTasks()
+/// \since Crypto++ 8.3
+class CRYPTOPP_NO_VTABLE ParallelTask
+{
+public:
+	virtual ~ParallelTask() {}
+
+	/// \brief Runs a task
+	/// \param index the index of the task in the batch
+	/// \details Run() is called on the worker threads, so tasks with different
+	///   indexes must not share state. If Run() throws on a worker thread then it
+	///   is called again with the same index on the calling thread, so a task must
+	///   be able to start over after a partial run.
+	virtual void Run(size_t index) =0;
+};
+
+/// \brief Runs a batch of tasks concurrently
+/// \param task the tasks to run
+/// \param count the number of tasks
+/// \details RunParallelTasks() calls <tt>task.Run(i)</tt> for every i less than count and
+///   returns when all of them have finished. Each task may run on its own thread, and the
+///   calling thread runs tasks too.
+/// \details Threading uses OpenMP when available. Otherwise the tasks run on a process-wide
+///   pool of <tt>std::thread</tt> workers, which is grown on demand and reused by later
+///   batches, so a stream of small batches does not pay for starting threads. Tasks that
+///   no worker picks up, for example because a thread could not be started, run on the
+///   calling thread. A task that throws on a worker thread is run again on the calling
+///   thread after the others finish, so an exception reaches the caller with its
+///   original type.
+/// \details RunParallelTasks() may be called from inside a task. The calling thread
+///   never waits for a task that has not started, so nested batches do not deadlock.
+/// \since Crypto++ 8.3
+CRYPTOPP_DLL void CRYPTOPP_API RunParallelTasks(ParallelTask &task, size_t count);
+
+/// \brief Determines the number of threads to use by default
+/// \returns the number of threads used when 0 threads are requested
+/// \details DefaultThreadCount() returns the OpenMP maximum number of threads, or
+///   the number of hardware threads when OpenMP is not available. It returns 1
+///   when the library is built without threads.
+/// \since Crypto++ 8.3
+CRYPTOPP_DLL unsigned int CRYPTOPP_API DefaultThreadCount();
+
+/// \brief Creates the transformations of a ParallelFilter
+/// \details A ParallelFilter asks the factory for a new transformation for every
+///   chunk. The chunk is put to the transformation followed by a MessageEnd(), and
+///   the output is then retrieved from it. A Filter without an attachment keeps its
+///   output for retrieval, so <tt>new HashFilter(hash)</tt> is a typical result.
+/// \details NewChunkTransformation() is called on the worker threads, so it must be
+///   thread safe and the transformations must not share state. For example, each
+///   one should own its cipher or hash object.
+/// \since Crypto++ 8.3
+class CRYPTOPP_NO_VTABLE ChunkTransformationFactory
+{
+public:
+	virtual ~ChunkTransformationFactory() {}
+
+	/// \brief Creates the transformation for a chunk
+	/// \param message the index of the message, starting at 0
+	/// \param chunk the index of the chunk in the message, starting at 0
+	/// \returns a new transformation, which the ParallelFilter deletes
+	virtual BufferedTransformation * NewChunkTransformation(lword message, lword chunk) const =0;
+};
+
+/// \brief Filter that transforms chunks of a stream on several threads
+/// \details ParallelFilter collects up to <tt>threads*chunkSize</tt> bytes of input, then
+///   transforms the chunks of the batch concurrently and outputs the results in order.
+///   Memory use is bounded by one batch of input and its output. When no partial
+///   batch is pending, a full batch is processed in place from the caller's buffer.
+/// \details Every chunk is chunkSize bytes except the last of a message, which may be
+///   shorter. A hard flush also ends the current chunk early. The chunk index
+///   restarts at 0 with every message.
+/// \details The chunks of a batch are transformed with RunParallelTasks(). If a chunk
+///   fails on a worker thread it is transformed again on the calling thread, so an
+///   exception reaches the caller with its original type.
+/// \since Crypto++ 8.3
+class CRYPTOPP_DLL ParallelFilter : public Filter
+{
+public:
+	/// \brief Default size of a chunk
+	CRYPTOPP_CONSTANT(DEFAULT_CHUNK_SIZE = 256*1024);
+
+	/// \brief Construct a ParallelFilter
+	/// \param factory the factory for the transformation of each chunk
+	/// \param attachment an optional attached transformation
+	/// \param threads the number of chunks transformed concurrently
+	/// \param chunkSize the size of a chunk, in bytes
+	/// \details 0 threads means one thread per processor.
+	ParallelFilter(const ChunkTransformationFactory &factory, BufferedTransformation *attachment = NULLPTR,
+		unsigned int threads=0, size_t chunkSize=DEFAULT_CHUNK_SIZE);
+
+	/// \brief Retrieves the number of threads
+	/// \returns the number of chunks transformed concurrently
+	unsigned int GetThreads() const {return m_threads;}
+
+	void IsolatedInitialize(const NameValuePairs &parameters);
+	size_t Put2(const byte *inString, size_t length, int messageEnd, bool blocking);
+	bool IsolatedFlush(bool hardFlush, bool blocking);
+
+protected:
+	class ChunkTask;
+
+	void ProcessBatch(const byte *data, size_t length);
+	void ProcessChunk(size_t index, const byte *data, size_t length);
+
+	const ChunkTransformationFactory &m_factory;
+	unsigned int m_threads;
+	size_t m_chunkSize, m_pendingLength;
+	lword m_message, m_chunk;
+	SecByteBlock m_pending;
+	vector_member_ptrs<BufferedTransformation> m_chunks;
+};
+
+NAMESPACE_END
+
+#endif
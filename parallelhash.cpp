@@ -0,0 +1,191 @@
+// parallelhash.cpp - written and placed in the public domain by
+//                    the Crypto++ project.
+
+#include "pch.h"
+#include "config.h"
+
+#include "parallelhash.h"
+#include "misc.h"
+
+NAMESPACE_BEGIN(CryptoPP)
+
+// The Keccak core function
+extern void KeccakF1600(word64 *state);
+// Sponges over many independent messages
+extern void KeccakSpongeMany(unsigned int rate, unsigned int rounds, byte pad,
+    byte *outputs, size_t outputLength, const byte *const *messages, const size_t *lengths, size_t count);
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+// Domain separation bytes of SHAKE and cSHAKE
+const byte SHAKE_PAD = 0x1F, CSHAKE_PAD = 0x04;
+// Most blocks hashed at a time, and most input buffered for them
+const size_t MAX_LANES = 8, MAX_BUFFER = 1024*1024;
+
+// left_encode(x) and right_encode(x) from SP 800-185. Return
+// the size of the encoding.
+unsigned int LeftEncode(byte out[9], lword x)
+{
+    unsigned int n = 1;
+    for (lword t = x >> 8; t; t >>= 8)
+        n++;
+    out[0] = static_cast<byte>(n);
+    for (unsigned int i=0; i<n; i++)
+        out[1+i] = GETBYTE(x, n-1-i);
+    return n+1;
+}
+
+unsigned int RightEncode(byte out[9], lword x)
+{
+    unsigned int n = 1;
+    for (lword t = x >> 8; t; t >>= 8)
+        n++;
+    for (unsigned int i=0; i<n; i++)
+        out[i] = GETBYTE(x, n-1-i);
+    out[n] = static_cast<byte>(n);
+    return n+1;
+}
+
+ANONYMOUS_NAMESPACE_END
+
+ParallelHash::ParallelHash(unsigned int digestSize, size_t blockSize, const byte *customization, size_t customizationLength)
+    : m_customization(customization, customizationLength), m_count(0), m_blockSize(blockSize)
+    , m_lanes(1), m_bufferLength(0), m_digestSize(digestSize), m_counter(0)
+{
+    if (blockSize == 0)
+        throw InvalidArgument("ParallelHash: the block size must be positive");
+
+    // Large blocks are buffered fewer at a time
+    m_lanes = STDMAX(size_t(1), STDMIN(MAX_LANES, MAX_BUFFER / blockSize));
+}
+
+void ParallelHash::AbsorbOuter(const byte *input, size_t length)
+{
+    size_t spaceLeft;
+    while (length >= (spaceLeft = r() - m_counter))
+    {
+        if (spaceLeft)
+            xorbuf(m_state.BytePtr() + m_counter, input, spaceLeft);
+        KeccakF1600(m_state);
+        input += spaceLeft;
+        length -= spaceLeft;
+        m_counter = 0;
+    }
+
+    if (length)
+        xorbuf(m_state.BytePtr() + m_counter, input, length);
+    m_counter += (unsigned int)length;
+}
+
+void ParallelHash::Restart()
+{
+    std::memset(m_state, 0, m_state.SizeInBytes());
+    m_counter = 0;
+    m_count = 0;
+    m_bufferLength = 0;
+
+    // bytepad(encode_string(N) || encode_string(S), rate)
+    static const byte name[] = {'P','a','r','a','l','l','e','l','H','a','s','h'};
+    byte encoded[9];
+    AbsorbOuter(encoded, LeftEncode(encoded, r()));
+    AbsorbOuter(encoded, LeftEncode(encoded, lword(sizeof(name))*8));
+    AbsorbOuter(name, sizeof(name));
+    AbsorbOuter(encoded, LeftEncode(encoded, lword(m_customization.size())*8));
+    if (!m_customization.empty())
+        AbsorbOuter(m_customization, m_customization.size());
+    if (m_counter)
+    {
+        KeccakF1600(m_state);
+        m_counter = 0;
+    }
+
+    AbsorbOuter(encoded, LeftEncode(encoded, m_blockSize));
+}
+
+void ParallelHash::HashBlocks(const byte *input, size_t length)
+{
+    CRYPTOPP_ASSERT(length > 0 && length <= m_lanes*m_blockSize);
+
+    const byte *blocks[MAX_LANES];
+    size_t lengths[MAX_LANES];
+    byte outputs[MAX_LANES*64];
+    const unsigned int outputSize = 200 - r();
+
+    size_t count = 0;
+    for (size_t offset = 0; offset < length; offset += m_blockSize, count++)
+    {
+        blocks[count] = input + offset;
+        lengths[count] = STDMIN(m_blockSize, length - offset);
+    }
+
+    KeccakSpongeMany(r(), 24, SHAKE_PAD, outputs, outputSize, blocks, lengths, count);
+    AbsorbOuter(outputs, count*outputSize);
+    m_count += count;
+}
+
+void ParallelHash::Update(const byte *input, size_t length)
+{
+    CRYPTOPP_ASSERT(!(input == NULLPTR && length != 0));
+    if (length == 0) { return; }
+
+    const size_t batch = m_lanes*m_blockSize;
+    while (length)
+    {
+        // Whole batches need no copy when nothing is buffered
+        if (m_bufferLength == 0 && length >= batch)
+        {
+            HashBlocks(input, batch);
+            input += batch;
+            length -= batch;
+            continue;
+        }
+
+        if (m_blocks.empty())
+            m_blocks.New(batch);
+
+        const size_t n = STDMIN(length, batch - m_bufferLength);
+        std::memcpy(m_blocks + m_bufferLength, input, n);
+        m_bufferLength += n;
+        input += n;
+        length -= n;
+
+        if (m_bufferLength == batch)
+        {
+            HashBlocks(m_blocks, batch);
+            m_bufferLength = 0;
+        }
+    }
+}
+
+void ParallelHash::TruncatedFinal(byte *hash, size_t size)
+{
+    CRYPTOPP_ASSERT(hash != NULLPTR);
+    ThrowIfInvalidTruncatedSize(size);
+
+    if (m_bufferLength)
+        HashBlocks(m_blocks, m_bufferLength);
+
+    byte encoded[9];
+    AbsorbOuter(encoded, RightEncode(encoded, m_count));
+    AbsorbOuter(encoded, RightEncode(encoded, lword(m_digestSize)*8));
+
+    m_state.BytePtr()[m_counter] ^= CSHAKE_PAD;
+    m_state.BytePtr()[r()-1] ^= 0x80;
+
+    // The output depends on DigestSize(), so a truncated
+    // digest is the prefix of the full one
+    while (size > 0)
+    {
+        KeccakF1600(m_state);
+
+        const size_t segmentLen = STDMIN(size, (size_t)r());
+        std::memcpy(hash, m_state, segmentLen);
+
+        hash += segmentLen;
+        size -= segmentLen;
+    }
+
+    Restart();
+}
+
+NAMESPACE_END
@@ -0,0 +1,144 @@
+// parallelhash.h - written and placed in the public domain by
+//                  the Crypto++ project.
+
+/// \file parallelhash.h
+/// \brief Classes for ParallelHash message digests
+/// \details ParallelHash from NIST SP 800-185 cuts the message into blocks of B
+///   bytes, hashes every block with SHAKE, and then hashes the concatenated
+///   results with cSHAKE. The blocks are independent, so they are hashed
+///   several at a time with the interleaved Keccak kernels.
+/// \sa SHAKE128, SHAKE256, KangarooTwelve,
+///   <a href="https://nvlpubs.nist.gov/nistpubs/SpecialPublications/NIST.SP.800-185.pdf">NIST
+///   SP 800-185, SHA-3 Derived Functions: cSHAKE, KMAC, TupleHash and ParallelHash</a>
+/// \since Crypto++ 8.3
+
+#ifndef CRYPTOPP_PARALLELHASH_H
+#define CRYPTOPP_PARALLELHASH_H
+
+#include "cryptlib.h"
+#include "secblock.h"
+
+NAMESPACE_BEGIN(CryptoPP)
+
+/// \brief ParallelHash message digest base class
+/// \details ParallelHash is the base class for ParallelHash128 and ParallelHash256.
+///   Library users should instantiate a derived class, and only use ParallelHash
+///   as a base class reference or pointer.
+/// \since Crypto++ 8.3
+class ParallelHash : public HashTransformation
+{
+protected:
+    /// \brief Construct a ParallelHash
+    /// \param digestSize the digest size, in bytes
+    /// \param blockSize the size of the blocks hashed in parallel, in bytes
+    /// \param customization the customization string
+    /// \param customizationLength the size of the customization string, in bytes
+    /// \details ParallelHash is the base class for ParallelHash128 and ParallelHash256.
+    ///   Library users should instantiate a derived class, and only use ParallelHash
+    ///   as a base class reference or pointer.
+    /// \details The rate is not known until the derived class is constructed, so the
+    ///   derived class calls Restart().
+    ParallelHash(unsigned int digestSize, size_t blockSize, const byte *customization, size_t customizationLength);
+
+public:
+    /// \brief Default size of the blocks hashed in parallel
+    CRYPTOPP_CONSTANT(DEFAULT_BLOCKSIZE = 8192);
+
+    unsigned int DigestSize() const {return m_digestSize;}
+    unsigned int OptimalDataAlignment() const {return GetAlignmentOf<word64>();}
+
+    /// \brief Provides the size of the blocks hashed in parallel
+    /// \return the block size B, in bytes
+    /// \details ParallelBlockSize() is the parameter B of SP 800-185. It is not the
+    ///   same as BlockSize(), which returns the rate of the sponges.
+    size_t ParallelBlockSize() const {return m_blockSize;}
+
+    void Update(const byte *input, size_t length);
+    void Restart();
+    void TruncatedFinal(byte *hash, size_t size);
+
+protected:
+    inline unsigned int r() const {return BlockSize();}
+
+    // Absorbs input into the outer cSHAKE
+    void AbsorbOuter(const byte *input, size_t length);
+    // Hashes blocks with SHAKE and absorbs the results
+    void HashBlocks(const byte *input, size_t length);
+
+    FixedSizeSecBlock<word64, 25> m_state;
+    SecByteBlock m_customization, m_blocks;
+    lword m_count;
+    size_t m_blockSize, m_lanes, m_bufferLength;
+    unsigned int m_digestSize, m_counter;
+};
+
+/// \brief ParallelHash message digest template
+/// \tparam T_Strength the strength of the digest
+/// \details The output of ParallelHash depends on the output size, so the size
+///   must be given in advance. TruncatedFinal returns a prefix of the output for
+///   DigestSize() bytes.
+/// \since Crypto++ 8.3
+template<unsigned int T_Strength>
+class ParallelHash_Final : public ParallelHash
+{
+public:
+    CRYPTOPP_CONSTANT(DIGESTSIZE = (T_Strength == 128 ? 32 : 64));
+    CRYPTOPP_CONSTANT(BLOCKSIZE = (T_Strength == 128 ? 1344/8 : 1088/8));
+    static std::string StaticAlgorithmName()
+        { return "ParallelHash" + IntToString(T_Strength); }
+
+    /// \brief Construct a ParallelHash-X message digest
+    /// \param blockSize the size of the blocks hashed in parallel, in bytes
+    /// \param outputSize the digest size, in bytes
+    /// \param customization the customization string
+    /// \param customizationLength the size of the customization string, in bytes
+    ParallelHash_Final(size_t blockSize=DEFAULT_BLOCKSIZE, unsigned int outputSize=DIGESTSIZE,
+        const byte *customization=NULLPTR, size_t customizationLength=0)
+        : ParallelHash(outputSize, blockSize, customization, customizationLength) {Restart();}
+
+    /// \brief Provides the block size of the compression function
+    /// \return block size of the compression function, in bytes
+    /// \details BlockSize() returns the rate of the sponges. The size of the
+    ///   blocks hashed in parallel is returned by ParallelBlockSize().
+    unsigned int BlockSize() const { return BLOCKSIZE; }
+
+    std::string AlgorithmName() const { return StaticAlgorithmName(); }
+};
+
+/// \brief ParallelHash128 message digest
+/// \details ParallelHash128 hashes the blocks with SHAKE128 and uses cSHAKE128
+///   for the outer hash.
+/// \since Crypto++ 8.3
+class ParallelHash128 : public ParallelHash_Final<128>
+{
+public:
+    /// \brief Construct a ParallelHash128 message digest
+    /// \param blockSize the size of the blocks hashed in parallel, in bytes
+    /// \param outputSize the digest size, in bytes
+    /// \param customization the customization string
+    /// \param customizationLength the size of the customization string, in bytes
+    ParallelHash128(size_t blockSize=DEFAULT_BLOCKSIZE, unsigned int outputSize=DIGESTSIZE,
+        const byte *customization=NULLPTR, size_t customizationLength=0)
+        : ParallelHash_Final<128>(blockSize, outputSize, customization, customizationLength) {}
+};
+
+/// \brief ParallelHash256 message digest
+/// \details ParallelHash256 hashes the blocks with SHAKE256 and uses cSHAKE256
+///   for the outer hash.
+/// \since Crypto++ 8.3
+class ParallelHash256 : public ParallelHash_Final<256>
+{
+public:
+    /// \brief Construct a ParallelHash256 message digest
+    /// \param blockSize the size of the blocks hashed in parallel, in bytes
+    /// \param outputSize the digest size, in bytes
+    /// \param customization the customization string
+    /// \param customizationLength the size of the customization string, in bytes
+    ParallelHash256(size_t blockSize=DEFAULT_BLOCKSIZE, unsigned int outputSize=DIGESTSIZE,
+        const byte *customization=NULLPTR, size_t customizationLength=0)
+        : ParallelHash_Final<256>(blockSize, outputSize, customization, customizationLength) {}
+};
+
+NAMESPACE_END
+
+#endif
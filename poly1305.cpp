@@ -27,16 +27,92 @@
 
 ////////////////////////////// Common Poly1305 //////////////////////////////
 
+NAMESPACE_BEGIN(CryptoPP)
+
+#if (CRYPTOPP_AVX512_AVAILABLE)
+extern void Poly1305_HashBlocks_AVX512(word32 h[5], const word32 *r, const byte *input, size_t length, word32 padbit);
+#endif
+
+#if (CRYPTOPP_AVX2_AVAILABLE)
+extern void Poly1305_HashBlocks_AVX2(word32 h[5], const word32 *r, const byte *input, size_t length, word32 padbit);
+#endif
+
+NAMESPACE_END
+
 ANONYMOUS_NAMESPACE_BEGIN
 
 using namespace CryptoPP;
 
+#if (CRYPTOPP_WORD128_AVAILABLE)
+
+// Radix 2^44 with 64-bit limbs. The accumulator is converted from
+// and back to the radix 2^32 limbs kept by the classes.
+void Poly1305_HashBlocks_CXX64(word32 h[5], const word32 r[4], const byte *input, size_t length, word32 padbit)
+{
+	const word64 M44 = W64LIT(0xfffffffffff), M42 = W64LIT(0x3ffffffffff);
+	const word64 hibit = (word64)padbit << 40;
+	word64 r0, r1, r2, s1, s2;
+	word64 h0, h1, h2, c, t0, t1;
+	word128 d0, d1, d2;
+
+	t0 = ((word64)r[1] << 32) | r[0];
+	t1 = ((word64)r[3] << 32) | r[2];
+	r0 = t0 & M44;
+	r1 = ((t0 >> 44) | (t1 << 20)) & M44;
+	r2 = (t1 >> 24) & M42;
+
+	// 2^132 = 20 mod 2^130-5
+	s1 = r1 * 20;
+	s2 = r2 * 20;
+
+	t0 = ((word64)h[1] << 32) | h[0];
+	t1 = ((word64)h[3] << 32) | h[2];
+	h0 = t0 & M44;
+	h1 = ((t0 >> 44) | (t1 << 20)) & M44;
+	h2 = (t1 >> 24) | ((word64)h[4] << 40);
+
+	while (length >= 16)
+	{
+		// h += m[i]
+		t0 = GetWord<word64>(false, LITTLE_ENDIAN_ORDER, input + 0);
+		t1 = GetWord<word64>(false, LITTLE_ENDIAN_ORDER, input + 8);
+		h0 += t0 & M44;
+		h1 += ((t0 >> 44) | (t1 << 20)) & M44;
+		h2 += (t1 >> 24) | hibit;
+
+		// h *= r "%" p
+		d0 = ((word128)h0 * r0) + ((word128)h1 * s2) + ((word128)h2 * s1);
+		d1 = ((word128)h0 * r1) + ((word128)h1 * r0) + ((word128)h2 * s2);
+		d2 = ((word128)h0 * r2) + ((word128)h1 * r1) + ((word128)h2 * r0);
+
+		// (h2:h0 += (h2:h0>>130) * 5) %= 2^130
+		c = (word64)(d0 >> 44); h0 = (word64)d0 & M44; d1 += c;
+		c = (word64)(d1 >> 44); h1 = (word64)d1 & M44; d2 += c;
+		c = (word64)(d2 >> 42); h2 = (word64)d2 & M42;
+		h0 += c * 5; c = h0 >> 44; h0 &= M44;
+		h1 += c;
+
+		input += 16;
+		length -= 16;
+	}
+
+	c = h1 >> 44; h1 &= M44; h2 += c;
+	t0 = h0 | (h1 << 44);
+	t1 = (h1 >> 20) | (h2 << 24);
+
+	h[0] = (word32)t0; h[1] = (word32)(t0 >> 32);
+	h[2] = (word32)t1; h[3] = (word32)(t1 >> 32);
+	h[4] = (word32)(h2 >> 40);
+}
+
+#else
+
 inline word32 CONSTANT_TIME_CARRY(word32 a, word32 b)
 {
 	return ((a ^ ((a ^ b) | ((a - b) ^ b))) >> (sizeof(a) * 8 - 1));
 }
 
-void Poly1305_HashBlocks(word32 h[5], word32 r[4], const byte *input, size_t length, word32 padbit)
+void Poly1305_HashBlocks_CXX(word32 h[5], const word32 r[4], const byte *input, size_t length, word32 padbit)
 {
 	word32 r0, r1, r2, r3;
 	word32 s1, s2, s3;
@@ -108,6 +184,127 @@ void Poly1305_HashBlocks(word32 h[5], word32 r[4], const byte *input, size_t len
 	h[3] = h3; h[4] = h4;
 }
 
+#endif  // CRYPTOPP_WORD128_AVAILABLE
+
+#if (CRYPTOPP_AVX2_AVAILABLE) || (CRYPTOPP_AVX512_AVAILABLE)
+
+// The SIMD code works in radix 2^26. Converts h from radix 2^32.
+inline void ToRadix26(const word32 h[5], word32 t[5])
+{
+	t[0] =   h[0] & 0x3ffffff;
+	t[1] = ((h[0] >> 26) | (h[1] <<  6)) & 0x3ffffff;
+	t[2] = ((h[1] >> 20) | (h[2] << 12)) & 0x3ffffff;
+	t[3] = ((h[2] >> 14) | (h[3] << 18)) & 0x3ffffff;
+	t[4] =  (h[3] >>  8) | (h[4] << 24);
+}
+
+// Converts h back to radix 2^32. The limbs of t may exceed 26 bits.
+inline void FromRadix26(const word32 t[5], word32 h[5])
+{
+	word64 acc;
+	acc  = t[0] + ((word64)t[1] << 26);  h[0] = (word32)acc; acc >>= 32;
+	acc += (word64)t[2] << 20;           h[1] = (word32)acc; acc >>= 32;
+	acc += (word64)t[3] << 14;           h[2] = (word32)acc; acc >>= 32;
+	acc += (word64)t[4] <<  8;           h[3] = (word32)acc;
+	h[4] = (word32)(acc >> 32);
+}
+
+// z = x * y mod 2^130-5 in radix 2^26. The limbs of z are reduced
+// to 26 bits, except z[1] which may be slightly larger.
+void Multiply26(const word32 x[5], const word32 y[5], word32 z[5])
+{
+	const word64 s1 = y[1]*5, s2 = y[2]*5, s3 = y[3]*5, s4 = y[4]*5;
+	word64 d0, d1, d2, d3, d4, c;
+
+	d0 = (word64)x[0]*y[0] + x[1]*s4 + x[2]*s3 + x[3]*s2 + x[4]*s1;
+	d1 = (word64)x[0]*y[1] + (word64)x[1]*y[0] + x[2]*s4 + x[3]*s3 + x[4]*s2;
+	d2 = (word64)x[0]*y[2] + (word64)x[1]*y[1] + (word64)x[2]*y[0] + x[3]*s4 + x[4]*s3;
+	d3 = (word64)x[0]*y[3] + (word64)x[1]*y[2] + (word64)x[2]*y[1] + (word64)x[3]*y[0] + x[4]*s4;
+	d4 = (word64)x[0]*y[4] + (word64)x[1]*y[3] + (word64)x[2]*y[2] + (word64)x[3]*y[1] + (word64)x[4]*y[0];
+
+	c = d0 >> 26; d1 += c;
+	c = d1 >> 26; d2 += c;
+	c = d2 >> 26; d3 += c;
+	c = d3 >> 26; d4 += c;
+	c = d4 >> 26;
+	d0 = (d0 & 0x3ffffff) + c*5;
+	c = d0 >> 26;
+
+	z[0] = (word32)(d0 & 0x3ffffff);
+	z[1] = (word32)(d1 & 0x3ffffff) + (word32)c;
+	z[2] = (word32)(d2 & 0x3ffffff);
+	z[3] = (word32)(d3 & 0x3ffffff);
+	z[4] = (word32)(d4 & 0x3ffffff);
+}
+
+// Computes r^1 to r^8 in radix 2^26, five limbs each
+void Poly1305_Powers(const word32 r[4], word32 rp[40])
+{
+	word32 t[5];
+	std::memcpy(t, r, 16); t[4] = 0;
+	ToRadix26(t, rp);
+
+	for (unsigned int i=1; i<8; ++i)
+		Multiply26(rp+(i-1)*5, rp, rp+i*5);
+}
+
+// Runs a SIMD kernel over a multiple of its group size. The powers
+// of r are computed on first use after the key is set.
+inline void Poly1305_HashBlocks_SIMD(void (*kernel)(word32*, const word32*, const byte*, size_t, word32),
+	word32 h[5], const word32 r[4], word32 rp[40], bool &powers, const byte *input, size_t length, word32 padbit)
+{
+	if (!powers)
+	{
+		Poly1305_Powers(r, rp);
+		powers = true;
+	}
+
+	word32 t[5];
+	ToRadix26(h, t);
+	kernel(t, rp, input, length, padbit);
+	FromRadix26(t, h);
+}
+
+#endif  // CRYPTOPP_AVX2_AVAILABLE || CRYPTOPP_AVX512_AVAILABLE
+
+// Hashes the whole 16-byte blocks of input. rp and powers cache the
+// powers of r for the SIMD code.
+void Poly1305_HashBlocks(word32 h[5], const word32 r[4], word32 rp[40], bool &powers, const byte *input, size_t length, word32 padbit)
+{
+#if (CRYPTOPP_AVX2_AVAILABLE) || (CRYPTOPP_AVX512_AVAILABLE)
+	// The powers of r cost about as much as a few blocks, so
+	// short messages under a fresh key stay on the scalar code
+	const bool simd = powers || length >= 512;
+#endif
+
+#if (CRYPTOPP_AVX512_AVAILABLE)
+	if (simd && length >= 128 && HasAVX512F() && HasAVX512BW() && HasAVX512VL())
+	{
+		const size_t n = length & ~size_t(127);
+		Poly1305_HashBlocks_SIMD(Poly1305_HashBlocks_AVX512, h, r, rp, powers, input, n, padbit);
+		input += n; length -= n;
+	}
+#endif
+#if (CRYPTOPP_AVX2_AVAILABLE)
+	if (simd && length >= 64 && HasAVX2())
+	{
+		const size_t n = length & ~size_t(63);
+		Poly1305_HashBlocks_SIMD(Poly1305_HashBlocks_AVX2, h, r, rp, powers, input, n, padbit);
+		input += n; length -= n;
+	}
+#endif
+
+	CRYPTOPP_UNUSED(rp); CRYPTOPP_UNUSED(powers);
+	if (length < 16)
+		return;
+
+#if (CRYPTOPP_WORD128_AVAILABLE)
+	Poly1305_HashBlocks_CXX64(h, r, input, length, padbit);
+#else
+	Poly1305_HashBlocks_CXX(h, r, input, length, padbit);
+#endif
+}
+
 void Poly1305_HashFinal(word32 h[5], word32 n[4], byte *mac, size_t size)
 {
 	word32 h0, h1, h2, h3, h4;
@@ -201,6 +398,7 @@ void Poly1305_Base<T>::UncheckedSetKey(const byte *key, unsigned int length, con
 	m_r[1] = GetWord<word32>(false, LITTLE_ENDIAN_ORDER, key +  4) & 0x0ffffffc;
 	m_r[2] = GetWord<word32>(false, LITTLE_ENDIAN_ORDER, key +  8) & 0x0ffffffc;
 	m_r[3] = GetWord<word32>(false, LITTLE_ENDIAN_ORDER, key + 12) & 0x0ffffffc;
+	m_rpReady = false;
 
 	// Mark the nonce as dirty, meaning we need a new one
 	m_used = true;
@@ -229,7 +427,7 @@ void Poly1305_Base<T>::Update(const byte *input, size_t length)
 		{
 			// Process
 			memcpy_s(m_acc + num, BLOCKSIZE - num, input, rem);
-			Poly1305_HashBlocks(m_h, m_r, m_acc, BLOCKSIZE, 1);
+			Poly1305_HashBlocks(m_h, m_r, m_rp, m_rpReady, m_acc, BLOCKSIZE, 1);
 			input += rem; length -= rem;
 		}
 		else
@@ -245,7 +443,7 @@ void Poly1305_Base<T>::Update(const byte *input, size_t length)
 	length -= rem;
 
 	if (length >= BLOCKSIZE) {
-		Poly1305_HashBlocks(m_h, m_r, input, length, 1);
+		Poly1305_HashBlocks(m_h, m_r, m_rp, m_rpReady, input, length, 1);
 		input += length;
 	}
 
@@ -269,7 +467,7 @@ void Poly1305_Base<T>::TruncatedFinal(byte *mac, size_t size)
 		m_acc[num++] = 1;   /* pad bit */
 		while (num < BLOCKSIZE)
 			m_acc[num++] = 0;
-		Poly1305_HashBlocks(m_h, m_r, m_acc, BLOCKSIZE, 0);
+		Poly1305_HashBlocks(m_h, m_r, m_rp, m_rpReady, m_acc, BLOCKSIZE, 0);
 	}
 
 	Poly1305_HashFinal(m_h, m_n, mac, size);
@@ -322,6 +520,7 @@ void Poly1305TLS_Base::UncheckedSetKey(const byte *key, unsigned int length, con
 	m_r[1] = GetWord<word32>(false, LITTLE_ENDIAN_ORDER, key +  4) & 0x0ffffffc;
 	m_r[2] = GetWord<word32>(false, LITTLE_ENDIAN_ORDER, key +  8) & 0x0ffffffc;
 	m_r[3] = GetWord<word32>(false, LITTLE_ENDIAN_ORDER, key + 12) & 0x0ffffffc;
+	m_rpReady = false;
 
 	key += 16;
 	m_n[0] = GetWord<word32>(false, LITTLE_ENDIAN_ORDER, key +  0);
@@ -345,7 +544,7 @@ void Poly1305TLS_Base::Update(const byte *input, size_t length)
 		{
 			// Process
 			memcpy_s(m_acc + num, BLOCKSIZE - num, input, rem);
-			Poly1305_HashBlocks(m_h, m_r, m_acc, BLOCKSIZE, 1);
+			Poly1305_HashBlocks(m_h, m_r, m_rp, m_rpReady, m_acc, BLOCKSIZE, 1);
 			input += rem; length -= rem;
 		}
 		else
@@ -361,7 +560,7 @@ void Poly1305TLS_Base::Update(const byte *input, size_t length)
 	length -= rem;
 
 	if (length >= BLOCKSIZE) {
-		Poly1305_HashBlocks(m_h, m_r, input, length, 1);
+		Poly1305_HashBlocks(m_h, m_r, m_rp, m_rpReady, input, length, 1);
 		input += length;
 	}
 
@@ -383,7 +582,7 @@ void Poly1305TLS_Base::TruncatedFinal(byte *mac, size_t size)
 		m_acc[num++] = 1;   /* pad bit */
 		while (num < BLOCKSIZE)
 			m_acc[num++] = 0;
-		Poly1305_HashBlocks(m_h, m_r, m_acc, BLOCKSIZE, 0);
+		Poly1305_HashBlocks(m_h, m_r, m_rp, m_rpReady, m_acc, BLOCKSIZE, 0);
 	}
 
 	Poly1305_HashFinal(m_h, m_n, mac, size);
@@ -16,6 +16,10 @@
 ///   message, using a 16-byte AES key, a 16-byte additional key, and a 16-byte nonce.
 /// \details Crypto++ also supplies the IETF's version of Poly1305. It is a slightly different
 ///   algorithm than Bernstein's version.
+/// \details On 64-bit platforms with a 128-bit multiply the blocks are hashed in radix 2^44.
+///   On x86 and x64 long inputs are hashed 4 (AVX2) or 8 (AVX-512) blocks at a time in radix
+///   2^26 using powers of the r-key. The powers are computed the first time they are needed
+///   after the key is set.
 /// \sa Daniel J. Bernstein <A HREF="http://cr.yp.to/mac/poly1305-20050329.pdf">The Poly1305-AES
 ///   Message-Authentication Code (20050329)</A>, <a href="http://tools.ietf.org/html/rfc8439">RFC
 ///   8439, ChaCha20 and Poly1305 for IETF Protocols</a> and Andy Polyakov <A
@@ -52,7 +56,7 @@ public:
 	CRYPTOPP_CONSTANT(BLOCKSIZE=T::BLOCKSIZE);
 
 	virtual ~Poly1305_Base() {}
-	Poly1305_Base() : m_idx(0), m_used(true) {}
+	Poly1305_Base() : m_idx(0), m_used(true), m_rpReady(false) {}
 
 	void Resynchronize (const byte *iv, int ivLength=-1);
 	void GetNextIV (RandomNumberGenerator &rng, byte *iv);
@@ -85,6 +89,10 @@ protected:
 
 	// Track nonce reuse; assert in debug but continue
 	bool m_used;
+
+	// Powers of r for the SIMD code, computed on first use
+	FixedSizeAlignedSecBlock<word32, 40> m_rp;
+	bool m_rpReady;
 };
 
 /// \brief Poly1305 message authentication code
@@ -169,7 +177,7 @@ public:
 	CRYPTOPP_CONSTANT(BLOCKSIZE=16);
 
 	virtual ~Poly1305TLS_Base() {}
-	Poly1305TLS_Base() {}
+	Poly1305TLS_Base() : m_idx(0), m_rpReady(false) {}
 
 	void UncheckedSetKey(const byte *key, unsigned int length, const NameValuePairs &params);
 	void Update(const byte *input, size_t length);
@@ -188,6 +196,10 @@ protected:
 	// Accumulated message bytes and index
 	FixedSizeAlignedSecBlock<byte, BLOCKSIZE> m_acc;
 	size_t m_idx;
+
+	// Powers of r for the SIMD code, computed on first use
+	FixedSizeAlignedSecBlock<word32, 40> m_rp;
+	bool m_rpReady;
 };
 
 /// \brief Poly1305-TLS message authentication code
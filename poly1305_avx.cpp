@@ -0,0 +1,155 @@
+// poly1305_avx.cpp - written and placed in the public domain by
+//                    the Crypto++ project.
+//
+//    This source file uses intrinsics and built-ins to gain access to
+//    AVX2 instructions. A separate source file is needed because
+//    additional CXXFLAGS are required to enable the appropriate
+//    instructions sets in some build configurations.
+//
+//    The code hashes 4 Poly1305 blocks at a time in radix 2^26. Each
+//    YMM register holds one limb of 4 accumulators, one accumulator per
+//    64-bit lane. Block i of every group of 4 goes to its own lane, and
+//    the lanes are multiplied by r^4 between groups. After the last group
+//    the lanes are multiplied by r^4, r^3, r^2 and r^1 and summed. The
+//    caller in poly1305.cpp converts the accumulator and computes the
+//    powers of r.
+
+#include "pch.h"
+#include "config.h"
+#include "misc.h"
+
+#if (CRYPTOPP_AVX2_AVAILABLE)
+# include <emmintrin.h>
+# include <immintrin.h>
+#endif
+
+// Squash MS LNK4221 and libtool warnings
+extern const char POLY1305_AVX_FNAME[] = __FILE__;
+
+// Clang intrinsic casts, http://bugs.llvm.org/show_bug.cgi?id=20670
+#define CONST_M256_CAST(x) ((const __m256i *)(const void *)(x))
+
+NAMESPACE_BEGIN(CryptoPP)
+
+#if (CRYPTOPP_AVX2_AVAILABLE)
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+#define ADD(a, b) _mm256_add_epi64((a), (b))
+#define MUL(a, b) _mm256_mul_epu32((a), (b))
+
+// Splits 4 blocks into 26-bit limbs. The 64-bit interleave
+// places blocks 0, 2, 1 and 3 in lanes 0, 1, 2 and 3.
+inline void LoadBlocks(const byte *input, __m256i m[5], const __m256i pad)
+{
+    const __m256i mask = _mm256_set1_epi64x(0x3ffffff);
+    const __m256i a = _mm256_loadu_si256(CONST_M256_CAST(input+ 0));
+    const __m256i b = _mm256_loadu_si256(CONST_M256_CAST(input+32));
+    const __m256i lo = _mm256_unpacklo_epi64(a, b);
+    const __m256i hi = _mm256_unpackhi_epi64(a, b);
+
+    m[0] = _mm256_and_si256(lo, mask);
+    m[1] = _mm256_and_si256(_mm256_srli_epi64(lo, 26), mask);
+    m[2] = _mm256_and_si256(_mm256_or_si256(_mm256_srli_epi64(lo, 52),
+        _mm256_slli_epi64(hi, 12)), mask);
+    m[3] = _mm256_and_si256(_mm256_srli_epi64(hi, 14), mask);
+    m[4] = _mm256_or_si256(_mm256_srli_epi64(hi, 40), pad);
+}
+
+// h = h * r mod 2^130-5, where s = 5*r. The limbs of the
+// result are partially reduced and below 2^27.
+inline void Multiply(__m256i h[5], const __m256i r[5], const __m256i s[5])
+{
+    const __m256i mask = _mm256_set1_epi64x(0x3ffffff);
+    __m256i d0, d1, d2, d3, d4, c;
+
+    d0 = ADD(ADD(ADD(ADD(MUL(h[0], r[0]), MUL(h[1], s[4])), MUL(h[2], s[3])), MUL(h[3], s[2])), MUL(h[4], s[1]));
+    d1 = ADD(ADD(ADD(ADD(MUL(h[0], r[1]), MUL(h[1], r[0])), MUL(h[2], s[4])), MUL(h[3], s[3])), MUL(h[4], s[2]));
+    d2 = ADD(ADD(ADD(ADD(MUL(h[0], r[2]), MUL(h[1], r[1])), MUL(h[2], r[0])), MUL(h[3], s[4])), MUL(h[4], s[3]));
+    d3 = ADD(ADD(ADD(ADD(MUL(h[0], r[3]), MUL(h[1], r[2])), MUL(h[2], r[1])), MUL(h[3], r[0])), MUL(h[4], s[4]));
+    d4 = ADD(ADD(ADD(ADD(MUL(h[0], r[4]), MUL(h[1], r[3])), MUL(h[2], r[2])), MUL(h[3], r[1])), MUL(h[4], r[0]));
+
+    c = _mm256_srli_epi64(d3, 26); d3 = _mm256_and_si256(d3, mask); d4 = ADD(d4, c);
+    c = _mm256_srli_epi64(d0, 26); d0 = _mm256_and_si256(d0, mask); d1 = ADD(d1, c);
+    c = _mm256_srli_epi64(d4, 26); d4 = _mm256_and_si256(d4, mask);
+    d0 = ADD(d0, ADD(c, _mm256_slli_epi64(c, 2)));
+    c = _mm256_srli_epi64(d1, 26); d1 = _mm256_and_si256(d1, mask); d2 = ADD(d2, c);
+    c = _mm256_srli_epi64(d2, 26); d2 = _mm256_and_si256(d2, mask); d3 = ADD(d3, c);
+    c = _mm256_srli_epi64(d0, 26); d0 = _mm256_and_si256(d0, mask); d1 = ADD(d1, c);
+    c = _mm256_srli_epi64(d3, 26); d3 = _mm256_and_si256(d3, mask); d4 = ADD(d4, c);
+
+    h[0] = d0; h[1] = d1; h[2] = d2; h[3] = d3; h[4] = d4;
+}
+
+inline word64 HorizontalSum(const __m256i x)
+{
+    const __m128i t = _mm_add_epi64(_mm256_castsi256_si128(x),
+        _mm256_extracti128_si256(x, 1));
+    return static_cast<word64>(_mm_cvtsi128_si64(
+        _mm_add_epi64(t, _mm_unpackhi_epi64(t, t))));
+}
+
+#undef ADD
+#undef MUL
+
+ANONYMOUS_NAMESPACE_END
+
+// h is the accumulator in radix 2^26, and r holds the limbs of
+// r^1, r^2, ... in radix 2^26. length is a multiple of 64.
+void Poly1305_HashBlocks_AVX2(word32 h[5], const word32 *r, const byte *input, size_t length, word32 padbit)
+{
+    CRYPTOPP_ASSERT(length >= 64 && length % 64 == 0);
+
+    const __m256i pad = _mm256_set1_epi64x(static_cast<long long>(padbit) << 24);
+    __m256i r4[5], s4[5], rn[5], sn[5], a[5], m[5];
+
+    // r^4 for the groups, and r^4, r^2, r^3, r^1 for the
+    // lanes of the last group due to the block order
+    for (unsigned int i=0; i<5; ++i)
+    {
+        r4[i] = _mm256_set1_epi64x(r[15+i]);
+        rn[i] = _mm256_set_epi64x(r[0+i], r[10+i], r[5+i], r[15+i]);
+        s4[i] = _mm256_add_epi64(r4[i], _mm256_slli_epi64(r4[i], 2));
+        sn[i] = _mm256_add_epi64(rn[i], _mm256_slli_epi64(rn[i], 2));
+    }
+
+    // The accumulator joins block 0 in lane 0
+    LoadBlocks(input, a, pad);
+    for (unsigned int i=0; i<5; ++i)
+        a[i] = _mm256_add_epi64(a[i], _mm256_set_epi64x(0, 0, 0, h[i]));
+
+    input += 64; length -= 64;
+    while (length)
+    {
+        Multiply(a, r4, s4);
+        LoadBlocks(input, m, pad);
+        for (unsigned int i=0; i<5; ++i)
+            a[i] = _mm256_add_epi64(a[i], m[i]);
+
+        input += 64; length -= 64;
+    }
+
+    Multiply(a, rn, sn);
+
+    word64 t[5];
+    for (unsigned int i=0; i<5; ++i)
+        t[i] = HorizontalSum(a[i]);
+
+    word64 c;
+    c = t[0] >> 26; t[0] &= 0x3ffffff; t[1] += c;
+    c = t[1] >> 26; t[1] &= 0x3ffffff; t[2] += c;
+    c = t[2] >> 26; t[2] &= 0x3ffffff; t[3] += c;
+    c = t[3] >> 26; t[3] &= 0x3ffffff; t[4] += c;
+    c = t[4] >> 26; t[4] &= 0x3ffffff; t[0] += c * 5;
+    c = t[0] >> 26; t[0] &= 0x3ffffff; t[1] += c;
+
+    for (unsigned int i=0; i<5; ++i)
+        h[i] = static_cast<word32>(t[i]);
+
+    // https://software.intel.com/en-us/articles/avoiding-avx-sse-transition-penalties
+    _mm256_zeroupper();
+}
+
+#endif  // CRYPTOPP_AVX2_AVAILABLE
+
+NAMESPACE_END
@@ -0,0 +1,155 @@
+// poly1305_avx512.cpp - written and placed in the public domain by
+//                       the Crypto++ project.
+//
+//    This source file uses intrinsics and built-ins to gain access to
+//    AVX-512 instructions. A separate source file is needed because
+//    additional CXXFLAGS are required to enable the appropriate
+//    instructions sets in some build configurations.
+//
+//    The code hashes 8 Poly1305 blocks at a time in radix 2^26. It is
+//    the AVX2 code in poly1305_avx.cpp widened to ZMM registers, with 8
+//    accumulators that are multiplied by r^8 between groups and by r^8
+//    down to r^1 after the last group.
+
+#include "pch.h"
+#include "config.h"
+#include "misc.h"
+
+#if (CRYPTOPP_AVX512_AVAILABLE)
+# include <emmintrin.h>
+# include <immintrin.h>
+#endif
+
+// Squash MS LNK4221 and libtool warnings
+extern const char POLY1305_AVX512_FNAME[] = __FILE__;
+
+// GCC 12 warns the __Y operand in avx512fintrin.h is used
+// uninitialized. It is the self-initialized placeholder of the
+// _mm512_undefined intrinsics and not a variable in this file.
+#if CRYPTOPP_GCC_DIAGNOSTIC_AVAILABLE
+# pragma GCC diagnostic ignored "-Wuninitialized"
+# if (CRYPTOPP_GCC_VERSION >= 40700)
+#  pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+# endif
+#endif
+
+// Clang intrinsic casts, http://bugs.llvm.org/show_bug.cgi?id=20670
+#define CONST_M512_CAST(x) ((const __m512i *)(const void *)(x))
+
+NAMESPACE_BEGIN(CryptoPP)
+
+#if (CRYPTOPP_AVX512_AVAILABLE)
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+#define ADD(a, b) _mm512_add_epi64((a), (b))
+#define MUL(a, b) _mm512_mul_epu32((a), (b))
+
+// Splits 8 blocks into 26-bit limbs. The 64-bit interleave
+// places blocks 0, 4, 1, 5, 2, 6, 3 and 7 in lanes 0 to 7.
+inline void LoadBlocks(const byte *input, __m512i m[5], const __m512i pad)
+{
+    const __m512i mask = _mm512_set1_epi64(0x3ffffff);
+    const __m512i a = _mm512_loadu_si512(CONST_M512_CAST(input+ 0));
+    const __m512i b = _mm512_loadu_si512(CONST_M512_CAST(input+64));
+    const __m512i lo = _mm512_unpacklo_epi64(a, b);
+    const __m512i hi = _mm512_unpackhi_epi64(a, b);
+
+    m[0] = _mm512_and_si512(lo, mask);
+    m[1] = _mm512_and_si512(_mm512_srli_epi64(lo, 26), mask);
+    m[2] = _mm512_and_si512(_mm512_or_si512(_mm512_srli_epi64(lo, 52),
+        _mm512_slli_epi64(hi, 12)), mask);
+    m[3] = _mm512_and_si512(_mm512_srli_epi64(hi, 14), mask);
+    m[4] = _mm512_or_si512(_mm512_srli_epi64(hi, 40), pad);
+}
+
+// h = h * r mod 2^130-5, where s = 5*r. The limbs of the
+// result are partially reduced and below 2^27.
+inline void Multiply(__m512i h[5], const __m512i r[5], const __m512i s[5])
+{
+    const __m512i mask = _mm512_set1_epi64(0x3ffffff);
+    __m512i d0, d1, d2, d3, d4, c;
+
+    d0 = ADD(ADD(ADD(ADD(MUL(h[0], r[0]), MUL(h[1], s[4])), MUL(h[2], s[3])), MUL(h[3], s[2])), MUL(h[4], s[1]));
+    d1 = ADD(ADD(ADD(ADD(MUL(h[0], r[1]), MUL(h[1], r[0])), MUL(h[2], s[4])), MUL(h[3], s[3])), MUL(h[4], s[2]));
+    d2 = ADD(ADD(ADD(ADD(MUL(h[0], r[2]), MUL(h[1], r[1])), MUL(h[2], r[0])), MUL(h[3], s[4])), MUL(h[4], s[3]));
+    d3 = ADD(ADD(ADD(ADD(MUL(h[0], r[3]), MUL(h[1], r[2])), MUL(h[2], r[1])), MUL(h[3], r[0])), MUL(h[4], s[4]));
+    d4 = ADD(ADD(ADD(ADD(MUL(h[0], r[4]), MUL(h[1], r[3])), MUL(h[2], r[2])), MUL(h[3], r[1])), MUL(h[4], r[0]));
+
+    c = _mm512_srli_epi64(d3, 26); d3 = _mm512_and_si512(d3, mask); d4 = ADD(d4, c);
+    c = _mm512_srli_epi64(d0, 26); d0 = _mm512_and_si512(d0, mask); d1 = ADD(d1, c);
+    c = _mm512_srli_epi64(d4, 26); d4 = _mm512_and_si512(d4, mask);
+    d0 = ADD(d0, ADD(c, _mm512_slli_epi64(c, 2)));
+    c = _mm512_srli_epi64(d1, 26); d1 = _mm512_and_si512(d1, mask); d2 = ADD(d2, c);
+    c = _mm512_srli_epi64(d2, 26); d2 = _mm512_and_si512(d2, mask); d3 = ADD(d3, c);
+    c = _mm512_srli_epi64(d0, 26); d0 = _mm512_and_si512(d0, mask); d1 = ADD(d1, c);
+    c = _mm512_srli_epi64(d3, 26); d3 = _mm512_and_si512(d3, mask); d4 = ADD(d4, c);
+
+    h[0] = d0; h[1] = d1; h[2] = d2; h[3] = d3; h[4] = d4;
+}
+
+#undef ADD
+#undef MUL
+
+ANONYMOUS_NAMESPACE_END
+
+// h is the accumulator in radix 2^26, and r holds the limbs of
+// r^1 to r^8 in radix 2^26. length is a multiple of 128.
+void Poly1305_HashBlocks_AVX512(word32 h[5], const word32 *r, const byte *input, size_t length, word32 padbit)
+{
+    CRYPTOPP_ASSERT(length >= 128 && length % 128 == 0);
+
+    const __m512i pad = _mm512_set1_epi64(static_cast<long long>(padbit) << 24);
+    __m512i r8[5], s8[5], rn[5], sn[5], a[5], m[5];
+
+    // r^8 for the groups, and r^8, r^4, r^7, r^3, r^6, r^2, r^5, r^1
+    // for the lanes of the last group due to the block order
+    for (unsigned int i=0; i<5; ++i)
+    {
+        r8[i] = _mm512_set1_epi64(r[35+i]);
+        rn[i] = _mm512_set_epi64(r[0+i], r[20+i], r[5+i], r[25+i],
+                                 r[10+i], r[30+i], r[15+i], r[35+i]);
+        s8[i] = _mm512_add_epi64(r8[i], _mm512_slli_epi64(r8[i], 2));
+        sn[i] = _mm512_add_epi64(rn[i], _mm512_slli_epi64(rn[i], 2));
+    }
+
+    // The accumulator joins block 0 in lane 0
+    LoadBlocks(input, a, pad);
+    for (unsigned int i=0; i<5; ++i)
+        a[i] = _mm512_add_epi64(a[i], _mm512_set_epi64(0, 0, 0, 0, 0, 0, 0, h[i]));
+
+    input += 128; length -= 128;
+    while (length)
+    {
+        Multiply(a, r8, s8);
+        LoadBlocks(input, m, pad);
+        for (unsigned int i=0; i<5; ++i)
+            a[i] = _mm512_add_epi64(a[i], m[i]);
+
+        input += 128; length -= 128;
+    }
+
+    Multiply(a, rn, sn);
+
+    word64 t[5];
+    for (unsigned int i=0; i<5; ++i)
+        t[i] = static_cast<word64>(_mm512_reduce_add_epi64(a[i]));
+
+    word64 c;
+    c = t[0] >> 26; t[0] &= 0x3ffffff; t[1] += c;
+    c = t[1] >> 26; t[1] &= 0x3ffffff; t[2] += c;
+    c = t[2] >> 26; t[2] &= 0x3ffffff; t[3] += c;
+    c = t[3] >> 26; t[3] &= 0x3ffffff; t[4] += c;
+    c = t[4] >> 26; t[4] &= 0x3ffffff; t[0] += c * 5;
+    c = t[0] >> 26; t[0] &= 0x3ffffff; t[1] += c;
+
+    for (unsigned int i=0; i<5; ++i)
+        h[i] = static_cast<word32>(t[i]);
+
+    // https://software.intel.com/en-us/articles/avoiding-avx-sse-transition-penalties
+    _mm256_zeroupper();
+}
+
+#endif  // CRYPTOPP_AVX512_AVAILABLE
+
+NAMESPACE_END
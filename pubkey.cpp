@@ -8,9 +8,151 @@
 #include "pubkey.h"
 #include "integer.h"
 #include "filters.h"
+#include "asn.h"
+#include "stdcpp.h"
 
 NAMESPACE_BEGIN(CryptoPP)
 
+ANONYMOUS_NAMESPACE_BEGIN
+
+struct PrecomputationCacheState
+{
+	PrecomputationCacheState() : size(0), capacity(4*1024*1024) {}
+
+	std::map<std::string, std::string> tables;
+	size_t size, capacity;
+#if defined(CRYPTOPP_CXX11_SYNCHRONIZATION)
+	std::mutex mutex;
+#endif
+};
+
+// The cache is reached through Singleton, which hands out a const
+// reference, and every access holds the mutex
+inline PrecomputationCacheState& GetPrecomputationCache()
+{
+	return const_cast<PrecomputationCacheState&>(Singleton<PrecomputationCacheState>().Ref());
+}
+
+#if defined(CRYPTOPP_CXX11_SYNCHRONIZATION)
+# define CRYPTOPP_CACHE_LOCK(c) std::lock_guard<std::mutex> lock((c).mutex)
+#else
+# define CRYPTOPP_CACHE_LOCK(c)
+#endif
+
+ANONYMOUS_NAMESPACE_END
+
+bool DL_PrecomputationCache::Find(const std::string &key, std::string &table)
+{
+	PrecomputationCacheState &cache = GetPrecomputationCache();
+	CRYPTOPP_CACHE_LOCK(cache);
+
+	std::map<std::string, std::string>::const_iterator it = cache.tables.find(key);
+	if (it == cache.tables.end())
+		return false;
+
+	table = it->second;
+	return true;
+}
+
+void DL_PrecomputationCache::Insert(const std::string &key, const std::string &table)
+{
+	PrecomputationCacheState &cache = GetPrecomputationCache();
+	CRYPTOPP_CACHE_LOCK(cache);
+
+	const size_t bytes = key.size() + table.size();
+	if (cache.size > cache.capacity || bytes > cache.capacity - cache.size)
+		return;
+
+	if (cache.tables.insert(std::make_pair(key, table)).second)
+		cache.size += bytes;
+}
+
+void DL_PrecomputationCache::Remove(const std::string &key)
+{
+	PrecomputationCacheState &cache = GetPrecomputationCache();
+	CRYPTOPP_CACHE_LOCK(cache);
+
+	std::map<std::string, std::string>::iterator it = cache.tables.find(key);
+	if (it == cache.tables.end())
+		return;
+
+	cache.size -= it->first.size() + it->second.size();
+	cache.tables.erase(it);
+}
+
+void DL_PrecomputationCache::SetCapacity(size_t bytes)
+{
+	PrecomputationCacheState &cache = GetPrecomputationCache();
+	CRYPTOPP_CACHE_LOCK(cache);
+	cache.capacity = bytes;
+}
+
+size_t DL_PrecomputationCache::GetCapacity()
+{
+	PrecomputationCacheState &cache = GetPrecomputationCache();
+	CRYPTOPP_CACHE_LOCK(cache);
+	return cache.capacity;
+}
+
+size_t DL_PrecomputationCache::GetSize()
+{
+	PrecomputationCacheState &cache = GetPrecomputationCache();
+	CRYPTOPP_CACHE_LOCK(cache);
+	return cache.size;
+}
+
+void DL_PrecomputationCache::Clear()
+{
+	PrecomputationCacheState &cache = GetPrecomputationCache();
+	CRYPTOPP_CACHE_LOCK(cache);
+	cache.tables.clear();
+	cache.size = 0;
+}
+
+void DL_PrecomputationCache::Save(BufferedTransformation &bt)
+{
+	PrecomputationCacheState &cache = GetPrecomputationCache();
+	CRYPTOPP_CACHE_LOCK(cache);
+
+	DERSequenceEncoder seq(bt);
+	DEREncodeUnsigned<word32>(seq, 1);	// version
+	std::map<std::string, std::string>::const_iterator it;
+	for (it = cache.tables.begin(); it != cache.tables.end(); ++it)
+	{
+		DEREncodeOctetString(seq, ConstBytePtr(it->first), BytePtrSize(it->first));
+		DEREncodeOctetString(seq, ConstBytePtr(it->second), BytePtrSize(it->second));
+	}
+	seq.MessageEnd();
+}
+
+void DL_PrecomputationCache::Load(BufferedTransformation &bt)
+{
+	// Decode everything before taking the lock
+	std::vector<std::pair<std::string, std::string> > entries;
+
+	BERSequenceDecoder seq(bt);
+	word32 version;
+	BERDecodeUnsigned<word32>(seq, version, INTEGER, 1, 1);
+	while (!seq.EndReached())
+	{
+		SecByteBlock key, table;
+		BERDecodeOctetString(seq, key);
+		BERDecodeOctetString(seq, table);
+		entries.push_back(std::make_pair(std::string(key.begin(), key.end()), std::string(table.begin(), table.end())));
+	}
+	seq.MessageEnd();
+
+	PrecomputationCacheState &cache = GetPrecomputationCache();
+	CRYPTOPP_CACHE_LOCK(cache);
+	for (size_t i=0; i<entries.size(); i++)
+	{
+		if (cache.tables.insert(entries[i]).second)
+			cache.size += entries[i].first.size() + entries[i].second.size();
+	}
+}
+
+#undef CRYPTOPP_CACHE_LOCK
+
 void P1363_MGF1KDF2_Common(HashTransformation &hash, byte *output, size_t outputLength, const byte *input, size_t inputLength, const byte *derivationParams, size_t derivationParamsLength, bool mask, unsigned int counterStart)
 {
 	ArraySink *sink;
@@ -774,6 +774,72 @@ public:
 	DL_BadElement() : InvalidDataFormat("CryptoPP: invalid group element") {}
 };
 
+/// \brief Process-wide cache of fixed-base precomputations
+/// \details DL_GroupParameters::Precompute() looks in the cache before it computes a table,
+///   and adds the tables it computes. Entries are keyed by the group parameters, the base and
+///   the table layout, so a named curve is keyed by its OID and base point. The cache is safe
+///   to use from several threads when the library is built with C++11 synchronization.
+/// \details Save() writes the cache in a compact DER form, and Load() adds the entries of a
+///   saved cache. A short-lived process can load a saved cache at startup, for example from a
+///   memory-mapped file through an ArraySource, and its Precompute() calls then decode the
+///   tables instead of computing them.
+/// \details Precompute() checks the base of a table it finds, and a table for another base is
+///   removed and computed again. The other entries of a table are not checked, so a saved cache
+///   must come from a trusted source. A corrupted cache produces wrong results for every object
+///   in the process that uses the group.
+/// \since Crypto++ 8.3
+class CRYPTOPP_DLL DL_PrecomputationCache
+{
+public:
+	/// \brief Find a table
+	/// \param key the key of the table
+	/// \param table the string to receive the table
+	/// \returns true if the table was found, false otherwise
+	static bool CRYPTOPP_API Find(const std::string &key, std::string &table);
+
+	/// \brief Add a table
+	/// \param key the key of the table
+	/// \param table the table in the form written by DL_FixedBasePrecomputation::Save()
+	/// \details Insert() does nothing if the key is present or if the table does not
+	///   fit in the remaining capacity.
+	static void CRYPTOPP_API Insert(const std::string &key, const std::string &table);
+
+	/// \brief Remove a table
+	/// \param key the key of the table
+	/// \details Remove() does nothing if the key is not present.
+	static void CRYPTOPP_API Remove(const std::string &key);
+
+	/// \brief Set the capacity
+	/// \param bytes the maximum size of the keys and tables that Insert() keeps
+	/// \details The default capacity is 4 MiB. A capacity of 0 stops Precompute() from
+	///   adding tables. Entries already in the cache are kept.
+	static void CRYPTOPP_API SetCapacity(size_t bytes);
+
+	/// \brief Retrieve the capacity
+	/// \returns the maximum size of the keys and tables that Insert() keeps
+	static size_t CRYPTOPP_API GetCapacity();
+
+	/// \brief Retrieve the size
+	/// \returns the size of the keys and tables in the cache, in bytes
+	static size_t CRYPTOPP_API GetSize();
+
+	/// \brief Remove all entries
+	static void CRYPTOPP_API Clear();
+
+	/// \brief Save the cache
+	/// \param bt BufferedTransformation to write the cache
+	static void CRYPTOPP_API Save(BufferedTransformation &bt);
+
+	/// \brief Load a saved cache
+	/// \param bt BufferedTransformation with the saved cache
+	/// \throws BERDecodeErr if the saved cache is malformed
+	/// \details Load() adds the entries whose keys are not present. The entries are added
+	///   even if they exceed the capacity.
+	/// \details The saved cache must come from a trusted source. Only the base of a table
+	///   is checked when it is used.
+	static void CRYPTOPP_API Load(BufferedTransformation &bt);
+};
+
 /// \brief Interface for Discrete Log (DL) group parameters
 /// \tparam T element in the group
 /// \details The element is usually an Integer, \ref ECP "ECP::Point" or \ref EC2N "EC2N::Point"
@@ -828,10 +894,55 @@ public:
 	///   a table of n objects that can be used later to speed up computation.
 	/// \details If a derived class does not override Precompute(), then the base class throws
 	///   NotImplemented.
+	/// \details Precompute() uses DL_PrecomputationCache when the derived class provides a key
+	///   for the group. A storage larger than the bit length of the subgroup order selects a
+	///   window table. See DL_FixedBasePrecomputation::Precompute().
 	/// \sa SupportsPrecomputation(), LoadPrecomputation(), SavePrecomputation()
 	void Precompute(unsigned int precomputationStorage=16)
 	{
-		AccessBasePrecomputation().Precompute(GetGroupPrecomputation(), GetSubgroupOrder().BitCount(), precomputationStorage);
+		const unsigned int maxExpBits = GetSubgroupOrder().BitCount();
+
+		std::string key, table;
+		if (GetPrecomputationKey(key))
+		{
+			// The base and the table layout complete the key
+			const size_t size = GetEncodedElementSize(true);
+			SecByteBlock suffix(size+8);
+			EncodeElement(true, GetSubgroupGenerator(), suffix);
+			PutWord(false, BIG_ENDIAN_ORDER, suffix+size, static_cast<word32>(maxExpBits));
+			PutWord(false, BIG_ENDIAN_ORDER, suffix+size+4, static_cast<word32>(precomputationStorage));
+			key.append(reinterpret_cast<const char *>(suffix.begin()), suffix.size());
+
+			if (DL_PrecomputationCache::Find(key, table))
+			{
+				// The cache may have been loaded from outside the process. Use
+				// the table only if its base is the generator, otherwise put the
+				// generator back and compute a new table.
+				const Element base = GetSubgroupGenerator();
+				try
+				{
+					StringStore store(table);
+					LoadPrecomputation(store);
+					if (GetGroupPrecomputation().GetGroup().Equal(GetSubgroupGenerator(), base))
+						return;
+				}
+				catch (const Exception&)
+				{
+				}
+
+				SetSubgroupGenerator(base);
+				DL_PrecomputationCache::Remove(key);
+			}
+		}
+
+		AccessBasePrecomputation().Precompute(GetGroupPrecomputation(), maxExpBits, precomputationStorage);
+
+		if (!key.empty())
+		{
+			StringSink sink(table);
+			SavePrecomputation(sink);
+			DL_PrecomputationCache::Insert(key, table);
+		}
 	}
 
 	/// \brief Retrieve previously saved precomputation
@@ -1001,6 +1112,15 @@ public:
 protected:
 	void ParametersChanged() {m_validationLevel = 0;}
 
+	/// \brief Retrieves the key of the group in DL_PrecomputationCache
+	/// \param key the string to receive the key
+	/// \return true if the group can be cached, false otherwise
+	/// \details The key must identify the group. Precompute() adds the base. The default
+	///   implementation returns false.
+	/// \since Crypto++ 8.3
+	virtual bool GetPrecomputationKey(std::string &key) const
+		{CRYPTOPP_UNUSED(key); return false;}
+
 private:
 	mutable unsigned int m_validationLevel;
 };
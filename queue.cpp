@@ -11,6 +11,8 @@
 NAMESPACE_BEGIN(CryptoPP)
 
 static const unsigned int s_maxAutoNodeSize = 16*1024;
+static const unsigned int s_maxQueuePoolNodes = 4;
+static const unsigned int s_maxSharedPoolNodes = 64;
 
 // this class for use by ByteQueue only
 class ByteQueueNode
@@ -131,9 +133,104 @@ public:
 
 // ********************************************************
 
+void ByteQueueNodePool::Clear()
+{
+	for (ByteQueueNode *next, *current=m_free; current; current=next)
+	{
+		next=current->m_next;
+		delete current;
+	}
+
+	m_free = NULLPTR;
+	m_count = 0;
+}
+
+ByteQueueNode * ByteQueueNodePool::Acquire(size_t size)
+{
+	for (ByteQueueNode **link=&m_free; *link; link=&(*link)->m_next)
+	{
+		ByteQueueNode *node = *link;
+		if (node->MaxSize() >= size)
+		{
+			*link = node->m_next;
+			node->m_next = NULLPTR;
+			m_count--;
+			return node;
+		}
+	}
+
+	return NULLPTR;
+}
+
+void ByteQueueNodePool::Release(ByteQueueNode *node)
+{
+	if (node->MaxSize() > s_maxAutoNodeSize || m_maxNodes == 0)
+	{
+		delete node;
+		return;
+	}
+
+	if (m_count == m_maxNodes)
+	{
+		// Keep the larger nodes, they can serve more requests
+		ByteQueueNode **smallest = &m_free;
+		for (ByteQueueNode **link=&m_free; *link; link=&(*link)->m_next)
+			if ((*link)->MaxSize() < (*smallest)->MaxSize())
+				smallest = link;
+
+		if ((*smallest)->MaxSize() >= node->MaxSize())
+		{
+			delete node;
+			return;
+		}
+
+		ByteQueueNode *evicted = *smallest;
+		*smallest = evicted->m_next;
+		delete evicted;
+		m_count--;
+	}
+
+	SecureWipeBuffer(node->m_buf.begin(), node->m_tail);
+	node->Clear();
+	node->m_next = m_free;
+	m_free = node;
+	m_count++;
+}
+
+#if defined(CRYPTOPP_CXX11_THREAD_LOCAL)
+ANONYMOUS_NAMESPACE_BEGIN
+
+// The pool of each thread is reached through a trivially destructible
+// pointer. A queue that outlives the pool at thread exit finds it NULL.
+thread_local ByteQueueNodePool *s_sharedPool = NULLPTR;
+thread_local bool s_sharedPoolDestroyed = false;
+
+struct SharedPoolHolder
+{
+	SharedPoolHolder() : m_pool(s_maxSharedPoolNodes) {s_sharedPool = &m_pool;}
+	~SharedPoolHolder() {s_sharedPool = NULLPTR; s_sharedPoolDestroyed = true;}
+	ByteQueueNodePool m_pool;
+};
+
+ByteQueueNodePool * SharedPool()
+{
+	if (!s_sharedPool && !s_sharedPoolDestroyed)
+	{
+		static thread_local SharedPoolHolder holder;
+		CRYPTOPP_UNUSED(holder);
+	}
+	return s_sharedPool;
+}
+
+ANONYMOUS_NAMESPACE_END
+#endif
+
+// ********************************************************
+
 ByteQueue::ByteQueue(size_t nodeSize)
 	: Bufferless<BufferedTransformation>(), m_autoNodeSize(!nodeSize), m_nodeSize(nodeSize)
 	, m_head(NULLPTR), m_tail(NULLPTR), m_lazyString(NULLPTR), m_lazyLength(0), m_lazyStringModifiable(false)
+	, m_sharedPool(false), m_pool(s_maxQueuePoolNodes), m_poolHits(0), m_poolMisses(0)
 {
 	SetNodeSize(nodeSize);
 	m_head = m_tail = new ByteQueueNode(m_nodeSize);
@@ -147,6 +244,7 @@ void ByteQueue::SetNodeSize(size_t nodeSize)
 
 ByteQueue::ByteQueue(const ByteQueue &copy)
 	: Bufferless<BufferedTransformation>(copy), m_lazyString(NULLPTR), m_lazyLength(0)
+	, m_sharedPool(copy.m_sharedPool), m_pool(s_maxQueuePoolNodes), m_poolHits(0), m_poolMisses(0)
 {
 	CopyFrom(copy);
 }
@@ -176,11 +274,43 @@ ByteQueue::~ByteQueue()
 
 void ByteQueue::Destroy()
 {
+	// The queue's own pool is about to go, only the shared pool outlives it
 	for (ByteQueueNode *next, *current=m_head; current; current=next)
 	{
 		next=current->m_next;
-		delete current;
+		if (m_sharedPool)
+			DeleteNode(current);
+		else
+			delete current;
+	}
+}
+
+ByteQueueNodePool & ByteQueue::NodePool()
+{
+#if defined(CRYPTOPP_CXX11_THREAD_LOCAL)
+	ByteQueueNodePool *shared = m_sharedPool ? SharedPool() : NULLPTR;
+	if (shared)
+		return *shared;
+#endif
+	return m_pool;
+}
+
+ByteQueueNode * ByteQueue::NewNode(size_t size)
+{
+	ByteQueueNode *node = NodePool().Acquire(size);
+	if (node)
+	{
+		m_poolHits++;
+		return node;
 	}
+
+	m_poolMisses++;
+	return new ByteQueueNode(size);
+}
+
+void ByteQueue::DeleteNode(ByteQueueNode *node)
+{
+	NodePool().Release(node);
 }
 
 void ByteQueue::IsolatedInitialize(const NameValuePairs &parameters)
@@ -209,7 +339,7 @@ void ByteQueue::Clear()
 	for (ByteQueueNode *next, *current=m_head->m_next; current; current=next)
 	{
 		next=current->m_next;
-		delete current;
+		DeleteNode(current);
 	}
 
 	m_tail = m_head;
@@ -236,13 +366,50 @@ size_t ByteQueue::Put2(const byte *inString, size_t length, int messageEnd, bool
 				m_nodeSize *= 2;
 			}
 			while (m_nodeSize < length && m_nodeSize < s_maxAutoNodeSize);
-		m_tail->m_next = new ByteQueueNode(STDMAX(m_nodeSize, length));
+		m_tail->m_next = NewNode(STDMAX(m_nodeSize, length));
 		m_tail = m_tail->m_next;
 	}
 
 	return 0;
 }
 
+size_t ByteQueue::Put2V(const ConstByteSpan *spans, size_t count, int messageEnd, bool blocking)
+{
+	CRYPTOPP_UNUSED(messageEnd), CRYPTOPP_UNUSED(blocking);
+
+	if (m_lazyLength > 0)
+		FinalizeLazyPut();
+
+	// A node that overflows is followed by one sized for all of the
+	// fragments that remain, not one node per fragment
+	size_t remaining = 0;
+	for (size_t i=0; i<count; i++)
+		remaining += spans[i].size;
+
+	for (size_t i=0; i<count; i++)
+	{
+		const byte *inString = spans[i].data;
+		size_t length = spans[i].size, len;
+		while ((len=m_tail->Put(inString, length)) < length)
+		{
+			inString = PtrAdd(inString, len);
+			length -= len;
+			remaining -= len;
+			if (m_autoNodeSize && m_nodeSize < s_maxAutoNodeSize)
+				do
+				{
+					m_nodeSize *= 2;
+				}
+				while (m_nodeSize < remaining && m_nodeSize < s_maxAutoNodeSize);
+			m_tail->m_next = NewNode(STDMAX(m_nodeSize, remaining));
+			m_tail = m_tail->m_next;
+		}
+		remaining -= length;
+	}
+
+	return 0;
+}
+
 void ByteQueue::CleanupUsedNodes()
 {
 	// Test for m_head due to Enterprise Anlysis finding
@@ -250,7 +417,7 @@ void ByteQueue::CleanupUsedNodes()
 	{
 		ByteQueueNode *temp=m_head;
 		m_head=m_head->m_next;
-		delete temp;
+		DeleteNode(temp);
 	}
 
 	// Test for m_head due to Enterprise Anlysis finding
@@ -397,6 +564,7 @@ void ByteQueue::Unget(const byte *inString, size_t length)
 
 	if (length > 0)
 	{
+		// A node ahead of the tail must be full, so the size is exact
 		ByteQueueNode *newHead = new ByteQueueNode(length);
 		newHead->m_next = m_head;
 		m_head = newHead;
@@ -423,7 +591,7 @@ byte * ByteQueue::CreatePutSpace(size_t &size)
 
 	if (m_tail->m_tail == m_tail->MaxSize())
 	{
-		m_tail->m_next = new ByteQueueNode(STDMAX(m_nodeSize, size));
+		m_tail->m_next = NewNode(STDMAX(m_nodeSize, size));
 		m_tail = m_tail->m_next;
 	}
 
@@ -433,7 +601,10 @@ byte * ByteQueue::CreatePutSpace(size_t &size)
 
 ByteQueue & ByteQueue::operator=(const ByteQueue &rhs)
 {
+	// Our nodes go back to our own pool, then the pool mode follows rhs
+	// like it does in the copy constructor
 	Destroy();
+	m_sharedPool = rhs.m_sharedPool;
 	CopyFrom(rhs);
 	return *this;
 }
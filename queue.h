@@ -13,6 +13,40 @@ NAMESPACE_BEGIN(CryptoPP)
 
 class ByteQueueNode;
 
+/// \brief Free list of ByteQueue nodes
+/// \details ByteQueueNodePool keeps the nodes released by a ByteQueue so later
+///   writes reuse them instead of going to the heap. The bytes a node held are
+///   wiped before the node is pooled. Only nodes up to the largest automatic
+///   node size are pooled, and when the pool is full the smallest node is freed.
+/// \since Crypto++ 8.3
+class CRYPTOPP_DLL ByteQueueNodePool : public NotCopyable
+{
+public:
+	/// \brief Construct a ByteQueueNodePool
+	/// \param maxNodes the maximum number of nodes kept in the pool
+	ByteQueueNodePool(size_t maxNodes) : m_free(NULLPTR), m_count(0), m_maxNodes(maxNodes) {}
+	~ByteQueueNodePool() {Clear();}
+
+	/// \brief Retrieves the number of pooled nodes
+	size_t Size() const {return m_count;}
+
+	/// \brief Frees the pooled nodes
+	void Clear();
+
+	/// \brief Takes a node from the pool
+	/// \param size the minimum node size
+	/// \returns a cleared node of at least \p size bytes, or NULL if none is pooled
+	ByteQueueNode * Acquire(size_t size);
+
+	/// \brief Returns a node to the pool
+	/// \param node the node, which is wiped, pooled or freed
+	void Release(ByteQueueNode *node);
+
+private:
+	ByteQueueNode *m_free;
+	size_t m_count, m_maxNodes;
+};
+
 /// \brief Data structure used to store byte strings
 /// \details The queue is implemented as a linked list of byte arrays
 class CRYPTOPP_DLL ByteQueue : public Bufferless<BufferedTransformation>
@@ -38,6 +72,7 @@ public:
 	void IsolatedInitialize(const NameValuePairs &parameters);
 	byte * CreatePutSpace(size_t &size);
 	size_t Put2(const byte *inString, size_t length, int messageEnd, bool blocking);
+	size_t Put2V(const ConstByteSpan *spans, size_t count, int messageEnd, bool blocking);
 
 	size_t Get(byte &outByte);
 	size_t Get(byte *outString, size_t getMax);
@@ -51,6 +86,25 @@ public:
 	// these member functions are not inherited
 	void SetNodeSize(size_t nodeSize);
 
+	/// \brief Selects the node pool
+	/// \param shared flag indicating if nodes are recycled through the pool of the calling thread
+	/// \details By default a ByteQueue recycles its nodes through a small pool of its own.
+	///   A shared pool also lets short lived queues reuse the nodes of queues
+	///   destroyed earlier on the same thread. The shared pool is used when
+	///   CRYPTOPP_CXX11_THREAD_LOCAL is defined, otherwise the queue keeps its own pool.
+	/// \since Crypto++ 8.3
+	void SetSharedNodePool(bool shared) {m_sharedPool = shared;}
+
+	/// \brief Retrieves the node pool hit count
+	/// \returns the number of nodes this queue took from a pool
+	/// \since Crypto++ 8.3
+	lword GetNodePoolHits() const {return m_poolHits;}
+
+	/// \brief Retrieves the node pool miss count
+	/// \returns the number of nodes this queue allocated from the heap
+	/// \since Crypto++ 8.3
+	lword GetNodePoolMisses() const {return m_poolMisses;}
+
 	lword CurrentSize() const;
 	bool IsEmpty() const;
 
@@ -113,6 +167,9 @@ private:
 	void CleanupUsedNodes();
 	void CopyFrom(const ByteQueue &copy);
 	void Destroy();
+	ByteQueueNode * NewNode(size_t size);
+	void DeleteNode(ByteQueueNode *node);
+	ByteQueueNodePool & NodePool();
 
 	bool m_autoNodeSize;
 	size_t m_nodeSize;
@@ -120,6 +177,9 @@ private:
 	byte *m_lazyString;
 	size_t m_lazyLength;
 	bool m_lazyStringModifiable;
+	bool m_sharedPool;
+	ByteQueueNodePool m_pool;
+	lword m_poolHits, m_poolMisses;
 };
 
 /// use this to make sure LazyPut is finalized in event of exception
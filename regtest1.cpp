@@ -17,6 +17,9 @@
 #include "sha3.h"
 #include "shake.h"
 #include "blake2.h"
+#include "blake3.h"
+#include "kangaroo12.h"
+#include "parallelhash.h"
 #include "sha.h"
 #include "sha3.h"
 #include "sm3.h"
@@ -115,6 +118,12 @@ void RegisterFactories1()
 	RegisterDefaultFactoryFor<HashTransformation, SM3>();
 	RegisterDefaultFactoryFor<HashTransformation, BLAKE2s>();
 	RegisterDefaultFactoryFor<HashTransformation, BLAKE2b>();
+	RegisterDefaultFactoryFor<HashTransformation, BLAKE2sp>();
+	RegisterDefaultFactoryFor<HashTransformation, BLAKE2bp>();
+	RegisterDefaultFactoryFor<HashTransformation, BLAKE3>();
+	RegisterDefaultFactoryFor<HashTransformation, KangarooTwelve>();
+	RegisterDefaultFactoryFor<HashTransformation, ParallelHash128>();
+	RegisterDefaultFactoryFor<HashTransformation, ParallelHash256>();
 
 #ifdef BLOCKING_RNG_AVAILABLE
 	RegisterDefaultFactoryFor<RandomNumberGenerator, BlockingRng>();
@@ -22,6 +22,7 @@
 #include "sha.h"
 #include "sha3.h"
 #include "blake2.h"
+#include "blake3.h"
 #include "ripemd.h"
 #include "chacha.h"
 #include "poly1305.h"
@@ -77,6 +78,9 @@ void RegisterFactories2()
 	RegisterDefaultFactoryFor<MessageAuthenticationCode, CMAC<DES_EDE3> >();
 	RegisterDefaultFactoryFor<MessageAuthenticationCode, BLAKE2s>();
 	RegisterDefaultFactoryFor<MessageAuthenticationCode, BLAKE2b>();
+	RegisterDefaultFactoryFor<MessageAuthenticationCode, BLAKE2sp>();
+	RegisterDefaultFactoryFor<MessageAuthenticationCode, BLAKE2bp>();
+	RegisterDefaultFactoryFor<MessageAuthenticationCode, BLAKE3>();
 	RegisterDefaultFactoryFor<MessageAuthenticationCode, SipHash<2,4> >();
 	RegisterDefaultFactoryFor<MessageAuthenticationCode, SipHash<4,8> >();
 }
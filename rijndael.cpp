@@ -320,6 +320,20 @@ extern size_t Rijndael_Dec_AdvancedProcessBlocks_AESNI(const word32 *subkeys, si
         const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags);
 #endif
 
+#if (CRYPTOPP_VAES_AVAILABLE)
+extern size_t Rijndael_Enc_AdvancedProcessBlocks_VAES256(const word32 *subkeys, size_t rounds,
+        const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags);
+extern size_t Rijndael_Dec_AdvancedProcessBlocks_VAES256(const word32 *subkeys, size_t rounds,
+        const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags);
+#endif
+
+#if (CRYPTOPP_VAES_AVAILABLE && CRYPTOPP_AVX512_AVAILABLE)
+extern size_t Rijndael_Enc_AdvancedProcessBlocks_VAES512(const word32 *subkeys, size_t rounds,
+        const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags);
+extern size_t Rijndael_Dec_AdvancedProcessBlocks_VAES512(const word32 *subkeys, size_t rounds,
+        const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags);
+#endif
+
 #if (CRYPTOPP_ARM_AES_AVAILABLE)
 extern size_t Rijndael_Enc_AdvancedProcessBlocks_ARMV8(const word32 *subkeys, size_t rounds,
         const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags);
@@ -369,6 +383,10 @@ void CRYPTOGAMS_decrypt(const byte *inBlock, const byte *xorBlock, byte *outBloc
 
 std::string Rijndael::Base::AlgorithmProvider() const
 {
+#if (CRYPTOPP_VAES_AVAILABLE)
+	if (HasVAES() && HasAVX2())
+		return "VAES";
+#endif
 #if (CRYPTOPP_AESNI_AVAILABLE)
 	if (HasAESNI())
 		return "AESNI";
@@ -1241,6 +1259,14 @@ void Rijndael_Enc_AdvancedProcessBlocks_SSE2(void *locals, const word32 *k);
 #if CRYPTOPP_RIJNDAEL_ADVANCED_PROCESS_BLOCKS
 size_t Rijndael::Enc::AdvancedProcessBlocks(const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags) const
 {
+#if CRYPTOPP_VAES_AVAILABLE && CRYPTOPP_AVX512_AVAILABLE
+	if (HasVAES() && HasAVX512F() && HasAVX512BW() && HasAVX512VL())
+		return Rijndael_Enc_AdvancedProcessBlocks_VAES512(m_key, m_rounds, inBlocks, xorBlocks, outBlocks, length, flags);
+#endif
+#if CRYPTOPP_VAES_AVAILABLE
+	if (HasVAES() && HasAVX2())
+		return Rijndael_Enc_AdvancedProcessBlocks_VAES256(m_key, m_rounds, inBlocks, xorBlocks, outBlocks, length, flags);
+#endif
 #if CRYPTOPP_AESNI_AVAILABLE
 	if (HasAESNI())
 		return Rijndael_Enc_AdvancedProcessBlocks_AESNI(m_key, m_rounds, inBlocks, xorBlocks, outBlocks, length, flags);
@@ -1309,6 +1335,14 @@ size_t Rijndael::Enc::AdvancedProcessBlocks(const byte *inBlocks, const byte *xo
 
 size_t Rijndael::Dec::AdvancedProcessBlocks(const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags) const
 {
+#if CRYPTOPP_VAES_AVAILABLE && CRYPTOPP_AVX512_AVAILABLE
+	if (HasVAES() && HasAVX512F() && HasAVX512BW() && HasAVX512VL())
+		return Rijndael_Dec_AdvancedProcessBlocks_VAES512(m_key, m_rounds, inBlocks, xorBlocks, outBlocks, length, flags);
+#endif
+#if CRYPTOPP_VAES_AVAILABLE
+	if (HasVAES() && HasAVX2())
+		return Rijndael_Dec_AdvancedProcessBlocks_VAES256(m_key, m_rounds, inBlocks, xorBlocks, outBlocks, length, flags);
+#endif
 #if CRYPTOPP_AESNI_AVAILABLE
 	if (HasAESNI())
 		return Rijndael_Dec_AdvancedProcessBlocks_AESNI(m_key, m_rounds, inBlocks, xorBlocks, outBlocks, length, flags);
@@ -66,6 +66,9 @@ class CRYPTOPP_DLL Rijndael : public Rijndael_Info, public BlockCipherDocumentat
 		unsigned int m_rounds;
 		SecBlock<word32, AllocatorWithCleanup<word32, true> > m_key;
 		mutable SecByteBlock m_aliasBlock;
+
+		// GCM uses the AES-NI key schedule for its stitched kernel
+		friend class GCM_Base;
 	};
 
 	/// \brief Encryption transformation
@@ -0,0 +1,234 @@
+// rijndael_avx.cpp - written and placed in the public domain by
+//                    the Crypto++ project.
+//
+//    This source file uses intrinsics and built-ins to gain access to
+//    VAES on 256-bit YMM registers. A separate source file is needed
+//    because additional CXXFLAGS are required to enable the appropriate
+//    instructions sets in some build configurations.
+//
+//    The VAES code processes 8 blocks at a time using four YMM registers,
+//    which is twice the width of the AES-NI code in rijndael_simd.cpp.
+//    Remaining blocks are handed to the AES-NI code. The VAES-256 code is
+//    used on machines like Zen 3 which provide VAES but not AVX-512. Also
+//    see rijndael_avx512.cpp for the 512-bit ZMM code.
+
+#include "pch.h"
+#include "config.h"
+#include "misc.h"
+
+#if (CRYPTOPP_VAES_AVAILABLE)
+# include "adv_simd.h"
+# include <emmintrin.h>
+# include <immintrin.h>
+#endif
+
+// Squash MS LNK4221 and libtool warnings
+extern const char RIJNDAEL_AVX_FNAME[] = __FILE__;
+
+// Clang intrinsic casts, http://bugs.llvm.org/show_bug.cgi?id=20670
+#define M128_CAST(x) ((__m128i *)(void *)(x))
+#define CONST_M128_CAST(x) ((const __m128i *)(const void *)(x))
+#define M256_CAST(x) ((__m256i *)(void *)(x))
+#define CONST_M256_CAST(x) ((const __m256i *)(const void *)(x))
+
+NAMESPACE_BEGIN(CryptoPP)
+
+#if (CRYPTOPP_VAES_AVAILABLE)
+
+extern size_t Rijndael_Enc_AdvancedProcessBlocks_AESNI(const word32 *subkeys, size_t rounds,
+        const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags);
+extern size_t Rijndael_Dec_AdvancedProcessBlocks_AESNI(const word32 *subkeys, size_t rounds,
+        const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags);
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+inline void VAES256_Enc_8_Blocks(__m256i &block0, __m256i &block1,
+        __m256i &block2, __m256i &block3, const word32 *subkeys, unsigned int rounds)
+{
+    const __m128i* skeys = CONST_M128_CAST(subkeys);
+
+    __m256i rk = _mm256_broadcastsi128_si256(_mm_loadu_si128(skeys+0));
+    block0 = _mm256_xor_si256(block0, rk);
+    block1 = _mm256_xor_si256(block1, rk);
+    block2 = _mm256_xor_si256(block2, rk);
+    block3 = _mm256_xor_si256(block3, rk);
+    for (unsigned int i=1; i<rounds; i++)
+    {
+        rk = _mm256_broadcastsi128_si256(_mm_loadu_si128(skeys+i));
+        block0 = _mm256_aesenc_epi128(block0, rk);
+        block1 = _mm256_aesenc_epi128(block1, rk);
+        block2 = _mm256_aesenc_epi128(block2, rk);
+        block3 = _mm256_aesenc_epi128(block3, rk);
+    }
+    rk = _mm256_broadcastsi128_si256(_mm_loadu_si128(skeys+rounds));
+    block0 = _mm256_aesenclast_epi128(block0, rk);
+    block1 = _mm256_aesenclast_epi128(block1, rk);
+    block2 = _mm256_aesenclast_epi128(block2, rk);
+    block3 = _mm256_aesenclast_epi128(block3, rk);
+}
+
+inline void VAES256_Dec_8_Blocks(__m256i &block0, __m256i &block1,
+        __m256i &block2, __m256i &block3, const word32 *subkeys, unsigned int rounds)
+{
+    const __m128i* skeys = CONST_M128_CAST(subkeys);
+
+    __m256i rk = _mm256_broadcastsi128_si256(_mm_loadu_si128(skeys+0));
+    block0 = _mm256_xor_si256(block0, rk);
+    block1 = _mm256_xor_si256(block1, rk);
+    block2 = _mm256_xor_si256(block2, rk);
+    block3 = _mm256_xor_si256(block3, rk);
+    for (unsigned int i=1; i<rounds; i++)
+    {
+        rk = _mm256_broadcastsi128_si256(_mm_loadu_si128(skeys+i));
+        block0 = _mm256_aesdec_epi128(block0, rk);
+        block1 = _mm256_aesdec_epi128(block1, rk);
+        block2 = _mm256_aesdec_epi128(block2, rk);
+        block3 = _mm256_aesdec_epi128(block3, rk);
+    }
+    rk = _mm256_broadcastsi128_si256(_mm_loadu_si128(skeys+rounds));
+    block0 = _mm256_aesdeclast_epi128(block0, rk);
+    block1 = _mm256_aesdeclast_epi128(block1, rk);
+    block2 = _mm256_aesdeclast_epi128(block2, rk);
+    block3 = _mm256_aesdeclast_epi128(block3, rk);
+}
+
+/// \brief AdvancedProcessBlocks for 8 blocks using VAES-256
+/// \details AdvancedProcessBlocks128_8x_VAES256 processes 8 blocks at a
+///  time, and returns the number of bytes that were not processed. The
+///  caller finishes the tail with the 4x1 AES-NI code. The pointers are
+///  returned by reference so the caller can pick up where we left off.
+///  In the reverse direction the unprocessed blocks are at the head of
+///  the buffers, so the pointers are not updated.
+template <typename F8>
+inline size_t AdvancedProcessBlocks128_8x_VAES256(F8 func8, const word32 *subKeys,
+        size_t rounds, const byte *&inBlocks, const byte *&xorBlocks, byte *&outBlocks,
+        size_t length, word32 flags)
+{
+    const size_t blockSize = 16;
+    const size_t groupSize = 8*blockSize;
+
+    if (!(flags & BT_AllowParallel) || (flags & BT_DontIncrementInOutPointers) ||
+        length < groupSize)
+    {
+        return length;
+    }
+
+    const bool isCounter = (flags & BT_InBlockIsCounter) != 0;
+    const bool xorInput = (xorBlocks != NULLPTR) && (flags & BT_XorInput);
+    const bool xorOutput = (xorBlocks != NULLPTR) && !(flags & BT_XorInput);
+
+    size_t inIncrement = isCounter ? 0 : groupSize;
+    size_t xorIncrement = (xorBlocks != NULLPTR) ? groupSize : 0;
+    size_t outIncrement = groupSize;
+
+    const byte *ib = inBlocks, *xb = xorBlocks;
+    byte *ob = outBlocks;
+
+    // The group is processed in memory order. Order within a group does
+    // not matter because all loads occur before any store.
+    if (flags & BT_ReverseDirection)
+    {
+        CRYPTOPP_ASSERT(!isCounter);
+        ib = PtrAdd(ib, length - groupSize);
+        xb = PtrAdd(xb, length - groupSize);
+        ob = PtrAdd(ob, length - groupSize);
+        inIncrement = 0-inIncrement;
+        xorIncrement = 0-xorIncrement;
+        outIncrement = 0-outIncrement;
+    }
+
+    // Increment of 1 in big-endian compatible with the ctr byte array.
+    const __m256i s_one = _mm256_set_epi32(1<<24, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i s_two = _mm256_set_epi32(2<<24, 0, 0, 0, 2<<24, 0, 0, 0);
+    const __m128i s_eight = _mm_set_epi32(8<<24, 0, 0, 0);
+
+    while (length >= groupSize)
+    {
+        __m256i block0, block1, block2, block3;
+        if (isCounter)
+        {
+            const __m128i ctr = _mm_loadu_si128(CONST_M128_CAST(ib));
+            block0 = _mm256_add_epi32(_mm256_broadcastsi128_si256(ctr), s_one);
+            block1 = _mm256_add_epi32(block0, s_two);
+            block2 = _mm256_add_epi32(block1, s_two);
+            block3 = _mm256_add_epi32(block2, s_two);
+            _mm_storeu_si128(M128_CAST(ib), _mm_add_epi32(ctr, s_eight));
+        }
+        else
+        {
+            block0 = _mm256_loadu_si256(CONST_M256_CAST(ib+ 0));
+            block1 = _mm256_loadu_si256(CONST_M256_CAST(ib+32));
+            block2 = _mm256_loadu_si256(CONST_M256_CAST(ib+64));
+            block3 = _mm256_loadu_si256(CONST_M256_CAST(ib+96));
+        }
+
+        if (xorInput)
+        {
+            block0 = _mm256_xor_si256(block0, _mm256_loadu_si256(CONST_M256_CAST(xb+ 0)));
+            block1 = _mm256_xor_si256(block1, _mm256_loadu_si256(CONST_M256_CAST(xb+32)));
+            block2 = _mm256_xor_si256(block2, _mm256_loadu_si256(CONST_M256_CAST(xb+64)));
+            block3 = _mm256_xor_si256(block3, _mm256_loadu_si256(CONST_M256_CAST(xb+96)));
+        }
+
+        func8(block0, block1, block2, block3, subKeys, static_cast<unsigned int>(rounds));
+
+        if (xorOutput)
+        {
+            block0 = _mm256_xor_si256(block0, _mm256_loadu_si256(CONST_M256_CAST(xb+ 0)));
+            block1 = _mm256_xor_si256(block1, _mm256_loadu_si256(CONST_M256_CAST(xb+32)));
+            block2 = _mm256_xor_si256(block2, _mm256_loadu_si256(CONST_M256_CAST(xb+64)));
+            block3 = _mm256_xor_si256(block3, _mm256_loadu_si256(CONST_M256_CAST(xb+96)));
+        }
+
+        _mm256_storeu_si256(M256_CAST(ob+ 0), block0);
+        _mm256_storeu_si256(M256_CAST(ob+32), block1);
+        _mm256_storeu_si256(M256_CAST(ob+64), block2);
+        _mm256_storeu_si256(M256_CAST(ob+96), block3);
+
+        ib = PtrAdd(ib, inIncrement);
+        xb = PtrAdd(xb, xorIncrement);
+        ob = PtrAdd(ob, outIncrement);
+        length -= groupSize;
+    }
+
+    if (!(flags & BT_ReverseDirection))
+    {
+        inBlocks = ib;
+        xorBlocks = xb;
+        outBlocks = ob;
+    }
+
+    return length;
+}
+
+ANONYMOUS_NAMESPACE_END
+
+size_t Rijndael_Enc_AdvancedProcessBlocks_VAES256(const word32 *subKeys, size_t rounds,
+        const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags)
+{
+    length = AdvancedProcessBlocks128_8x_VAES256(VAES256_Enc_8_Blocks,
+                subKeys, rounds, inBlocks, xorBlocks, outBlocks, length, flags);
+
+    if (length < 16)
+        return length;
+
+    return Rijndael_Enc_AdvancedProcessBlocks_AESNI(subKeys, rounds,
+                inBlocks, xorBlocks, outBlocks, length, flags);
+}
+
+size_t Rijndael_Dec_AdvancedProcessBlocks_VAES256(const word32 *subKeys, size_t rounds,
+        const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags)
+{
+    length = AdvancedProcessBlocks128_8x_VAES256(VAES256_Dec_8_Blocks,
+                subKeys, rounds, inBlocks, xorBlocks, outBlocks, length, flags);
+
+    if (length < 16)
+        return length;
+
+    return Rijndael_Dec_AdvancedProcessBlocks_AESNI(subKeys, rounds,
+                inBlocks, xorBlocks, outBlocks, length, flags);
+}
+
+#endif  // CRYPTOPP_VAES_AVAILABLE
+
+NAMESPACE_END
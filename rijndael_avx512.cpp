@@ -0,0 +1,244 @@
+// rijndael_avx512.cpp - written and placed in the public domain by
+//                       the Crypto++ project.
+//
+//    This source file uses intrinsics and built-ins to gain access to
+//    VAES on 512-bit ZMM registers. A separate source file is needed
+//    because additional CXXFLAGS are required to enable the appropriate
+//    instructions sets in some build configurations.
+//
+//    The VAES code processes 16 blocks at a time using four ZMM registers,
+//    which is four times the width of the AES-NI code in rijndael_simd.cpp.
+//    Remaining blocks are handed to the 256-bit YMM code in
+//    rijndael_avx.cpp, which processes 8 blocks at a time and hands
+//    its own remainder to the AES-NI code.
+
+#include "pch.h"
+#include "config.h"
+#include "misc.h"
+
+#if (CRYPTOPP_VAES_AVAILABLE) && (CRYPTOPP_AVX512_AVAILABLE)
+# include "adv_simd.h"
+# include <emmintrin.h>
+# include <immintrin.h>
+#endif
+
+// Squash MS LNK4221 and libtool warnings
+extern const char RIJNDAEL_AVX512_FNAME[] = __FILE__;
+
+// GCC 12 warns the __Y operand in avx512fintrin.h is used
+// uninitialized. It is the self-initialized placeholder of the
+// _mm512_undefined intrinsics and not a variable in this file.
+#if CRYPTOPP_GCC_DIAGNOSTIC_AVAILABLE
+# pragma GCC diagnostic ignored "-Wuninitialized"
+# if (CRYPTOPP_GCC_VERSION >= 40700)
+#  pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+# endif
+#endif
+
+// Clang intrinsic casts, http://bugs.llvm.org/show_bug.cgi?id=20670
+#define M128_CAST(x) ((__m128i *)(void *)(x))
+#define CONST_M128_CAST(x) ((const __m128i *)(const void *)(x))
+#define M512_CAST(x) ((__m512i *)(void *)(x))
+#define CONST_M512_CAST(x) ((const __m512i *)(const void *)(x))
+
+NAMESPACE_BEGIN(CryptoPP)
+
+#if (CRYPTOPP_VAES_AVAILABLE) && (CRYPTOPP_AVX512_AVAILABLE)
+
+extern size_t Rijndael_Enc_AdvancedProcessBlocks_VAES256(const word32 *subkeys, size_t rounds,
+        const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags);
+extern size_t Rijndael_Dec_AdvancedProcessBlocks_VAES256(const word32 *subkeys, size_t rounds,
+        const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags);
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+// The round keys are broadcast once per call and kept in a table.
+// rounds+1 is at most 15, which fits in the 32 ZMM registers along
+// with the data. The table is passed in place of the subkeys.
+inline void VAES512_Enc_16_Blocks(__m512i &block0, __m512i &block1,
+        __m512i &block2, __m512i &block3, const __m512i *rk, unsigned int rounds)
+{
+    block0 = _mm512_xor_si512(block0, rk[0]);
+    block1 = _mm512_xor_si512(block1, rk[0]);
+    block2 = _mm512_xor_si512(block2, rk[0]);
+    block3 = _mm512_xor_si512(block3, rk[0]);
+    for (unsigned int i=1; i<rounds; i++)
+    {
+        block0 = _mm512_aesenc_epi128(block0, rk[i]);
+        block1 = _mm512_aesenc_epi128(block1, rk[i]);
+        block2 = _mm512_aesenc_epi128(block2, rk[i]);
+        block3 = _mm512_aesenc_epi128(block3, rk[i]);
+    }
+    block0 = _mm512_aesenclast_epi128(block0, rk[rounds]);
+    block1 = _mm512_aesenclast_epi128(block1, rk[rounds]);
+    block2 = _mm512_aesenclast_epi128(block2, rk[rounds]);
+    block3 = _mm512_aesenclast_epi128(block3, rk[rounds]);
+}
+
+inline void VAES512_Dec_16_Blocks(__m512i &block0, __m512i &block1,
+        __m512i &block2, __m512i &block3, const __m512i *rk, unsigned int rounds)
+{
+    block0 = _mm512_xor_si512(block0, rk[0]);
+    block1 = _mm512_xor_si512(block1, rk[0]);
+    block2 = _mm512_xor_si512(block2, rk[0]);
+    block3 = _mm512_xor_si512(block3, rk[0]);
+    for (unsigned int i=1; i<rounds; i++)
+    {
+        block0 = _mm512_aesdec_epi128(block0, rk[i]);
+        block1 = _mm512_aesdec_epi128(block1, rk[i]);
+        block2 = _mm512_aesdec_epi128(block2, rk[i]);
+        block3 = _mm512_aesdec_epi128(block3, rk[i]);
+    }
+    block0 = _mm512_aesdeclast_epi128(block0, rk[rounds]);
+    block1 = _mm512_aesdeclast_epi128(block1, rk[rounds]);
+    block2 = _mm512_aesdeclast_epi128(block2, rk[rounds]);
+    block3 = _mm512_aesdeclast_epi128(block3, rk[rounds]);
+}
+
+/// \brief AdvancedProcessBlocks for 16 blocks using VAES-512
+/// \details AdvancedProcessBlocks128_16x_VAES512 processes 16 blocks at a
+///  time, and returns the number of bytes that were not processed. The
+///  caller finishes the tail with the 4x1 AES-NI code. The pointers are
+///  returned by reference so the caller can pick up where we left off.
+///  In the reverse direction the unprocessed blocks are at the head of
+///  the buffers, so the pointers are not updated.
+template <typename F16>
+inline size_t AdvancedProcessBlocks128_16x_VAES512(F16 func16, const word32 *subKeys,
+        size_t rounds, const byte *&inBlocks, const byte *&xorBlocks, byte *&outBlocks,
+        size_t length, word32 flags)
+{
+    const size_t blockSize = 16;
+    const size_t groupSize = 16*blockSize;
+
+    if (!(flags & BT_AllowParallel) || (flags & BT_DontIncrementInOutPointers) ||
+        length < groupSize)
+    {
+        return length;
+    }
+
+    const bool isCounter = (flags & BT_InBlockIsCounter) != 0;
+    const bool xorInput = (xorBlocks != NULLPTR) && (flags & BT_XorInput);
+    const bool xorOutput = (xorBlocks != NULLPTR) && !(flags & BT_XorInput);
+
+    size_t inIncrement = isCounter ? 0 : groupSize;
+    size_t xorIncrement = (xorBlocks != NULLPTR) ? groupSize : 0;
+    size_t outIncrement = groupSize;
+
+    const byte *ib = inBlocks, *xb = xorBlocks;
+    byte *ob = outBlocks;
+
+    // The group is processed in memory order. Order within a group does
+    // not matter because all loads occur before any store.
+    if (flags & BT_ReverseDirection)
+    {
+        CRYPTOPP_ASSERT(!isCounter);
+        ib = PtrAdd(ib, length - groupSize);
+        xb = PtrAdd(xb, length - groupSize);
+        ob = PtrAdd(ob, length - groupSize);
+        inIncrement = 0-inIncrement;
+        xorIncrement = 0-xorIncrement;
+        outIncrement = 0-outIncrement;
+    }
+
+    __m512i rk[15];
+    const __m128i* skeys = CONST_M128_CAST(subKeys);
+    for (size_t i=0; i<=rounds; i++)
+        rk[i] = _mm512_broadcast_i32x4(_mm_loadu_si128(skeys+i));
+
+    // Increment of 1 in big-endian compatible with the ctr byte array.
+    const __m512i s_0123 = _mm512_set_epi32(3<<24, 0, 0, 0, 2<<24, 0, 0, 0,
+                                            1<<24, 0, 0, 0, 0, 0, 0, 0);
+    const __m512i s_four = _mm512_set_epi32(4<<24, 0, 0, 0, 4<<24, 0, 0, 0,
+                                            4<<24, 0, 0, 0, 4<<24, 0, 0, 0);
+    const __m128i s_sixteen = _mm_set_epi32(16<<24, 0, 0, 0);
+
+    while (length >= groupSize)
+    {
+        __m512i block0, block1, block2, block3;
+        if (isCounter)
+        {
+            const __m128i ctr = _mm_loadu_si128(CONST_M128_CAST(ib));
+            block0 = _mm512_add_epi32(_mm512_broadcast_i32x4(ctr), s_0123);
+            block1 = _mm512_add_epi32(block0, s_four);
+            block2 = _mm512_add_epi32(block1, s_four);
+            block3 = _mm512_add_epi32(block2, s_four);
+            _mm_storeu_si128(M128_CAST(ib), _mm_add_epi32(ctr, s_sixteen));
+        }
+        else
+        {
+            block0 = _mm512_loadu_si512(CONST_M512_CAST(ib+  0));
+            block1 = _mm512_loadu_si512(CONST_M512_CAST(ib+ 64));
+            block2 = _mm512_loadu_si512(CONST_M512_CAST(ib+128));
+            block3 = _mm512_loadu_si512(CONST_M512_CAST(ib+192));
+        }
+
+        if (xorInput)
+        {
+            block0 = _mm512_xor_si512(block0, _mm512_loadu_si512(CONST_M512_CAST(xb+  0)));
+            block1 = _mm512_xor_si512(block1, _mm512_loadu_si512(CONST_M512_CAST(xb+ 64)));
+            block2 = _mm512_xor_si512(block2, _mm512_loadu_si512(CONST_M512_CAST(xb+128)));
+            block3 = _mm512_xor_si512(block3, _mm512_loadu_si512(CONST_M512_CAST(xb+192)));
+        }
+
+        func16(block0, block1, block2, block3, rk, static_cast<unsigned int>(rounds));
+
+        if (xorOutput)
+        {
+            block0 = _mm512_xor_si512(block0, _mm512_loadu_si512(CONST_M512_CAST(xb+  0)));
+            block1 = _mm512_xor_si512(block1, _mm512_loadu_si512(CONST_M512_CAST(xb+ 64)));
+            block2 = _mm512_xor_si512(block2, _mm512_loadu_si512(CONST_M512_CAST(xb+128)));
+            block3 = _mm512_xor_si512(block3, _mm512_loadu_si512(CONST_M512_CAST(xb+192)));
+        }
+
+        _mm512_storeu_si512(M512_CAST(ob+  0), block0);
+        _mm512_storeu_si512(M512_CAST(ob+ 64), block1);
+        _mm512_storeu_si512(M512_CAST(ob+128), block2);
+        _mm512_storeu_si512(M512_CAST(ob+192), block3);
+
+        ib = PtrAdd(ib, inIncrement);
+        xb = PtrAdd(xb, xorIncrement);
+        ob = PtrAdd(ob, outIncrement);
+        length -= groupSize;
+    }
+
+    if (!(flags & BT_ReverseDirection))
+    {
+        inBlocks = ib;
+        xorBlocks = xb;
+        outBlocks = ob;
+    }
+
+    return length;
+}
+
+ANONYMOUS_NAMESPACE_END
+
+size_t Rijndael_Enc_AdvancedProcessBlocks_VAES512(const word32 *subKeys, size_t rounds,
+        const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags)
+{
+    length = AdvancedProcessBlocks128_16x_VAES512(VAES512_Enc_16_Blocks,
+                subKeys, rounds, inBlocks, xorBlocks, outBlocks, length, flags);
+
+    if (length < 16)
+        return length;
+
+    return Rijndael_Enc_AdvancedProcessBlocks_VAES256(subKeys, rounds,
+                inBlocks, xorBlocks, outBlocks, length, flags);
+}
+
+size_t Rijndael_Dec_AdvancedProcessBlocks_VAES512(const word32 *subKeys, size_t rounds,
+        const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags)
+{
+    length = AdvancedProcessBlocks128_16x_VAES512(VAES512_Dec_16_Blocks,
+                subKeys, rounds, inBlocks, xorBlocks, outBlocks, length, flags);
+
+    if (length < 16)
+        return length;
+
+    return Rijndael_Dec_AdvancedProcessBlocks_VAES256(subKeys, rounds,
+                inBlocks, xorBlocks, outBlocks, length, flags);
+}
+
+#endif  // CRYPTOPP_VAES_AVAILABLE && CRYPTOPP_AVX512_AVAILABLE
+
+NAMESPACE_END
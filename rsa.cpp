@@ -126,9 +126,13 @@ void InvertibleRSAFunction::GenerateRandom(RandomNumberGenerator &rng, const Nam
 	if (m_e < 3 || m_e.IsEven())
 		throw InvalidArgument("InvertibleRSAFunction: invalid public exponent");
 
+	// Candidates are tested on Threads threads. The selector is
+	// called concurrently, and it only reads m_e.
+	const int threads = alg.GetIntValueWithDefault("Threads", 1);
+
 	RSAPrimeSelector selector(m_e);
 	AlgorithmParameters primeParam = MakeParametersForTwoPrimesOfEqualSize(modulusSize)
-		(Name::PointerToPrimeSelector(), selector.GetSelectorPointer());
+		(Name::PointerToPrimeSelector(), selector.GetSelectorPointer())("Threads", threads);
 	m_p.GenerateRandom(rng, primeParam);
 	m_q.GenerateRandom(rng, primeParam);
 
@@ -12,6 +12,8 @@
 #include "salsa.h"
 #include "misc.h"
 #include "sha.h"
+#include "cpu.h"
+#include "parallel.h"
 
 #include <sstream>
 #include <limits>
@@ -20,6 +22,11 @@
 # include <omp.h>
 #endif
 
+// Internal compiler error in GCC 3.3 and below
+#if defined(__GNUC__) && (__GNUC__ < 4)
+# undef CRYPTOPP_SSE2_INTRIN_AVAILABLE
+#endif
+
 // https://github.com/weidai11/cryptopp/issues/777
 #if CRYPTOPP_GCC_DIAGNOSTIC_AVAILABLE
 # if defined(__clang__)
@@ -29,6 +36,14 @@
 # endif
 #endif
 
+NAMESPACE_BEGIN(CryptoPP)
+
+#if (CRYPTOPP_SSE2_INTRIN_AVAILABLE)
+extern void Scrypt_Smix_SSE2(byte* B, size_t r, word64 N, byte* V, byte* XY);
+#endif
+
+NAMESPACE_END
+
 ANONYMOUS_NAMESPACE_BEGIN
 
 using CryptoPP::byte;
@@ -171,6 +186,41 @@ inline void Smix(byte* B, size_t r, word64 N, byte* V, byte* XY)
     BlockCopy(B, X, 128 * r);
 }
 
+// 3: B_i <-- MF(B_i, N)
+inline void SmixLane(byte* B, size_t r, word64 N, byte* V, byte* XY, word64 i)
+{
+    byte* Bi = B + static_cast<ptrdiff_t>(r*i*128);
+
+#if (CRYPTOPP_SSE2_INTRIN_AVAILABLE)
+    if (CryptoPP::HasSSE2())
+        return CryptoPP::Scrypt_Smix_SSE2(Bi, r, N, V, XY);
+#endif
+
+    Smix(Bi, r, N, V, XY);
+}
+
+// Worker w of n processes lanes w, w+n, w+2n ... of the p lanes
+// with its own copy of the scratch space
+class SmixTask : public CryptoPP::ParallelTask
+{
+public:
+    SmixTask(byte* B, size_t r, word64 N, word64 p, std::vector<AlignedSecByteBlock>& V,
+        std::vector<AlignedSecByteBlock>& XY) : m_B(B), m_r(r), m_N(N), m_p(p), m_V(V), m_XY(XY) {}
+
+    void Run(size_t w)
+    {
+        for (word64 i = w; i < m_p; i += m_V.size())
+            SmixLane(m_B, m_r, m_N, m_V[w], m_XY[w], i);
+    }
+
+private:
+    byte* m_B;
+    size_t m_r;
+    word64 m_N, m_p;
+    std::vector<AlignedSecByteBlock>& m_V;
+    std::vector<AlignedSecByteBlock>& m_XY;
+};
+
 ANONYMOUS_NAMESPACE_END
 
 NAMESPACE_BEGIN(CryptoPP)
@@ -276,11 +326,23 @@ size_t Scrypt::DeriveKey(byte*derived, size_t derivedLen,
     ConstByteArrayParameter salt;
     (void)params.GetValue("Salt", salt);
 
-    return DeriveKey(derived, derivedLen, secret, secretLen, salt.begin(), salt.size(), cost, blockSize, parallelization);
+    int threads = 0;
+    (void)params.GetValue("Threads", threads);
+
+    return DeriveKey(derived, derivedLen, secret, secretLen, salt.begin(), salt.size(),
+        cost, blockSize, parallelization, static_cast<unsigned int>(STDMAX(threads, 0)));
 }
 
 size_t Scrypt::DeriveKey(byte*derived, size_t derivedLen, const byte*secret, size_t secretLen,
     const byte*salt, size_t saltLen, word64 cost, word64 blockSize, word64 parallel) const
+{
+    return DeriveKey(derived, derivedLen, secret, secretLen, salt, saltLen,
+        cost, blockSize, parallel, 0);
+}
+
+size_t Scrypt::DeriveKey(byte*derived, size_t derivedLen, const byte*secret, size_t secretLen,
+    const byte*salt, size_t saltLen, word64 cost, word64 blockSize, word64 parallel,
+    unsigned int threads) const
 {
     CRYPTOPP_ASSERT(secret /*&& secretLen*/);
     CRYPTOPP_ASSERT(derived && derivedLen);
@@ -294,32 +356,26 @@ size_t Scrypt::DeriveKey(byte*derived, size_t derivedLen, const byte*secret, siz
     // 1: (B_0 ... B_{p-1}) <-- PBKDF2(P, S, 1, p * MFLen)
     PBKDF2_SHA256(B, B.size(), secret, secretLen, salt, saltLen, 1);
 
-    // Visual Studio and OpenMP 2.0 fixup. We must use int, not size_t.
-    int maxParallel=0;
-    if (!SafeConvert(parallel, maxParallel))
-        maxParallel = std::numeric_limits<int>::max();
+    const size_t r = static_cast<size_t>(blockSize);
 
-    #ifdef _OPENMP
-    int threads = STDMIN(omp_get_max_threads(), maxParallel);
-    #endif
+    if (threads == 0)
+        threads = DefaultThreadCount();
+    const size_t workers = static_cast<size_t>(STDMIN(static_cast<word64>(threads), parallel));
 
-    // http://stackoverflow.com/q/49604260/608639
-    #pragma omp parallel num_threads(threads)
+    // Each worker gets its own copy. The scratch space is allocated
+    // here so an exception is thrown in the calling thread.
+    std::vector<AlignedSecByteBlock> XY(workers);
+    std::vector<AlignedSecByteBlock>  V(workers);
+    for (size_t w = 0; w < workers; ++w)
     {
-        // Each thread gets its own copy
-        AlignedSecByteBlock XY(static_cast<size_t>(blockSize * 256U));
-        AlignedSecByteBlock  V(static_cast<size_t>(blockSize * cost * 128U));
-
-        // 2: for i = 0 to p - 1 do
-        #pragma omp for
-        for (int i = 0; i < maxParallel; ++i)
-        {
-            // 3: B_i <-- MF(B_i, N)
-            const ptrdiff_t offset = static_cast<ptrdiff_t>(blockSize*i*128);
-            Smix(B+offset, static_cast<size_t>(blockSize), cost, V, XY);
-        }
+        XY[w].New(static_cast<size_t>(blockSize * 256U));
+         V[w].New(static_cast<size_t>(blockSize * cost * 128U));
     }
 
+    // 2: for i = 0 to p - 1 do
+    SmixTask task(B, r, cost, parallel, V, XY);
+    RunParallelTasks(task, workers);
+
     // 5: DK <-- PBKDF2(P, B, 1, dkLen)
     PBKDF2_SHA256(derived, derivedLen, secret, secretLen, B, B.size(), 1);
 
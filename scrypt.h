@@ -19,8 +19,11 @@
 NAMESPACE_BEGIN(CryptoPP)
 
 /// \brief Scrypt key derivation function
-/// \details The Crypto++ implementation uses OpenMP to accelerate the derivation when
-///   available.
+/// \details The Crypto++ implementation runs the <tt>parallelization</tt> lanes with
+///   RunParallelTasks(), which uses OpenMP when available and a pool of <tt>std::thread</tt>
+///   workers otherwise. The lanes are run sequentially when neither is available. The
+///   number of threads can be limited using the <tt>Threads</tt> parameter of the
+///   NameValuePairs overload of DeriveKey().
 /// \details The Crypto++ implementation of Scrypt is limited by C++ datatypes. For
 ///   example, the library is limited to a derived key length of <tt>SIZE_MAX</tt>,
 ///   and not <tt>(2^32 - 1) * 32</tt>.
@@ -52,7 +55,20 @@ public:
     // KeyDerivationFunction interface
     size_t GetValidDerivedLength(size_t keylength) const;
 
-    // KeyDerivationFunction interface
+    /// \brief Derive a key from a seed
+    /// \param derived the derived output buffer
+    /// \param derivedLen the size of the derived buffer, in bytes
+    /// \param secret the seed input buffer
+    /// \param secretLen the size of the secret buffer, in bytes
+    /// \param params additional initialization parameters to configure the object
+    /// \returns the number of iterations performed
+    /// \details The parameters <tt>Cost</tt>, <tt>BlockSize</tt> and <tt>Parallelization</tt>
+    ///   are <tt>word64</tt> and <tt>Salt</tt> is a ConstByteArrayParameter.
+    /// \details The optional <tt>Threads</tt> parameter is an <tt>int</tt> that limits the
+    ///   number of threads used for the <tt>parallelization</tt> lanes. The default value
+    ///   of 0 uses one thread per hardware thread. The derived key does not depend on
+    ///   <tt>Threads</tt>. The <tt>Threads</tt> parameter is available in Crypto++ 8.3
+    ///   and above.
     size_t DeriveKey(byte *derived, size_t derivedLen, const byte *secret, size_t secretLen,
         const NameValuePairs& params) const;
 
@@ -96,6 +112,11 @@ protected:
     }
 
     inline void ValidateParameters(size_t derivedlen, word64 cost, word64 blockSize, word64 parallelization) const;
+
+    // Threads of 0 means one thread per hardware thread
+    size_t DeriveKey(byte *derived, size_t derivedLen, const byte *secret, size_t secretLen,
+        const byte *salt, size_t saltLen, word64 cost, word64 blockSize, word64 parallelization,
+        unsigned int threads) const;
 };
 
 NAMESPACE_END
@@ -0,0 +1,182 @@
+// scrypt_simd.cpp - written and placed in the public domain by
+//                   the Crypto++ project.
+//
+//    This source file uses intrinsics and built-ins to gain access to
+//    SSE2 instructions. A separate source file is needed because
+//    additional CXXFLAGS are required to enable the appropriate
+//    instructions sets in some build configurations.
+//
+//    The code is based on Colin Percival's crypto_scrypt-sse.c. Each
+//    64-byte block is permuted so the four Salsa20 columns occupy the
+//    lanes of four XMM registers, and the permutation is kept for the
+//    whole of SMix. The caller in scrypt.cpp schedules the lanes.
+
+#include "pch.h"
+#include "config.h"
+#include "misc.h"
+
+// Internal compiler error in GCC 3.3 and below
+#if defined(__GNUC__) && (__GNUC__ < 4)
+# undef CRYPTOPP_SSE2_INTRIN_AVAILABLE
+#endif
+
+#if (CRYPTOPP_SSE2_INTRIN_AVAILABLE)
+# include <xmmintrin.h>
+# include <emmintrin.h>
+#endif
+
+// Squash MS LNK4221 and libtool warnings
+extern const char SCRYPT_SIMD_FNAME[] = __FILE__;
+
+// Clang intrinsic casts, http://bugs.llvm.org/show_bug.cgi?id=20670
+#define M128_CAST(x) ((__m128i *)(void *)(x))
+#define CONST_M128_CAST(x) ((const __m128i *)(const void *)(x))
+
+NAMESPACE_BEGIN(CryptoPP)
+
+#if (CRYPTOPP_SSE2_INTRIN_AVAILABLE)
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+template <unsigned int R>
+inline __m128i RotateLeft(const __m128i val)
+{
+    return _mm_or_si128(_mm_slli_epi32(val, R), _mm_srli_epi32(val, 32-R));
+}
+
+// Salsa20/8 on a block in diagonal order. X0 holds words {0,5,10,15},
+// X1 holds {4,9,14,3}, X2 holds {8,13,2,7} and X3 holds {12,1,6,11}.
+inline void Salsa20_8(__m128i &X0, __m128i &X1, __m128i &X2, __m128i &X3)
+{
+    const __m128i S0 = X0, S1 = X1, S2 = X2, S3 = X3;
+
+    for (unsigned int i = 0; i < 8; i += 2)
+    {
+        // Operate on columns
+        X1 = _mm_xor_si128(X1, RotateLeft< 7>(_mm_add_epi32(X0, X3)));
+        X2 = _mm_xor_si128(X2, RotateLeft< 9>(_mm_add_epi32(X1, X0)));
+        X3 = _mm_xor_si128(X3, RotateLeft<13>(_mm_add_epi32(X2, X1)));
+        X0 = _mm_xor_si128(X0, RotateLeft<18>(_mm_add_epi32(X3, X2)));
+
+        X1 = _mm_shuffle_epi32(X1, _MM_SHUFFLE(2,1,0,3));
+        X2 = _mm_shuffle_epi32(X2, _MM_SHUFFLE(1,0,3,2));
+        X3 = _mm_shuffle_epi32(X3, _MM_SHUFFLE(0,3,2,1));
+
+        // Operate on rows
+        X3 = _mm_xor_si128(X3, RotateLeft< 7>(_mm_add_epi32(X0, X1)));
+        X2 = _mm_xor_si128(X2, RotateLeft< 9>(_mm_add_epi32(X3, X0)));
+        X1 = _mm_xor_si128(X1, RotateLeft<13>(_mm_add_epi32(X2, X3)));
+        X0 = _mm_xor_si128(X0, RotateLeft<18>(_mm_add_epi32(X1, X2)));
+
+        X1 = _mm_shuffle_epi32(X1, _MM_SHUFFLE(0,3,2,1));
+        X2 = _mm_shuffle_epi32(X2, _MM_SHUFFLE(1,0,3,2));
+        X3 = _mm_shuffle_epi32(X3, _MM_SHUFFLE(2,1,0,3));
+    }
+
+    X0 = _mm_add_epi32(X0, S0);
+    X1 = _mm_add_epi32(X1, S1);
+    X2 = _mm_add_epi32(X2, S2);
+    X3 = _mm_add_epi32(X3, S3);
+}
+
+// BlockMix of in, or of (in \xor x) when x is not NULL. The output is
+// written in the final order (Y_0, Y_2 ... Y_{2r-2}, Y_1, Y_3 ... Y_{2r-1}).
+inline void BlockMix(const __m128i *in, const __m128i *x, __m128i *out, size_t r)
+{
+    const size_t last = (2*r-1)*4;
+    __m128i X0 = _mm_loadu_si128(in+last+0);
+    __m128i X1 = _mm_loadu_si128(in+last+1);
+    __m128i X2 = _mm_loadu_si128(in+last+2);
+    __m128i X3 = _mm_loadu_si128(in+last+3);
+
+    if (x != NULLPTR)
+    {
+        X0 = _mm_xor_si128(X0, _mm_loadu_si128(x+last+0));
+        X1 = _mm_xor_si128(X1, _mm_loadu_si128(x+last+1));
+        X2 = _mm_xor_si128(X2, _mm_loadu_si128(x+last+2));
+        X3 = _mm_xor_si128(X3, _mm_loadu_si128(x+last+3));
+    }
+
+    for (size_t i = 0; i < 2*r; ++i)
+    {
+        const size_t src = i*4, dst = ((i&1) ? r+i/2 : i/2)*4;
+
+        X0 = _mm_xor_si128(X0, _mm_loadu_si128(in+src+0));
+        X1 = _mm_xor_si128(X1, _mm_loadu_si128(in+src+1));
+        X2 = _mm_xor_si128(X2, _mm_loadu_si128(in+src+2));
+        X3 = _mm_xor_si128(X3, _mm_loadu_si128(in+src+3));
+
+        if (x != NULLPTR)
+        {
+            X0 = _mm_xor_si128(X0, _mm_loadu_si128(x+src+0));
+            X1 = _mm_xor_si128(X1, _mm_loadu_si128(x+src+1));
+            X2 = _mm_xor_si128(X2, _mm_loadu_si128(x+src+2));
+            X3 = _mm_xor_si128(X3, _mm_loadu_si128(x+src+3));
+        }
+
+        Salsa20_8(X0, X1, X2, X3);
+
+        _mm_storeu_si128(out+dst+0, X0);
+        _mm_storeu_si128(out+dst+1, X1);
+        _mm_storeu_si128(out+dst+2, X2);
+        _mm_storeu_si128(out+dst+3, X3);
+    }
+}
+
+// Words 0 and 1 of the last block are lane 0 of X0 and lane 1 of X3
+inline word64 Integerify(const __m128i *X, size_t r)
+{
+    const __m128i *b = X+(2*r-1)*4;
+    const word32 lo = static_cast<word32>(_mm_cvtsi128_si32(_mm_loadu_si128(b+0)));
+    const word32 hi = static_cast<word32>(_mm_cvtsi128_si32(
+        _mm_shuffle_epi32(_mm_loadu_si128(b+3), _MM_SHUFFLE(3,2,0,1))));
+    return (static_cast<word64>(hi) << 32) | lo;
+}
+
+ANONYMOUS_NAMESPACE_END
+
+void Scrypt_Smix_SSE2(byte* B, size_t r, word64 N, byte* V, byte* XY)
+{
+    const size_t blocks = 2*r, stride = 8*r;
+    __m128i* X = M128_CAST(XY);
+    __m128i* Y = M128_CAST(XY+128*r);
+    __m128i* W = M128_CAST(V);
+
+    // 1: V_0 <-- B, in diagonal order
+    for (size_t k = 0; k < blocks; ++k)
+    {
+        word32 T[16];
+        for (size_t i = 0; i < 16; ++i)
+            T[i] = GetWord<word32>(false, LITTLE_ENDIAN_ORDER, B+(k*16+(i*5)%16)*4);
+        for (size_t i = 0; i < 4; ++i)
+            _mm_storeu_si128(W+k*4+i, _mm_loadu_si128(CONST_M128_CAST(T+i*4)));
+    }
+
+    // 2: for i = 0 to N - 1 do V_i <-- X, X <-- H(X). The
+    //    output of one BlockMix is the input to the next.
+    for (word64 i = 0; i+1 < N; ++i)
+        BlockMix(W+static_cast<size_t>(i)*stride, NULLPTR, W+static_cast<size_t>(i+1)*stride, r);
+    BlockMix(W+static_cast<size_t>(N-1)*stride, NULLPTR, X, r);
+
+    // 6: for i = 0 to N - 1 do X <-- H(X \xor V_j)
+    for (word64 i = 0; i < N; ++i)
+    {
+        const word64 j = Integerify(X, r) & (N - 1);
+        BlockMix(X, W+static_cast<size_t>(j)*stride, Y, r);
+        std::swap(X, Y);
+    }
+
+    // 10: B' <-- X, in natural order
+    for (size_t k = 0; k < blocks; ++k)
+    {
+        word32 T[16];
+        for (size_t i = 0; i < 4; ++i)
+            _mm_storeu_si128(M128_CAST(T+i*4), _mm_loadu_si128(X+k*4+i));
+        for (size_t i = 0; i < 16; ++i)
+            PutWord(false, LITTLE_ENDIAN_ORDER, B+(k*16+(i*5)%16)*4, T[i]);
+    }
+}
+
+#endif  // CRYPTOPP_SSE2_INTRIN_AVAILABLE
+
+NAMESPACE_END
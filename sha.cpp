@@ -61,6 +61,16 @@
 
 NAMESPACE_BEGIN(CryptoPP)
 
+#if CRYPTOPP_AVX2_AVAILABLE
+extern void SHA1_HashMultiBuffer_AVX2(word32 *state, const byte *const data[8]);
+extern void SHA256_HashMultiBuffer_AVX2(word32 *state, const byte *const data[8]);
+#endif
+
+#if CRYPTOPP_AVX512_AVAILABLE
+extern void SHA1_HashMultiBuffer_AVX512(word32 *state, const byte *const data[16]);
+extern void SHA256_HashMultiBuffer_AVX512(word32 *state, const byte *const data[16]);
+#endif
+
 #if CRYPTOPP_SHANI_AVAILABLE
 extern void SHA1_HashMultipleBlocks_SHANI(word32 *state, const word32 *data, size_t length, ByteOrder order);
 extern void SHA256_HashMultipleBlocks_SHANI(word32 *state, const word32 *data, size_t length, ByteOrder order);
@@ -1032,6 +1042,191 @@ size_t SHA224::HashMultipleBlocks(const word32 *input, size_t length)
 
 // *************************************************************
 
+ANONYMOUS_NAMESPACE_BEGIN
+
+// Hash the messages one at a time. Used when there are too few
+// messages to fill the lanes of the multi-buffer code.
+template <class H>
+void CalculateDigests_Serial(byte *digests, const byte *const *messages, const size_t *lengths, size_t count)
+{
+    H hash;
+    for (size_t i=0; i<count; i++)
+        hash.CalculateDigest(digests+i*H::DIGESTSIZE, messages[i], lengths[i]);
+}
+
+#if CRYPTOPP_AVX2_AVAILABLE || CRYPTOPP_AVX512_AVAILABLE
+
+// Per-lane bookkeeping for the multi-buffer code. A lane hashes the
+// whole blocks of the message in place, and then one or two blocks of
+// padding from the tail buffer.
+struct MultiBufferLane
+{
+    const byte *data;
+    size_t whole, blocks, message;
+    byte tail[128];
+};
+
+inline void MultiBufferAdvance(MultiBufferLane &lane, size_t blockSize)
+{
+    if (lane.whole)
+        lane.data = --lane.whole ? lane.data+blockSize : lane.tail;
+    else
+        lane.data += blockSize;
+    lane.blocks--;
+}
+
+// Schedule the messages across the lanes of the multi-buffer kernel.
+// The state is transposed, so word i of lane j is state[i*LANES+j].
+// Idle lanes hash a dummy block. Once the last message has been handed
+// out and fewer than half the lanes remain busy, the stragglers are
+// finished one block at a time with H::Transform.
+template <class H, unsigned int LANES, class F>
+void CalculateDigests_MultiBuffer(F func, byte *digests, const byte *const *messages, const size_t *lengths, size_t count)
+{
+    const unsigned int WORDS = H::DIGESTSIZE/4, BLOCKSIZE = H::BLOCKSIZE;
+
+    FixedSizeAlignedSecBlock<word32, 8*LANES> state;
+    FixedSizeSecBlock<MultiBufferLane, LANES> lanes;
+    CRYPTOPP_ALIGN_DATA(16) word32 temp[16];
+    CRYPTOPP_ALIGN_DATA(16) static const byte dummy[BLOCKSIZE] = {0};
+    const byte *data[LANES];
+
+    size_t next = 0;
+    unsigned int active = 0;
+    for (unsigned int j=0; j<LANES; j++)
+        lanes[j].blocks = 0;
+
+    while (true)
+    {
+        // Hand out new messages to idle lanes
+        for (unsigned int j=0; j<LANES && next<count; j++)
+        {
+            MultiBufferLane &lane = lanes[j];
+            if (lane.blocks)
+                continue;
+
+            const size_t length = lengths[next], rem = length % BLOCKSIZE;
+            const size_t pad = (rem + 9 <= BLOCKSIZE) ? 1 : 2;
+            std::memset(lane.tail, 0, sizeof(lane.tail));
+            if (rem)
+                std::memcpy(lane.tail, messages[next]+length-rem, rem);
+            lane.tail[rem] = 0x80;
+            PutWord(false, BIG_ENDIAN_ORDER, lane.tail+pad*BLOCKSIZE-8, static_cast<word64>(length) << 3);
+
+            lane.whole = length / BLOCKSIZE;
+            lane.data = lane.whole ? messages[next] : lane.tail;
+            lane.blocks = lane.whole + pad;
+            lane.message = next++;
+
+            H::InitState(temp);
+            for (unsigned int i=0; i<WORDS; i++)
+                state[i*LANES+j] = temp[i];
+            active++;
+        }
+
+        if (active == 0)
+            break;
+
+        if (next == count && active < LANES/2)
+        {
+            for (unsigned int j=0; j<LANES; j++)
+            {
+                MultiBufferLane &lane = lanes[j];
+                if (!lane.blocks)
+                    continue;
+
+                CRYPTOPP_ALIGN_DATA(16) word32 st[8];
+                for (unsigned int i=0; i<WORDS; i++)
+                    st[i] = state[i*LANES+j];
+                while (lane.blocks)
+                {
+                    std::memcpy(temp, lane.data, BLOCKSIZE);
+                    ConditionalByteReverse(BIG_ENDIAN_ORDER, temp, temp, BLOCKSIZE);
+                    H::Transform(st, temp);
+                    MultiBufferAdvance(lane, BLOCKSIZE);
+                }
+                for (unsigned int i=0; i<WORDS; i++)
+                    PutWord(false, BIG_ENDIAN_ORDER, digests+lane.message*H::DIGESTSIZE+i*4, st[i]);
+            }
+            break;
+        }
+
+        for (unsigned int j=0; j<LANES; j++)
+            data[j] = lanes[j].blocks ? lanes[j].data : dummy;
+
+        func(state, data);
+
+        for (unsigned int j=0; j<LANES; j++)
+        {
+            MultiBufferLane &lane = lanes[j];
+            if (!lane.blocks)
+                continue;
+
+            MultiBufferAdvance(lane, BLOCKSIZE);
+            if (lane.blocks)
+                continue;
+
+            for (unsigned int i=0; i<WORDS; i++)
+                PutWord(false, BIG_ENDIAN_ORDER, digests+lane.message*H::DIGESTSIZE+i*4, state[i*LANES+j]);
+            active--;
+        }
+    }
+}
+
+#endif  // CRYPTOPP_AVX2_AVAILABLE || CRYPTOPP_AVX512_AVAILABLE
+
+ANONYMOUS_NAMESPACE_END
+
+void SHA1::CalculateDigests(byte *digests, const byte *const *messages, const size_t *lengths, size_t count)
+{
+    CRYPTOPP_ASSERT(digests || count == 0);
+    CRYPTOPP_ASSERT(messages || count == 0);
+    CRYPTOPP_ASSERT(lengths || count == 0);
+
+#if CRYPTOPP_AVX512_AVAILABLE
+    if (HasAVX512F() && HasAVX512BW() && HasAVX512VL() && count >= 8)
+    {
+        CalculateDigests_MultiBuffer<SHA1, 16>(SHA1_HashMultiBuffer_AVX512, digests, messages, lengths, count);
+        return;
+    }
+#endif
+#if CRYPTOPP_AVX2_AVAILABLE
+    if (HasAVX2() && count >= 4)
+    {
+        CalculateDigests_MultiBuffer<SHA1, 8>(SHA1_HashMultiBuffer_AVX2, digests, messages, lengths, count);
+        return;
+    }
+#endif
+
+    CalculateDigests_Serial<SHA1>(digests, messages, lengths, count);
+}
+
+void SHA256::CalculateDigests(byte *digests, const byte *const *messages, const size_t *lengths, size_t count)
+{
+    CRYPTOPP_ASSERT(digests || count == 0);
+    CRYPTOPP_ASSERT(messages || count == 0);
+    CRYPTOPP_ASSERT(lengths || count == 0);
+
+#if CRYPTOPP_AVX512_AVAILABLE
+    if (HasAVX512F() && HasAVX512BW() && HasAVX512VL() && count >= 8)
+    {
+        CalculateDigests_MultiBuffer<SHA256, 16>(SHA256_HashMultiBuffer_AVX512, digests, messages, lengths, count);
+        return;
+    }
+#endif
+#if CRYPTOPP_AVX2_AVAILABLE
+    if (HasAVX2() && count >= 4)
+    {
+        CalculateDigests_MultiBuffer<SHA256, 8>(SHA256_HashMultiBuffer_AVX2, digests, messages, lengths, count);
+        return;
+    }
+#endif
+
+    CalculateDigests_Serial<SHA256>(digests, messages, lengths, count);
+}
+
+// *************************************************************
+
 std::string SHA512_AlgorithmProvider()
 {
 #if CRYPTOPP_SSE2_ASM_AVAILABLE
@@ -47,6 +47,20 @@ public:
 	///   with the user supplied state.
 	/// \note On Intel platforms the state array and data must be 16-byte aligned for SSE2.
 	static void CRYPTOPP_API Transform(HashWordType *digest, const HashWordType *data);
+	/// \brief Hash many independent messages
+	/// \param digests the output buffer for the digests
+	/// \param messages an array of pointers to the messages
+	/// \param lengths an array of the message lengths, in bytes
+	/// \param count the number of messages
+	/// \details CalculateDigests computes the SHA-1 digest of each message and
+	///   writes it to <tt>digests + i*DIGESTSIZE</tt>. <tt>digests</tt> must be at least
+	///   <tt>count*20</tt> bytes.
+	/// \details On x86 and x64 the messages are hashed in parallel using multi-buffer
+	///   AVX2 (8 lanes) or AVX-512 (16 lanes) code. When there are too few messages
+	///   to fill half the lanes the messages are hashed one at a time, which uses
+	///   Intel SHA extensions if available.
+	/// \since Crypto++ 8.3
+	static void CRYPTOPP_API CalculateDigests(byte *digests, const byte *const *messages, const size_t *lengths, size_t count);
 	/// \brief The algorithm name
 	/// \returns C-style string "SHA-1"
 	CRYPTOPP_STATIC_CONSTEXPR const char* CRYPTOPP_API StaticAlgorithmName() {return "SHA-1";}
@@ -85,6 +99,20 @@ public:
 	///   with the user supplied state.
 	/// \note On Intel platforms the state array and data must be 16-byte aligned for SSE2.
 	static void CRYPTOPP_API Transform(HashWordType *digest, const HashWordType *data);
+	/// \brief Hash many independent messages
+	/// \param digests the output buffer for the digests
+	/// \param messages an array of pointers to the messages
+	/// \param lengths an array of the message lengths, in bytes
+	/// \param count the number of messages
+	/// \details CalculateDigests computes the SHA-256 digest of each message and
+	///   writes it to <tt>digests + i*DIGESTSIZE</tt>. <tt>digests</tt> must be at least
+	///   <tt>count*32</tt> bytes.
+	/// \details On x86 and x64 the messages are hashed in parallel using multi-buffer
+	///   AVX2 (8 lanes) or AVX-512 (16 lanes) code. When there are too few messages
+	///   to fill half the lanes the messages are hashed one at a time, which uses
+	///   Intel SHA extensions if available.
+	/// \since Crypto++ 8.3
+	static void CRYPTOPP_API CalculateDigests(byte *digests, const byte *const *messages, const size_t *lengths, size_t count);
 	/// \brief The algorithm name
 	/// \returns C-style string "SHA-256"
 	CRYPTOPP_STATIC_CONSTEXPR const char* CRYPTOPP_API StaticAlgorithmName() {return "SHA-256";}
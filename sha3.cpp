@@ -24,6 +24,9 @@ NAMESPACE_BEGIN(CryptoPP)
 
 // The Keccak core function
 extern void KeccakF1600(word64 *state);
+// Sponges over many independent messages
+extern void KeccakSpongeMany(unsigned int rate, unsigned int rounds, byte pad,
+    byte *outputs, size_t outputLength, const byte *const *messages, const size_t *lengths, size_t count);
 
 NAMESPACE_END
 
@@ -68,4 +71,10 @@ void SHA3::TruncatedFinal(byte *hash, size_t size)
     Restart();
 }
 
+void SHA3::CalculateDigests(unsigned int rate, unsigned int digestSize,
+    byte *digests, const byte *const *messages, const size_t *lengths, size_t count)
+{
+    KeccakSpongeMany(rate, 24, 0x06, digests, digestSize, messages, lengths, count);
+}
+
 NAMESPACE_END
@@ -49,6 +49,11 @@ public:
 protected:
     inline unsigned int r() const {return BlockSize();}
 
+    // Hashes the messages with the given rate and digest size.
+    // See SHA3_Final::CalculateDigests.
+    static void CRYPTOPP_API CalculateDigests(unsigned int rate, unsigned int digestSize,
+        byte *digests, const byte *const *messages, const size_t *lengths, size_t count);
+
     FixedSizeSecBlock<word64, 25> m_state;
     unsigned int m_digestSize, m_counter;
 };
@@ -68,6 +73,21 @@ public:
     /// \brief Construct a SHA3-X message digest
     SHA3_Final() : SHA3(DIGESTSIZE) {}
 
+    /// \brief Compute the digests of many messages
+    /// \param digests the output buffer for the digests
+    /// \param messages an array of pointers to the messages
+    /// \param lengths an array of the message lengths, in bytes
+    /// \param count the number of messages
+    /// \details CalculateDigests computes the digest of each message and writes
+    ///   it to <tt>digests + i*DIGESTSIZE</tt>. <tt>digests</tt> must be at least
+    ///   <tt>count*DIGESTSIZE</tt> bytes.
+    /// \details On x86 and x64 the messages are hashed in parallel using 4 (AVX2)
+    ///   or 8 (AVX-512) interleaved Keccak states. The interleaving pays off for
+    ///   many short messages, where a single state would wait on each permutation.
+    /// \since Crypto++ 8.3
+    static void CRYPTOPP_API CalculateDigests(byte *digests, const byte *const *messages, const size_t *lengths, size_t count)
+        { SHA3::CalculateDigests(BLOCKSIZE, DIGESTSIZE, digests, messages, lengths, count); }
+
     /// \brief Provides the block size of the compression function
     /// \return block size of the compression function, in bytes
     /// \details BlockSize() will return 0 if the hash is not block based
@@ -0,0 +1,188 @@
+// sha_avx.cpp - written and placed in the public domain by
+//               the Crypto++ project.
+//
+//    This source file uses intrinsics and built-ins to gain access to
+//    AVX2 instructions. A separate source file is needed because
+//    additional CXXFLAGS are required to enable the appropriate
+//    instructions sets in some build configurations.
+//
+//    The code hashes 8 independent messages at a time, one message per
+//    32-bit lane of a YMM register. It is the multi-buffer technique
+//    described by Guilford, Yap and Gopal in "Fast SHA-256 Implementations
+//    on Intel Architecture Processors". The caller in sha.cpp schedules
+//    the messages and the padding. Also see sha_avx512.cpp for 16 lanes.
+
+#include "pch.h"
+#include "config.h"
+#include "misc.h"
+
+#if (CRYPTOPP_AVX2_AVAILABLE)
+# include <emmintrin.h>
+# include <immintrin.h>
+#endif
+
+// Squash MS LNK4221 and libtool warnings
+extern const char SHA_AVX_FNAME[] = __FILE__;
+
+// Clang intrinsic casts, http://bugs.llvm.org/show_bug.cgi?id=20670
+#define M256_CAST(x) ((__m256i *)(void *)(x))
+#define CONST_M256_CAST(x) ((const __m256i *)(const void *)(x))
+
+NAMESPACE_BEGIN(CryptoPP)
+
+#if (CRYPTOPP_AVX2_AVAILABLE)
+
+extern const word32 SHA256_K[64];
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+template <unsigned int R>
+inline __m256i RotateLeft(const __m256i val)
+{
+    return _mm256_or_si256(_mm256_slli_epi32(val, R), _mm256_srli_epi32(val, 32-R));
+}
+
+template <unsigned int R>
+inline __m256i RotateRight(const __m256i val)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(val, R), _mm256_slli_epi32(val, 32-R));
+}
+
+inline __m256i Xor3(const __m256i a, const __m256i b, const __m256i c)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(a, b), c);
+}
+
+inline __m256i Add3(const __m256i a, const __m256i b, const __m256i c)
+{
+    return _mm256_add_epi32(_mm256_add_epi32(a, b), c);
+}
+
+// Load 32 bytes from each lane and transpose so W[i] holds
+// big-endian word i of all 8 lanes.
+inline void LoadMessage8(__m256i W[8], const byte *const data[8], size_t offset)
+{
+    const __m256i mask = _mm256_set_epi8(
+        12,13,14,15, 8,9,10,11, 4,5,6,7, 0,1,2,3,
+        12,13,14,15, 8,9,10,11, 4,5,6,7, 0,1,2,3);
+
+    __m256i r[8], t[8];
+    for (unsigned int i=0; i<8; i++)
+        r[i] = _mm256_shuffle_epi8(_mm256_loadu_si256(CONST_M256_CAST(data[i]+offset)), mask);
+
+    for (unsigned int i=0; i<8; i+=2)
+    {
+        t[i+0] = _mm256_unpacklo_epi32(r[i], r[i+1]);
+        t[i+1] = _mm256_unpackhi_epi32(r[i], r[i+1]);
+    }
+    for (unsigned int i=0; i<8; i+=4)
+    {
+        r[i+0] = _mm256_unpacklo_epi64(t[i+0], t[i+2]);
+        r[i+1] = _mm256_unpackhi_epi64(t[i+0], t[i+2]);
+        r[i+2] = _mm256_unpacklo_epi64(t[i+1], t[i+3]);
+        r[i+3] = _mm256_unpackhi_epi64(t[i+1], t[i+3]);
+    }
+    for (unsigned int i=0; i<4; i++)
+    {
+        W[i+0] = _mm256_permute2x128_si256(r[i], r[i+4], 0x20);
+        W[i+4] = _mm256_permute2x128_si256(r[i], r[i+4], 0x31);
+    }
+}
+
+ANONYMOUS_NAMESPACE_END
+
+void SHA1_HashMultiBuffer_AVX2(word32 *state, const byte *const data[8])
+{
+    __m256i W[16];
+    LoadMessage8(W+0, data, 0);
+    LoadMessage8(W+8, data, 32);
+
+    __m256i A = _mm256_loadu_si256(CONST_M256_CAST(state+ 0));
+    __m256i B = _mm256_loadu_si256(CONST_M256_CAST(state+ 8));
+    __m256i C = _mm256_loadu_si256(CONST_M256_CAST(state+16));
+    __m256i D = _mm256_loadu_si256(CONST_M256_CAST(state+24));
+    __m256i E = _mm256_loadu_si256(CONST_M256_CAST(state+32));
+    const __m256i A0 = A, B0 = B, C0 = C, D0 = D, E0 = E;
+
+    for (unsigned int i=0; i<80; i++)
+    {
+        if (i >= 16)
+        {
+            W[i&15] = RotateLeft<1>(_mm256_xor_si256(
+                Xor3(W[(i-3)&15], W[(i-8)&15], W[(i-14)&15]), W[i&15]));
+        }
+
+        __m256i f, k;
+        if (i < 20)
+        {
+            f = _mm256_xor_si256(_mm256_and_si256(B, C), _mm256_andnot_si256(B, D));
+            k = _mm256_set1_epi32(0x5A827999);
+        }
+        else if (i < 40)
+        {
+            f = Xor3(B, C, D);
+            k = _mm256_set1_epi32(0x6ED9EBA1);
+        }
+        else if (i < 60)
+        {
+            f = _mm256_or_si256(_mm256_and_si256(B, C), _mm256_and_si256(D, _mm256_or_si256(B, C)));
+            k = _mm256_set1_epi32(static_cast<int>(0x8F1BBCDC));
+        }
+        else
+        {
+            f = Xor3(B, C, D);
+            k = _mm256_set1_epi32(static_cast<int>(0xCA62C1D6));
+        }
+
+        const __m256i T = _mm256_add_epi32(Add3(RotateLeft<5>(A), f, E), _mm256_add_epi32(k, W[i&15]));
+        E = D; D = C; C = RotateLeft<30>(B); B = A; A = T;
+    }
+
+    _mm256_storeu_si256(M256_CAST(state+ 0), _mm256_add_epi32(A, A0));
+    _mm256_storeu_si256(M256_CAST(state+ 8), _mm256_add_epi32(B, B0));
+    _mm256_storeu_si256(M256_CAST(state+16), _mm256_add_epi32(C, C0));
+    _mm256_storeu_si256(M256_CAST(state+24), _mm256_add_epi32(D, D0));
+    _mm256_storeu_si256(M256_CAST(state+32), _mm256_add_epi32(E, E0));
+}
+
+void SHA256_HashMultiBuffer_AVX2(word32 *state, const byte *const data[8])
+{
+    __m256i W[16];
+    LoadMessage8(W+0, data, 0);
+    LoadMessage8(W+8, data, 32);
+
+    __m256i S[8], T[8];
+    for (unsigned int i=0; i<8; i++)
+        S[i] = T[i] = _mm256_loadu_si256(CONST_M256_CAST(state+i*8));
+
+    for (unsigned int i=0; i<64; i++)
+    {
+        if (i >= 16)
+        {
+            const __m256i w15 = W[(i-15)&15], w2 = W[(i-2)&15];
+            const __m256i s0 = Xor3(RotateRight<7>(w15), RotateRight<18>(w15), _mm256_srli_epi32(w15, 3));
+            const __m256i s1 = Xor3(RotateRight<17>(w2), RotateRight<19>(w2), _mm256_srli_epi32(w2, 10));
+            W[i&15] = _mm256_add_epi32(Add3(W[i&15], s0, W[(i-7)&15]), s1);
+        }
+
+        const __m256i a = T[0], b = T[1], c = T[2], e = T[4], f = T[5], g = T[6];
+        const __m256i S1 = Xor3(RotateRight<6>(e), RotateRight<11>(e), RotateRight<25>(e));
+        const __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        const __m256i t1 = _mm256_add_epi32(Add3(T[7], S1, ch),
+            _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(SHA256_K[i])), W[i&15]));
+        const __m256i S0 = Xor3(RotateRight<2>(a), RotateRight<13>(a), RotateRight<22>(a));
+        const __m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+
+        T[7] = g; T[6] = f; T[5] = e;
+        T[4] = _mm256_add_epi32(T[3], t1);
+        T[3] = c; T[2] = b; T[1] = a;
+        T[0] = Add3(t1, S0, maj);
+    }
+
+    for (unsigned int i=0; i<8; i++)
+        _mm256_storeu_si256(M256_CAST(state+i*8), _mm256_add_epi32(S[i], T[i]));
+}
+
+#endif  // CRYPTOPP_AVX2_AVAILABLE
+
+NAMESPACE_END
@@ -0,0 +1,191 @@
+// sha_avx512.cpp - written and placed in the public domain by
+//                  the Crypto++ project.
+//
+//    This source file uses intrinsics and built-ins to gain access to
+//    AVX-512 instructions. A separate source file is needed because
+//    additional CXXFLAGS are required to enable the appropriate
+//    instructions sets in some build configurations.
+//
+//    The code hashes 16 independent messages at a time, one message per
+//    32-bit lane of a ZMM register. AVX-512 provides rotates and three
+//    input logic operations, so the rounds are shorter than the AVX2
+//    code in sha_avx.cpp. The caller in sha.cpp schedules the messages
+//    and the padding.
+
+#include "pch.h"
+#include "config.h"
+#include "misc.h"
+
+#if (CRYPTOPP_AVX512_AVAILABLE)
+# include <emmintrin.h>
+# include <immintrin.h>
+#endif
+
+// Squash MS LNK4221 and libtool warnings
+extern const char SHA_AVX512_FNAME[] = __FILE__;
+
+// GCC 12 warns the __Y operand in avx512fintrin.h is used
+// uninitialized. It is the self-initialized placeholder of the
+// _mm512_undefined intrinsics and not a variable in this file.
+#if CRYPTOPP_GCC_DIAGNOSTIC_AVAILABLE
+# pragma GCC diagnostic ignored "-Wuninitialized"
+# if (CRYPTOPP_GCC_VERSION >= 40700)
+#  pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+# endif
+#endif
+
+NAMESPACE_BEGIN(CryptoPP)
+
+#if (CRYPTOPP_AVX512_AVAILABLE)
+
+extern const word32 SHA256_K[64];
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+// Ternary logic immediates
+enum {XOR3 = 0x96, CHOOSE = 0xCA, MAJORITY = 0xE8};
+
+// Load 64 bytes from each lane and transpose so W[i] holds
+// big-endian word i of all 16 lanes.
+inline void LoadMessage16(__m512i W[16], const byte *const data[16])
+{
+    const __m512i mask = _mm512_set_epi32(
+        0x0c0d0e0f, 0x08090a0b, 0x04050607, 0x00010203,
+        0x0c0d0e0f, 0x08090a0b, 0x04050607, 0x00010203,
+        0x0c0d0e0f, 0x08090a0b, 0x04050607, 0x00010203,
+        0x0c0d0e0f, 0x08090a0b, 0x04050607, 0x00010203);
+
+    __m512i r[16], t[16];
+    for (unsigned int i=0; i<16; i++)
+        r[i] = _mm512_shuffle_epi8(_mm512_loadu_si512(data[i]), mask);
+
+    for (unsigned int i=0; i<16; i+=2)
+    {
+        t[i+0] = _mm512_unpacklo_epi32(r[i], r[i+1]);
+        t[i+1] = _mm512_unpackhi_epi32(r[i], r[i+1]);
+    }
+    for (unsigned int i=0; i<16; i+=4)
+    {
+        r[i+0] = _mm512_unpacklo_epi64(t[i+0], t[i+2]);
+        r[i+1] = _mm512_unpackhi_epi64(t[i+0], t[i+2]);
+        r[i+2] = _mm512_unpacklo_epi64(t[i+1], t[i+3]);
+        r[i+3] = _mm512_unpackhi_epi64(t[i+1], t[i+3]);
+    }
+
+    // Lane k of r[4*i+j] holds word 4*k+j of messages 4*i..4*i+3.
+    // Transpose the 128-bit lanes to finish.
+    for (unsigned int j=0; j<4; j++)
+    {
+        const __m512i v0 = _mm512_shuffle_i32x4(r[j+0], r[j+4], 0x44);
+        const __m512i v1 = _mm512_shuffle_i32x4(r[j+0], r[j+4], 0xEE);
+        const __m512i v2 = _mm512_shuffle_i32x4(r[j+8], r[j+12], 0x44);
+        const __m512i v3 = _mm512_shuffle_i32x4(r[j+8], r[j+12], 0xEE);
+
+        W[j+ 0] = _mm512_shuffle_i32x4(v0, v2, 0x88);
+        W[j+ 4] = _mm512_shuffle_i32x4(v0, v2, 0xDD);
+        W[j+ 8] = _mm512_shuffle_i32x4(v1, v3, 0x88);
+        W[j+12] = _mm512_shuffle_i32x4(v1, v3, 0xDD);
+    }
+}
+
+ANONYMOUS_NAMESPACE_END
+
+void SHA1_HashMultiBuffer_AVX512(word32 *state, const byte *const data[16])
+{
+    __m512i W[16];
+    LoadMessage16(W, data);
+
+    __m512i A = _mm512_loadu_si512(state+ 0);
+    __m512i B = _mm512_loadu_si512(state+16);
+    __m512i C = _mm512_loadu_si512(state+32);
+    __m512i D = _mm512_loadu_si512(state+48);
+    __m512i E = _mm512_loadu_si512(state+64);
+    const __m512i A0 = A, B0 = B, C0 = C, D0 = D, E0 = E;
+
+    for (unsigned int i=0; i<80; i++)
+    {
+        if (i >= 16)
+        {
+            W[i&15] = _mm512_rol_epi32(_mm512_xor_si512(_mm512_ternarylogic_epi32(
+                W[(i-3)&15], W[(i-8)&15], W[(i-14)&15], XOR3), W[i&15]), 1);
+        }
+
+        __m512i f, k;
+        if (i < 20)
+        {
+            f = _mm512_ternarylogic_epi32(B, C, D, CHOOSE);
+            k = _mm512_set1_epi32(0x5A827999);
+        }
+        else if (i < 40)
+        {
+            f = _mm512_ternarylogic_epi32(B, C, D, XOR3);
+            k = _mm512_set1_epi32(0x6ED9EBA1);
+        }
+        else if (i < 60)
+        {
+            f = _mm512_ternarylogic_epi32(B, C, D, MAJORITY);
+            k = _mm512_set1_epi32(static_cast<int>(0x8F1BBCDC));
+        }
+        else
+        {
+            f = _mm512_ternarylogic_epi32(B, C, D, XOR3);
+            k = _mm512_set1_epi32(static_cast<int>(0xCA62C1D6));
+        }
+
+        const __m512i T = _mm512_add_epi32(_mm512_add_epi32(_mm512_rol_epi32(A, 5), f),
+            _mm512_add_epi32(_mm512_add_epi32(E, k), W[i&15]));
+        E = D; D = C; C = _mm512_rol_epi32(B, 30); B = A; A = T;
+    }
+
+    _mm512_storeu_si512(state+ 0, _mm512_add_epi32(A, A0));
+    _mm512_storeu_si512(state+16, _mm512_add_epi32(B, B0));
+    _mm512_storeu_si512(state+32, _mm512_add_epi32(C, C0));
+    _mm512_storeu_si512(state+48, _mm512_add_epi32(D, D0));
+    _mm512_storeu_si512(state+64, _mm512_add_epi32(E, E0));
+}
+
+void SHA256_HashMultiBuffer_AVX512(word32 *state, const byte *const data[16])
+{
+    __m512i W[16];
+    LoadMessage16(W, data);
+
+    __m512i S[8], T[8];
+    for (unsigned int i=0; i<8; i++)
+        S[i] = T[i] = _mm512_loadu_si512(state+i*16);
+
+    for (unsigned int i=0; i<64; i++)
+    {
+        if (i >= 16)
+        {
+            const __m512i w15 = W[(i-15)&15], w2 = W[(i-2)&15];
+            const __m512i s0 = _mm512_ternarylogic_epi32(_mm512_ror_epi32(w15, 7),
+                _mm512_ror_epi32(w15, 18), _mm512_srli_epi32(w15, 3), XOR3);
+            const __m512i s1 = _mm512_ternarylogic_epi32(_mm512_ror_epi32(w2, 17),
+                _mm512_ror_epi32(w2, 19), _mm512_srli_epi32(w2, 10), XOR3);
+            W[i&15] = _mm512_add_epi32(_mm512_add_epi32(W[i&15], s0),
+                _mm512_add_epi32(W[(i-7)&15], s1));
+        }
+
+        const __m512i a = T[0], b = T[1], c = T[2], e = T[4], f = T[5], g = T[6];
+        const __m512i S1 = _mm512_ternarylogic_epi32(_mm512_ror_epi32(e, 6),
+            _mm512_ror_epi32(e, 11), _mm512_ror_epi32(e, 25), XOR3);
+        const __m512i ch = _mm512_ternarylogic_epi32(e, f, g, CHOOSE);
+        const __m512i t1 = _mm512_add_epi32(_mm512_add_epi32(T[7], S1),
+            _mm512_add_epi32(ch, _mm512_add_epi32(_mm512_set1_epi32(static_cast<int>(SHA256_K[i])), W[i&15])));
+        const __m512i S0 = _mm512_ternarylogic_epi32(_mm512_ror_epi32(a, 2),
+            _mm512_ror_epi32(a, 13), _mm512_ror_epi32(a, 22), XOR3);
+        const __m512i maj = _mm512_ternarylogic_epi32(a, b, c, MAJORITY);
+
+        T[7] = g; T[6] = f; T[5] = e;
+        T[4] = _mm512_add_epi32(T[3], t1);
+        T[3] = c; T[2] = b; T[1] = a;
+        T[0] = _mm512_add_epi32(t1, _mm512_add_epi32(S0, maj));
+    }
+
+    for (unsigned int i=0; i<8; i++)
+        _mm512_storeu_si512(state+i*16, _mm512_add_epi32(S[i], T[i]));
+}
+
+#endif  // CRYPTOPP_AVX512_AVAILABLE
+
+NAMESPACE_END
@@ -24,6 +24,9 @@ NAMESPACE_BEGIN(CryptoPP)
 
 // The Keccak core function
 extern void KeccakF1600(word64 *state);
+// Sponges over many independent messages
+extern void KeccakSpongeMany(unsigned int rate, unsigned int rounds, byte pad,
+    byte *outputs, size_t outputLength, const byte *const *messages, const size_t *lengths, size_t count);
 
 void SHAKE::Update(const byte *input, size_t length)
 {
@@ -82,4 +85,10 @@ void SHAKE::TruncatedFinal(byte *hash, size_t size)
     Restart();
 }
 
+void SHAKE::CalculateDigests(unsigned int rate, byte *digests, size_t digestSize,
+    const byte *const *messages, const size_t *lengths, size_t count)
+{
+    KeccakSpongeMany(rate, 24, 0x1F, digests, digestSize, messages, lengths, count);
+}
+
 NAMESPACE_END
@@ -55,6 +55,11 @@ protected:
     // we are limited in practice to UINT_MAX.
     void ThrowIfInvalidTruncatedSize(size_t size) const;
 
+    // Hashes the messages with the given rate.
+    // See SHAKE_Final::CalculateDigests.
+    static void CRYPTOPP_API CalculateDigests(unsigned int rate, byte *digests, size_t digestSize,
+        const byte *const *messages, const size_t *lengths, size_t count);
+
     FixedSizeSecBlock<word64, 25> m_state;
     unsigned int m_digestSize, m_counter;
 };
@@ -79,6 +84,23 @@ public:
     ///   output size as a parameter to the hash function.
     SHAKE_Final(unsigned int outputSize=DIGESTSIZE) : SHAKE(outputSize) {}
 
+    /// \brief Compute the output of many messages
+    /// \param digests the output buffer for the digests
+    /// \param digestSize the size of each digest, in bytes
+    /// \param messages an array of pointers to the messages
+    /// \param lengths an array of the message lengths, in bytes
+    /// \param count the number of messages
+    /// \details CalculateDigests computes digestSize bytes of output for each
+    ///   message and writes it to <tt>digests + i*digestSize</tt>. <tt>digests</tt>
+    ///   must be at least <tt>count*digestSize</tt> bytes. Any digest size is
+    ///   allowed, so the function also serves bulk XOF expansion of many seeds.
+    /// \details On x86 and x64 the messages are absorbed and squeezed in parallel
+    ///   using 4 (AVX2) or 8 (AVX-512) interleaved Keccak states.
+    /// \since Crypto++ 8.3
+    static void CRYPTOPP_API CalculateDigests(byte *digests, size_t digestSize,
+        const byte *const *messages, const size_t *lengths, size_t count)
+        { SHAKE::CalculateDigests(BLOCKSIZE, digests, digestSize, messages, lengths, count); }
+
     /// \brief Provides the block size of the compression function
     /// \return block size of the compression function, in bytes
     /// \details BlockSize() will return 0 if the hash is not block based
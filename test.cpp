@@ -1030,6 +1030,11 @@ bool Validate(int alg, bool thorough)
 	case 90: result = ValidateHashDRBG(); break;
 	case 91: result = ValidateHmacDRBG(); break;
 	case 92: result = ValidateNaCl(); break;
+	case 93: result = ValidateBLAKE2sp(); break;
+	case 94: result = ValidateBLAKE2bp(); break;
+	case 95: result = ValidateBLAKE3(); break;
+	case 96: result = ValidateKangarooTwelve(); break;
+	case 97: result = ValidateParallelHash(); break;
 
 	case 100: result = ValidateCHAM(); break;
 	case 101: result = ValidateSIMECK(); break;
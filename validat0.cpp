@@ -21,9 +21,21 @@
 #include "gzip.h"
 #include "zlib.h"
 
+#include "aes.h"
+#include "gcm.h"
+#include "sha.h"
+#include "modes.h"
+#include "parallel.h"
+
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <cstdio>
+
+#if defined(CRYPTOPP_UNIX_AVAILABLE)
+# include <fcntl.h>
+# include <unistd.h>
+#endif
 
 // Aggressive stack checking with VS2005 SP1 and above.
 #if (_MSC_FULL_VER >= 140050727)
@@ -147,6 +159,136 @@ bool TestPolynomialMod2()
 }
 #endif
 
+#if defined(CRYPTOPP_EXTENDED_VALIDATION)
+ANONYMOUS_NAMESPACE_BEGIN
+
+// Writes raw deflate blocks with the fixed Huffman codes of RFC 1951,
+// and keeps the data they decode to
+class FixedDeflateWriter
+{
+public:
+    FixedDeflateWriter() : m_buffer(0), m_count(0) {}
+
+    void BeginBlock(bool final)
+    {
+        PutBits(final ? 1 : 0, 1);
+        PutBits(1, 2);
+    }
+
+    void EndBlock()
+    {
+        PutCode(0, 7);
+    }
+
+    void Literal(byte value)
+    {
+        if (value < 144)
+            PutCode(0x30 + value, 8);
+        else
+            PutCode(0x190 + value - 144, 9);
+        m_data += static_cast<char>(value);
+    }
+
+    // Distances past the data are written, but not copied
+    void Match(unsigned int length, unsigned int distance)
+    {
+        unsigned int code = 28;
+        if (length < 258)
+            for (code = 0; code < 27 && LengthStart(code+1) <= length; code++) {}
+
+        const unsigned int symbol = 257 + code;
+        if (symbol < 280)
+            PutCode(symbol - 256, 7);
+        else
+            PutCode(0xC0 + symbol - 280, 8);
+        if (code < 28)
+            PutBits(length - LengthStart(code), LengthExtra(code));
+
+        for (code = 0; code < 29 && DistanceStart(code+1) <= distance; code++) {}
+        PutCode(code, 5);
+        PutBits(distance - DistanceStart(code), DistanceExtra(code));
+
+        for (unsigned int i = 0; distance <= m_data.size() && i < length; i++)
+            m_data += m_data[m_data.size() - distance];
+    }
+
+    // The deflate stream in a zlib wrapper
+    std::string Zlib(unsigned int log2WindowSize)
+    {
+        std::string stream = m_stream;
+        if (m_count)
+            stream += static_cast<char>(m_buffer);
+
+        const byte cmf = static_cast<byte>(8 | ((log2WindowSize - 8) << 4));
+        std::string zlib(1, static_cast<char>(cmf));
+        zlib += static_cast<char>((31 - cmf * 256 % 31) % 31);
+        zlib += stream;
+
+        byte adler[4];
+        Adler32().CalculateDigest(adler, ConstBytePtr(m_data), BytePtrSize(m_data));
+        return zlib.append(reinterpret_cast<const char*>(adler), 4);
+    }
+
+    const std::string & Data() const {return m_data;}
+
+private:
+    static unsigned int LengthExtra(unsigned int code) {return code < 8 ? 0 : code/4 - 1;}
+    static unsigned int LengthStart(unsigned int code)
+        {return code < 8 ? code + 3 : ((4 + (code & 3)) << LengthExtra(code)) + 3;}
+    static unsigned int DistanceExtra(unsigned int code) {return code < 4 ? 0 : code/2 - 1;}
+    static unsigned int DistanceStart(unsigned int code)
+        {return code < 4 ? code + 1 : ((2 + (code & 1)) << DistanceExtra(code)) + 1;}
+
+    void PutBits(word32 value, unsigned int bits)
+    {
+        for (unsigned int i = 0; i < bits; i++)
+        {
+            m_buffer |= ((value >> i) & 1) << m_count;
+            if (++m_count == 8)
+            {
+                m_stream += static_cast<char>(m_buffer);
+                m_buffer = 0;
+                m_count = 0;
+            }
+        }
+    }
+
+    // Huffman codes are packed starting with the most significant bit
+    void PutCode(word32 code, unsigned int bits)
+    {
+        word32 reversed = 0;
+        for (unsigned int i = 0; i < bits; i++)
+            reversed |= ((code >> i) & 1) << (bits - 1 - i);
+        PutBits(reversed, bits);
+    }
+
+    std::string m_stream, m_data;
+    word32 m_buffer;
+    unsigned int m_count;
+};
+
+// Decompresses a zlib stream in one Put, which takes the fast path of
+// the Inflator, or one byte at a time, which keeps it on the slow path
+std::string ZlibDecompress(const std::string &stream, bool bytewise)
+{
+    std::string data;
+    ZlibDecompressor zlib(new StringSink(data));
+    if (bytewise)
+    {
+        for (size_t i = 0; i < stream.size(); i++)
+            zlib.Put(ConstBytePtr(stream)[i]);
+    }
+    else
+    {
+        zlib.Put(ConstBytePtr(stream), BytePtrSize(stream));
+    }
+    zlib.MessageEnd();
+    return data;
+}
+
+ANONYMOUS_NAMESPACE_END
+#endif
+
 #if defined(CRYPTOPP_EXTENDED_VALIDATION)
 bool TestCompressors()
 {
@@ -420,7 +562,247 @@ bool TestCompressors()
 
     // **************************************************************
 
-    return !fail1 && !fail2 && !fail3;
+    // Chunks compressed on several threads
+    bool fail4 = false;
+    try
+    {
+        for (unsigned int i = 0; i<COMP_COUNT; ++i)
+        {
+            std::string src, dest, rec, ref;
+            unsigned int len = GlobalRNG().GenerateWord32(0, 0x3ffff);
+            unsigned int split = GlobalRNG().GenerateWord32(0, len);
+
+            // Compressible data, so the chunks use the preceding window
+            std::string words;
+            RandomNumberSource(GlobalRNG(), 64, true, new HexEncoder(new StringSink(words)));
+            while (src.size() < len)
+                src += words.substr(GlobalRNG().GenerateWord32(0, 100), GlobalRNG().GenerateWord32(3, 27));
+            src.resize(len);
+
+            for (int threads = 2; threads <= 4; threads += 2)
+            {
+                dest.clear();
+                AlgorithmParameters params = MakeParameters("Threads", threads)("ChunkSize", 4096);
+                Gzip gzip(params, new StringSink(dest));
+                gzip.Put(ConstBytePtr(src), split);
+                gzip.Flush(true);
+                gzip.Put(ConstBytePtr(src)+split, len-split);
+                gzip.MessageEnd();
+
+                rec.clear();
+                StringSource(dest, true, new Gunzip(new StringSink(rec)));
+                if (src != rec)
+                    throw Exception(Exception::OTHER_ERROR, "Gzip failed to decompress a parallel stream");
+
+                if (threads == 2)
+                    ref = dest;
+                else if (ref != dest)
+                    throw Exception(Exception::OTHER_ERROR, "Gzip parallel stream depends on the number of threads");
+            }
+        }
+    }
+    catch (const Exception& ex)
+    {
+        std::cout << "FAILED:   " << ex.what() << "\n";
+        fail4 = true;
+    }
+
+    if (!fail4)
+        std::cout << "passed:";
+    else
+        std::cout << "FAILED:";
+    std::cout << "  " << COMP_COUNT << " parallel zips and unzips" << std::endl;
+
+    // **************************************************************
+
+    // Crafted streams for the fast path of the Inflator. Each stream is
+    // decoded in one Put and one byte at a time.
+    bool fail5 = false;
+    try
+    {
+        // A 512 byte window with matches reaching back exactly the window,
+        // and enough output to wrap the ring buffer several times
+        FixedDeflateWriter window;
+        window.BeginBlock(true);
+        for (unsigned int i = 0; i < 512; i++)
+            window.Literal(static_cast<byte>(GlobalRNG().GenerateByte()));
+        for (unsigned int i = 0; i < 24; i++)
+        {
+            window.Match(GlobalRNG().GenerateWord32(3, 258), 512);
+            window.Literal(static_cast<byte>(i));
+            window.Match(3 + i, 512 - i);
+        }
+        window.EndBlock();
+
+        const std::string stream = window.Zlib(9);
+        for (unsigned int bytewise = 0; bytewise < 2; bytewise++)
+        {
+            if (ZlibDecompress(stream, bytewise != 0) != window.Data())
+                throw Exception(Exception::OTHER_ERROR, "Inflate failed at the window boundary");
+        }
+
+        // Round trips with a 512 byte window
+        for (unsigned int i = 0; i < 16; i++)
+        {
+            std::string src, dest, words;
+            RandomNumberSource(GlobalRNG(), 32, true, new HexEncoder(new StringSink(words)));
+            const unsigned int len = GlobalRNG().GenerateWord32(0, 0x3fff);
+            while (src.size() < len)
+                src += words.substr(GlobalRNG().GenerateWord32(0, 60), GlobalRNG().GenerateWord32(3, 4));
+            src.resize(len);
+
+            StringSource(src, true, new ZlibCompressor(new StringSink(dest), 6, 9));
+            for (unsigned int bytewise = 0; bytewise < 2; bytewise++)
+            {
+                if (ZlibDecompress(dest, bytewise != 0) != src)
+                    throw Exception(Exception::OTHER_ERROR, "Inflate failed with a 512 byte window");
+            }
+        }
+
+        // Distances one past the output and one past the window. Both
+        // are followed by enough input for the fast path.
+        for (unsigned int test = 0; test < 2; test++)
+        {
+            FixedDeflateWriter bad;
+            const unsigned int produced = test ? 600 : 100;
+            bad.BeginBlock(true);
+            for (unsigned int i = 0; i < produced; i++)
+                bad.Literal(static_cast<byte>(i));
+            bad.Match(10, test ? 513 : produced+1);
+            for (unsigned int i = 0; i < 40; i++)
+                bad.Literal(static_cast<byte>(i));
+            bad.EndBlock();
+
+            const std::string stream = bad.Zlib(9);
+            for (unsigned int bytewise = 0; bytewise < 2; bytewise++)
+            {
+                bool thrown = false;
+                try {
+                    ZlibDecompress(stream, bytewise != 0);
+                }
+                catch (const Inflator::BadDistanceErr&) {
+                    thrown = true;
+                }
+
+                if (!thrown)
+                    throw Exception(Exception::OTHER_ERROR, "Inflate failed to detect a bad distance");
+            }
+        }
+
+        // The final block ends at every position in the last bytes of the
+        // input, where the fast path hands over to the slow path and
+        // returns its lookahead before the trailer
+        for (unsigned int count = 0; count < 48; count++)
+        {
+            FixedDeflateWriter tail;
+            tail.BeginBlock(false);
+            for (unsigned int i = 0; i < 300; i++)
+                tail.Literal(static_cast<byte>(i % 7 + 'a'));
+            tail.Match(258, 7);
+            tail.EndBlock();
+            tail.BeginBlock(true);
+            for (unsigned int i = 0; i < count; i++)
+                tail.Literal(static_cast<byte>(GlobalRNG().GenerateByte()));
+            if (count % 3 == 1)
+                tail.Match(count + 3, 1);
+            tail.EndBlock();
+
+            const std::string stream = tail.Zlib(15);
+            for (unsigned int bytewise = 0; bytewise < 2; bytewise++)
+            {
+                if (ZlibDecompress(stream, bytewise != 0) != tail.Data())
+                    throw Exception(Exception::OTHER_ERROR, "Inflate failed at the end of the input");
+            }
+        }
+    }
+    catch (const Exception& ex)
+    {
+        std::cout << "FAILED:   " << ex.what() << "\n";
+        fail5 = true;
+    }
+
+    if (!fail5)
+        std::cout << "passed:";
+    else
+        std::cout << "FAILED:";
+    std::cout << "  inflate window boundaries, bad distances and stream ends" << std::endl;
+
+    // **************************************************************
+
+    // Every level and window size, with and without the single probe
+    // matcher, over random data and data with long runs and short
+    // periods. Each stream switches to level 1 part way.
+    bool fail6 = false;
+    try
+    {
+        for (int level = Deflator::MIN_DEFLATE_LEVEL; level <= Deflator::MAX_DEFLATE_LEVEL; level++)
+        {
+            for (int fast = 0; fast < 2; fast++)
+            {
+                for (int log2WindowSize = Deflator::MIN_LOG2_WINDOW_SIZE; log2WindowSize <= Deflator::MAX_LOG2_WINDOW_SIZE; log2WindowSize++)
+                {
+                    for (unsigned int kind = 0; kind < 3; kind++)
+                    {
+                        std::string src, dest, rec;
+                        const unsigned int len = GlobalRNG().GenerateWord32(0, 0x7fff);
+                        if (kind == 0)
+                        {
+                            RandomNumberSource(GlobalRNG(), len, true, new StringSink(src));
+                        }
+                        else
+                        {
+                            // Runs longer than a match, or a period of 1 to 16 bytes
+                            std::string period;
+                            RandomNumberSource(GlobalRNG(), GlobalRNG().GenerateWord32(1, 16), true, new StringSink(period));
+                            while (src.size() < len)
+                            {
+                                if (kind == 1)
+                                    src.append(GlobalRNG().GenerateWord32(1, 1000), period[0]);
+                                else
+                                    src += period;
+                            }
+                            src.resize(len);
+                        }
+
+                        const size_t split = GlobalRNG().GenerateWord32(0, len);
+                        AlgorithmParameters params = MakeParameters("DeflateLevel", level)
+                            ("Log2WindowSize", log2WindowSize)("FastMatch", fast != 0);
+                        Deflator deflator(params, new StringSink(dest));
+                        deflator.Put(ConstBytePtr(src), split);
+                        deflator.SetDeflateLevel(1);
+                        deflator.Put(ConstBytePtr(src)+split, len-split);
+                        deflator.MessageEnd();
+
+                        StringSource(dest, true, new Inflator(new StringSink(rec)));
+                        if (src != rec)
+                            throw Exception(Exception::OTHER_ERROR, "Inflate failed to decompress level " +
+                                IntToString(level) + " with a window of 2^" + IntToString(log2WindowSize) +
+                                (fast ? " and FastMatch" : ""));
+
+                        // Repetitive data must compress when the matcher runs
+                        if (level > 0 && kind != 0 && len >= 0x1000 && dest.size() > len/4)
+                            throw Exception(Exception::OTHER_ERROR, "Deflate failed to compress repetitive data at level " +
+                                IntToString(level) + (fast ? " with FastMatch" : ""));
+                    }
+                }
+            }
+        }
+    }
+    catch (const Exception& ex)
+    {
+        std::cout << "FAILED:   " << ex.what() << "\n";
+        fail6 = true;
+    }
+
+    if (!fail6)
+        std::cout << "passed:";
+    else
+        std::cout << "FAILED:";
+    std::cout << "  deflate levels 0 to 9, FastMatch and window sizes 2^9 to 2^15" << std::endl;
+
+    // **************************************************************
+
+    return !fail1 && !fail2 && !fail3 && !fail4 && !fail5 && !fail6;
 }
 
 bool TestEncryptors()
@@ -1572,5 +1954,520 @@ bool TestStringSink()
 }
 #endif
 
+#if defined(CRYPTOPP_EXTENDED_VALIDATION)
+bool TestMappedFileSource()
+{
+#if defined(CRYPTOPP_MAPPED_FILE_AVAILABLE)
+    std::cout << "\nTesting MappedFileSource...\n\n";
+    bool pass = true;
+
+    try
+    {
+        const std::string filename = DataDir("TestData/descert.dat");
+
+        std::string expected, actual;
+        FileSource(filename.c_str(), true, new StringSink(expected));
+        MappedFileSource(filename.c_str(), true, new StringSink(actual));
+        pass = !expected.empty() && actual == expected;
+
+        // Skip, copy and transfer a range, then retrieve the rest
+        std::string copied, range;
+        StringSink copySink(copied), rangeSink(range);
+        MappedFileStore store(filename.c_str());
+        pass = store.MaxRetrievable() == expected.size() && pass;
+        store.Skip(10);
+        store.CopyTo(copySink, 100);
+        store.TransferTo(rangeSink, 100);
+        pass = copied == expected.substr(10, 100) && range == copied && pass;
+        store.TransferTo(rangeSink);
+        pass = range == expected.substr(10) && pass;
+        pass = store.MaxRetrievable() == 0 && pass;
+    }
+    catch (const Exception&)
+    {
+        pass = false;
+    }
+
+    // A file of several windows. The window size is rounded up to 2 MB,
+    // so a one page window maps the file in three views.
+    const char *filename = "TestMappedFileSource.tmp";
+    try
+    {
+        const size_t windowSize = 2*1024*1024;
+        std::string expected;
+        RandomNumberSource(GlobalRNG(), 2*windowSize+12345, true, new StringSink(expected));
+        StringSource(expected, true, new FileSink(filename));
+
+        std::string actual;
+        MappedFileSource(filename, true, new StringSink(actual), 4096);
+        pass = actual == expected && pass;
+
+        // Ranges at unaligned offsets, some crossing a window boundary
+        MappedFileStore store(filename, 4096);
+        for (unsigned int i = 0; i < 16; i++)
+        {
+            const size_t begin = (i % 2) ? windowSize*(1+i%4/2) - GlobalRNG().GenerateWord32(1, 4096) :
+                GlobalRNG().GenerateWord32(0, static_cast<word32>(expected.size()-1));
+            const size_t length = GlobalRNG().GenerateWord32(1, 8192);
+
+            std::string range;
+            StringSink rangeSink(range);
+            store.CopyRangeTo(rangeSink, begin, length);
+            pass = range == expected.substr(begin, length) && pass;
+        }
+
+        // Skip past a boundary, then transfer odd sized pieces across the next
+        std::string rest;
+        StringSink restSink(rest);
+        const size_t skipped = windowSize - 1000;
+        pass = store.Skip(skipped) == skipped && pass;
+        while (store.MaxRetrievable())
+            store.TransferTo(restSink, 123457);
+        pass = rest == expected.substr(skipped) && pass;
+    }
+    catch (const Exception&)
+    {
+        pass = false;
+    }
+    std::remove(filename);
+
+    if (!pass)
+        std::cout << "FAILED:";
+    else
+        std::cout << "passed:";
+    std::cout << "  mapped file source\n";
+
+    return pass;
+#else
+    return true;
+#endif
+}
+#endif
+
+#if defined(CRYPTOPP_EXTENDED_VALIDATION)
+bool TestByteQueueNodePool()
+{
+    std::cout << "\nTesting ByteQueue node pool...\n\n";
+    bool pass = true;
+
+    for (unsigned int shared = 0; shared < 2; shared++)
+    {
+        ByteQueue queue;
+        queue.SetSharedNodePool(shared != 0);
+
+        std::string expected, actual;
+        for (unsigned int i = 0; i < 64; i++)
+        {
+            std::string message(1000 + i*100, static_cast<char>('a' + i%26));
+            queue.Put(ConstBytePtr(message), BytePtrSize(message));
+            expected += message;
+
+            // Drain most of the queue so its nodes are recycled
+            if (i % 4 == 3)
+            {
+                StringSink sink(actual);
+                queue.TransferTo(sink, queue.MaxRetrievable() - 10);
+            }
+        }
+
+        StringSink sink(actual);
+        queue.TransferAllTo(sink);
+
+        const bool temp = actual == expected && queue.GetNodePoolHits() > 0;
+        pass = temp && pass;
+
+        if (!temp)
+            std::cout << "FAILED:";
+        else
+            std::cout << "passed:";
+        std::cout << "  " << (shared ? "shared" : "queue") << " pool, " << queue.GetNodePoolHits();
+        std::cout << " hits, " << queue.GetNodePoolMisses() << " misses\n";
+    }
+
+    return pass;
+}
+#endif
+
+#if defined(CRYPTOPP_EXTENDED_VALIDATION)
+bool TestVectoredPut()
+{
+    std::cout << "\nTesting vectored Put...\n\n";
+    bool pass = true;
+
+    // Fragments of odd sizes, so cipher blocks straddle fragment boundaries
+    std::string message(2000, '\0');
+    GlobalRNG().GenerateBlock(BytePtr(message), message.size());
+    const size_t sizes[] = {0, 1, 15, 17, 100, 3, 0, 500, 64, 1300};
+
+    ConstByteSpan spans[COUNTOF(sizes)];
+    size_t offset = 0;
+    for (size_t i = 0; i < COUNTOF(sizes); i++)
+    {
+        spans[i].data = ConstBytePtr(message) + offset;
+        spans[i].size = sizes[i];
+        offset += sizes[i];
+    }
+    CRYPTOPP_ASSERT(offset == message.size());
+
+    try
+    {
+        // ByteQueue
+        {
+            ByteQueue queue;
+            queue.PutV(spans, COUNTOF(spans));
+            std::string recovered;
+            StringSink sink(recovered);
+            queue.TransferAllTo(sink);
+
+            const bool temp = recovered == message;
+            pass = temp && pass;
+            std::cout << (temp ? "passed:" : "FAILED:") << "  ByteQueue\n";
+        }
+
+        // HashFilter with the message passed through
+        {
+            SHA256 hash;
+            std::string expected, actual;
+            StringSource(message, true, new HashFilter(hash, new StringSink(expected), true));
+            HashFilter filter(hash, new StringSink(actual), true);
+            filter.PutV(spans, COUNTOF(spans));
+            filter.MessageEnd();
+
+            const bool temp = actual == expected;
+            pass = temp && pass;
+            std::cout << (temp ? "passed:" : "FAILED:") << "  HashFilter\n";
+        }
+
+        // StreamTransformationFilter with padding
+        {
+            const byte key[16] = {0}, iv[16] = {0};
+            CBC_Mode<AES>::Encryption enc(key, sizeof(key), iv);
+            std::string expected, actual;
+            StringSource(message, true, new StreamTransformationFilter(enc, new StringSink(expected)));
+            enc.Resynchronize(iv);
+            StreamTransformationFilter filter(enc, new StringSink(actual));
+            filter.Put2V(spans, COUNTOF(spans), -1, true);
+
+            const bool temp = actual == expected;
+            pass = temp && pass;
+            std::cout << (temp ? "passed:" : "FAILED:") << "  StreamTransformationFilter\n";
+        }
+
+        // Authenticated encryption and decryption with vectored AAD
+        {
+            const byte key[16] = {0}, iv[12] = {0};
+            GCM<AES>::Encryption enc;
+            enc.SetKeyWithIV(key, sizeof(key), iv, sizeof(iv));
+            std::string expected, actual;
+            AuthenticatedEncryptionFilter ef1(enc, new StringSink(expected));
+            // The first five fragments are the 133 bytes of AAD
+            ef1.ChannelPut(AAD_CHANNEL, ConstBytePtr(message), 133);
+            ef1.ChannelMessageEnd(AAD_CHANNEL);
+            ef1.PutMessageEnd(ConstBytePtr(message), message.size());
+
+            enc.SetKeyWithIV(key, sizeof(key), iv, sizeof(iv));
+            AuthenticatedEncryptionFilter ef2(enc, new StringSink(actual));
+            ef2.ChannelPutV(AAD_CHANNEL, spans, 5);
+            ef2.ChannelMessageEnd(AAD_CHANNEL);
+            ef2.ChannelPut2V(DEFAULT_CHANNEL, spans, COUNTOF(spans), -1, true);
+
+            GCM<AES>::Decryption dec;
+            dec.SetKeyWithIV(key, sizeof(key), iv, sizeof(iv));
+            std::string recovered;
+            AuthenticatedDecryptionFilter df(dec, new StringSink(recovered));
+            df.ChannelPutV(AAD_CHANNEL, spans, 5);
+            df.ChannelMessageEnd(AAD_CHANNEL);
+            ConstByteSpan ciphertext[2] = {{ConstBytePtr(actual), 7}, {ConstBytePtr(actual) + 7, actual.size() - 7}};
+            df.ChannelPut2V(DEFAULT_CHANNEL, ciphertext, 2, -1, true);
+
+            const bool temp = actual == expected && df.GetLastResult() && recovered == message;
+            pass = temp && pass;
+            std::cout << (temp ? "passed:" : "FAILED:") << "  AuthenticatedEncryptionFilter and AuthenticatedDecryptionFilter\n";
+        }
+    }
+    catch (const Exception&)
+    {
+        pass = false;
+        std::cout << "FAILED:  exception during vectored Put\n";
+    }
+
+    return pass;
+}
+#endif
+
+#if defined(CRYPTOPP_EXTENDED_VALIDATION)
+// Base-from-member, so the hash and cipher are constructed before the filters
+struct TestChunkHash { SHA256 m_hash; };
+struct TestChunkCipher { CTR_Mode<AES>::Encryption m_enc; };
+
+class TestChunkHashFilter : private TestChunkHash, public HashFilter
+{
+public:
+    TestChunkHashFilter() : HashFilter(m_hash) {}
+};
+
+class TestChunkCipherFilter : private TestChunkCipher, public StreamTransformationFilter
+{
+public:
+    TestChunkCipherFilter(lword message, lword chunk) : StreamTransformationFilter(m_enc)
+    {
+        const byte key[16] = {0};
+        byte iv[16];
+        PutWord(false, BIG_ENDIAN_ORDER, iv+0, word64(message));
+        PutWord(false, BIG_ENDIAN_ORDER, iv+8, word64(chunk));
+        m_enc.SetKeyWithIV(key, sizeof(key), iv, sizeof(iv));
+    }
+};
+
+class TestChunkFactory : public ChunkTransformationFactory
+{
+public:
+    enum Mode {COPY, HASH, CIPHER, THROW};
+    TestChunkFactory(Mode mode) : m_mode(mode) {}
+
+    BufferedTransformation * NewChunkTransformation(lword message, lword chunk) const
+    {
+        switch (m_mode)
+        {
+        case COPY:
+            return new ByteQueue;
+        case HASH:
+            return new TestChunkHashFilter;
+        case THROW:
+            if (chunk == 2)
+                throw InvalidArgument("TestChunkFactory: chunk 2");
+            return new ByteQueue;
+        default:
+            return new TestChunkCipherFilter(message, chunk);
+        }
+    }
+
+    // The same transformations, one chunk at a time
+    std::string Expected(const std::string &message, lword index, size_t chunkSize) const
+    {
+        std::string result;
+        lword chunk = 0;
+        for (size_t i = 0; i < message.size(); i += chunkSize, chunk++)
+        {
+            member_ptr<BufferedTransformation> bt(NewChunkTransformation(index, chunk));
+            bt->PutMessageEnd(ConstBytePtr(message) + i, STDMIN(chunkSize, message.size() - i));
+            StringSink sink(result);
+            bt->TransferTo(sink);
+        }
+        return result;
+    }
+
+private:
+    Mode m_mode;
+};
+
+// Each outer task runs a batch of inner tasks, which fill one row of slots
+class TestNestedTask : public ParallelTask
+{
+public:
+    TestNestedTask(std::vector<word32> &slots, size_t width, size_t row=~size_t(0))
+        : m_slots(slots), m_width(width), m_row(row) {}
+
+    void Run(size_t index)
+    {
+        if (m_row == ~size_t(0))
+        {
+            TestNestedTask inner(m_slots, m_width, index);
+            RunParallelTasks(inner, m_width);
+        }
+        else
+        {
+            const size_t slot = m_row*m_width+index;
+            m_slots[slot] = static_cast<word32>(slot+1);
+        }
+    }
+
+private:
+    std::vector<word32> &m_slots;
+    size_t m_width, m_row;
+};
+
+bool TestParallelFilter()
+{
+    std::cout << "\nTesting ParallelFilter...\n\n";
+    bool pass = true;
+
+    const TestChunkFactory::Mode modes[] = {TestChunkFactory::COPY, TestChunkFactory::HASH, TestChunkFactory::CIPHER};
+    const char* names[] = {"ByteQueue", "HashFilter", "StreamTransformationFilter"};
+    const unsigned int threads[] = {1, 3, 0};
+    const size_t chunkSizes[] = {1, 64, 1000};
+
+    std::string message1(5000, '\0'), message2(777, '\0');
+    GlobalRNG().GenerateBlock(BytePtr(message1), message1.size());
+    GlobalRNG().GenerateBlock(BytePtr(message2), message2.size());
+
+    try
+    {
+        for (size_t i = 0; i < COUNTOF(modes); i++)
+        {
+            bool temp = true;
+            const TestChunkFactory factory(modes[i]);
+            for (size_t j = 0; j < COUNTOF(threads); j++)
+            {
+                for (size_t k = 0; k < COUNTOF(chunkSizes); k++)
+                {
+                    const std::string expected = factory.Expected(message1, 0, chunkSizes[k]) +
+                        factory.Expected(message2, 1, chunkSizes[k]);
+
+                    // Odd sized Puts exercise both the copy and the in place paths
+                    std::string actual;
+                    ParallelFilter filter(factory, new StringSink(actual), threads[j], chunkSizes[k]);
+                    for (size_t n = 0, m = 1; n < message1.size(); n += m, m = m*3+1)
+                        filter.Put(ConstBytePtr(message1) + n, STDMIN(m, message1.size() - n));
+                    filter.MessageEnd();
+                    filter.PutMessageEnd(ConstBytePtr(message2), message2.size());
+
+                    temp = actual == expected && temp;
+                }
+            }
+
+            pass = temp && pass;
+            std::cout << (temp ? "passed:" : "FAILED:") << "  " << names[i] << "\n";
+        }
+
+        // An exception in a chunk reaches the caller
+        {
+            bool temp = false;
+            const TestChunkFactory factory(TestChunkFactory::THROW);
+            ParallelFilter filter(factory, new Redirector(TheBitBucket()), 4, 16);
+            try
+            {
+                filter.PutMessageEnd(ConstBytePtr(message1), 64);
+            }
+            catch (const InvalidArgument&)
+            {
+                temp = true;
+            }
+
+            pass = temp && pass;
+            std::cout << (temp ? "passed:" : "FAILED:") << "  exception propagation\n";
+        }
+
+        // Small batches reuse the pool, and a task may run a batch of its own
+        {
+            bool temp = true;
+            for (size_t i = 0; i < 1000; i++)
+            {
+                const size_t rows = i%5 + 1, width = (i/5)%4 + 1;
+                std::vector<word32> slots(rows*width, 0);
+                TestNestedTask task(slots, width);
+                RunParallelTasks(task, rows);
+                for (size_t j = 0; j < slots.size(); j++)
+                    temp = slots[j] == j+1 && temp;
+            }
+
+            pass = temp && pass;
+            std::cout << (temp ? "passed:" : "FAILED:") << "  nested task batches\n";
+        }
+    }
+    catch (const Exception&)
+    {
+        pass = false;
+        std::cout << "FAILED:  exception during ParallelFilter\n";
+    }
+
+    return pass;
+}
+#endif
+
+#if defined(CRYPTOPP_EXTENDED_VALIDATION) && defined(CRYPTOPP_UNIX_AVAILABLE)
+ANONYMOUS_NAMESPACE_BEGIN
+
+// Writes two messages of random pieces, with a hard flush part way
+// through the first. Returns the bytes written.
+std::string WritePosixFileSink(PosixFileSink &sink, size_t bufferSize)
+{
+    std::string written;
+    for (unsigned int message = 0; message < 2; message++)
+    {
+        for (unsigned int i = 0; i < 48; i++)
+        {
+            // Pieces shorter than a block, and pieces spanning several buffers
+            const size_t length = (i % 4 == 3) ? GlobalRNG().GenerateWord32(0, static_cast<word32>(3*bufferSize)) :
+                GlobalRNG().GenerateWord32(0, 5000);
+
+            std::string piece;
+            RandomNumberSource(GlobalRNG(), length, true, new StringSink(piece));
+            sink.Put(ConstBytePtr(piece), BytePtrSize(piece));
+            written += piece;
+
+            if (message == 0 && i == 20)
+                sink.Flush(true);
+        }
+        sink.MessageEnd();
+    }
+    return written;
+}
+
+ANONYMOUS_NAMESPACE_END
+
+bool TestPosixFileSink()
+{
+    std::cout << "\nTesting PosixFileSink...\n\n";
+    const char *filename = "TestPosixFileSink.tmp";
+    bool pass = true;
+
+    const word32 flags[] = {
+        0, PosixFileSink::DIRECT_IO, PosixFileSink::SYNC_DATA, PosixFileSink::ASYNC_WRITE,
+        PosixFileSink::DIRECT_IO | PosixFileSink::SYNC_DATA,
+        PosixFileSink::DIRECT_IO | PosixFileSink::ASYNC_WRITE,
+        PosixFileSink::SYNC_DATA | PosixFileSink::ASYNC_WRITE,
+        PosixFileSink::DIRECT_IO | PosixFileSink::SYNC_DATA | PosixFileSink::ASYNC_WRITE
+    };
+
+    for (size_t i = 0; i < COUNTOF(flags); i++)
+    {
+        bool temp = true;
+        try
+        {
+            // Odd buffer sizes are rounded up to whole blocks
+            const size_t bufferSize = 2*PosixFileSink::DIRECT_ALIGNMENT + GlobalRNG().GenerateWord32(1, 4095);
+
+            std::string expected, actual;
+            {
+                PosixFileSink sink(filename, flags[i], bufferSize);
+                expected = WritePosixFileSink(sink, bufferSize);
+            }
+            FileSource(filename, true, new StringSink(actual));
+            temp = actual == expected && temp;
+
+            // The sink leaves a descriptor of the caller open
+            const int fd = open(filename, O_WRONLY | O_TRUNC);
+            if (fd == -1)
+                throw Exception(Exception::IO_ERROR, "TestPosixFileSink: open failed");
+            {
+                PosixFileSink sink(fd, flags[i], bufferSize);
+                expected = WritePosixFileSink(sink, bufferSize);
+            }
+            temp = fcntl(fd, F_GETFD) != -1 && temp;
+            close(fd);
+
+            actual.clear();
+            FileSource(filename, true, new StringSink(actual));
+            temp = actual == expected && temp;
+        }
+        catch (const Exception&)
+        {
+            temp = false;
+        }
+
+        pass = temp && pass;
+        std::cout << (temp ? "passed:" : "FAILED:") << "  flags";
+        std::cout << ((flags[i] & PosixFileSink::DIRECT_IO) ? " DIRECT_IO" : "");
+        std::cout << ((flags[i] & PosixFileSink::SYNC_DATA) ? " SYNC_DATA" : "");
+        std::cout << ((flags[i] & PosixFileSink::ASYNC_WRITE) ? " ASYNC_WRITE" : "");
+        std::cout << (flags[i] ? "" : " none") << "\n";
+    }
+
+    std::remove(filename);
+    return pass;
+}
+#endif
+
 NAMESPACE_END  // Test
 NAMESPACE_END  // CryptoPP
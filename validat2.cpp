@@ -887,6 +887,53 @@ bool TestIntegerOps()
        std::cout << "FAILED:";
     std::cout << "  Squaring operations\n";
 
+    // ****************************** Integer Multiply ******************************
+
+    {
+        // Karatsuba, Toom-4 and the number theoretic transform must agree
+        size_t toom4, ntt;
+        Integer::GetMultiplyThresholds(toom4, ntt);
+
+        const size_t thresholds[][2] = {
+            {SIZE_MAX, SIZE_MAX}, {16, SIZE_MAX}, {SIZE_MAX, 16}, {64, 512}
+        };
+
+        result = true;
+        for (size_t i=0; i<24; ++i)
+        {
+            const size_t bits1 = 1+prng.GenerateWord32(0, 96*1024);
+            const size_t bits2 = (i%3 == 0) ? bits1 : 1+prng.GenerateWord32(0, 96*1024);
+
+            Integer a(prng, bits1), b(prng, bits2);
+            if (i%4 == 1) {a = Integer::Power2(bits1) - 1;}
+            if (i%4 == 2) {b = Integer::Power2(bits2) - 1;}
+            if (i%2 == 1) {a.Negate();}
+
+            Integer x[COUNTOF(thresholds)], y[COUNTOF(thresholds)];
+            for (size_t j=0; j<COUNTOF(thresholds); ++j)
+            {
+                Integer::SetMultiplyThresholds(thresholds[j][0], thresholds[j][1]);
+                x[j] = a.Times(b);
+                y[j] = a.Squared();
+            }
+
+            for (size_t j=1; j<COUNTOF(thresholds); ++j)
+                result = (x[j] == x[0]) && (y[j] == y[0]) && result;
+        }
+
+        Integer::SetMultiplyThresholds(toom4, ntt);
+    }
+
+    pass = result && pass;
+    if (!result)
+        std::cout << "FAILED:  Integer Multiply\n";
+
+    if (pass)
+       std::cout << "passed:";
+    else
+       std::cout << "FAILED:";
+    std::cout << "  Multiplication operations\n";
+
     // ****************************** Integer GCD ******************************
 
     {
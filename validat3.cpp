@@ -75,6 +75,13 @@ bool ValidateAll(bool thorough)
 	pass=TestASN1Parse() && pass;
 	// https://github.com/weidai11/cryptopp/pull/334
 	pass=TestStringSink() && pass;
+	pass=TestMappedFileSource() && pass;
+	pass=TestByteQueueNodePool() && pass;
+	pass=TestVectoredPut() && pass;
+	pass=TestParallelFilter() && pass;
+# if defined(CRYPTOPP_UNIX_AVAILABLE)
+	pass=TestPosixFileSink() && pass;
+# endif
 	// Always part of the self tests; call in Debug
 # if defined(CRYPTOPP_ALTIVEC_AVAILABLE)
 	pass=TestAltivecOps() && pass;
@@ -117,6 +124,11 @@ bool ValidateAll(bool thorough)
 	pass=ValidateSM3() && pass;
 	pass=ValidateBLAKE2s() && pass;
 	pass=ValidateBLAKE2b() && pass;
+	pass=ValidateBLAKE2sp() && pass;
+	pass=ValidateBLAKE2bp() && pass;
+	pass=ValidateBLAKE3() && pass;
+	pass=ValidateKangarooTwelve() && pass;
+	pass=ValidateParallelHash() && pass;
 	pass=ValidatePoly1305() && pass;
 	pass=ValidateSipHash() && pass;
 
@@ -351,18 +363,23 @@ bool TestSettings()
 	bool hasSSE42 = HasSSE42();
 	bool hasAVX = HasAVX();
 	bool hasAVX2 = HasAVX2();
+	bool hasAVX512F = HasAVX512F();
 	bool hasAESNI = HasAESNI();
 	bool hasCLMUL = HasCLMUL();
 	bool hasRDRAND = HasRDRAND();
 	bool hasRDSEED = HasRDSEED();
 	bool hasSHA = HasSHA();
+	bool hasVAES = HasVAES();
+	bool hasVPCLMULQDQ = HasVPCLMULQDQ();
 	bool isP4 = IsP4();
 
 	std::cout << "hasSSE2 == " << hasSSE2 << ", hasSSSE3 == " << hasSSSE3;
 	std::cout << ", hasSSE4.1 == " << hasSSE41 << ", hasSSE4.2 == " << hasSSE42;
 	std::cout << ", hasAVX == " << hasAVX << ", hasAVX2 == " << hasAVX2;
+	std::cout << ", hasAVX512F == " << hasAVX512F;
 	std::cout << ", hasAESNI == " << hasAESNI << ", hasCLMUL == " << hasCLMUL;
 	std::cout << ", hasRDRAND == " << hasRDRAND << ", hasRDSEED == " << hasRDSEED;
+	std::cout << ", hasVAES == " << hasVAES << ", hasVPCLMULQDQ == " << hasVPCLMULQDQ;
 	std::cout << ", hasSHA == " << hasSHA << ", isP4 == " << isP4;
 	std::cout << "\n";
 
@@ -44,6 +44,7 @@
 #include "sosemanuk.h"
 
 #include "modes.h"
+#include "xts.h"
 #include "cmac.h"
 #include "dmac.h"
 #include "hmac.h"
@@ -1800,7 +1801,80 @@ bool ValidateGCM()
 bool ValidateXTS()
 {
 	std::cout << "\nAES/XTS validation suite running...\n";
-	return RunTestDataFile("TestVectors/xts.txt");
+	bool pass = RunTestDataFile("TestVectors/xts.txt");
+
+	// ProcessSectors must match one Resynchronize and ProcessLastBlock per sector
+	const size_t sectorSizes[] = {16, 512, 520, 4096};
+	const byte iv[16] = {0}, key[32] = {1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,32};
+	bool temp = true;
+
+	for (size_t i = 0; i < COUNTOF(sectorSizes); i++)
+	{
+		const size_t sectorSize = sectorSizes[i], sectors = 19;
+		const word64 first = W64LIT(0xfffffffffffffff8);
+		SecByteBlock plain(sectorSize*sectors), expected(plain.size()), actual(plain.size());
+		GlobalRNG().GenerateBlock(plain, plain.size());
+
+		XTS_Mode<AES>::Encryption enc;
+		enc.SetKeyWithIV(key, sizeof(key), iv);
+		for (size_t j = 0; j < sectors; j++)
+		{
+			enc.Resynchronize(first+j, LITTLE_ENDIAN_ORDER);
+			enc.ProcessLastBlock(expected+j*sectorSize, sectorSize, plain+j*sectorSize, sectorSize);
+		}
+
+		enc.ProcessSectors(actual, plain, plain.size(), sectorSize, first, LITTLE_ENDIAN_ORDER);
+		temp = (actual == expected) && temp;
+
+		XTS_Mode<AES>::Decryption dec;
+		dec.SetKeyWithIV(key, sizeof(key), iv);
+		dec.ProcessSectors(actual, actual, actual.size(), sectorSize, first, LITTLE_ENDIAN_ORDER);
+		temp = (actual == plain) && temp;
+	}
+
+	pass = temp && pass;
+	std::cout << (temp ? "passed:" : "FAILED:") << "  ProcessSectors\n";
+
+	// ProcessData must match a block at a time reference for every batch
+	// length, so the 16, 8 and 4 block AES kernels all see the data
+	temp = true;
+	for (size_t blocks = 1; blocks <= 53; blocks++)
+	{
+		const size_t length = blocks*16;
+		SecByteBlock plain(length), expected(length), actual(length);
+		GlobalRNG().GenerateBlock(plain, plain.size());
+
+		AES::Encryption data(key, 16), tweak(key+16, 16);
+		byte t[16];
+		tweak.ProcessBlock(iv, t);
+		for (size_t j = 0; j < length; j += 16)
+		{
+			byte x[16];
+			xorbuf(x, plain+j, t, 16);
+			data.ProcessBlock(x);
+			xorbuf(expected+j, x, t, 16);
+
+			// Multiply T by alpha, little-endian
+			const byte carry = t[15] >> 7;
+			for (size_t k = 15; k > 0; k--)
+				t[k] = byte((t[k] << 1) | (t[k-1] >> 7));
+			t[0] = byte((t[0] << 1) ^ (carry ? 0x87 : 0));
+		}
+
+		XTS_Mode<AES>::Encryption enc;
+		enc.SetKeyWithIV(key, sizeof(key), iv);
+		enc.ProcessData(actual, plain, length);
+		temp = (actual == expected) && temp;
+
+		XTS_Mode<AES>::Decryption dec;
+		dec.SetKeyWithIV(key, sizeof(key), iv);
+		dec.ProcessData(actual, actual, length);
+		temp = (actual == plain) && temp;
+	}
+
+	pass = temp && pass;
+	std::cout << (temp ? "passed:" : "FAILED:") << "  ProcessData batch lengths\n";
+	return pass;
 }
 
 bool ValidateCMAC()
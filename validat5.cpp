@@ -24,6 +24,9 @@
 #include "keccak.h"
 #include "tiger.h"
 #include "blake2.h"
+#include "blake3.h"
+#include "kangaroo12.h"
+#include "parallelhash.h"
 #include "ripemd.h"
 #include "siphash.h"
 #include "poly1305.h"
@@ -97,6 +100,49 @@ bool HashModuleTest(HashTransformation &md, const HashTestTuple *testSet, unsign
 	return pass;
 }
 
+// Single calls of at least 64 bytes take the folding loops of the
+// CLMUL and PMULL code. The known answers hash the pattern i mod 251,
+// and random lengths and offsets are compared with a bitwise CRC.
+template <class H>
+bool TestLongCRC(word32 polynomial, const char *const expected[3])
+{
+	const size_t lengths[] = {129, 1000, 4099};
+	SecByteBlock message(4099+16);
+	for (size_t i=0; i<message.size(); ++i)
+		message[i] = static_cast<byte>(i % 251);
+
+	H crc;
+	byte digest[4];
+	bool fail = false;
+
+	for (size_t i=0; i<COUNTOF(lengths); ++i)
+	{
+		crc.CalculateDigest(digest, message, lengths[i]);
+		fail = (std::memcmp(digest, expected[i], 4) != 0) || fail;
+	}
+
+	for (size_t i=0; i<256; ++i)
+	{
+		const size_t offset = GlobalRNG().GenerateWord32(0, 15);
+		const size_t length = GlobalRNG().GenerateWord32(0, 4099);
+		GlobalRNG().GenerateBlock(message+offset, length);
+
+		word32 c = 0xffffffff;
+		for (size_t j=0; j<length; ++j)
+		{
+			c ^= message[offset+j];
+			for (unsigned int k=0; k<8; ++k)
+				c = (c >> 1) ^ (polynomial & (0 - (c & 1)));
+		}
+
+		crc.CalculateDigest(digest, message+offset, length);
+		fail = (GetWord<word32>(false, LITTLE_ENDIAN_ORDER, digest) != ~c) || fail;
+	}
+
+	std::cout << (fail ? "FAILED   " : "passed   ") << "single calls of up to 4099 bytes" << std::endl;
+	return !fail;
+}
+
 bool ValidateCRC32()
 {
 	HashTestTuple testSet[] =
@@ -108,13 +154,18 @@ bool ValidateCRC32()
 		HashTestTuple("abcdefghijklmnopqrstuvwxyz", "\xbd\x50\x27\x4c"),
 		HashTestTuple("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789", "\xd2\xe6\xc2\x1f"),
 		HashTestTuple("12345678901234567890123456789012345678901234567890123456789012345678901234567890", "\x72\x4a\xa9\x7c"),
-		HashTestTuple("123456789", "\x26\x39\xf4\xcb")
+		HashTestTuple("123456789", "\x26\x39\xf4\xcb"),
+		HashTestTuple("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", "\xbc\xbf\x25\xdc", 15625)
 	};
 
+	const char *const longSet[] = {"\xf7\xcd\x91\xca", "\xa6\x46\x17\x72", "\x1d\x72\xd1\x48"};
+
 	CRC32 crc;
 
 	std::cout << "\nCRC-32 validation suite running...\n\n";
-	return HashModuleTest(crc, testSet, COUNTOF(testSet));
+	bool pass = HashModuleTest(crc, testSet, COUNTOF(testSet));
+	pass = TestLongCRC<CRC32>(0xEDB88320, longSet) && pass;
+	return pass;
 }
 
 bool ValidateCRC32C()
@@ -128,13 +179,18 @@ bool ValidateCRC32C()
 		HashTestTuple("abcdefghijklmnopqrstuvwxyz", "\x25\xef\xe6\x9e"),
 		HashTestTuple("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789", "\x7d\xd5\x45\xa2"),
 		HashTestTuple("12345678901234567890123456789012345678901234567890123456789012345678901234567890", "\x81\x67\x7a\x47"),
-		HashTestTuple("123456789", "\x83\x92\x06\xe3")
+		HashTestTuple("123456789", "\x83\x92\x06\xe3"),
+		HashTestTuple("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", "\x40\xe2\x6f\x43", 15625)
 	};
 
+	const char *const longSet[] = {"\x9f\x62\x14\xf5", "\x20\x62\xf6\x11", "\x80\x51\x7a\x98"};
+
 	CRC32C crc;
 
 	std::cout << "\nCRC-32C validation suite running...\n\n";
-	return HashModuleTest(crc, testSet, COUNTOF(testSet));
+	bool pass = HashModuleTest(crc, testSet, COUNTOF(testSet));
+	pass = TestLongCRC<CRC32C>(0x82F63B78, longSet) && pass;
+	return pass;
 }
 
 bool ValidateAdler32()
@@ -213,10 +269,127 @@ bool ValidateMD5()
 	return HashModuleTest(md5, testSet, COUNTOF(testSet));
 }
 
+// Compare CalculateDigests with one-at-a-time hashing. The counts
+// leave lanes of the multi-buffer code idle, and the lengths cross
+// the one and two padding block boundaries.
+template <class H>
+bool TestCalculateDigests()
+{
+	const size_t counts[] = {0, 1, 3, 4, 7, 8, 9, 16, 17, 33};
+	const size_t maxCount = 33, maxLength = 1100;
+
+	SecByteBlock data(maxCount*maxLength), digests(maxCount*H::DIGESTSIZE);
+	SecByteBlock expected(H::DIGESTSIZE);
+	const byte *messages[maxCount];
+	size_t lengths[maxCount];
+
+	GlobalRNG().GenerateBlock(data, data.size());
+	bool pass = true;
+
+	for (size_t i=0; i<COUNTOF(counts); i++)
+	{
+		const size_t count = counts[i];
+		for (size_t j=0; j<count; j++)
+		{
+			messages[j] = data+j*maxLength;
+			lengths[j] = (j % 4 == 0) ? 55 + j % 11 : GlobalRNG().GenerateWord32(0, maxLength);
+		}
+
+		H::CalculateDigests(digests, messages, lengths, count);
+
+		bool fail = false;
+		for (size_t j=0; j<count; j++)
+		{
+			H().CalculateDigest(expected, messages[j], lengths[j]);
+			fail = fail || std::memcmp(digests+j*H::DIGESTSIZE, expected, H::DIGESTSIZE) != 0;
+		}
+
+		pass = pass && !fail;
+		std::cout << (fail ? "FAILED   " : "passed   ") << H::StaticAlgorithmName();
+		std::cout << " CalculateDigests, " << count << " messages" << std::endl;
+	}
+
+	return pass;
+}
+
+// CalculateDigests of an extendable output function, with
+// outputs longer than the rate of the sponge
+template <class H>
+bool TestCalculateXofDigests(size_t digestSize)
+{
+	const size_t counts[] = {0, 1, 2, 3, 4, 7, 8, 9, 16, 17, 33};
+	const size_t maxCount = 33, maxLength = 700;
+
+	SecByteBlock data(maxCount*maxLength), digests(maxCount*digestSize);
+	SecByteBlock expected(digestSize);
+	const byte *messages[maxCount];
+	size_t lengths[maxCount];
+
+	GlobalRNG().GenerateBlock(data, data.size());
+	bool pass = true;
+
+	for (size_t i=0; i<COUNTOF(counts); i++)
+	{
+		const size_t count = counts[i];
+		for (size_t j=0; j<count; j++)
+		{
+			messages[j] = data+j*maxLength;
+			lengths[j] = (j % 4 == 0) ? 34 : GlobalRNG().GenerateWord32(0, maxLength);
+		}
+
+		H::CalculateDigests(digests, digestSize, messages, lengths, count);
+
+		bool fail = false;
+		for (size_t j=0; j<count; j++)
+		{
+			H hash;
+			hash.Update(messages[j], lengths[j]);
+			hash.TruncatedFinal(expected, digestSize);
+			fail = fail || std::memcmp(digests+j*digestSize, expected, digestSize) != 0;
+		}
+
+		pass = pass && !fail;
+		std::cout << (fail ? "FAILED   " : "passed   ") << H::StaticAlgorithmName();
+		std::cout << " CalculateDigests, " << count << " messages of " << digestSize << " bytes" << std::endl;
+	}
+
+	return pass;
+}
+
+// Compare one-shot hashing of a message with hashing it in odd sized
+// updates. The updates split the blocks and chunks of tree and parallel
+// hashes at every alignment, and leave partial batches in the buffers.
+template <class H>
+bool TestIncrementalDigest(H &hash, size_t messageLength)
+{
+	SecByteBlock message(messageLength);
+	for (size_t i=0; i<message.size(); ++i)
+		message[i] = static_cast<byte>(i % 251);
+
+	SecByteBlock expected(hash.DigestSize()), calculated(hash.DigestSize());
+	hash.CalculateDigest(expected, message, message.size());
+
+	bool fail = false;
+	const size_t sizes[] = {1, hash.BlockSize()-1, 1000, 1025, 8193, 65537};
+	for (size_t i=0; i<COUNTOF(sizes); ++i)
+	{
+		for (size_t j=0; j<message.size(); j+=sizes[i])
+			hash.Update(message+j, STDMIN(sizes[i], message.size()-j));
+		hash.Final(calculated);
+		fail = (expected != calculated) || fail;
+	}
+
+	std::cout << (fail ? "FAILED   " : "passed   ") << "incremental hashing" << std::endl;
+	return !fail;
+}
+
 bool ValidateSHA()
 {
 	std::cout << "\nSHA validation suite running...\n";
-	return RunTestDataFile("TestVectors/sha.txt");
+	bool pass = RunTestDataFile("TestVectors/sha.txt");
+	pass = TestCalculateDigests<SHA1>() && pass;
+	pass = TestCalculateDigests<SHA256>() && pass;
+	return pass;
 }
 
 bool ValidateSHA2()
@@ -234,13 +407,18 @@ bool ValidateKeccak()
 bool ValidateSHA3()
 {
 	std::cout << "\nSHA-3 validation suite running...\n";
-	return RunTestDataFile("TestVectors/sha3.txt");
+	bool pass = RunTestDataFile("TestVectors/sha3.txt");
+	pass = TestCalculateDigests<SHA3_256>() && pass;
+	return pass;
 }
 
 bool ValidateSHAKE()
 {
 	std::cout << "\nSHAKE validation suite running...\n";
-	return RunTestDataFile("TestVectors/shake.txt");
+	bool pass = RunTestDataFile("TestVectors/shake.txt");
+	pass = TestCalculateXofDigests<SHAKE128>(32) && pass;
+	pass = TestCalculateXofDigests<SHAKE128>(840) && pass;
+	return pass;
 }
 
 // We needed to hand craft the SHAKE tests because SHAKE128 and SHAKE256
@@ -992,6 +1170,30 @@ bool ValidateScrypt()
 	std::cout << "\nRFC 7914 Scrypt validation suite running...\n\n";
 	pass = TestScrypt(pbkdf, testSet, COUNTOF(testSet)) && pass;
 
+	// The derived key must not depend on the number of threads
+	{
+		const Scrypt_TestTuple& tuple = testSet[1];
+		std::string password(tuple.passwd), salt(tuple.salt), expect;
+		StringSource(tuple.expect, true, new HexDecoder(new StringSink(expect)));
+
+		bool fail = false;
+		const int threads[] = {1, 3, 4, 32};
+		for (size_t i=0; i<COUNTOF(threads); ++i)
+		{
+			AlgorithmParameters params = MakeParameters("Cost", (word64)tuple.n)
+				("BlockSize", (word64)tuple.r)("Parallelization", (word64)tuple.p)
+				(Name::Salt(), ConstByteArrayParameter(ConstBytePtr(salt), BytePtrSize(salt)))
+				("Threads", threads[i]);
+
+			SecByteBlock derived(expect.size());
+			pbkdf.DeriveKey(derived, derived.size(), ConstBytePtr(password), BytePtrSize(password), params);
+			fail = !!memcmp(derived, expect.data(), expect.size()) || fail;
+		}
+
+		pass = pass && !fail;
+		std::cout << (fail ? "FAILED   " : "passed   ") << "  Threads 1, 3, 4 and 32\n";
+	}
+
 	return pass;
 }
 
@@ -2208,5 +2410,168 @@ bool ValidateSM3()
 	return RunTestDataFile("TestVectors/sm3.txt");
 }
 
+bool ValidateBLAKE2sp()
+{
+	std::cout << "\nBLAKE2sp validation suite running...\n";
+	return RunTestDataFile("TestVectors/blake2sp.txt");
+}
+
+bool ValidateBLAKE2bp()
+{
+	std::cout << "\nBLAKE2bp validation suite running...\n";
+	return RunTestDataFile("TestVectors/blake2bp.txt");
+}
+
+bool ValidateBLAKE3()
+{
+	std::cout << "\nBLAKE3 validation suite running...\n";
+	bool pass = RunTestDataFile("TestVectors/blake3.txt");
+
+	// The subtrees of a long message are hashed on several threads.
+	// The digests must not depend on the number of threads.
+	{
+		SecByteBlock message(5*BLAKE3::SUBTREE_CHUNKS*BLAKE3::CHUNKSIZE+777);
+		for (size_t i=0; i<message.size(); ++i)
+			message[i] = static_cast<byte>(i % 251);
+
+		SecByteBlock expected(BLAKE3::DIGESTSIZE), calculated(BLAKE3::DIGESTSIZE);
+		BLAKE3 blake3;
+		blake3.CalculateDigest(expected, message, message.size());
+
+		bool fail = false;
+		const unsigned int threads[] = {2, 4, 0};
+		for (size_t i=0; i<COUNTOF(threads); ++i)
+		{
+			blake3.SetThreads(threads[i]);
+			blake3.CalculateDigest(calculated, message, message.size());
+			fail = (expected != calculated) || fail;
+		}
+
+		pass = pass && !fail;
+		std::cout << (fail ? "FAILED   " : "passed   ") << "threaded hashing" << std::endl;
+	}
+
+	BLAKE3 blake3;
+	pass = TestIncrementalDigest(blake3, 5*BLAKE3::SUBTREE_CHUNKS*BLAKE3::CHUNKSIZE+777) && pass;
+
+	return pass;
+}
+
+bool ValidateKangarooTwelve()
+{
+	std::cout << "\nKangarooTwelve validation suite running...\n";
+	bool pass = RunTestDataFile("TestVectors/kangaroo12.txt");
+
+	// draft-irtf-cfrg-kangarootwelve, customization strings and
+	// extended output. ptn(n) is the pattern i mod 251.
+	{
+		struct Test
+		{
+			size_t messageLength, customizationLength;
+			const char *digest;
+		};
+
+		const Test tests[] = {
+			{0, 1, "FAB658DB63E94A246188BF7AF69A133045F46EE984C56E3C3328CAAF1AA1A583"},
+			{1, 41, "D848C5068CED736F4462159B9867FD4C20B808ACC3D5BC48E0B06BA0A3762EC4"},
+			{3, 41*41, "C389E5009AE57120854C2E8C64670AC01358CF4C1BAF89447A724234DC7CED74"},
+			{7, 41*41*41, "75D2F86A2E644566726B4FBCFC5657B9DBCF070C7B0DCA06450AB291D7443BCF"}
+		};
+
+		SecByteBlock pattern(41*41*41);
+		for (size_t i=0; i<pattern.size(); ++i)
+			pattern[i] = static_cast<byte>(i % 251);
+
+		const byte ff[7] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+		SecByteBlock calculated(KangarooTwelve::DIGESTSIZE);
+
+		for (size_t i=0; i<COUNTOF(tests); ++i)
+		{
+			std::string expected;
+			StringSource(tests[i].digest, true, new HexDecoder(new StringSink(expected)));
+
+			KangarooTwelve k12(pattern, tests[i].customizationLength);
+			k12.CalculateDigest(calculated, ff, tests[i].messageLength);
+
+			bool fail = std::memcmp(calculated, expected.data(), expected.size()) != 0;
+			pass = pass && !fail;
+			std::cout << (fail ? "FAILED   " : "passed   ") << "customization string of ";
+			std::cout << tests[i].customizationLength << " bytes" << std::endl;
+		}
+
+		// The last 32 bytes of 10032 bytes of output for the empty message
+		std::string expected;
+		StringSource("E8DC563642F7228C84684C898405D3A834799158C079B12880277A1D28E2FF6D", true,
+			new HexDecoder(new StringSink(expected)));
+
+		SecByteBlock output(10032);
+		KangarooTwelve k12;
+		k12.TruncatedFinal(output, output.size());
+
+		bool fail = std::memcmp(output+output.size()-32, expected.data(), expected.size()) != 0;
+		pass = pass && !fail;
+		std::cout << (fail ? "FAILED   " : "passed   ") << "extended output" << std::endl;
+	}
+
+	KangarooTwelve k12;
+	pass = TestIncrementalDigest(k12, 21*KangarooTwelve::CHUNKSIZE+777) && pass;
+
+	return pass;
+}
+
+bool ValidateParallelHash()
+{
+	std::cout << "\nParallelHash validation suite running...\n";
+	bool pass = RunTestDataFile("TestVectors/parallelhash.txt");
+
+	// NIST SP 800-185 samples, block size 8
+	{
+		struct Test
+		{
+			unsigned int strength, digestSize;
+			const char *customization, *digest;
+		};
+
+		const Test tests[] = {
+			{128, 32, "", "BA8DC1D1D979331D3F813603C67F72609AB5E44B94A0B8F9AF46514454A2B4F5"},
+			{128, 32, "Parallel Data", "FC484DCB3F84DCEEDC353438151BEE58157D6EFED0445A81F165E495795B7206"},
+			{256, 64, "", "BC1EF124DA34495E948EAD207DD9842235DA432D2BBC54B4C110E64C451105531B7F2A3E0CE055C02805E7C2DE1FB746AF97A1DD01F43B824E31B87612410429"}
+		};
+
+		const byte message[] = {
+			0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x10, 0x11, 0x12, 0x13,
+			0x14, 0x15, 0x16, 0x17, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27
+		};
+
+		for (size_t i=0; i<COUNTOF(tests); ++i)
+		{
+			std::string expected;
+			StringSource(tests[i].digest, true, new HexDecoder(new StringSink(expected)));
+
+			const byte *customization = reinterpret_cast<const byte*>(tests[i].customization);
+			const size_t customizationLength = std::strlen(tests[i].customization);
+
+			member_ptr<HashTransformation> hash;
+			if (tests[i].strength == 128)
+				hash.reset(new ParallelHash128(8, tests[i].digestSize, customization, customizationLength));
+			else
+				hash.reset(new ParallelHash256(8, tests[i].digestSize, customization, customizationLength));
+
+			SecByteBlock calculated(hash->DigestSize());
+			hash->CalculateDigest(calculated, message, sizeof(message));
+
+			bool fail = std::memcmp(calculated, expected.data(), expected.size()) != 0;
+			pass = pass && !fail;
+			std::cout << (fail ? "FAILED   " : "passed   ") << hash->AlgorithmName();
+			std::cout << " sample, customization \"" << tests[i].customization << "\"" << std::endl;
+		}
+	}
+
+	ParallelHash256 hash(1000);
+	pass = TestIncrementalDigest(hash, 13*ParallelHash::DEFAULT_BLOCKSIZE+777) && pass;
+
+	return pass;
+}
+
 NAMESPACE_END  // Test
 NAMESPACE_END  // CryptoPP
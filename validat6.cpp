@@ -308,6 +308,202 @@ bool ValidateBBS()
 	return pass;
 }
 
+template <class EC>
+bool TestMultiScalarMultiply(const DL_GroupParameters_EC<EC> &params)
+{
+	typedef typename EC::Point Point;
+	const EC &curve = params.GetCurve();
+	const Integer &order = params.GetSubgroupOrder();
+	const unsigned int counts[] = {0, 1, 2, 3, 5, 17, 100};
+	bool pass = true;
+
+	for (size_t c=0; c<COUNTOF(counts); c++)
+	{
+		const unsigned int count = counts[c];
+		std::vector<Point> bases(count);
+		std::vector<Integer> exponents(count);
+		Point expected = curve.Identity();
+
+		// Repeated and inverted bases, and negative and zero
+		// exponents, exercise the special cases of the additions
+		for (unsigned int i=0; i<count; i++)
+		{
+			bases[i] = params.ExponentiateBase(Integer(GlobalRNG(), Integer::One(), order-1));
+			exponents[i] = Integer(GlobalRNG(), order.BitCount());
+			if (i % 7 == 3)
+				bases[i] = bases[i-1];
+			if (i % 7 == 4)
+				bases[i] = curve.Inverse(bases[i-1]);
+			if (i % 7 == 5)
+				exponents[i].Negate();
+			if (i % 7 == 6)
+				exponents[i] = Integer::Zero();
+			if (i == 1)
+				bases[i] = curve.Identity();
+
+			Point t = curve.ScalarMultiply(bases[i], exponents[i].AbsoluteValue());
+			if (exponents[i].IsNegative())
+				t = curve.Inverse(t);
+			expected = curve.Add(expected, t);
+		}
+
+		const Point result = curve.MultiScalarMultiply(count ? &bases[0] : NULLPTR, count ? &exponents[0] : NULLPTR, count);
+		pass = curve.Equal(result, expected) && pass;
+	}
+
+	std::cout << (pass ? "passed    " : "FAILED    ");
+	std::cout << "MultiScalarMultiply\n";
+	return pass;
+}
+
+template <class EC>
+bool TestFixedBasePrecomputation(const OID &oid)
+{
+	typedef typename EC::Point Point;
+	DL_GroupParameters_EC<EC> params(oid), plain(oid);
+	const unsigned int storage = params.GetSubgroupOrder().BitCount() * 2;
+	bool pass = true;
+
+	// A storage larger than the order selects a window table. The
+	// second Precompute() finds the table in the cache.
+	DL_PrecomputationCache::Clear();
+	params.Precompute(storage);
+	const size_t size = DL_PrecomputationCache::GetSize();
+	pass = (size != 0) && pass;
+
+	DL_GroupParameters_EC<EC> cached(oid);
+	cached.Precompute(storage);
+	pass = (DL_PrecomputationCache::GetSize() == size) && pass;
+
+	std::string saved, table;
+	StringSink sink(saved);
+	DL_PrecomputationCache::Save(sink);
+	DL_PrecomputationCache::Clear();
+	StringSource source(saved, true);
+	DL_PrecomputationCache::Load(source);
+	pass = (DL_PrecomputationCache::GetSize() == size) && pass;
+
+	DL_GroupParameters_EC<EC> loaded(oid);
+	StringSink tableSink(table);
+	params.SavePrecomputation(tableSink);
+	StringStore tableStore(table);
+	loaded.LoadPrecomputation(tableStore);
+
+	for (unsigned int i=0; i<16; i++)
+	{
+		const Integer e = (i < 2) ? Integer(i) : Integer(GlobalRNG(), Integer::Zero(), params.GetSubgroupOrder()-1);
+		const Point expected = plain.ExponentiateBase(e);
+		pass = params.GetCurve().Equal(params.ExponentiateBase(e), expected) && pass;
+		pass = params.GetCurve().Equal(cached.ExponentiateBase(e), expected) && pass;
+		pass = params.GetCurve().Equal(loaded.ExponentiateBase(e), expected) && pass;
+	}
+
+	// A saved cache whose entry for G holds the table of 2G. Precompute()
+	// must reject the table and compute its own.
+	{
+		DL_GroupParameters_EC<EC> doubled(oid);
+		const Point &G = params.GetSubgroupGenerator();
+		doubled.SetSubgroupGenerator(params.GetCurve().Double(G));
+
+		DL_PrecomputationCache::Clear();
+		doubled.Precompute(storage);
+
+		std::string hostile;
+		StringSink hostileSink(hostile);
+		DL_PrecomputationCache::Save(hostileSink);
+		DL_PrecomputationCache::Clear();
+
+		// Point the key at G. The key is saved before its table.
+		const size_t size = params.GetEncodedElementSize(true);
+		std::string from(size, '\0'), to(size, '\0');
+		params.EncodeElement(true, doubled.GetSubgroupGenerator(), BytePtr(from));
+		params.EncodeElement(true, G, BytePtr(to));
+		const size_t pos = hostile.find(from);
+		pass = (pos != std::string::npos) && pass;
+		if (pos != std::string::npos)
+			hostile.replace(pos, size, to);
+
+		StringSource hostileSource(hostile, true);
+		DL_PrecomputationCache::Load(hostileSource);
+
+		DL_GroupParameters_EC<EC> victim(oid);
+		victim.Precompute(storage);
+		pass = params.GetCurve().Equal(victim.GetSubgroupGenerator(), G) && pass;
+
+		for (unsigned int i=0; i<4; i++)
+		{
+			const Integer e(GlobalRNG(), Integer::One(), params.GetSubgroupOrder()-1);
+			const Point actual = victim.GetBasePrecomputation().Exponentiate(victim.GetGroupPrecomputation(), e);
+			pass = params.GetCurve().Equal(actual, plain.ExponentiateBase(e)) && pass;
+		}
+	}
+
+	DL_PrecomputationCache::Clear();
+
+	std::cout << (pass ? "passed    " : "FAILED    ");
+	std::cout << "fixed-base precomputation\n";
+	return pass;
+}
+
+bool TestDedicatedArithmetic(const OID &oid)
+{
+	typedef ECP::Point Point;
+	const DL_GroupParameters_EC<ECP> params(oid);
+	const ECP &curve = params.GetCurve();
+	const Integer &order = params.GetSubgroupOrder();
+	const Point &G = params.GetSubgroupGenerator();
+	bool pass = curve.HasDedicatedArithmetic();
+
+	// The dedicated arithmetic has its own table, so Precompute() adds none
+	DL_PrecomputationCache::Clear();
+	DL_GroupParameters_EC<ECP>(oid).Precompute();
+	pass = (DL_PrecomputationCache::GetSize() == 0) && pass;
+
+	// The generic double-and-add is the reference
+	const Point P = params.ExponentiateBase(Integer(GlobalRNG(), Integer::One(), order-1));
+	const Point Q = params.ExponentiateBase(Integer(GlobalRNG(), Integer::One(), order-1));
+	const Point bases[] = {G, P, curve.Inverse(P), curve.Identity()};
+	pass = curve.VerifyPoint(P) && curve.VerifyPoint(Q) && pass;
+
+	for (size_t b=0; b<COUNTOF(bases); b++)
+	{
+		for (unsigned int i=0; i<12; i++)
+		{
+			Integer k;
+			switch (i)
+			{
+			case 0: case 1: case 2: k = i; break;
+			case 3: k = order-1; break;
+			case 4: k = order; break;
+			case 5: k = order+1; break;
+			case 6: k = Integer(GlobalRNG(), 2*order.BitCount()); break;
+			case 7: k = -Integer(GlobalRNG(), order.BitCount()); break;
+			default: k = Integer(GlobalRNG(), order.BitCount()); break;
+			}
+
+			Point expected;
+			const Integer e = k.AbsoluteValue();
+			curve.AbstractGroup<Point>::SimultaneousMultiply(&expected, bases[b], &e, 1);
+			if (k.IsNegative())
+				expected = curve.Inverse(expected);
+
+			pass = curve.Equal(curve.ScalarMultiply(bases[b], k), expected) && pass;
+			if (b == 0)
+				pass = curve.Equal(params.ExponentiateBase(k), expected) && pass;
+
+			Point expected2;
+			const Integer k2(GlobalRNG(), order.BitCount());
+			curve.AbstractGroup<Point>::SimultaneousMultiply(&expected2, Q, &k2, 1);
+			expected2 = curve.Add(expected, expected2);
+			pass = curve.Equal(curve.CascadeScalarMultiply(bases[b], k, Q, k2), expected2) && pass;
+		}
+	}
+
+	std::cout << (pass ? "passed    " : "FAILED    ");
+	std::cout << "dedicated " << order.BitCount() << "-bit arithmetic\n";
+	return pass;
+}
+
 bool ValidateECP()
 {
 	// Remove word recommend. Some ECP curves may not be recommended depending
@@ -324,6 +520,10 @@ bool ValidateECP()
 	}
 
 	std::cout << "\nECP validation suite running...\n\n";
+	pass = TestMultiScalarMultiply(DL_GroupParameters_EC<ECP>(ASN1::secp256r1())) && pass;
+	pass = TestFixedBasePrecomputation<ECP>(ASN1::brainpoolP256r1()) && pass;
+	pass = TestDedicatedArithmetic(ASN1::secp256r1()) && pass;
+	pass = TestDedicatedArithmetic(ASN1::secp384r1()) && pass;
 	return ValidateECP_Agreement() && ValidateECP_Encrypt() && ValidateECP_NULLDigest_Encrypt() && ValidateECP_Sign() && pass;
 }
 
@@ -345,6 +545,8 @@ bool ValidateEC2N()
 #endif
 
 	std::cout << "\nEC2N validation suite running...\n\n";
+	pass = TestMultiScalarMultiply(DL_GroupParameters_EC<EC2N>(ASN1::sect233k1())) && pass;
+	pass = TestFixedBasePrecomputation<EC2N>(ASN1::sect233k1()) && pass;
 	return ValidateEC2N_Agreement() && ValidateEC2N_Encrypt() && ValidateEC2N_Sign() && pass;
 }
 
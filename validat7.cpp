@@ -19,6 +19,8 @@
 #include "dh.h"
 #include "luc.h"
 #include "mqv.h"
+#include "nbtheory.h"
+#include "rng.h"
 #include "xtr.h"
 #include "hmqv.h"
 #include "pubkey.h"
@@ -52,7 +54,24 @@ bool ValidateDH()
 
 	FileSource f(DataDir("TestData/dh1024.dat").c_str(), true, new HexDecoder);
 	DH dh(f);
-	return SimpleKeyAgreementValidate(dh);
+	bool pass = SimpleKeyAgreementValidate(dh);
+
+	{
+		// The primes do not depend on the number of threads
+		LC_RNG rng1(0x5e5e5e5e), rng4(0x5e5e5e5e);
+		PrimeAndGenerator pg1, pg4;
+		pg1.Generate(1, rng1, 512, 511, 1);
+		pg4.Generate(1, rng4, 512, 511, 4);
+
+		const bool fail = pg1.Prime() != pg4.Prime() || pg1.Generator() != pg4.Generator() ||
+			pg4.SubPrime() != (pg4.Prime() >> 1) || !VerifyPrime(GlobalRNG(), pg4.SubPrime());
+		pass = pass && !fail;
+
+		std::cout << (fail ? "FAILED    " : "passed    ");
+		std::cout << "safe prime generation using threads\n";
+	}
+
+	return pass;
 }
 
 bool ValidateX25519()
@@ -14,6 +14,7 @@
 #include "oids.h"
 
 #include "luc.h"
+#include "rng.h"
 #include "rsa.h"
 #include "xtr.h"
 #include "rabin.h"
@@ -68,6 +69,20 @@ bool ValidateRSA_Encrypt()
 
 		pass = CryptoSystemValidate(rsaPriv, rsaPub) && pass;
 	}
+	{
+		// The primes do not depend on the number of threads
+		LC_RNG rng1(0x5e5e5e5e), rng4(0x5e5e5e5e);
+		InvertibleRSAFunction key1, key4;
+		key1.GenerateRandom(rng1, MakeParameters(Name::ModulusSize(), 1024)("Threads", 1));
+		key4.GenerateRandom(rng4, MakeParameters(Name::ModulusSize(), 1024)("Threads", 4));
+
+		fail = key1.GetPrime1() != key4.GetPrime1() || key1.GetPrime2() != key4.GetPrime2() ||
+			!key4.Validate(GlobalRNG(), 3);
+		pass = pass && !fail;
+
+		std::cout << (fail ? "FAILED    " : "passed    ");
+		std::cout << "RSA key generation using threads\n";
+	}
 	{
 		byte *plain = (byte *)
 			"\x54\x85\x9b\x34\x2c\x49\xea\x2a";
@@ -697,6 +697,74 @@ bool ValidateEd25519()
 	std::cout << (fail ? "FAILED    " : "passed    ");
 	std::cout << "verification check against test vector\n";
 
+	// Batch verification. 150 signatures spans two full batches and a partial one.
+	{
+		const size_t count = 150;
+		ed25519::Signer signer2(GlobalRNG());
+		ed25519::Verifier verifier2(signer2);
+
+		std::vector<std::string> messages(count);
+		std::vector<SecByteBlock> signatures(count);
+		std::vector<const byte*> msgs(count), sigs(count), keys(count);
+		std::vector<size_t> lengths(count);
+
+		const ed25519PublicKey& pk1 = dynamic_cast<const ed25519PublicKey&>(verifier.GetPublicKey());
+		const ed25519PublicKey& pk2 = dynamic_cast<const ed25519PublicKey&>(verifier2.GetPublicKey());
+
+		for (size_t i=0; i<count; ++i)
+		{
+			messages[i].resize(GlobalRNG().GenerateWord32(0, 256));
+			GlobalRNG().GenerateBlock((byte*)&messages[i][0], messages[i].size());
+			signatures[i].resize(signer.MaxSignatureLength());
+
+			msgs[i] = (const byte*)messages[i].data();
+			lengths[i] = messages[i].size();
+			sigs[i] = signatures[i].begin();
+		}
+
+		// Single public key
+		for (size_t i=0; i<count; ++i)
+			signer.SignMessage(GlobalRNG(), msgs[i], lengths[i], signatures[i]);
+
+		bool results[count];
+		fail = !verifier.VerifyBatch(GlobalRNG(), &msgs[0], &lengths[0], &sigs[0], count, results);
+		for (size_t i=0; i<count; ++i)
+			fail = fail || !results[i];
+
+		// Tamper with R, S and the message
+		signatures[5][3] ^= 0x01;
+		signatures[70][40] ^= 0x80;
+		messages[149].append(1, 'x');
+		msgs[149] = (const byte*)messages[149].data();
+		lengths[149] = messages[149].size();
+
+		fail = fail || verifier.VerifyBatch(GlobalRNG(), &msgs[0], &lengths[0], &sigs[0], count, results);
+		for (size_t i=0; i<count; ++i)
+			fail = fail || (results[i] != (i != 5 && i != 70 && i != 149));
+
+		// Mixed public keys
+		for (size_t i=0; i<count; ++i)
+		{
+			const bool second = (i % 3 == 0);
+			(second ? signer2 : signer).SignMessage(GlobalRNG(), msgs[i], lengths[i], signatures[i]);
+			keys[i] = second ? pk2.GetPublicKeyBytePtr() : pk1.GetPublicKeyBytePtr();
+		}
+
+		fail = fail || !ed25519::Verifier::VerifyBatch(GlobalRNG(), &keys[0], &msgs[0], &lengths[0], &sigs[0], count, results);
+		for (size_t i=0; i<count; ++i)
+			fail = fail || !results[i];
+
+		keys[33] = keys[34];
+		fail = fail || ed25519::Verifier::VerifyBatch(GlobalRNG(), &keys[0], &msgs[0], &lengths[0], &sigs[0], count, results);
+		for (size_t i=0; i<count; ++i)
+			fail = fail || (results[i] != (i != 33));
+
+		pass = pass && !fail;
+
+		std::cout << (fail ? "FAILED    " : "passed    ");
+		std::cout << "batch verification of " << count << " signatures\n";
+	}
+
 	return pass;
 }
 
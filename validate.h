@@ -64,6 +64,11 @@ bool ValidateWhirlpool();
 bool ValidateSM3();
 bool ValidateBLAKE2s();
 bool ValidateBLAKE2b();
+bool ValidateBLAKE2sp();
+bool ValidateBLAKE2bp();
+bool ValidateBLAKE3();
+bool ValidateKangarooTwelve();
+bool ValidateParallelHash();
 bool ValidatePoly1305();
 bool ValidateSipHash();
 
@@ -174,6 +179,13 @@ bool TestHuffmanCodes();
 bool TestASN1Parse();
 // https://github.com/weidai11/cryptopp/pull/334
 bool TestStringSink();
+bool TestMappedFileSource();
+bool TestByteQueueNodePool();
+bool TestVectoredPut();
+bool TestParallelFilter();
+#if defined(CRYPTOPP_UNIX_AVAILABLE)
+bool TestPosixFileSink();
+#endif
 // Additional tests due to no coverage
 bool TestCompressors();
 bool TestEncryptors();
@@ -878,4 +878,22 @@ bool ed25519Verifier::VerifyStream(std::istream& stream, const byte *signature,
     return ret == 0;
 }
 
+bool ed25519Verifier::VerifyBatch(RandomNumberGenerator &rng, const byte *const messages[],
+    const size_t messageLengths[], const byte *const signatures[], size_t count, bool results[]) const
+{
+    const ed25519PublicKey& pk = static_cast<const ed25519PublicKey&>(GetPublicKey());
+    const std::vector<const byte*> publicKeys(count, pk.GetPublicKeyBytePtr());
+
+    return VerifyBatch(rng, count ? &publicKeys[0] : NULLPTR, messages, messageLengths, signatures, count, results);
+}
+
+bool ed25519Verifier::VerifyBatch(RandomNumberGenerator &rng, const byte *const publicKeys[],
+    const byte *const messages[], const size_t messageLengths[],
+    const byte *const signatures[], size_t count, bool results[])
+{
+    int ret = Donna::ed25519_sign_open_batch(rng, messages, messageLengths, publicKeys, signatures, count, results);
+
+    return ret == 0;
+}
+
 NAMESPACE_END  // CryptoPP
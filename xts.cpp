@@ -175,6 +175,48 @@ inline void GF_Double(byte *inout, unsigned int len)
     GF_Double(inout, inout, len);
 }
 
+// Computes the tweaks for blocks 1 to count-1 from the tweak for block 0.
+// The SIMD code keeps the 16-byte tweak in a register and doubles it with
+// 64-bit shifts, moving the carries between the halves with a shuffle.
+inline void GF_DoubleTweaks(byte *tweaks, unsigned int blockSize, unsigned int count)
+{
+#if defined(CRYPTOPP_DISABLE_ASM)
+    // Fall through to the portable code
+
+#elif defined(__SSE2__) || defined(_M_X64)
+    if (blockSize == 16)
+    {
+        const __m128i poly = _mm_set_epi32(0, 1, 0, 0x87);
+        __m128i x = _mm_loadu_si128(CONST_M128_CAST(tweaks));
+        for (unsigned int i=1; i<count; ++i)
+        {
+            const __m128i carry = _mm_shuffle_epi32(_mm_srai_epi32(x, 31), _MM_SHUFFLE(1,1,3,3));
+            x = _mm_xor_si128(_mm_slli_epi64(x, 1), _mm_and_si128(carry, poly));
+            _mm_storeu_si128(M128_CAST(tweaks+i*16), x);
+        }
+        return;
+    }
+
+#elif (defined(__aarch32__) || defined(__aarch64__) || defined(_M_ARM64)) && defined(CRYPTOPP_LITTLE_ENDIAN)
+    if (blockSize == 16)
+    {
+        const uint64x2_t poly = vcombine_u64(vcreate_u64(0x87), vcreate_u64(1));
+        uint64x2_t x = vreinterpretq_u64_u8(vld1q_u8(tweaks));
+        for (unsigned int i=1; i<count; ++i)
+        {
+            const int64x2_t sign = vshrq_n_s64(vreinterpretq_s64_u64(x), 63);
+            const uint64x2_t carry = vandq_u64(vreinterpretq_u64_s64(vextq_s64(sign, sign, 1)), poly);
+            x = veorq_u64(vshlq_n_u64(x, 1), carry);
+            vst1q_u8(tweaks+i*16, vreinterpretq_u8_u64(x));
+        }
+        return;
+    }
+#endif
+
+    for (unsigned int i=1; i<count; ++i)
+        GF_Double(tweaks+i*blockSize, tweaks+(i-1)*blockSize, blockSize);
+}
+
 ANONYMOUS_NAMESPACE_END
 
 NAMESPACE_BEGIN(CryptoPP)
@@ -249,25 +291,26 @@ void XTS_ModeBase::ProcessData(byte *outString, const byte *inString, size_t len
     const size_t parallelSize = blockSize*ParallelBlocks;
     size_t i = 0;
 
-    // encrypt the data unit, optimal size at a time
-    for ( ; i+parallelSize<=length; i+=parallelSize)
+    // encrypt the data unit, optimal size at a time. The blocks left
+    // over at the end are one shorter batch, so they still reach the
+    // narrower kernels of the cipher.
+    while (length-i >= 2*blockSize)
     {
-        // If this fires the GF_Double'ing below is not in sync
-        CRYPTOPP_ASSERT(ParallelBlocks == 4);
+        const size_t batchSize = STDMIN(parallelSize, length-i);
+        const unsigned int count = static_cast<unsigned int>(batchSize/blockSize);
 
         // m_xregister[0] always points to the next tweak.
-        GF_Double(m_xregister+1*blockSize, m_xregister+0*blockSize, blockSize);
-        GF_Double(m_xregister+2*blockSize, m_xregister+1*blockSize, blockSize);
-        GF_Double(m_xregister+3*blockSize, m_xregister+2*blockSize, blockSize);
+        GF_DoubleTweaks(m_xregister, blockSize, count);
 
         // merge the tweak into the input block
-        XorBuffer(m_xworkspace, inString+i, m_xregister, parallelSize);
+        XorBuffer(m_xworkspace, inString+i, m_xregister, batchSize);
 
         // encrypt one block, merge the tweak into the output block
-        GetBlockCipher().AdvancedProcessBlocks(m_xworkspace, m_xregister, outString+i, parallelSize, BlockTransformation::BT_AllowParallel);
+        GetBlockCipher().AdvancedProcessBlocks(m_xworkspace, m_xregister, outString+i, batchSize, BlockTransformation::BT_AllowParallel);
 
         // m_xregister[0] always points to the next tweak.
-        GF_Double(m_xregister+0, m_xregister+(ParallelBlocks-1)*blockSize, blockSize);
+        GF_Double(m_xregister+0, m_xregister+(count-1)*blockSize, blockSize);
+        i += batchSize;
     }
 
     // encrypt the data unit, blocksize at a time
@@ -287,6 +330,35 @@ void XTS_ModeBase::ProcessData(byte *outString, const byte *inString, size_t len
     }
 }
 
+void XTS_ModeBase::ProcessSectors(byte *outString, const byte *inString, size_t length, size_t sectorSize, word64 sector, ByteOrder order)
+{
+    const unsigned int blockSize = GetBlockCipher().BlockSize();
+    if (sectorSize < blockSize || length % sectorSize != 0)
+        throw InvalidArgument(AlgorithmName() + ": data is not a whole number of sectors");
+
+    // Encrypt the tweaks of up to ParallelBlocks sectors at a time
+    SecByteBlock tweaks(blockSize*ParallelBlocks);
+    const size_t sectors = length / sectorSize;
+
+    for (size_t i = 0; i < sectors; i += ParallelBlocks)
+    {
+        const size_t count = STDMIN(sectors-i, size_t(ParallelBlocks));
+        std::memset(tweaks, 0x00, tweaks.size());
+        for (size_t j = 0; j < count; ++j)
+            PutWord<word64>(false, order, tweaks+j*blockSize, sector+i+j);
+
+        GetTweakCipher().AdvancedProcessBlocks(tweaks, NULLPTR, tweaks, count*blockSize, BlockTransformation::BT_AllowParallel);
+
+        for (size_t j = 0; j < count; ++j)
+        {
+            std::memcpy(m_xregister, tweaks+j*blockSize, blockSize);
+            ProcessLastBlock(outString, sectorSize, inString, sectorSize);
+            outString += sectorSize;
+            inString += sectorSize;
+        }
+    }
+}
+
 size_t XTS_ModeBase::ProcessLastBlock(byte *outString, size_t outLength, const byte *inString, size_t inLength)
 {
     // need at least a full AES block
@@ -321,7 +393,7 @@ size_t XTS_ModeBase::ProcessLastPlainBlock(byte *outString, size_t outLength, co
     {
         // Allow ProcessData to handle full blocks except one
         const size_t head = (blocks-1)*blockSize;
-        ProcessData(outString, inString, inLength-head);
+        ProcessData(outString, inString, head);
 
         outString += head;
         inString  += head; inLength -= head;
@@ -386,7 +458,7 @@ size_t XTS_ModeBase::ProcessLastCipherBlock(byte *outString, size_t outLength, c
     {
         // Allow ProcessData to handle full blocks except one
         const size_t head = (blocks-1)*blockSize;
-        ProcessData(outString, inString, inLength-head);
+        ProcessData(outString, inString, head);
 
         outString += head;
         inString  += head; inLength -= head;
@@ -119,6 +119,25 @@ public:
     ///  compatibility with the IEEE P1619 paper.
     void Resynchronize(word64 sector, ByteOrder order=BIG_ENDIAN_ORDER);
 
+    /// \brief Encrypt or decrypt consecutive sectors
+    /// \param outString the output byte buffer
+    /// \param inString the input byte buffer
+    /// \param length the size of the input and output byte buffers, in bytes
+    /// \param sectorSize the size of a sector, in bytes
+    /// \param sector the 64-bit sector number of the first sector
+    /// \param order the endian order the sector numbers should be written
+    /// \throws InvalidArgument if length is not a multiple of sectorSize, or
+    ///  sectorSize is less than the block size
+    /// \details ProcessSectors() processes each sector as a separate data unit,
+    ///  as if Resynchronize(sector+i, order) was called before ProcessLastBlock().
+    ///  The tweaks of several sectors are encrypted together, so a large request
+    ///  costs less than one call per sector. Sectors that are not a multiple of the
+    ///  block size use ciphertext stealing. outString and inString may be the same.
+    /// \details The cipher must be resynchronized before it is used again as a
+    ///  stream.
+    /// \since Crypto++ 8.3
+    void ProcessSectors(byte *outString, const byte *inString, size_t length, size_t sectorSize, word64 sector, ByteOrder order=BIG_ENDIAN_ORDER);
+
 protected:
     virtual void ResizeBuffers();
 
@@ -137,7 +156,8 @@ protected:
     SecByteBlock m_xregister;
     SecByteBlock m_xworkspace;
 
-    enum {ParallelBlocks = 4};
+    // The widest AES kernel, VAES-512, encrypts 16 blocks at a time
+    enum {ParallelBlocks = 16};
 };
 
 /// \brief XTS block cipher mode of operation implementation
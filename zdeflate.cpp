@@ -7,6 +7,9 @@
 
 #include "pch.h"
 #include "zdeflate.h"
+#include "algparam.h"
+#include "queue.h"
+#include "parallel.h"
 #include "stdcpp.h"
 #include "misc.h"
 
@@ -236,7 +239,8 @@ inline void HuffmanEncoder::Encode(LowFirstBitWriter &writer, value_t value) con
 
 Deflator::Deflator(BufferedTransformation *attachment, int deflateLevel, int log2WindowSize, bool detectUncompressible)
 	: LowFirstBitWriter(attachment)
-	, m_deflateLevel(-1)
+	, m_deflateLevel(-1), m_fastMatch(false), m_threads(1), m_chunkSize(0)
+	, m_pendingStart(0), m_pendingEnd(0)
 {
 	InitializeStaticEncoders();
 	Deflator::IsolatedInitialize(MakeParameters("DeflateLevel", deflateLevel)("Log2WindowSize", log2WindowSize)("DetectUncompressible", detectUncompressible));
@@ -244,7 +248,8 @@ Deflator::Deflator(BufferedTransformation *attachment, int deflateLevel, int log
 
 Deflator::Deflator(const NameValuePairs &parameters, BufferedTransformation *attachment)
 	: LowFirstBitWriter(attachment)
-	, m_deflateLevel(-1)
+	, m_deflateLevel(-1), m_fastMatch(false), m_threads(1), m_chunkSize(0)
+	, m_pendingStart(0), m_pendingEnd(0)
 {
 	InitializeStaticEncoders();
 	Deflator::IsolatedInitialize(parameters);
@@ -284,6 +289,31 @@ void Deflator::IsolatedInitialize(const NameValuePairs &parameters)
 	SetDeflateLevel(deflateLevel);
 	bool detectUncompressible = parameters.GetValueWithDefault("DetectUncompressible", true);
 	m_compressibleDeflateLevel = detectUncompressible ? m_deflateLevel : 0;
+	m_fastMatch = parameters.GetValueWithDefault("FastMatch", false);
+
+	int threads = parameters.GetIntValueWithDefault("Threads", 1);
+	if (threads < 0)
+		throw InvalidArgument("Deflator: " + IntToString(threads) + " is an invalid number of threads");
+	const int chunkSize = parameters.GetIntValueWithDefault("ChunkSize", 128*1024);
+	if (chunkSize <= 0)
+		throw InvalidArgument("Deflator: " + IntToString(chunkSize) + " is an invalid chunk size");
+
+	m_threads = threads ? static_cast<unsigned int>(threads) : DefaultThreadCount();
+	m_chunkSize = static_cast<size_t>(chunkSize);
+	m_pendingStart = m_pendingEnd = 0;
+	m_helpers.resize(0);
+	m_pending.New(0);
+
+	if (m_threads > 1)
+	{
+		m_pending.New(DSIZE + m_threads*m_chunkSize);
+		m_helpers.resize(m_threads);
+		for (unsigned int i=0; i<m_threads; i++)
+			m_helpers[i].reset(new Deflator(MakeParameters("DeflateLevel", m_deflateLevel)
+				("Log2WindowSize", m_log2WindowSize)("DetectUncompressible", detectUncompressible)
+				("FastMatch", m_fastMatch),
+				new ByteQueue));
+	}
 }
 
 void Deflator::Reset(bool forceReset)
@@ -306,6 +336,9 @@ void Deflator::Reset(bool forceReset)
 	m_detectCount = 1;
 	m_detectSkip = 0;
 
+	m_pendingStart = 0;
+	m_pendingEnd = 0;
+
 	// m_prev will be initialized automatically in InsertString
 	std::fill(m_head.begin(), m_head.end(), byte(0));
 
@@ -338,6 +371,7 @@ void Deflator::SetDeflateLevel(int deflateLevel)
 
 	GOOD_MATCH = configurationTable[deflateLevel][0];
 	MAX_LAZYLENGTH = configurationTable[deflateLevel][1];
+	NICE_MATCH = configurationTable[deflateLevel][2];
 	MAX_CHAIN_LENGTH = configurationTable[deflateLevel][3];
 
 	m_deflateLevel = deflateLevel;
@@ -385,9 +419,34 @@ unsigned int Deflator::FillWindow(const byte *str, size_t length)
 inline unsigned int Deflator::ComputeHash(const byte *str) const
 {
 	CRYPTOPP_ASSERT(str+3 <= m_byteBuffer + m_stringStart + m_lookahead);
-	return ((str[0] << 10) ^ (str[1] << 5) ^ str[2]) & HMASK;
+	// Multiplicative hash of the MIN_MATCH bytes, the top bits mix all of them
+	const word32 x = word32(str[0]) | word32(str[1]) << 8 | word32(str[2]) << 16;
+	return (x * 0x9E3779B1) >> (32 - m_log2WindowSize);
+}
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+// Length of the common prefix of scan and match, at most scanEnd - scan.
+// Compares a word at a time, and the first differing byte is located
+// from the trailing zeros of the little-endian difference.
+inline unsigned int MatchLength(const byte *scan, const byte *scanEnd, const byte *match)
+{
+	const byte *start = scan;
+	while (scan + 8 <= scanEnd)
+	{
+		const word64 diff = GetWord<word64>(false, LITTLE_ENDIAN_ORDER, scan) ^
+			GetWord<word64>(false, LITTLE_ENDIAN_ORDER, match);
+		if (diff)
+			return (unsigned int)(scan - start) + TrailingZeros(diff) / 8;
+		scan += 8; match += 8;
+	}
+	while (scan < scanEnd && *scan == *match)
+		scan++, match++;
+	return (unsigned int)(scan - start);
 }
 
+ANONYMOUS_NAMESPACE_END
+
 unsigned int Deflator::LongestMatch(unsigned int &bestMatch) const
 {
 	CRYPTOPP_ASSERT(m_previousLength < MAX_MATCH);
@@ -402,7 +461,9 @@ unsigned int Deflator::LongestMatch(unsigned int &bestMatch) const
 	unsigned int current = m_head[ComputeHash(scan)];
 
 	unsigned int chainLength = MAX_CHAIN_LENGTH;
-	if (m_previousLength >= GOOD_MATCH)
+	if (m_fastMatch)
+		chainLength = 2;	// a single probe
+	else if (m_previousLength >= GOOD_MATCH)
 		chainLength >>= 2;
 
 	while (current > limit && --chainLength > 0)
@@ -411,26 +472,15 @@ unsigned int Deflator::LongestMatch(unsigned int &bestMatch) const
 		CRYPTOPP_ASSERT(scan + bestLength < m_byteBuffer + m_stringStart + m_lookahead);
 		if (scan[bestLength-1] == match[bestLength-1] && scan[bestLength] == match[bestLength] && scan[0] == match[0] && scan[1] == match[1])
 		{
-			CRYPTOPP_ASSERT(scan[2] == match[2]);
-			unsigned int len = (unsigned int)(
-#if defined(_STDEXT_BEGIN) && !(defined(_MSC_VER) && (_MSC_VER < 1400 || _MSC_VER >= 1600)) && !defined(_STLPORT_VERSION)
-				stdext::unchecked_mismatch
-#else
-				std::mismatch
-#endif
-#if _MSC_VER >= 1600
-				(stdext::make_unchecked_array_iterator(scan)+3, stdext::make_unchecked_array_iterator(scanEnd), stdext::make_unchecked_array_iterator(match)+3).first - stdext::make_unchecked_array_iterator(scan));
-#else
-				(scan+3, scanEnd, match+3).first - scan);
-#endif
-			CRYPTOPP_ASSERT(len != bestLength);
+			// The hash no longer guarantees scan[2] == match[2]
+			unsigned int len = MatchLength(scan+2, scanEnd, match+2) + 2;
 			if (len > bestLength)
 			{
 				bestLength = len;
 				bestMatch = current;
 
 				CRYPTOPP_ASSERT(scanEnd >= scan);
-				if (len == (unsigned int)(scanEnd - scan))
+				if (len == (unsigned int)(scanEnd - scan) || len >= NICE_MATCH)
 					break;
 			}
 		}
@@ -500,7 +550,22 @@ void Deflator::ProcessBuffer()
 		{
 			m_previousLength = 0;
 			m_previousLength = LongestMatch(m_previousMatch);
-			if (m_previousLength)
+			if (m_previousLength && m_fastMatch)
+			{
+				// the fast matcher takes the match at once, and does not
+				// index the strings inside long matches
+				MatchFound(m_stringStart-m_previousMatch, m_previousLength);
+				if (m_previousLength > MAX_LAZYLENGTH+1)
+				{
+					if (m_dictionaryEnd == m_stringStart)
+						InsertString(m_dictionaryEnd);
+					m_dictionaryEnd = m_stringStart + m_previousLength;
+				}
+				m_stringStart += m_previousLength;
+				m_lookahead -= m_previousLength;
+				continue;
+			}
+			else if (m_previousLength)
 				m_matchAvailable = true;
 			else
 				LiteralByte(m_byteBuffer[m_stringStart]);
@@ -518,11 +583,116 @@ void Deflator::ProcessBuffer()
 	}
 }
 
+void Deflator::SetDictionary(const byte *dictionary, size_t length)
+{
+	CRYPTOPP_ASSERT(m_stringStart == 0 && m_lookahead == 0);
+
+	// The strings are inserted into the hash chains by ProcessBuffer()
+	// as the lookahead reaches them, and the block starts after them
+	length = STDMIN(length, size_t(DSIZE));
+	memcpy_s(m_byteBuffer, m_byteBuffer.size(), dictionary, length);
+	m_stringStart = m_blockStart = static_cast<unsigned int>(length);
+}
+
+void Deflator::CompressChunk(size_t chunk, size_t chunks, bool eof)
+{
+	const size_t start = m_pendingStart + chunk*m_chunkSize;
+	const size_t length = STDMIN(m_chunkSize, m_pendingEnd - start);
+	const size_t window = STDMIN(start, size_t(DSIZE));
+	const bool last = eof && chunk+1 == chunks;
+
+	Deflator &helper = *m_helpers[chunk];
+	helper.AttachedTransformation()->Skip();
+	helper.Reset(true);
+	helper.SetDeflateLevel(m_deflateLevel);
+	helper.m_compressibleDeflateLevel = m_compressibleDeflateLevel;
+	helper.SetDictionary(m_pending+start-window, window);
+
+	// A sync flush ends all but the last chunk on a byte boundary
+	helper.Put2(m_pending+start, length, last, true);
+	if (!last)
+		helper.IsolatedFlush(true, true);
+}
+
+class Deflator::ChunkTask : public ParallelTask
+{
+public:
+	ChunkTask(Deflator &deflator, size_t chunks, bool eof)
+		: m_deflator(deflator), m_chunks(chunks), m_eof(eof) {}
+
+	void Run(size_t index)
+		{m_deflator.CompressChunk(index, m_chunks, m_eof);}
+
+private:
+	Deflator &m_deflator;
+	size_t m_chunks;
+	bool m_eof;
+};
+
+void Deflator::CompressPending(bool eof)
+{
+	const size_t length = m_pendingEnd - m_pendingStart;
+	size_t chunks = (length + m_chunkSize - 1) / m_chunkSize;
+	if (eof && chunks == 0)
+		chunks = 1;
+	CRYPTOPP_ASSERT(chunks <= m_helpers.size());
+
+	ChunkTask task(*this, chunks, eof);
+	RunParallelTasks(task, chunks);
+
+	for (size_t i = 0; i < chunks; ++i)
+		m_helpers[i]->AttachedTransformation()->TransferTo(*AttachedTransformation());
+
+	// Keep the end of the data as the window of the next chunks
+	const size_t window = STDMIN(m_pendingEnd, size_t(DSIZE));
+	memmove(m_pending, m_pending+m_pendingEnd-window, window);
+	m_pendingStart = m_pendingEnd = window;
+}
+
+void Deflator::ParallelPut(const byte *str, size_t length)
+{
+	if (!m_headerWritten)
+	{
+		WritePrestreamHeader();
+		m_headerWritten = true;
+	}
+
+	ProcessUncompressedData(str, length);
+
+	const size_t batch = m_threads*m_chunkSize;
+	while (length > 0)
+	{
+		const size_t space = m_pendingStart + batch - m_pendingEnd;
+		const size_t accepted = STDMIN(space, length);
+		memcpy_s(m_pending+m_pendingEnd, m_pending.size()-m_pendingEnd, str, accepted);
+		m_pendingEnd += accepted;
+		str += accepted;
+		length -= accepted;
+
+		if (m_pendingEnd - m_pendingStart == batch)
+			CompressPending(false);
+	}
+}
+
 size_t Deflator::Put2(const byte *str, size_t length, int messageEnd, bool blocking)
 {
 	if (!blocking)
 		throw BlockingInputOnly("Deflator");
 
+	if (m_threads > 1)
+	{
+		ParallelPut(str, length);
+		if (messageEnd)
+		{
+			CompressPending(true);
+			WritePoststreamTail();
+			Reset();
+		}
+
+		Output(0, NULLPTR, 0, messageEnd, blocking);
+		return 0;
+	}
+
 	size_t accepted = 0;
 	while (accepted < length)
 	{
@@ -553,6 +723,14 @@ bool Deflator::IsolatedFlush(bool hardFlush, bool blocking)
 	if (!blocking)
 		throw BlockingInputOnly("Deflator");
 
+	if (m_threads > 1)
+	{
+		CRYPTOPP_UNUSED(hardFlush);
+		if (m_pendingEnd > m_pendingStart)
+			CompressPending(false);
+		return false;
+	}
+
 	m_minLookahead = 0;
 	ProcessBuffer();
 	m_minLookahead = MAX_MATCH;
@@ -607,7 +785,15 @@ void Deflator::MatchFound(unsigned int distance, unsigned int length)
 	unsigned int lengthCode = lengthCodes[length-3];
 	m.literalCode = lengthCode;
 	m.literalExtra = length - lengthBases[lengthCode-257];
-	unsigned int distanceCode = (unsigned int)(std::upper_bound(distanceBases, distanceBases+30, distance) - distanceBases - 1);
+	// Codes 4 and up come in pairs per power of 2, the bit below the
+	// leading bit of distance-1 selects the code within the pair
+	unsigned int distanceCode = distance-1;
+	if (distanceCode >= 4)
+	{
+		const unsigned int bits = BitPrecision(distanceCode) - 1;
+		distanceCode = 2*bits + ((distanceCode >> (bits-1)) & 1);
+	}
+	CRYPTOPP_ASSERT(distanceCode < 30 && distanceBases[distanceCode] <= distance);
 	m.distanceCode = distanceCode;
 	m.distanceExtra = distance - distanceBases[distanceCode];
 
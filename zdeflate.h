@@ -105,7 +105,18 @@ public:
 	/// \brief Construct a Deflator compressor
 	/// \param parameters a set of NameValuePairs to initialize this object
 	/// \param attachment an attached transformation
-	/// \details Possible parameter names: Log2WindowSize, DeflateLevel, DetectUncompressible
+	/// \details Possible parameter names: Log2WindowSize, DeflateLevel, DetectUncompressible,
+	///   FastMatch, Threads, ChunkSize
+	/// \details <tt>FastMatch</tt> is meant for streaming at high speed. The matcher probes
+	///   a single hash table entry for each string, takes the first match greedily, and
+	///   does not index the strings inside long matches. It trades ratio for speed at
+	///   every level but 0. The default is false, which searches the hash chains of the level.
+	/// \details When <tt>Threads</tt> is not 1 the input is split into chunks of
+	///   <tt>ChunkSize</tt> bytes, and the chunks are compressed concurrently. Each chunk
+	///   is primed with the window of data that precedes it and ends with a sync flush,
+	///   so the output is a single valid stream. 0 means one thread per processor. The
+	///   default is 1, which compresses on the calling thread. The default ChunkSize is
+	///   128 KB. The output depends on ChunkSize but not on the number of threads.
 	Deflator(const NameValuePairs &parameters, BufferedTransformation *attachment=NULLPTR);
 
 	/// \brief Sets the deflation level
@@ -121,6 +132,18 @@ public:
 	/// \returns the windows size
 	int GetLog2WindowSize() const {return m_log2WindowSize;}
 
+	/// \brief Retrieves the number of threads
+	/// \returns the number of threads used to compress chunks
+	/// \details GetThreads() returns 1 when the input is compressed on the
+	///   calling thread.
+	/// \since Crypto++ 8.3
+	unsigned int GetThreads() const {return m_threads;}
+
+	/// \brief Determines if the single probe matcher is used
+	/// \returns true if the FastMatch parameter was set, false otherwise
+	/// \since Crypto++ 8.3
+	bool GetFastMatch() const {return m_fastMatch;}
+
 	void IsolatedInitialize(const NameValuePairs &parameters);
 	size_t Put2(const byte *inString, size_t length, int messageEnd, bool blocking);
 	bool IsolatedFlush(bool hardFlush, bool blocking);
@@ -147,6 +170,13 @@ protected:
 	void EncodeBlock(bool eof, unsigned int blockType);
 	void EndBlock(bool eof);
 
+	void SetDictionary(const byte *dictionary, size_t length);
+	void ParallelPut(const byte *str, size_t length);
+	void CompressPending(bool eof);
+	void CompressChunk(size_t chunk, size_t chunks, bool eof);
+
+	class ChunkTask;
+
 	struct EncodedMatch
 	{
 		unsigned literalCode : 9;
@@ -157,8 +187,8 @@ protected:
 
 	int m_deflateLevel, m_log2WindowSize, m_compressibleDeflateLevel;
 	unsigned int m_detectSkip, m_detectCount;
-	unsigned int DSIZE, DMASK, HSIZE, HMASK, GOOD_MATCH, MAX_LAZYLENGTH, MAX_CHAIN_LENGTH;
-	bool m_headerWritten, m_matchAvailable;
+	unsigned int DSIZE, DMASK, HSIZE, HMASK, GOOD_MATCH, MAX_LAZYLENGTH, NICE_MATCH, MAX_CHAIN_LENGTH;
+	bool m_headerWritten, m_matchAvailable, m_fastMatch;
 	unsigned int m_dictionaryEnd, m_stringStart, m_lookahead, m_minLookahead, m_previousMatch, m_previousLength;
 	HuffmanEncoder m_staticLiteralEncoder, m_staticDistanceEncoder, m_dynamicLiteralEncoder, m_dynamicDistanceEncoder;
 	SecByteBlock m_byteBuffer;
@@ -167,6 +197,14 @@ protected:
 	FixedSizeSecBlock<unsigned int, 30> m_distanceCounts;
 	SecBlock<EncodedMatch> m_matchBuffer;
 	unsigned int m_matchBufferEnd, m_blockStart, m_blockLength;
+
+	// Chunks compressed concurrently. m_pending holds the window that
+	// precedes the chunks in [0, m_pendingStart) and the chunks in
+	// [m_pendingStart, m_pendingEnd). Each helper writes to a ByteQueue.
+	unsigned int m_threads;
+	size_t m_chunkSize, m_pendingStart, m_pendingEnd;
+	SecByteBlock m_pending;
+	vector_member_ptrs<Deflator> m_helpers;
 };
 
 NAMESPACE_END
@@ -57,6 +57,13 @@ inline unsigned long LowFirstBitReader::GetBits(unsigned int length)
 	return result;
 }
 
+inline void LowFirstBitReader::UngetBits(unsigned long value, unsigned int length)
+{
+	CRYPTOPP_ASSERT(m_bitsBuffered + length <= sizeof(unsigned long)*8);
+	m_buffer = (m_buffer << length) | value;
+	m_bitsBuffered += length;
+}
+
 inline HuffmanDecoder::code_t HuffmanDecoder::NormalizeCode(HuffmanDecoder::code_t code, unsigned int codeBits)
 {
 	return code << (MAX_CODE_BITS - codeBits);
@@ -221,6 +228,91 @@ bool HuffmanDecoder::Decode(LowFirstBitReader &reader, value_t &value) const
 
 // *************************************************************
 
+ANONYMOUS_NAMESPACE_BEGIN
+
+const unsigned int lengthStarts[] = {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+	35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const unsigned int lengthExtraBits[] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+	3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const unsigned int distanceStarts[] = {
+	1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+	257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+	8193, 12289, 16385, 24577};
+const unsigned int distanceExtraBits[] = {
+	0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+	7, 7, 8, 8, 9, 9, 10, 10, 11, 11,
+	12, 12, 13, 13};
+
+// An entry of the fast path lookup tables is base<<16 | extra<<8 | kind<<5 | len.
+// The base is the literal, length start or distance start of the symbol, extra
+// is the number of extra bits that follow the code, and len is the length of
+// the code. A len of 0 means the code is longer than the table index, and the
+// symbol must be decoded with the HuffmanDecoder.
+enum {FAST_LITERAL = 0, FAST_MATCH = 1, FAST_END = 2, FAST_INVALID = 3};
+enum {FAST_LITERAL_BITS = 10, FAST_DISTANCE_BITS = 8};
+
+inline word32 FastEntry(unsigned int base, unsigned int extra, unsigned int kind)
+{
+	return word32(base) << 16 | word32(extra) << 8 | word32(kind) << 5;
+}
+
+inline word32 LiteralEntry(unsigned int value)
+{
+	if (value < 256)
+		return FastEntry(value, 0, FAST_LITERAL);
+	else if (value == 256)
+		return FastEntry(0, 0, FAST_END);
+	else if (value - 257 < COUNTOF(lengthStarts))
+		return FastEntry(lengthStarts[value-257], lengthExtraBits[value-257], FAST_MATCH);
+	else
+		return FastEntry(0, 0, FAST_INVALID);
+}
+
+inline word32 DistanceEntry(unsigned int value)
+{
+	if (value < COUNTOF(distanceStarts))
+		return FastEntry(distanceStarts[value], distanceExtraBits[value], FAST_MATCH);
+	else
+		return FastEntry(0, 0, FAST_INVALID);
+}
+
+// Build a fast path table from code lengths that HuffmanDecoder::Initialize
+// accepted. Each code of at most tableBits bits fills every slot whose low
+// bits match the code in stream order.
+void BuildFastTable(SecBlock<word32> &table, unsigned int tableBits, const unsigned int *codeBits,
+	unsigned int nCodes, word32 (*entry)(unsigned int))
+{
+	table.New(size_t(1) << tableBits);
+	std::fill(table.begin(), table.end(), word32(0));
+
+	unsigned int blCount[16] = {0}, nextCode[16] = {0};
+	for (unsigned int i=0; i<nCodes; i++)
+		blCount[codeBits[i]]++;
+	blCount[0] = 0;
+	for (unsigned int i=1, code=0; i<16; i++)
+	{
+		code = (code + blCount[i-1]) << 1;
+		nextCode[i] = code;
+	}
+
+	for (unsigned int i=0; i<nCodes; i++)
+	{
+		const unsigned int len = codeBits[i];
+		if (len == 0)
+			continue;
+		const word32 code = BitReverse(word32(nextCode[len]++)) >> (32-len);
+		if (len > tableBits)
+			continue;
+		const word32 value = entry(i) | len;
+		for (size_t j=code; j<table.size(); j+=size_t(1)<<len)
+			table[j] = value;
+	}
+}
+
+ANONYMOUS_NAMESPACE_END
+
 Inflator::Inflator(BufferedTransformation *attachment, bool repeat, int propagation)
 	: AutoSignaling<Filter>(propagation)
 	, m_state(PRE_STREAM), m_repeat(repeat), m_eof(0), m_wrappedAround(0)
@@ -271,13 +363,17 @@ void Inflator::OutputString(const byte *string, size_t length)
 
 void Inflator::OutputPast(unsigned int length, unsigned int distance)
 {
+	// The ring buffer holds two windows, see ProcessInput()
+	if (distance > m_window.size()/2)
+		throw BadDistanceErr();
+
 	size_t start;
 	if (distance <= m_current)
 		start = m_current - distance;
 	else if (m_wrappedAround && distance <= m_window.size())
 		start = m_current + m_window.size() - distance;
 	else
-		throw BadBlockErr();
+		throw BadDistanceErr();
 
 	if (start + length > m_window.size())
 	{
@@ -340,7 +436,9 @@ void Inflator::ProcessInput(bool flush)
 			m_wrappedAround = false;
 			m_current = 0;
 			m_lastFlush = 0;
-			m_window.New(((size_t) 1) << GetLog2WindowSize());
+			// The ring buffer is twice the window so the wide match copies
+			// in DecodeFast() never overwrite history that is still in use
+			m_window.New(((size_t) 2) << GetLog2WindowSize());
 			break;
 		case WAIT_HEADER:
 			{
@@ -458,13 +556,20 @@ void Inflator::DecodeHeader()
 				i += count;
 			}
 			m_dynamicLiteralDecoder.Initialize(codeLengths, hlit+257);
+			BuildFastTable(m_dynamicLiteralTable, FAST_LITERAL_BITS, codeLengths, hlit+257, LiteralEntry);
 			if (hdist == 0 && codeLengths[hlit+257] == 0)
 			{
 				if (hlit != 0)	// a single zero distance code length means all literals
 					throw BadBlockErr();
+				// any distance code in the block is an error
+				m_dynamicDistanceTable.New(size_t(1) << FAST_DISTANCE_BITS);
+				std::fill(m_dynamicDistanceTable.begin(), m_dynamicDistanceTable.end(), DistanceEntry(~0U) | 1);
 			}
 			else
+			{
 				m_dynamicDistanceDecoder.Initialize(codeLengths+hlit+257, hdist+1);
+				BuildFastTable(m_dynamicDistanceTable, FAST_DISTANCE_BITS, codeLengths+hlit+257, hdist+1, DistanceEntry);
+			}
 			m_nextDecode = LITERAL;
 		}
 		catch (HuffmanDecoder::Err &)
@@ -502,21 +607,6 @@ bool Inflator::DecodeBody()
 		break;
 	case 1:	// fixed codes
 	case 2:	// dynamic codes
-		static const unsigned int lengthStarts[] = {
-			3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
-			35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
-		static const unsigned int lengthExtraBits[] = {
-			0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
-			3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
-		static const unsigned int distanceStarts[] = {
-			1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
-			257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
-			8193, 12289, 16385, 24577};
-		static const unsigned int distanceExtraBits[] = {
-			0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
-			7, 7, 8, 8, 9, 9, 10, 10, 11, 11,
-			12, 12, 13, 13};
-
 		const HuffmanDecoder& literalDecoder = GetLiteralDecoder();
 		const HuffmanDecoder& distanceDecoder = GetDistanceDecoder();
 
@@ -525,6 +615,11 @@ bool Inflator::DecodeBody()
 		case LITERAL:
 			while (true)
 			{
+				if (DecodeFast(literalDecoder, distanceDecoder))
+				{
+					blockEnd = true;
+					break;
+				}
 				if (!literalDecoder.Decode(m_reader, m_literal))
 				{
 					m_nextDecode = LITERAL;
@@ -602,6 +697,133 @@ bool Inflator::DecodeBody()
 	return blockEnd;
 }
 
+bool Inflator::DecodeFast(const HuffmanDecoder &literalDecoder, const HuffmanDecoder &distanceDecoder)
+{
+	// The fast path decodes whole symbols from a 64-bit bit buffer that is
+	// refilled from the contiguous input once per symbol, and writes straight
+	// into the window. It runs while there are enough input bytes for a
+	// refill and enough window space for the longest match plus the overrun
+	// of the wide copy, and hands back to the caller otherwise.
+	const size_t MIN_INPUT = 16, MAX_OUTPUT = 258+8;
+
+	if (m_current + MAX_OUTPUT > m_window.size())
+		return false;
+
+	size_t size;
+	const byte *block = m_inQueue.Spy(size);
+	if (size < MIN_INPUT)
+		return false;
+
+	const word32 *literalTable = (m_blockType == 1) ? m_fixedLiteralTable.begin() : m_dynamicLiteralTable.begin();
+	const word32 *distanceTable = (m_blockType == 1) ? m_fixedDistanceTable.begin() : m_dynamicDistanceTable.begin();
+	const word32 literalMask = (1 << FAST_LITERAL_BITS) - 1, distanceMask = (1 << FAST_DISTANCE_BITS) - 1;
+
+	const byte *in = block, *const end = block + size;
+	byte *const window = m_window.begin();
+	const size_t limit = m_window.size() - MAX_OUTPUT, history = m_window.size()/2;
+	size_t current = m_current;
+
+	unsigned int bitcount = m_reader.BitsBuffered();
+	word64 bitbuf = m_reader.PeekBuffer();
+	m_reader.SkipBits(bitcount);
+
+	bool blockEnd = false;
+	while (in + 8 <= end && current <= limit)
+	{
+		// Bits above bitcount are the following input bits or zero, so the
+		// refill can OR in a whole word and advance by whole bytes.
+		bitbuf |= GetWord<word64>(false, LITTLE_ENDIAN_ORDER, in) << bitcount;
+		in += (63 - bitcount) >> 3;
+		bitcount |= 56;
+
+		word32 entry = literalTable[bitbuf & literalMask];
+		if ((entry & 31) == 0)
+		{
+			HuffmanDecoder::value_t value;
+			entry = literalDecoder.Decode(HuffmanDecoder::code_t(bitbuf), value);
+			entry |= LiteralEntry(value);
+		}
+		bitbuf >>= (entry & 31);
+		bitcount -= (entry & 31);
+
+		const unsigned int kind = (entry >> 5) & 3;
+		if (kind == FAST_LITERAL)
+		{
+			window[current++] = byte(entry >> 16);
+			continue;
+		}
+		else if (kind == FAST_END)
+		{
+			blockEnd = true;
+			break;
+		}
+		else if (kind == FAST_INVALID)
+			throw BadBlockErr();
+
+		unsigned int extra = (entry >> 8) & 31;
+		const unsigned int length = (entry >> 16) + (unsigned int)(bitbuf & ((1 << extra) - 1));
+		bitbuf >>= extra;
+		bitcount -= extra;
+
+		entry = distanceTable[bitbuf & distanceMask];
+		if ((entry & 31) == 0)
+		{
+			HuffmanDecoder::value_t value;
+			entry = distanceDecoder.Decode(HuffmanDecoder::code_t(bitbuf), value);
+			entry |= DistanceEntry(value);
+		}
+		bitbuf >>= (entry & 31);
+		bitcount -= (entry & 31);
+
+		if (((entry >> 5) & 3) == FAST_INVALID)
+			throw BadDistanceErr();
+
+		extra = (entry >> 8) & 31;
+		const unsigned int distance = (entry >> 16) + (unsigned int)(bitbuf & ((1 << extra) - 1));
+		bitbuf >>= extra;
+		bitcount -= extra;
+
+		if (distance > history)
+			throw BadDistanceErr();
+		else if (distance > current)
+		{
+			// the match starts in the previous pass of the ring buffer
+			m_current = current;
+			OutputPast(length, distance);
+			current = m_current;
+		}
+		else if (distance >= 8)
+		{
+			// each 8-byte step reads bytes already written, and may
+			// write up to 7 bytes past the end of the match
+			const byte *src = window + current - distance;
+			byte *dst = window + current;
+			for (unsigned int i=0; i<length; i+=8)
+				std::memcpy(dst+i, src+i, 8);
+			current += length;
+		}
+		else
+		{
+			const byte *src = window + current - distance;
+			byte *dst = window + current;
+			for (unsigned int i=0; i<length; i++)
+				dst[i] = src[i];
+			current += length;
+		}
+	}
+	m_current = current;
+
+	// Return the whole bytes still in the bit buffer to the input, and
+	// the remaining bits to the bit reader
+	const size_t rewind = STDMIN(size_t(bitcount / 8), size_t(in - block));
+	bitcount -= (unsigned int)rewind * 8;
+	bitbuf &= (word64(1) << bitcount) - 1;
+	m_inQueue.Skip(in - rewind - block);
+	m_reader.UngetBits((unsigned long)bitbuf, bitcount);
+
+	return blockEnd;
+}
+
 void Inflator::FlushOutput()
 {
 	if (m_state != PRE_STREAM)
@@ -621,6 +843,7 @@ void Inflator::CreateFixedLiteralDecoder()
 	std::fill(codeLengths + 280, codeLengths + 288, 8);
 	m_fixedLiteralDecoder.reset(new HuffmanDecoder);
 	m_fixedLiteralDecoder->Initialize(codeLengths, 288);
+	BuildFastTable(m_fixedLiteralTable, FAST_LITERAL_BITS, codeLengths, 288, LiteralEntry);
 }
 
 void Inflator::CreateFixedDistanceDecoder()
@@ -629,6 +852,7 @@ void Inflator::CreateFixedDistanceDecoder()
 	std::fill(codeLengths + 0, codeLengths + 32, 5);
 	m_fixedDistanceDecoder.reset(new HuffmanDecoder);
 	m_fixedDistanceDecoder->Initialize(codeLengths, 32);
+	BuildFastTable(m_fixedDistanceTable, FAST_DISTANCE_BITS, codeLengths, 32, DistanceEntry);
 }
 
 const HuffmanDecoder& Inflator::GetLiteralDecoder()
@@ -25,6 +25,7 @@ public:
 	unsigned long PeekBits(unsigned int length);
 	void SkipBits(unsigned int length);
 	unsigned long GetBits(unsigned int length);
+	void UngetBits(unsigned long value, unsigned int length);
 
 private:
 	BufferedTransformation &m_store;
@@ -141,6 +142,8 @@ private:
 	void CreateFixedDistanceDecoder();
 	void CreateFixedLiteralDecoder();
 
+	bool DecodeFast(const HuffmanDecoder &literalDecoder, const HuffmanDecoder &distanceDecoder);
+
 	const HuffmanDecoder& GetLiteralDecoder();
 	const HuffmanDecoder& GetDistanceDecoder();
 
@@ -154,6 +157,9 @@ private:
 	unsigned int m_literal, m_distance;	// for LENGTH_BITS or DISTANCE_BITS
 	HuffmanDecoder m_dynamicLiteralDecoder, m_dynamicDistanceDecoder;
 	member_ptr<HuffmanDecoder> m_fixedLiteralDecoder, m_fixedDistanceDecoder;
+	// Lookup tables of the fast path, see DecodeFast()
+	SecBlock<word32> m_dynamicLiteralTable, m_dynamicDistanceTable;
+	SecBlock<word32> m_fixedLiteralTable, m_fixedDistanceTable;
 	LowFirstBitReader m_reader;
 	SecByteBlock m_window;
 	size_t m_current, m_lastFlush;